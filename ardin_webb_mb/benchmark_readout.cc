@@ -0,0 +1,344 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdlib>
+
+// POSIX C includes
+extern "C"
+{
+#include <glob.h>
+}
+
+// Common includes
+#include "../common/bit_packed_readout.h"
+#include "../common/parallel_connectors.h"
+#include "../common/png_to_float.h"
+
+// Model includes
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+typedef std::chrono::high_resolution_clock Clock;
+
+double getDuration(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+unsigned int convertMsToTimesteps(double ms)
+{
+    return (unsigned int)std::round(ms / Parameters::timestepMs);
+}
+
+//----------------------------------------------------------------------------
+// LIFPopulation
+//----------------------------------------------------------------------------
+//! Host implementation of model.cc's LIF neurons with exponentially-shaped synaptic input,
+//! updated in the same order as GeNN - spikes are delivered the timestep after they are emitted
+class LIFPopulation
+{
+public:
+    LIFPopulation(unsigned int size, double tauSyn)
+    :   m_V(size), m_RefracTime(size), m_InSyn(size),
+        m_ExpDecay((float)std::exp(-Parameters::timestepMs / tauSyn)),
+        m_Init((float)((tauSyn * (1.0 - std::exp(-Parameters::timestepMs / tauSyn))) / Parameters::timestepMs))
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(m_V.begin(), m_V.end(), -60.0f);
+        std::fill(m_RefracTime.begin(), m_RefracTime.end(), 0.0f);
+        std::fill(m_InSyn.begin(), m_InSyn.end(), 0.0f);
+    }
+
+    void addInput(unsigned int i, float weight){ m_InSyn[i] += weight; }
+
+    //! Update neurons with external current (or none if iExt is nullptr), adding indices of spiking neurons to spikes
+    void update(const float *iExt, std::vector<unsigned int> &spikes)
+    {
+        spikes.clear();
+        for(unsigned int i = 0; i < m_V.size(); i++) {
+            const float iSyn = m_Init * m_InSyn[i];
+            m_InSyn[i] *= m_ExpDecay;
+
+            if(m_RefracTime[i] <= 0.0f) {
+                const float alpha = ((iSyn + (iExt ? iExt[i] : 0.0f)) * rMembrane) + vRest;
+                m_V[i] = alpha - (expTC * (alpha - m_V[i]));
+            }
+            else {
+                m_RefracTime[i] -= (float)Parameters::timestepMs;
+            }
+
+            if(m_RefracTime[i] <= 0.0f && m_V[i] >= vThresh) {
+                spikes.push_back(i);
+                m_V[i] = vReset;
+                m_RefracTime[i] = tauRefrac;
+            }
+        }
+    }
+
+private:
+    // Parameters from model.cc
+    static constexpr float rMembrane = 20.0f / 0.2f;
+    static constexpr float vRest = -60.0f;
+    static constexpr float vReset = -60.0f;
+    static constexpr float vThresh = -50.0f;
+    static constexpr float tauRefrac = 2.0f;
+    const float expTC = (float)std::exp(-Parameters::timestepMs / 20.0);
+
+    std::vector<float> m_V;
+    std::vector<float> m_RefracTime;
+    std::vector<float> m_InSyn;
+    const float m_ExpDecay;
+    const float m_Init;
+};
+
+constexpr float LIFPopulation::rMembrane;
+constexpr float LIFPopulation::vRest;
+constexpr float LIFPopulation::vReset;
+constexpr float LIFPopulation::vThresh;
+constexpr float LIFPopulation::tauRefrac;
+
+//! KC spikes emitted while one image was presented
+struct KCResponse
+{
+    KCResponse() : activity(Parameters::numKC)
+    {
+    }
+
+    //! Spikes emitted in each timestep
+    std::vector<std::vector<unsigned int>> spikes;
+    BitPackedReadout::Bitset activity;
+};
+
+//! Simulate PNs and KCs for one stimulus period of each image
+std::vector<KCResponse> simulateKCs(const std::vector<float> &images, unsigned int numImages,
+                                    const std::vector<std::vector<unsigned int>> &pnToKC, unsigned int duration)
+{
+    const unsigned int presentDuration = convertMsToTimesteps(Parameters::presentDurationMs);
+    LIFPopulation pn(Parameters::numPN, 3.0);
+    LIFPopulation kc(Parameters::numKC, 3.0);
+    const std::vector<float> zeros(Parameters::numPN, 0.0f);
+
+    std::vector<KCResponse> responses(numImages);
+    std::vector<unsigned int> pnSpikes;
+    for(unsigned int i = 0; i < numImages; i++) {
+        // **NOTE** stimuli are separated by long enough for neurons to return to rest
+        pn.reset();
+        kc.reset();
+        pnSpikes.clear();
+
+        auto &response = responses[i];
+        response.spikes.resize(duration);
+        for(unsigned int t = 0; t < duration; t++) {
+            // Deliver last timestep's PN spikes to KCs
+            for(unsigned int p : pnSpikes) {
+                for(unsigned int k : pnToKC[p]) {
+                    kc.addInput(k, (float)Parameters::pnToKCWeight);
+                }
+            }
+
+            pn.update((t < presentDuration) ? &images[i * Parameters::numPN] : zeros.data(), pnSpikes);
+            kc.update(nullptr, response.spikes[t]);
+            for(unsigned int k : response.spikes[t]) {
+                response.activity.set(k);
+            }
+        }
+    }
+    return responses;
+}
+
+//! Full spiking readout - simulate EN driven by replaying KC spikes and count its spikes
+unsigned int simulateEN(const KCResponse &response, const std::vector<float> &kcToENWeights)
+{
+    LIFPopulation en(1, 8.0);
+    std::vector<unsigned int> enSpikes;
+    unsigned int numSpikes = 0;
+    for(size_t t = 0; t < response.spikes.size(); t++) {
+        if(t > 0) {
+            for(unsigned int k : response.spikes[t - 1]) {
+                en.addInput(0, kcToENWeights[k]);
+            }
+        }
+        en.update(nullptr, enSpikes);
+        numSpikes += (unsigned int)enSpikes.size();
+    }
+    return numSpikes;
+}
+
+//! Spearman rank correlation between a and b, giving tied values their average rank
+double getSpearman(const std::vector<double> &a, const std::vector<double> &b)
+{
+    auto rank =
+        [](const std::vector<double> &values)
+        {
+            std::vector<size_t> order(values.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&values](size_t x, size_t y){ return values[x] < values[y]; });
+
+            std::vector<double> ranks(values.size());
+            for(size_t i = 0; i < order.size();) {
+                size_t j = i;
+                while(j < order.size() && values[order[j]] == values[order[i]]) {
+                    j++;
+                }
+                for(size_t k = i; k < j; k++) {
+                    ranks[order[k]] = 0.5 * (double)(i + j - 1);
+                }
+                i = j;
+            }
+            return ranks;
+        };
+
+    const auto rankA = rank(a);
+    const auto rankB = rank(b);
+    const double meanRank = 0.5 * (double)(a.size() - 1);
+    double covariance = 0.0;
+    double varianceA = 0.0;
+    double varianceB = 0.0;
+    for(size_t i = 0; i < a.size(); i++) {
+        covariance += (rankA[i] - meanRank) * (rankB[i] - meanRank);
+        varianceA += (rankA[i] - meanRank) * (rankA[i] - meanRank);
+        varianceB += (rankB[i] - meanRank) * (rankB[i] - meanRank);
+    }
+    return covariance / std::sqrt(varianceA * varianceB);
+}
+
+template<typename F>
+double timePerView(unsigned int numViews, unsigned int numRepeats, F f)
+{
+    const auto start = Clock::now();
+    for(unsigned int r = 0; r < numRepeats; r++) {
+        for(unsigned int v = 0; v < numViews; v++) {
+            f(v);
+        }
+    }
+    return getDuration(start) / (double)(numRepeats * numViews);
+}
+
+void benchmark(const std::string &dataset, const std::vector<std::vector<unsigned int>> &pnToKC, unsigned int numRepeats)
+{
+    // Load training image followed by test images
+    std::vector<std::string> imageFilenames{dataset + "/train.png"};
+    {
+        glob_t globBuffer;
+        glob((dataset + "/test*.png").c_str(), GLOB_TILDE, nullptr, &globBuffer);
+        imageFilenames.insert(imageFilenames.end(), globBuffer.gl_pathv, globBuffer.gl_pathv + globBuffer.gl_pathc);
+        globfree(&globBuffer);
+    }
+    const unsigned int numImages = (unsigned int)imageFilenames.size();
+    const unsigned int numViews = numImages - 1;
+    std::vector<float> images(Parameters::numPN * numImages);
+    PNGToFloat::readPNGs(imageFilenames, Parameters::inputCurrentScale, false, Parameters::numPN, images.data());
+
+    // Simulate KCs for each image
+    const unsigned int duration = convertMsToTimesteps(Parameters::presentDurationMs + Parameters::interStimuliDurationMs);
+    const auto kcStart = Clock::now();
+    const auto responses = simulateKCs(images, numImages, pnToKC, duration);
+    const double kcS = getDuration(kcStart) / (double)numImages;
+
+    // Learn training image - in the limit of strong reward, dopamine-modulated STDP removes
+    // the synapses from every KC which fired in response to the training image
+    std::vector<float> kcToENWeights(Parameters::numKC, (float)Parameters::kcToENWeight);
+    for(unsigned int k = 0; k < Parameters::numKC; k++) {
+        if(responses[0].activity.test(k)) {
+            kcToENWeights[k] = 0.0f;
+        }
+    }
+    BitPackedReadout::QuantisedWeights binaryWeights(Parameters::numKC, 1, (float)Parameters::kcToENWeight);
+    BitPackedReadout::QuantisedWeights quantisedWeights(Parameters::numKC, Parameters::readoutWeightBits, (float)Parameters::kcToENWeight);
+    binaryWeights.set(kcToENWeights.data());
+    quantisedWeights.set(kcToENWeights.data());
+
+    // Read out familiarity of each test view using each approach
+    std::vector<double> enSpikes(numViews);
+    std::vector<double> denseDrive(numViews);
+    std::vector<double> binaryDrive(numViews);
+    std::vector<double> quantisedDrive(numViews);
+    const double enS = timePerView(numViews, 1,
+        [&](unsigned int v){ enSpikes[v] = simulateEN(responses[v + 1], kcToENWeights); });
+    const double denseS = timePerView(numViews, numRepeats,
+        [&](unsigned int v)
+        {
+            float drive = 0.0f;
+            for(unsigned int k = 0; k < Parameters::numKC; k++) {
+                drive += responses[v + 1].activity.test(k) ? kcToENWeights[k] : 0.0f;
+            }
+            denseDrive[v] = drive;
+        });
+    const double binaryS = timePerView(numViews, numRepeats,
+        [&](unsigned int v){ binaryDrive[v] = binaryWeights.getDrive(responses[v + 1].activity); });
+    const double quantisedS = timePerView(numViews, numRepeats,
+        [&](unsigned int v){ quantisedDrive[v] = quantisedWeights.getDrive(responses[v + 1].activity); });
+
+    // Most familiar view is the one which excites the EN least
+    const auto mostFamiliar = [](const std::vector<double> &v){ return std::min_element(v.cbegin(), v.cend()) - v.cbegin(); };
+
+    double meanActive = 0.0;
+    for(const auto &r : responses) {
+        meanActive += (double)r.activity.count() / (double)numImages;
+    }
+
+    std::cout << dataset << ": " << numViews << " test views, " << meanActive << " active KCs per view on average" << std::endl;
+    std::cout << "\tPN and KC simulation (needed by all readouts):" << kcS * 1.0E6 << "us per view" << std::endl;
+    std::cout << "\tSpiking EN readout:" << enS * 1.0E6 << "us per view" << std::endl;
+    std::cout << "\tDense float readout:" << denseS * 1.0E6 << "us per view (" << enS / denseS << "x), Spearman "
+              << getSpearman(enSpikes, denseDrive) << std::endl;
+    std::cout << "\tBinary popcount readout:" << binaryS * 1.0E6 << "us per view (" << enS / binaryS << "x), Spearman "
+              << getSpearman(enSpikes, binaryDrive) << std::endl;
+    std::cout << "\t" << Parameters::readoutWeightBits << "-bit popcount readout:" << quantisedS * 1.0E6 << "us per view ("
+              << enS / quantisedS << "x), Spearman " << getSpearman(enSpikes, quantisedDrive) << std::endl;
+    std::cout << "\tMost familiar view - spiking:" << mostFamiliar(enSpikes) << ", binary popcount:" << mostFamiliar(binaryDrive)
+              << ", " << Parameters::readoutWeightBits << "-bit popcount:" << mostFamiliar(quantisedDrive) << std::endl;
+
+    // Popcount readout should exactly match dense readout of the same weights
+    for(unsigned int v = 0; v < numViews; v++) {
+        if(std::fabs(binaryDrive[v] - denseDrive[v]) > (1.0E-3 * Parameters::kcToENWeight * Parameters::numKC)) {
+            throw std::runtime_error("Popcount and dense readouts disagree for view " + std::to_string(v));
+        }
+    }
+}
+}   // Anonymous namespace
+
+// Compares the familiarity of each test view read out by simulating the EN against bit-packed popcount readouts
+// of the KC activity, simulating the PNs and KCs on the host with the same parameters and connectivity as model.cc:
+//      ./benchmark_readout [repeats of cheap readouts]
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const unsigned int numRepeats = (argc > 1) ? std::stoul(argv[1]) : 1000;
+
+        // Build PN to KC connectivity with the same seed as simulator
+        std::vector<std::vector<unsigned int>> pnToKC(Parameters::numPN);
+        std::vector<unsigned int> chosen;
+        for(unsigned int k = 0; k < Parameters::numKC; k++) {
+            ParallelConnectors::forEachFixedNumberPreSource(k, Parameters::numPN, Parameters::numPNSynapsesPerKC,
+                                                            Parameters::connectivitySeed, chosen,
+                                                            [&pnToKC, k](unsigned int p){ pnToKC[p].push_back(k); });
+        }
+
+        benchmark("ant1_data", pnToKC, numRepeats);
+        benchmark("ant2_data", pnToKC, numRepeats);
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -54,18 +54,24 @@ public:
 IMPLEMENT_MODEL(LIFVarOffset);
 
 //---------------------------------------------------------------------------
-// Standard LIF model extended to take an additional
-// input current from an extra global variable
+// Standard LIF model extended to take an additional input current from an
+// extra global variable. The population holds several instances, each of
+// NumPixels neurons, which all read the same image through a column offset
+// so each instance sees it rotated RotationStride pixels further. Only the
+// first IextNumInstances instances receive input
 //---------------------------------------------------------------------------
 class LIFExtCurrent : public NeuronModels::Base
 {
 public:
-    DECLARE_MODEL(LIFExtCurrent, 6, 3);
+    DECLARE_MODEL(LIFExtCurrent, 8, 3);
 
     SET_SIM_CODE(
         "if ($(RefracTime) <= 0.0)\n"
         "{\n"
-        "   const scalar Iext = *($(Iext) + $(IextOffset) + $(id));\n"
+        "   const unsigned int numPixels = (unsigned int)$(NumPixels);\n"
+        "   const unsigned int instance = $(id) / numPixels;\n"
+        "   const unsigned int pixel = (($(id) % numPixels) + (instance * (unsigned int)$(RotationStride))) % numPixels;\n"
+        "   const scalar Iext = (instance < $(IextNumInstances)) ? *($(Iext) + $(IextOffset) + pixel) : 0.0;\n"
         "   scalar alpha = (($(Isyn) + $(Ioffset) + Iext) * $(Rmembrane)) + $(Vrest);\n"
         "   $(V) = alpha - ($(ExpTC) * (alpha - $(V)));\n"
         "}\n"
@@ -87,7 +93,9 @@ public:
         "Vrest",      // Resting membrane potential [mV]
         "Vreset",     // Reset voltage [mV]
         "Vthresh",    // Spiking threshold [mV]
-        "TauRefrac"});
+        "TauRefrac",
+        "NumPixels",        // Number of pixels in image and hence neurons in each instance
+        "RotationStride"}); // Pixel offset between the images seen by successive instances
 
     SET_DERIVED_PARAMS({
         {"ExpTC", [](const vector<double> &pars, double dt){ return std::exp(-dt / pars[1]); }},
@@ -95,7 +103,7 @@ public:
 
     SET_VARS({{"V", "scalar"}, {"RefracTime", "scalar"}, {"Ioffset", "scalar"}});
 
-    SET_EXTRA_GLOBAL_PARAMS({{"Iext", "scalar *"}, {"IextOffset", "unsigned int"}});
+    SET_EXTRA_GLOBAL_PARAMS({{"Iext", "scalar *"}, {"IextOffset", "unsigned int"}, {"IextNumInstances", "unsigned int"}});
 };
 IMPLEMENT_MODEL(LIFExtCurrent);
 
@@ -109,7 +117,7 @@ void modelDefinition(NNmodel &model)
     // Neuron model parameters
     //---------------------------------------------------------------------------
     // LIF model parameters
-    LIFExtCurrent::ParamValues lifParams(
+    LIFVarOffset::ParamValues lifParams(
         0.2,    // 0 - C
         20.0,   // 1 - TauM
         -60.0,  // 2 - Vrest
@@ -117,8 +125,19 @@ void modelDefinition(NNmodel &model)
         -50.0,  // 4 - Vthresh
         2.0);    // 5 - TauRefrac
 
+    // PN model parameters - each rotation instance sees the image rotated by scanRotationColumns more columns
+    LIFExtCurrent::ParamValues pnParams(
+        0.2,    // 0 - C
+        20.0,   // 1 - TauM
+        -60.0,  // 2 - Vrest
+        -60.0,  // 3 - Vreset
+        -50.0,  // 4 - Vthresh
+        2.0,    // 5 - TauRefrac
+        Parameters::numPN,                                              // 6 - NumPixels
+        Parameters::panoramaHeight * Parameters::scanRotationColumns);  // 7 - RotationStride
+
     // LIF initial conditions
-    LIFExtCurrent::VarValues lifInit(
+    LIFVarOffset::VarValues lifInit(
         -60.0,  // 0 - V
         0.0,    // 1 - RefracTime
         0.0);   // 2 - Ioffset
@@ -153,8 +172,10 @@ void modelDefinition(NNmodel &model)
         0.0);                       // Time of last synaptic tag update
 
     // Create neuron populations
-    model.addNeuronPopulation<LIFExtCurrent>("PN", Parameters::numPN, lifParams, lifInit);
-    model.addNeuronPopulation<LIFVarOffset>("KC", Parameters::numKC, lifParams, lifInit);
+    // **NOTE** PNs and KCs consist of one instance per scan rotation, each with identical PN to KC connectivity,
+    // but familiarity is read out using the first instance's KC to EN weights so a single EN is shared by all
+    model.addNeuronPopulation<LIFExtCurrent>("PN", Parameters::numPN * Parameters::numScanRotations, pnParams, lifInit);
+    model.addNeuronPopulation<LIFVarOffset>("KC", Parameters::numKC * Parameters::numScanRotations, lifParams, lifInit);
     model.addNeuronPopulation<LIFVarOffset>("EN", Parameters::numEN, lifParams, lifInit);
 
     auto pnToKC = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
@@ -170,7 +191,7 @@ void modelDefinition(NNmodel &model)
         kcToENPostsynapticParams, {});
 
 
-    // Calculate max connections
+    // Calculate max connections - as instances aren't connected to each other, this is the same as for one instance
     const unsigned int maxConn = calcFixedNumberPreConnectorMaxConnections(Parameters::numPN, Parameters::numKC,
                                                                            Parameters::numPNSynapsesPerKC);
 
@@ -12,8 +12,20 @@ namespace Parameters
     constexpr double presentDurationMs = 40.0;
     constexpr double interStimuliDurationMs = 200.0;
 
-    // Network dimensions
-    constexpr unsigned int numPN = 360;
+    // Dimensions of panoramic views - images are stored column-major so
+    // rotating a view by one column offsets its pixel indices by panoramaHeight
+    constexpr unsigned int panoramaWidth = 36;
+    constexpr unsigned int panoramaHeight = 10;
+
+    // Rotation scan - each test view is presented to numScanRotations instances of the PNs and KCs,
+    // rotated scanRotationColumns further in each. Disabled by default so the model is the original
+    // experiment - set numScanRotations to panoramaWidth / scanRotationColumns to scan a full circle
+    // **NOTE** the EN is shared by all instances so its spikes during test views are only meaningful without a scan
+    constexpr unsigned int scanRotationColumns = 1;
+    constexpr unsigned int numScanRotations = 1;
+
+    // Network dimensions (of each rotation instance)
+    constexpr unsigned int numPN = panoramaWidth * panoramaHeight;
     constexpr unsigned int numKC = 20000;
     constexpr unsigned int numEN = 1;
 
@@ -36,4 +48,10 @@ namespace Parameters
 
     // How many PN neurons are connected to each KC
     constexpr unsigned int numPNSynapsesPerKC = 10;
+
+    // Number of bits KC to EN weights are quantised to for bit-packed familiarity readout
+    constexpr unsigned int readoutWeightBits = 4;
+
+    // Seed for PN to KC connectivity - each KC gets its own random stream so it's independent of thread count
+    constexpr unsigned int connectivitySeed = 1234;
 }
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <random>
+#include <string>
+#include <vector>
 
 // C standard includes
 #include <cstdint>
@@ -16,8 +19,9 @@ extern "C"
 }
 
 // Common includes
-#include "../common/connectors.h"
-#include "../common/png_to_float.h"
+#include "../common/bit_packed_readout.h"
+#include "../common/decoded_image_cache.h"
+#include "../common/parallel_connectors.h"
 #include "../common/spike_csv_recorder.h"
 #include "../common/timer.h"
 
@@ -37,10 +41,24 @@ unsigned int convertMsToTimesteps(double ms)
 {
     return (unsigned int)std::round(ms / Parameters::timestepMs);
 }
+
+// Azimuthal rotation of the view seen by a rotation instance
+double getRotationDegrees(unsigned int rotation)
+{
+    return (360.0 * rotation * Parameters::scanRotationColumns) / Parameters::panoramaWidth;
+}
 }
 
-int main()
+// Run with the directory containing the training and test images (defaults to ant2_data):
+//      ./simulator [ant1_data | ant2_data]
+// As well as recording spikes, the familiarity of each stimulus is read out from the KCs which fired during it,
+// using popcounts of their bit-packed activity and binary or quantised KC to EN weights, and written to readout.csv.
+// If Parameters::numScanRotations is more than 1, each test image is also presented to every rotation instance
+// and the familiarity of every rotation of every test image is written to rotation_scan.csv
+int main(int argc, char *argv[])
 {
+    const std::string dataset = (argc > 1) ? argv[1] : "ant2_data";
+
     std::mt19937 gen;
 
     {
@@ -56,8 +74,9 @@ int main()
     {
         Timer<> t("Building connectivity:");
 
-        buildFixedNumberPreConnector(Parameters::numPN, Parameters::numKC,
-                                     Parameters::numPNSynapsesPerKC, CpnToKC, &allocatepnToKC, gen);
+        ParallelConnectors::buildTiledFixedNumberPreConnector(Parameters::numScanRotations, Parameters::numPN, Parameters::numKC,
+                                                              Parameters::numPNSynapsesPerKC, CpnToKC, &allocatepnToKC,
+                                                              Parameters::connectivitySeed);
 
         /*allocatekcToEN(Parameters::numKC);
         for(unsigned int i = 0; i < Parameters::numKC; i++) {
@@ -85,51 +104,48 @@ int main()
     {
         Timer<> t("Stimuli generation:");
 
-        glob_t globBuffer;
-        glob("ant2_data/test*.png", GLOB_TILDE, nullptr, &globBuffer);
-        std::cout << globBuffer.gl_pathc << " test images found" << std::endl;
-
-        try
+        // Find test images, loading training image first
+        std::vector<std::string> imageFilenames{dataset + "/train.png"};
         {
-            const size_t stimuliSize = Parameters::numPN * (2 + globBuffer.gl_pathc);
-            numStimuli = globBuffer.gl_pathc + 1;
+            glob_t globBuffer;
+            glob((dataset + "/test*.png").c_str(), GLOB_TILDE, nullptr, &globBuffer);
+            imageFilenames.insert(imageFilenames.end(), globBuffer.gl_pathv, globBuffer.gl_pathv + globBuffer.gl_pathc);
+            globfree(&globBuffer);
+        }
+        std::cout << imageFilenames.size() - 1 << " test images found" << std::endl;
+
+        // Allocate stimuli with a block of zeros followed by each image
+        const size_t stimuliSize = Parameters::numPN * (1 + imageFilenames.size());
+        numStimuli = imageFilenames.size();
 
 #ifdef CPU_ONLY
-            stimuliCurrent = new float[stimuliSize];
+        stimuliCurrent = new float[stimuliSize];
 #else
-            CHECK_CUDA_ERRORS(cudaMallocHost(&stimuliCurrent, stimuliSize * sizeof(float)));
-            CHECK_CUDA_ERRORS(cudaMalloc(&d_stimuliCurrent, stimuliSize * sizeof(float)));
+        CHECK_CUDA_ERRORS(cudaMallocHost(&stimuliCurrent, stimuliSize * sizeof(float)));
+        CHECK_CUDA_ERRORS(cudaMalloc(&d_stimuliCurrent, stimuliSize * sizeof(float)));
 #endif
 
-            std::fill_n(&stimuliCurrent[0], Parameters::numPN, 0.0f);
-
-            // Load training image
-            read_png("ant2_data/train.png", Parameters::inputCurrentScale, false, &stimuliCurrent[Parameters::numPN]);
+        std::fill_n(&stimuliCurrent[0], Parameters::numPN, 0.0f);
 
-            // Load testing images
-            for(size_t i = 0; i < globBuffer.gl_pathc; i++) {
-                read_png(globBuffer.gl_pathv[i], Parameters::inputCurrentScale, false, &stimuliCurrent[(i + 2) * Parameters::numPN]);
-            }
+        // Decode images straight into stimuli or copy them from cache of previous decode
+        if(DecodedImageCache::readPNGs(imageFilenames, Parameters::inputCurrentScale, false, Parameters::numPN,
+                                       &stimuliCurrent[Parameters::numPN]))
+        {
+            std::cout << "\tLoaded decoded images from cache" << std::endl;
+        }
 
 #ifndef CPU_ONLY
-            // Upload data to GPU
-            CHECK_CUDA_ERRORS(cudaMemcpy(d_stimuliCurrent, stimuliCurrent, stimuliSize * sizeof(float), cudaMemcpyHostToDevice));
+        // Upload data to GPU
+        CHECK_CUDA_ERRORS(cudaMemcpy(d_stimuliCurrent, stimuliCurrent, stimuliSize * sizeof(float), cudaMemcpyHostToDevice));
 #endif
 
-            // Set correct image pointer
+        // Set correct image pointer
 #ifdef CPU_ONLY
-            IextPN = stimuliCurrent;
+        IextPN = stimuliCurrent;
 #else
-            IextPN = d_stimuliCurrent;
+        IextPN = d_stimuliCurrent;
 #endif
-        }
-        catch(...)
-        {
-            if(globBuffer.gl_pathc > 0) {
-                globfree(&globBuffer);
-            }
-            throw;
-        }
+        IextNumInstancesPN = 1;
     }
 
     dkcToEN = 0.0f;
@@ -143,6 +159,10 @@ int main()
     std::ofstream synapticTagStream("kc_en_syn.csv");
 #endif  // RECORD_SYNAPSE_STATE
 
+    // Bitsets of the KCs which spiked in each rotation instance and number of EN spikes during each stimulus
+    std::vector<BitPackedReadout::Bitset> kcActivity(numStimuli * Parameters::numScanRotations, BitPackedReadout::Bitset(Parameters::numKC));
+    std::vector<unsigned int> numENSpikes(numStimuli, 0);
+
     {
         Timer<> t("Simulation:");
 
@@ -180,6 +200,9 @@ int main()
 
                 // Update offset to point to correct block of pixel data
                 IextOffsetPN = Parameters::numPN * (1 + tStimuli.quot);
+
+                // Only present training image to unrotated instance but scan test images over all rotations
+                IextNumInstancesPN = (tStimuli.quot == 0) ? 1 : Parameters::numScanRotations;
             }
             // Otherwise update offset to point to block of zeros
             else {
@@ -242,6 +265,63 @@ int main()
             pnSpikes.record(t);
             kcSpikes.record(t);
             enSpikes.record(t);
+
+            // Accumulate KC activity of each rotation instance and EN spikes for stimulus
+            BitPackedReadout::Bitset *stimulusKCActivity = &kcActivity[tStimuli.quot * Parameters::numScanRotations];
+            for(unsigned int i = 0; i < spikeCount_KC; i++) {
+                stimulusKCActivity[spike_KC[i] / Parameters::numKC].set(spike_KC[i] % Parameters::numKC);
+            }
+            numENSpikes[tStimuli.quot] += spikeCount_EN;
+        }
+    }
+
+#ifndef CPU_ONLY
+    // Download learned KC to EN weights
+    pullkcToENStateFromDevice();
+#endif
+
+    {
+        Timer<> t("Bit-packed readout:");
+
+        // Quantise weights onto EN from unrotated instance's KCs
+        BitPackedReadout::QuantisedWeights binaryWeights(Parameters::numKC, 1, Parameters::kcToENWeight);
+        BitPackedReadout::QuantisedWeights quantisedWeights(Parameters::numKC, Parameters::readoutWeightBits, Parameters::kcToENWeight);
+        binaryWeights.set(gkcToEN, Parameters::numEN);
+        quantisedWeights.set(gkcToEN, Parameters::numEN);
+
+        // Write drive onto EN from each stimulus's KCs alongside number of spikes it actually caused
+        // **NOTE** the first stimulus was presented before learning so its EN spikes reflect the initial weights
+        // and, during test images, EN is also driven by the rotated instances so its spikes are only meaningful without a scan
+        std::ofstream readout("readout.csv");
+        readout << "Stimulus, Active KCs, EN spikes, Binary drive, Quantised drive" << std::endl;
+        for(unsigned int s = 0; s < numStimuli; s++) {
+            const auto &activity = kcActivity[s * Parameters::numScanRotations];
+            readout << s << ", " << activity.count() << ", " << numENSpikes[s] << ", "
+                << binaryWeights.getDrive(activity) << ", " << quantisedWeights.getDrive(activity) << std::endl;
+        }
+
+        // Because every instance has the same connectivity, the same weights read out the familiarity of each
+        // rotation - write rotation-familiarity curve of each test image and report its most familiar rotation
+        if(Parameters::numScanRotations > 1) {
+            std::ofstream rotationScan("rotation_scan.csv");
+            rotationScan << "Stimulus, Rotation [degrees], Active KCs, Binary drive, Quantised drive" << std::endl;
+            for(unsigned int s = 1; s < numStimuli; s++) {
+                unsigned int mostFamiliarRotation = 0;
+                float minDrive = std::numeric_limits<float>::max();
+                for(unsigned int r = 0; r < Parameters::numScanRotations; r++) {
+                    const auto &activity = kcActivity[(s * Parameters::numScanRotations) + r];
+                    const float quantisedDrive = quantisedWeights.getDrive(activity);
+                    rotationScan << s << ", " << getRotationDegrees(r) << ", " << activity.count() << ", "
+                        << binaryWeights.getDrive(activity) << ", " << quantisedDrive << std::endl;
+
+                    // Familiar views excite EN least
+                    if(quantisedDrive < minDrive) {
+                        minDrive = quantisedDrive;
+                        mostFamiliarRotation = r;
+                    }
+                }
+                std::cout << "\tStimulus " << s << " most familiar at rotation of " << getRotationDegrees(mostFamiliarRotation) << " degrees" << std::endl;
+            }
         }
     }
 
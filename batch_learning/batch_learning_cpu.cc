@@ -0,0 +1,158 @@
+#include "batch_learning_cpu.h"
+
+// Standard C++ includes
+#include <algorithm>
+
+// Batch-learning includes
+#include "optimisers_cpu.h"
+#include "simd_cpu.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// How large are (square) tiles used to calculate CPU transpose
+// **NOTE** 64x64 floats is 16KB so a tile remains in L1 cache between being updated and transposed
+constexpr unsigned int TILE_DIM = 64;
+
+// How many parameters are updated by each OpenMP work item when not transposing
+constexpr size_t UPDATE_CHUNK = 16 * 1024;
+
+class NOP
+{
+public:
+    template<typename V>
+    bool updateParameters(V&, size_t)
+    {
+        return false;
+    }
+};
+
+// Update contiguous range of parameters, using widest available vectors followed by scalars for tail
+template<typename Operation>
+void updateRange(float *g, size_t begin, size_t end, Operation &operation)
+{
+    typedef SIMD::Native V;
+
+    size_t idx = begin;
+    for(; (idx + V::width) <= end; idx += V::width) {
+        V gIn = V::load(&g[idx]);
+        if(operation.updateParameters(gIn, idx)) {
+            gIn.store(&g[idx]);
+        }
+    }
+
+    for(; idx < end; idx++) {
+        SIMD::Scalar gIn = SIMD::Scalar::load(&g[idx]);
+        if(operation.updateParameters(gIn, idx)) {
+            gIn.store(&g[idx]);
+        }
+    }
+}
+
+// Cache-blocked transpose, fused with update so each tile of parameters is only read from memory once
+template<typename Operation>
+void transposeTiles(float *in, float *out, unsigned int numInRows, unsigned int numInCols, Operation operation)
+{
+    // Calculate number of tiles required to process matrix
+    const int numTileX = (int)((numInCols + TILE_DIM - 1) / TILE_DIM);
+    const int numTileY = (int)((numInRows + TILE_DIM - 1) / TILE_DIM);
+
+    #pragma omp parallel for collapse(2) schedule(static) firstprivate(operation)
+    for(int tileY = 0; tileY < numTileY; tileY++) {
+        for(int tileX = 0; tileX < numTileX; tileX++) {
+            // Calculate extent of tile in input matrix
+            const unsigned int rowBegin = tileY * TILE_DIM;
+            const unsigned int rowEnd = std::min(rowBegin + TILE_DIM, numInRows);
+            const unsigned int colBegin = tileX * TILE_DIM;
+            const unsigned int colEnd = std::min(colBegin + TILE_DIM, numInCols);
+
+            // Update parameters in each row of tile
+            for(unsigned int i = rowBegin; i < rowEnd; i++) {
+                const size_t rowStart = (size_t)i * numInCols;
+                updateRange(in, rowStart + colBegin, rowStart + colEnd, operation);
+            }
+
+            // Write tile to output, reading columns of (cached) input tile to write contiguous output rows
+            for(unsigned int j = colBegin; j < colEnd; j++) {
+                float *outRow = &out[(size_t)j * numInRows];
+                for(unsigned int i = rowBegin; i < rowEnd; i++) {
+                    outRow[i] = in[((size_t)i * numInCols) + j];
+                }
+            }
+        }
+    }
+}
+
+template<typename Operation>
+void updateChunks(float *g, size_t size, Operation operation)
+{
+    const int numChunks = (int)((size + UPDATE_CHUNK - 1) / UPDATE_CHUNK);
+
+    #pragma omp parallel for schedule(static) firstprivate(operation)
+    for(int c = 0; c < numChunks; c++) {
+        const size_t begin = (size_t)c * UPDATE_CHUNK;
+        updateRange(g, begin, std::min(begin + UPDATE_CHUNK, size), operation);
+    }
+}
+}   // Anonymous namespace
+
+//----------------------------------------------------------------------------
+// BatchLearning
+//----------------------------------------------------------------------------
+namespace BatchLearning
+{
+void transposeCPU(const float *in, float *out, unsigned int numInRows, unsigned int numInCols)
+{
+    // **NOTE** NOP never updates parameters so input isn't written
+    NOP nop;
+    transposeTiles(const_cast<float*>(in), out, numInRows, numInCols, nop);
+}
+
+void fixedRateLearningCPU(float *deltaG, float *g, unsigned int numRows, unsigned int numCols, float learningRate)
+{
+    FixedLearningRateCPU fixedLearningRate(deltaG, learningRate);
+    updateChunks(g, (size_t)numRows * numCols, fixedLearningRate);
+}
+
+void fixedRateLearningTransposeCPU(float *deltaGIn, float *gIn, float *gOut, unsigned int numInRows, unsigned int numInCols, float learningRate)
+{
+    FixedLearningRateCPU fixedLearningRate(deltaGIn, learningRate);
+    transposeTiles(gIn, gOut, numInRows, numInCols, fixedLearningRate);
+}
+
+void adamOptimizerCPU(float *deltaG, float *m, float *v, float *g,
+                      unsigned int numRows, unsigned int numCols, unsigned int t,
+                      float alpha, float beta1, float beta2, float epsilon)
+{
+    AdamOptimizerCPU adam(deltaG, m, v, t, alpha, beta1, beta2, epsilon);
+    updateChunks(g, (size_t)numRows * numCols, adam);
+}
+
+void adamOptimizerTransposeCPU(float *deltaGIn, float *mIn, float *vIn, float *gIn,
+                               float *gOut, unsigned int numInRows, unsigned int numInCols,
+                               unsigned int t, float alpha, float beta1,
+                               float beta2, float epsilon)
+{
+    AdamOptimizerCPU adam(deltaGIn, mIn, vIn, t, alpha, beta1, beta2, epsilon);
+    transposeTiles(gIn, gOut, numInRows, numInCols, adam);
+}
+
+void rMaxPropCPU(float *m, float *upsilon, float *g,
+                 unsigned int numRows, unsigned int numCols,
+                 float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax)
+{
+    RMaxPropCPU rMaxProp(m, upsilon, updateTime, dt, tauRMS, r0, epsilon, wMin, wMax);
+    updateChunks(g, (size_t)numRows * numCols, rMaxProp);
+}
+
+void rMaxPropTransposeCPU(float *mIn, float *upsilonIn, float *gIn,
+                          float *gOut, unsigned int numInRows, unsigned int numInCols,
+                          float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax)
+{
+    RMaxPropCPU rMaxProp(mIn, upsilonIn, updateTime, dt, tauRMS, r0, epsilon, wMin, wMax);
+    transposeTiles(gIn, gOut, numInRows, numInCols, rMaxProp);
+}
+
+}   // namespace BatchLearning
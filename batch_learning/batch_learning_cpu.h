@@ -0,0 +1,46 @@
+#pragma once
+
+//----------------------------------------------------------------------------
+// BatchLearning
+//----------------------------------------------------------------------------
+//! Host equivalents of the functions in batch_learning.h which operate on host pointers.
+//! Matrices are processed in cache-sized tiles, parallelised across tiles with OpenMP
+//! and vectorised using the widest SIMD instruction set enabled when compiling
+namespace BatchLearning
+{
+//! Calculate transpose of matrix on CPU
+void transposeCPU(const float *in, float *out,
+                  unsigned int numInRows, unsigned int numInCols);
+
+//! Apply fixed rate learning to dense weights
+void fixedRateLearningCPU(float *deltaG, float *g,
+                          unsigned int numRows, unsigned int numCols,
+                          float learningRate);
+
+//! Apply fixed rate learning to dense weights and then transfer to transpose
+void fixedRateLearningTransposeCPU(float *deltaGIn, float *gIn, float *gOut,
+                                   unsigned int numInRows, unsigned int numInCols,
+                                   float learningRate);
+
+//! Apply Adam optimizer to dense weights
+void adamOptimizerCPU(float *deltaG, float *m, float *v, float *g,
+                      unsigned int numRows, unsigned int numCols, unsigned int t,
+                      float alpha = 0.001, float beta1 = 0.9, float beta2 = 0.999,
+                      float epsilon = 1E-8);
+
+//! Apply Adam optimizer to dense weights and then transfer to transpose
+void adamOptimizerTransposeCPU(float *deltaGIn, float *mIn, float *vIn, float *gIn,
+                               float *gOut, unsigned int numInRows, unsigned int numInCols,
+                               unsigned int t, float alpha = 0.001, float beta1 = 0.9,
+                               float beta2 = 0.999, float epsilon = 1E-8);
+
+//! Apply RMaxProp to dense weights
+void rMaxPropCPU(float *m, float *upsilon, float *g,
+                 unsigned int numRows, unsigned int numCols,
+                 float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax);
+
+//! Apply RMaxProp to dense weights and then transfer to transpose
+void rMaxPropTransposeCPU(float *mIn, float *upsilonIn, float *gIn,
+                          float *gOut, unsigned int numInRows, unsigned int numInCols,
+                          float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax);
+}
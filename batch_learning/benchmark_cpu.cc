@@ -0,0 +1,282 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+// Batch-learning includes
+#include "batch_learning_cpu.h"
+#include "deep_r_cpu.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+//----------------------------------------------------------------------------
+// State
+//----------------------------------------------------------------------------
+// Copy of all the arrays an optimiser operates on so naive and optimised versions can start from the same state
+struct State
+{
+    State(unsigned int numRows, unsigned int numCols, std::mt19937 &rng)
+    :   g(numRows * numCols), gOut(numRows * numCols), deltaG(numRows * numCols),
+        m(numRows * numCols), v(numRows * numCols)
+    {
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        std::generate(g.begin(), g.end(), [&dist, &rng](){ return dist(rng); });
+        std::generate(deltaG.begin(), deltaG.end(), [&dist, &rng](){ return dist(rng); });
+        std::generate(m.begin(), m.end(), [&dist, &rng](){ return dist(rng); });
+        std::generate(v.begin(), v.end(), [&dist, &rng](){ return std::fabs(dist(rng)); });
+    }
+
+    std::vector<float> g;
+    std::vector<float> gOut;
+    std::vector<float> deltaG;
+    std::vector<float> m;
+    std::vector<float> v;
+};
+
+//----------------------------------------------------------------------------
+// Naive reference implementations
+//----------------------------------------------------------------------------
+void transposeNaive(const float *in, float *out, unsigned int numInRows, unsigned int numInCols)
+{
+    for(unsigned int i = 0; i < numInRows; i++) {
+        for(unsigned int j = 0; j < numInCols; j++) {
+            out[(j * numInRows) + i] = in[(i * numInCols) + j];
+        }
+    }
+}
+
+void adamOptimizerTransposeNaive(float *deltaG, float *m, float *v, float *g, float *gOut,
+                                 unsigned int numInRows, unsigned int numInCols, unsigned int t,
+                                 float alpha = 0.001, float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1E-8)
+{
+    const float firstMomentScale = 1.0f / (1.0f - pow(beta1, t + 1));
+    const float secondMomentScale = 1.0f / (1.0f - pow(beta2, t + 1));
+    for(unsigned int i = 0; i < numInRows; i++) {
+        for(unsigned int j = 0; j < numInCols; j++) {
+            const unsigned int idx = (i * numInCols) + j;
+            const float gradient = deltaG[idx];
+            const float mT = (beta1 * m[idx]) + ((1.0f - beta1) * gradient);
+            const float vT = (beta2 * v[idx]) + ((1.0f - beta2) * gradient * gradient);
+            g[idx] -= (alpha * mT * firstMomentScale) / (std::sqrt(vT * secondMomentScale) + epsilon);
+            m[idx] = mT;
+            v[idx] = vT;
+            deltaG[idx] = 0.0f;
+            gOut[(j * numInRows) + i] = g[idx];
+        }
+    }
+}
+
+void rMaxPropTransposeNaive(float *m, float *upsilon, float *g, float *gOut,
+                            unsigned int numInRows, unsigned int numInCols,
+                            float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax)
+{
+    const float updateTimesteps = updateTime / dt;
+    const float expRMS = exp(-updateTime / tauRMS);
+    for(unsigned int i = 0; i < numInRows; i++) {
+        for(unsigned int j = 0; j < numInCols; j++) {
+            const unsigned int idx = (i * numInCols) + j;
+            const float gradient = m[idx] / updateTimesteps;
+            upsilon[idx] = std::max(upsilon[idx] * expRMS, gradient * gradient);
+            const float r = r0 / (std::sqrt(upsilon[idx]) + epsilon);
+            g[idx] = std::min(wMax, std::max(wMin, g[idx] + (r * gradient)));
+            m[idx] = 0.0f;
+            gOut[(j * numInRows) + i] = g[idx];
+        }
+    }
+}
+
+// Time the best of numRepeats runs, each starting from a copy of initial state
+double timeBest(const State &initial, State &final, unsigned int numRepeats, std::function<void(State&)> func)
+{
+    double best = std::numeric_limits<double>::max();
+    for(unsigned int r = 0; r < numRepeats; r++) {
+        final = initial;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        func(final);
+        const std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        best = std::min(best, duration.count());
+    }
+    return best;
+}
+
+bool compare(const State &a, const State &b)
+{
+    return (a.g == b.g && a.gOut == b.gOut && a.deltaG == b.deltaG && a.m == b.m && a.v == b.v);
+}
+
+bool report(const std::string &name, const State &initial, unsigned int numRepeats,
+            std::function<void(State&)> naive, std::function<void(State&)> optimised)
+{
+    State naiveFinal = initial;
+    State optimisedFinal = initial;
+    const double naiveTime = timeBest(initial, naiveFinal, numRepeats, naive);
+    const double optimisedTime = timeBest(initial, optimisedFinal, numRepeats, optimised);
+
+    std::cout << name << ":" << std::endl;
+    std::cout << "\tNaive:" << naiveTime * 1000.0 << "ms" << std::endl;
+    std::cout << "\tOptimised:" << optimisedTime * 1000.0 << "ms" << std::endl;
+    std::cout << "\tSpeedup:" << naiveTime / optimisedTime << "x" << std::endl;
+
+    if(!compare(naiveFinal, optimisedFinal)) {
+        std::cerr << name << ": naive and optimised results differ" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Run DeepRCPU on a small sparse matrix with large gradients, so many synapses change sign
+// and are made dormant each update, and check its data structures remain consistent
+bool checkDeepR()
+{
+    constexpr unsigned int numRows = 64;
+    constexpr unsigned int numCols = 100;
+    constexpr unsigned int maxRowLength = 40;
+    constexpr unsigned int numUpdates = 50;
+
+    // Build rows of random length with random, distinct postsynaptic indices
+    std::mt19937 rng(1234);
+    std::vector<unsigned int> rowLength(numRows);
+    std::vector<unsigned int> ind(numRows * maxRowLength);
+    std::vector<unsigned int> cols(numCols);
+    std::uniform_int_distribution<unsigned int> rowLengthDist(0, maxRowLength);
+    for(unsigned int i = 0; i < numRows; i++) {
+        std::iota(cols.begin(), cols.end(), 0);
+        std::shuffle(cols.begin(), cols.end(), rng);
+        rowLength[i] = rowLengthDist(rng);
+        std::copy_n(cols.cbegin(), rowLength[i], &ind[i * maxRowLength]);
+    }
+    const size_t numSynapses = std::accumulate(rowLength.cbegin(), rowLength.cend(), size_t{0});
+
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> deltaG(numRows * maxRowLength);
+    std::vector<float> m(numRows * maxRowLength, 0.0f);
+    std::vector<float> v(numRows * maxRowLength, 0.0f);
+    std::vector<float> g(numRows * maxRowLength);
+    std::vector<float> eFiltered(numRows * maxRowLength);
+    std::generate(g.begin(), g.end(), [&dist, &rng](){ return 0.001f * dist(rng); });
+
+    BatchLearning::DeepRCPU deepR(numRows, numCols, maxRowLength, rowLength.data(), ind.data(),
+                                  deltaG.data(), m.data(), v.data(), g.data(), eFiltered.data(), 0.9f, 0.999f, 1E-8f, 1234);
+
+    std::vector<unsigned int> oldInd(numRows * maxRowLength);
+    unsigned int numMoved = 0;
+    unsigned int numReactivated = 0;
+    for(unsigned int t = 0; t < numUpdates; t++) {
+        // Tag each synapse with its position in eFiltered - this is moved when rows are compacted and zeroed when synapses are reactivated
+        for(unsigned int i = 0; i < numRows; i++) {
+            for(unsigned int j = 0; j < rowLength[i]; j++) {
+                eFiltered[(i * maxRowLength) + j] = (float)(j + 1);
+            }
+        }
+        std::generate(deltaG.begin(), deltaG.end(), [&dist, &rng](){ return dist(rng); });
+        oldInd = ind;
+
+        deepR.update(t, 0.01f);
+
+        // Total number of connections is conserved
+        if(std::accumulate(rowLength.cbegin(), rowLength.cend(), size_t{0}) != numSynapses) {
+            std::cerr << "DeepR: number of synapses not conserved after update " << t << std::endl;
+            return false;
+        }
+
+        for(unsigned int i = 0; i < numRows; i++) {
+            const size_t rowStart = i * maxRowLength;
+            if(rowLength[i] > maxRowLength) {
+                std::cerr << "DeepR: row " << i << " longer than maximum after update " << t << std::endl;
+                return false;
+            }
+
+            // Surviving synapses keep their order at the start of the row and are followed by reactivated ones
+            unsigned int previousTag = 0;
+            bool reactivated = false;
+            for(unsigned int j = 0; j < rowLength[i]; j++) {
+                const unsigned int tag = (unsigned int)eFiltered[rowStart + j];
+                if(tag == 0) {
+                    reactivated = true;
+                    numReactivated++;
+                }
+                else if(reactivated || tag <= previousTag || oldInd[rowStart + tag - 1] != ind[rowStart + j]) {
+                    std::cerr << "DeepR: row " << i << " order not preserved after update " << t << std::endl;
+                    return false;
+                }
+                else {
+                    numMoved += (tag != (j + 1)) ? 1 : 0;
+                    previousTag = tag;
+                }
+            }
+
+            // Bitmask has exactly the bits of row's indices set, as well as the padding bits beyond numCols
+            std::vector<uint32_t> expected((numCols + 31) / 32, 0);
+            for(unsigned int j = 0; j < rowLength[i]; j++) {
+                expected[ind[rowStart + j] / 32] |= (1u << (ind[rowStart + j] % 32));
+            }
+            if((numCols % 32) != 0) {
+                expected.back() |= ~((1u << (numCols % 32)) - 1u);
+            }
+            if(!std::equal(expected.cbegin(), expected.cend(), deepR.getBitmaskRow(i))) {
+                std::cerr << "DeepR: bitmask of row " << i << " doesn't match indices after update " << t << std::endl;
+                return false;
+            }
+            std::vector<unsigned int> rowInd(&ind[rowStart], &ind[rowStart + rowLength[i]]);
+            std::sort(rowInd.begin(), rowInd.end());
+            if(std::adjacent_find(rowInd.cbegin(), rowInd.cend()) != rowInd.cend()) {
+                std::cerr << "DeepR: row " << i << " has duplicate indices after update " << t << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "DeepR: " << numSynapses << " synapses consistent over " << numUpdates << " updates, "
+              << numReactivated << " reactivated, " << numMoved << " moved by compaction" << std::endl;
+
+    // Check was meaningful
+    return (numReactivated > 0 && numMoved > 0);
+}
+}
+
+// Compares the host batch-learning kernels with naive loops on a randomly-initialised matrix
+int main(int argc, char *argv[])
+{
+    const unsigned int numRows = (argc > 1) ? std::stoul(argv[1]) : 2000;
+    const unsigned int numCols = (argc > 2) ? std::stoul(argv[2]) : 3000;
+    const unsigned int numRepeats = (argc > 3) ? std::stoul(argv[3]) : 5;
+
+    std::mt19937 rng;
+    const State initial(numRows, numCols, rng);
+
+    bool correct = report("Transpose", initial, numRepeats,
+        [=](State &s){ transposeNaive(s.g.data(), s.gOut.data(), numRows, numCols); },
+        [=](State &s){ BatchLearning::transposeCPU(s.g.data(), s.gOut.data(), numRows, numCols); });
+
+    correct &= report("Adam transpose", initial, numRepeats,
+        [=](State &s){ adamOptimizerTransposeNaive(s.deltaG.data(), s.m.data(), s.v.data(), s.g.data(), s.gOut.data(),
+                                                   numRows, numCols, 10); },
+        [=](State &s){ BatchLearning::adamOptimizerTransposeCPU(s.deltaG.data(), s.m.data(), s.v.data(), s.g.data(), s.gOut.data(),
+                                                                numRows, numCols, 10); });
+
+    // **NOTE** RMaxProp's M and Upsilon are stored in m and v
+    correct &= report("RMaxProp transpose", initial, numRepeats,
+        [=](State &s){ rMaxPropTransposeNaive(s.m.data(), s.v.data(), s.g.data(), s.gOut.data(), numRows, numCols,
+                                              1000.0f, 0.1f, 10000.0f, 0.001f, 1E-8f, -10.0f, 10.0f); },
+        [=](State &s){ BatchLearning::rMaxPropTransposeCPU(s.m.data(), s.v.data(), s.g.data(), s.gOut.data(), numRows, numCols,
+                                                           1000.0f, 0.1f, 10000.0f, 0.001f, 1E-8f, -10.0f, 10.0f); });
+
+    correct &= checkDeepR();
+
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Standard C++ includes
+#include <chrono>
+
+//----------------------------------------------------------------------------
+// CPUTimer
+//----------------------------------------------------------------------------
+//! Host equivalent of CUDATimer - time between start and stop is only
+//! added to the total when update is called, mirroring the CUDA event API
+class CPUTimer
+{
+public:
+    CPUTimer() : m_TotalTime(0.0f)
+    {
+    }
+
+    void start()
+    {
+        m_Start = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop()
+    {
+        m_Stop = std::chrono::high_resolution_clock::now();
+    }
+
+    void synchronize()
+    {
+    }
+
+    void update()
+    {
+        m_TotalTime += std::chrono::duration<float>(m_Stop - m_Start).count();
+        m_Start = m_Stop;
+    }
+
+    float getTotalTime() const{ return m_TotalTime; }
+
+private:
+    std::chrono::high_resolution_clock::time_point m_Start;
+    std::chrono::high_resolution_clock::time_point m_Stop;
+
+    float m_TotalTime;
+};
@@ -0,0 +1,264 @@
+#include "deep_r_cpu.h"
+
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+// Standard C includes
+#include <cassert>
+#include <cmath>
+
+// Batch-learning includes
+#include "optimisers_cpu.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// Postsynaptic index used to mark synapses made dormant during first pass until row is compacted
+constexpr unsigned int DORMANT_IND = 0xFFFFFFFF;
+
+// SplitMix64 generator - a single 64-bit word of state per row is cheap
+// enough to keep a fully independent stream for every row of the matrix
+uint64_t nextRandom(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniformly distributed integer in [0, n)
+unsigned int uniformInt(uint64_t &state, unsigned int n)
+{
+    return (unsigned int)(((nextRandom(state) >> 32) * n) >> 32);
+}
+
+// Uniformly distributed float in [0, 1)
+float uniformFloat(uint64_t &state)
+{
+    return (float)(nextRandom(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+// Find the index of the nth zero bit in a bitmask row by counting
+// the clear bits in each word, then stripping set bits of the word
+unsigned int findNthClearBit(const uint32_t *bitmaskRow, unsigned int numWords, unsigned int n)
+{
+    for(unsigned int w = 0; w < numWords; w++) {
+        uint32_t clear = ~bitmaskRow[w];
+        const unsigned int numClear = __builtin_popcount(clear);
+        if(n < numClear) {
+            for(; n > 0; n--) {
+                clear &= (clear - 1);
+            }
+            return (w * 32) + __builtin_ctz(clear);
+        }
+        n -= numClear;
+    }
+    assert(false);
+    return 0;
+}
+}   // Anonymous namespace
+
+//----------------------------------------------------------------------------
+// BatchLearning::DeepRCPU
+//----------------------------------------------------------------------------
+namespace BatchLearning
+{
+DeepRCPU::DeepRCPU(unsigned int numRows, unsigned int numCols, unsigned int maxRowLength,
+                   unsigned int *rowLength, unsigned int *ind,
+                   float *deltaG, float *m, float *v, float *g, float *eFiltered,
+                   float beta1, float beta2, float epsilon, unsigned int seed)
+    : m_NumRows(numRows), m_NumCols(numCols), m_MaxRowLength(maxRowLength),
+    m_BitmaskRowWords((m_NumCols + 31) / 32), m_RowLength(rowLength), m_Ind(ind),
+    m_DeltaG(deltaG), m_M(m), m_V(v), m_G(g), m_EFiltered(eFiltered),
+    m_Bitmask(m_BitmaskRowWords * m_NumRows, 0), m_NumActivations(m_NumRows), m_RowRNG(m_NumRows),
+    m_Beta1(beta1), m_Beta2(beta2), m_Epsilon(epsilon), m_HostUpdateTime(0.0)
+{
+    // If no seed is passed
+    uint64_t rowSeed;
+    if(seed == 0) {
+        std::random_device seedSource;
+
+        // Initialize row seed using seed source
+        rowSeed = ((uint64_t)seedSource() << 32) | seedSource();
+
+        // Generate random state for host RNG from seed source
+        uint32_t seedData[std::mt19937::state_size];
+        for(size_t i = 0; i < std::mt19937::state_size; i++) {
+            seedData[i] = seedSource();
+        }
+
+        // Convert into seed sequence
+        std::seed_seq seeds(std::begin(seedData), std::end(seedData));
+        m_RNG.seed(seeds);
+    }
+    // Otherwise
+    else {
+        // Use seed to create seed sequence for host RNG
+        std::seed_seq seeds{seed};
+        m_RNG.seed(seeds);
+
+        // Use seed directly for row RNGs
+        rowSeed = seed;
+    }
+
+    // Bits beyond the end of each row which should always be set
+    const uint32_t paddingMask = ((m_NumCols % 32) == 0) ? 0 : ~((1u << (m_NumCols % 32)) - 1u);
+
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < (int)m_NumRows; i++) {
+        // Set bits for existing synapses and padding
+        uint32_t *bitmaskRow = &m_Bitmask[m_BitmaskRowWords * i];
+        const unsigned int *indRow = &m_Ind[m_MaxRowLength * i];
+        for(unsigned int j = 0; j < m_RowLength[i]; j++) {
+            bitmaskRow[indRow[j] / 32] |= (1u << (indRow[j] % 32));
+        }
+        bitmaskRow[m_BitmaskRowWords - 1] |= paddingMask;
+
+        // Initialise row RNG by hashing seed and row index
+        uint64_t state = rowSeed ^ ((uint64_t)i * 0xD1B54A32D192ED03ull);
+        m_RowRNG[i] = nextRandom(state);
+    }
+}
+//----------------------------------------------------------------------------
+void DeepRCPU::update(unsigned int t, float alpha)
+{
+    // Create optimizer
+    AdamOptimizerCPU adam(m_DeltaG, m_M, m_V, t, alpha, m_Beta1, m_Beta2, m_Epsilon);
+
+    // First pass - apply optimizer and make synapses whose weights change sign dormant
+    unsigned int numDormant = 0;
+    m_FirstPassKernelTimer.start();
+    #pragma omp parallel for schedule(dynamic, 32) firstprivate(adam) reduction(+:numDormant)
+    for(int i = 0; i < (int)m_NumRows; i++) {
+        uint32_t *bitmaskRow = &m_Bitmask[m_BitmaskRowWords * i];
+        const size_t rowStartIdx = (size_t)i * m_MaxRowLength;
+        const unsigned int rowLength = m_RowLength[i];
+
+        // Loop through synapses
+        unsigned int numRowDormant = 0;
+        for(unsigned int j = 0; j < rowLength; j++) {
+            const size_t idx = rowStartIdx + j;
+
+            // Cache parameter and its sign
+            SIMD::Scalar gIn = SIMD::Scalar::load(&m_G[idx]);
+            const bool oldSign = std::signbit(gIn.v);
+
+            // If update changes parameter
+            if(adam.updateParameters(gIn, idx)) {
+                // If sign hasn't changed, update weight in memory
+                if(std::signbit(gIn.v) == oldSign) {
+                    gIn.store(&m_G[idx]);
+                }
+                // Otherwise, clear bit in bitmask and mark synapse as dormant
+                else {
+                    const unsigned int ind = m_Ind[idx];
+                    bitmaskRow[ind / 32] &= ~(1u << (ind % 32));
+                    m_Ind[idx] = DORMANT_IND;
+                    numRowDormant++;
+                }
+            }
+        }
+
+        // If any synapses became dormant, compact row in place
+        if(numRowDormant > 0) {
+            unsigned int k = 0;
+            for(unsigned int j = 0; j < rowLength; j++) {
+                const size_t idx = rowStartIdx + j;
+                if(m_Ind[idx] != DORMANT_IND) {
+                    if(k != j) {
+                        const size_t dstIdx = rowStartIdx + k;
+                        m_Ind[dstIdx] = m_Ind[idx];
+                        m_G[dstIdx] = m_G[idx];
+                        m_EFiltered[dstIdx] = m_EFiltered[idx];
+
+                        // Instruct operation to do the same for any of its parameters
+                        adam.moveParams(idx, dstIdx);
+                    }
+                    k++;
+                }
+            }
+            m_RowLength[i] = k;
+            numDormant += numRowDormant;
+        }
+    }
+    m_FirstPassKernelTimer.stop();
+
+    {
+        const auto hostStart = std::chrono::high_resolution_clock::now();
+
+        // Count number of synapses
+        const size_t numSynapses = std::accumulate(&m_RowLength[0], &m_RowLength[m_NumRows], size_t{0});
+
+        // From this, calculate how many padding synapses there are in data structure
+        size_t numTotalPaddingSynapses = ((size_t)m_MaxRowLength * m_NumRows) - numSynapses;
+
+        // Loop through rows of synaptic matrix
+        for(unsigned int i = 0; i < (m_NumRows - 1); i++) {
+            const unsigned int numRowPaddingSynapses = m_MaxRowLength - m_RowLength[i];
+            const double probability = (double)numRowPaddingSynapses / (double)numTotalPaddingSynapses;
+
+            // Create distribution to sample number of activations
+            std::binomial_distribution<unsigned int> numActivationDist(numDormant, probability);
+
+            // Sample number of activations
+            const unsigned int numActivations = std::min(numRowPaddingSynapses, numActivationDist(m_RNG));
+            m_NumActivations[i] = numActivations;
+
+            // Update counters
+            numDormant -= numActivations;
+            numTotalPaddingSynapses -= numRowPaddingSynapses;
+        }
+
+        // Put remainder of activations in last row
+        assert(numDormant <= (m_MaxRowLength - m_RowLength[m_NumRows - 1]));
+        m_NumActivations[m_NumRows - 1] = numDormant;
+
+        m_HostUpdateTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - hostStart).count();
+    }
+
+    // Second pass - distribute reactivations by picking uniformly from the clear bits of each row's bitmask
+    m_SecondPassKernelTimer.start();
+    #pragma omp parallel for schedule(dynamic, 32) firstprivate(adam)
+    for(int i = 0; i < (int)m_NumRows; i++) {
+        uint32_t *bitmaskRow = &m_Bitmask[m_BitmaskRowWords * i];
+        const size_t rowStartIdx = (size_t)i * m_MaxRowLength;
+
+        // Copy RNG state to local
+        uint64_t rng = m_RowRNG[i];
+
+        // Loop through activations we need to distribute across this row
+        const unsigned int numActivations = m_NumActivations[i];
+        unsigned int rowLength = m_RowLength[i];
+        assert((rowLength + numActivations) <= m_NumCols);
+        for(unsigned int a = 0; a < numActivations; a++) {
+            // Pick a random inactive synapse and set its bit
+            const unsigned int j = findNthClearBit(bitmaskRow, m_BitmaskRowWords, uniformInt(rng, m_NumCols - rowLength));
+            bitmaskRow[j / 32] |= (1u << (j % 32));
+
+            // Set postsynaptic index and zero eligibility trace
+            const size_t idx = rowStartIdx + rowLength;
+            m_Ind[idx] = j;
+            m_EFiltered[idx] = 0.0f;
+
+            // Initialise weight
+            // **NOTE** matches the small non-zero weights used by the CUDA implementation
+            m_G[idx] = (uniformFloat(rng) < 0.2f) ? -0.000000001f : 0.0000000001f;
+
+            // Instruct operation to initialise any of its parameters
+            adam.initSynapse(idx);
+
+            // Increment row length
+            rowLength++;
+        }
+
+        // Write back row length and RNG state
+        m_RowLength[i] = rowLength;
+        m_RowRNG[i] = rng;
+    }
+    m_SecondPassKernelTimer.stop();
+}
+}   // namespace BatchLearning
@@ -0,0 +1,91 @@
+#pragma once
+
+// Standard C++ includes
+#include <random>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+
+// Batch-learning includes
+#include "cpu_timer.h"
+
+//----------------------------------------------------------------------------
+// BatchLearning::DeepRCPU
+//----------------------------------------------------------------------------
+//! Host implementation of DeepR which operates on host copies of GeNN's sparse
+//! connectivity and synapse variables (i.e. those used by GeNN's CPU backend)
+namespace BatchLearning
+{
+class DeepRCPU
+{
+public:
+    DeepRCPU(unsigned int numRows, unsigned int numCols, unsigned int maxRowLength,
+             unsigned int *rowLength, unsigned int *ind,
+             float *deltaG, float *m, float *v, float *g, float *eFiltered,
+             float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1E-8, unsigned int seed = 0);
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    void update(unsigned int t, float alpha = 0.001);
+
+    void updateTimers()
+    {
+        m_FirstPassKernelTimer.update();
+        m_SecondPassKernelTimer.update();
+    }
+
+    float getFirstPassKernelTime() const { return m_FirstPassKernelTimer.getTotalTime(); }
+    float getSecondPassKernelTime() const { return m_SecondPassKernelTimer.getTotalTime(); }
+    double getHostUpdateTime() const { return m_HostUpdateTime; }
+
+    //! Get row of bitmask, e.g. to check it agrees with sparse connectivity
+    const uint32_t *getBitmaskRow(unsigned int i) const { return &m_Bitmask[m_BitmaskRowWords * i]; }
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    // Dimensions of matrix
+    const unsigned int m_NumRows;
+    const unsigned int m_NumCols;
+    const unsigned int m_MaxRowLength;
+    const unsigned int m_BitmaskRowWords;
+
+    // GeNN-allocated sparse connectivity
+    unsigned int *m_RowLength;
+    unsigned int *m_Ind;
+
+    // GeNN-allocated synapse variables
+    float *m_DeltaG;
+    float *m_M;
+    float *m_V;
+    float *m_G;
+    float *m_EFiltered;
+
+    // Additional bitmask data structure used for Deep-R update
+    // **NOTE** bits beyond numCols in the last word of each row are always set
+    std::vector<uint32_t> m_Bitmask;
+
+    // Number of new activations to make for each row
+    std::vector<unsigned int> m_NumActivations;
+
+    // Per-row RNG state used for distributing re-activated synapses
+    // **NOTE** streams are independent of how rows are divided between threads
+    std::vector<uint64_t> m_RowRNG;
+
+    // Adam optimizer parameters
+    const float m_Beta1;
+    const float m_Beta2;
+    const float m_Epsilon;
+
+    // RNG for distributing reactivations
+    std::mt19937 m_RNG;
+
+    // Timers for two passes
+    CPUTimer m_FirstPassKernelTimer;
+    CPUTimer m_SecondPassKernelTimer;
+    double m_HostUpdateTime;
+};
+}   // namespace BatchLearning
@@ -83,7 +83,7 @@ public:
     {
         m_Gradients[dstIdx] = m_Gradients[srcIdx];
         m_M[dstIdx] = m_M[srcIdx];
-        m_V[dstIdx] = m_M[srcIdx];
+        m_V[dstIdx] = m_V[srcIdx];
     }
 
     __forceinline__ __device__ void initSynapse(unsigned int idx)
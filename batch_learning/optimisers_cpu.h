@@ -0,0 +1,171 @@
+#pragma once
+
+// Standard C++ includes
+#include <cmath>
+
+// Standard C includes
+#include <cstddef>
+
+// Batch-learning includes
+#include "simd_cpu.h"
+
+//----------------------------------------------------------------------------
+// FixedLearningRateCPU
+//----------------------------------------------------------------------------
+//! Host equivalent of FixedLearningRate. updateParameters is templated on the
+//! SIMD vector type so it can update V::width contiguous parameters at once
+class FixedLearningRateCPU
+{
+public:
+    FixedLearningRateCPU(float *gradients, float learningRate)
+    :   m_Gradients(gradients), m_LearningRate(learningRate)
+    {
+    }
+
+    template<typename V>
+    bool updateParameters(V &param, size_t idx)
+    {
+        // Subtract gradient to parameter, scaled by learning rate
+        param = param - (V::load(&m_Gradients[idx]) * V::set(m_LearningRate));
+
+        // Zero gradient
+        V::set(0.0f).store(&m_Gradients[idx]);
+        return true;
+    }
+
+    void moveParams(size_t srcIdx, size_t dstIdx)
+    {
+        m_Gradients[dstIdx] = m_Gradients[srcIdx];
+    }
+
+    void initSynapse(size_t idx)
+    {
+        m_Gradients[idx] = 0.0f;
+    }
+
+private:
+    float *m_Gradients;
+    const float m_LearningRate;
+};
+
+//----------------------------------------------------------------------------
+// AdamOptimizerCPU
+//----------------------------------------------------------------------------
+//! Host equivalent of AdamOptimizer
+class AdamOptimizerCPU
+{
+public:
+    AdamOptimizerCPU(float *gradients, float *m, float *v, unsigned int t, float alpha = 0.001,
+                     float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1E-8)
+    :   m_Gradients(gradients), m_M(m), m_V(v), m_Alpha(alpha),
+        m_Beta1(beta1), m_Beta2(beta2), m_Epsilon(epsilon),
+        m_FirstMomentScale(1.0f / (1.0f - pow(m_Beta1, t + 1))),
+        m_SecondMomentScale(1.0f / (1.0f - pow(m_Beta2, t + 1)))
+    {
+    }
+
+    template<typename V>
+    bool updateParameters(V &param, size_t idx)
+    {
+        // Get gradients
+        const V gradient = V::load(&m_Gradients[idx]);
+
+        // Update biased first moment estimate
+        const V mT = (V::set(m_Beta1) * V::load(&m_M[idx])) + (V::set(1.0f - m_Beta1) * gradient);
+
+        // Update biased second moment estimate
+        const V vT = (V::set(m_Beta2) * V::load(&m_V[idx])) + (V::set(1.0f - m_Beta2) * gradient * gradient);
+
+        // Add gradient to parameter, scaled by learning rate
+        param = param - ((V::set(m_Alpha) * mT * V::set(m_FirstMomentScale))
+                         / (sqrt(vT * V::set(m_SecondMomentScale)) + V::set(m_Epsilon)));
+
+        // Write moments back to memory
+        mT.store(&m_M[idx]);
+        vT.store(&m_V[idx]);
+
+        // Zero gradient
+        V::set(0.0f).store(&m_Gradients[idx]);
+        return true;
+    }
+
+    void moveParams(size_t srcIdx, size_t dstIdx)
+    {
+        m_Gradients[dstIdx] = m_Gradients[srcIdx];
+        m_M[dstIdx] = m_M[srcIdx];
+        m_V[dstIdx] = m_V[srcIdx];
+    }
+
+    void initSynapse(size_t idx)
+    {
+        m_Gradients[idx] = 0.0f;
+        m_M[idx] = 0.0f;
+        m_V[idx] = 0.0f;
+    }
+
+private:
+    float *m_Gradients;
+    float *m_M;
+    float *m_V;
+    const float m_Alpha;
+    const float m_Beta1;
+    const float m_Beta2;
+    const float m_Epsilon;
+    const float m_FirstMomentScale;
+    const float m_SecondMomentScale;
+};
+
+//----------------------------------------------------------------------------
+// RMaxPropCPU
+//----------------------------------------------------------------------------
+//! Host equivalent of RMaxProp
+class RMaxPropCPU
+{
+public:
+    RMaxPropCPU(float *m, float *upsilon,
+                float updateTime, float dt, float tauRMS, float r0, float epsilon, float wMin, float wMax)
+    :   m_M(m), m_Upsilon(upsilon), m_UpdateTimesteps(updateTime / dt), m_ExpRMS(exp(-updateTime / tauRMS)),
+        m_R0(r0), m_Epsilon(epsilon), m_WMin(wMin), m_WMax(wMax)
+    {
+    }
+
+    template<typename V>
+    bool updateParameters(V &param, size_t idx)
+    {
+        // Get gradients
+        const V gradient = V::load(&m_M[idx]) / V::set(m_UpdateTimesteps);
+
+        // Calculate learning rate r
+        const V upsilon = max(V::load(&m_Upsilon[idx]) * V::set(m_ExpRMS), gradient * gradient);
+        upsilon.store(&m_Upsilon[idx]);
+        const V r = V::set(m_R0) / (sqrt(upsilon) + V::set(m_Epsilon));
+
+        // Update synaptic parameter
+        param = min(V::set(m_WMax), max(V::set(m_WMin), param + (r * gradient)));
+        V::set(0.0f).store(&m_M[idx]);
+        return true;
+    }
+
+    void moveParams(size_t srcIdx, size_t dstIdx)
+    {
+        m_M[dstIdx] = m_M[srcIdx];
+        m_Upsilon[dstIdx] = m_Upsilon[srcIdx];
+    }
+
+    void initSynapse(size_t idx)
+    {
+        m_M[idx] = 0.0f;
+        m_Upsilon[idx] = 0.0f;
+    }
+
+private:
+    float *m_M;
+    float *m_Upsilon;
+
+    const float m_UpdateTimesteps;
+    const float m_ExpRMS;
+    const float m_R0;
+    const float m_Epsilon;
+    const float m_WMin;
+    const float m_WMax;
+};
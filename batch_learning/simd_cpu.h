@@ -0,0 +1,97 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <cmath>
+
+// Standard C includes
+#include <cstddef>
+
+// x86 intrinsics
+#if defined(__AVX512F__) || defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------
+// SIMD
+//----------------------------------------------------------------------------
+//! Minimal wrappers around vectors of floats so CPU optimisers can be written once and
+//! instantiated for the widest instruction set enabled at compile time (e.g. with
+//! -march=native) as well as for scalars, which are used for the tails of rows.
+//! **NOTE** only IEEE-exact operations are wrapped (no FMA or reciprocal approximations)
+//! so vectorised and scalar code paths produce bitwise-identical results
+namespace SIMD
+{
+//----------------------------------------------------------------------------
+// SIMD::Scalar
+//----------------------------------------------------------------------------
+struct Scalar
+{
+    static constexpr size_t width = 1;
+
+    static Scalar load(const float *ptr){ return Scalar{*ptr}; }
+    static Scalar set(float v){ return Scalar{v}; }
+    void store(float *ptr) const{ *ptr = v; }
+
+    friend Scalar operator + (Scalar a, Scalar b){ return Scalar{a.v + b.v}; }
+    friend Scalar operator - (Scalar a, Scalar b){ return Scalar{a.v - b.v}; }
+    friend Scalar operator * (Scalar a, Scalar b){ return Scalar{a.v * b.v}; }
+    friend Scalar operator / (Scalar a, Scalar b){ return Scalar{a.v / b.v}; }
+    friend Scalar sqrt(Scalar a){ return Scalar{std::sqrt(a.v)}; }
+    friend Scalar max(Scalar a, Scalar b){ return Scalar{std::max(a.v, b.v)}; }
+    friend Scalar min(Scalar a, Scalar b){ return Scalar{std::min(a.v, b.v)}; }
+
+    float v;
+};
+
+#if defined(__AVX512F__)
+//----------------------------------------------------------------------------
+// SIMD::AVX512
+//----------------------------------------------------------------------------
+struct AVX512
+{
+    static constexpr size_t width = 16;
+
+    static AVX512 load(const float *ptr){ return AVX512{_mm512_loadu_ps(ptr)}; }
+    static AVX512 set(float v){ return AVX512{_mm512_set1_ps(v)}; }
+    void store(float *ptr) const{ _mm512_storeu_ps(ptr, v); }
+
+    friend AVX512 operator + (AVX512 a, AVX512 b){ return AVX512{_mm512_add_ps(a.v, b.v)}; }
+    friend AVX512 operator - (AVX512 a, AVX512 b){ return AVX512{_mm512_sub_ps(a.v, b.v)}; }
+    friend AVX512 operator * (AVX512 a, AVX512 b){ return AVX512{_mm512_mul_ps(a.v, b.v)}; }
+    friend AVX512 operator / (AVX512 a, AVX512 b){ return AVX512{_mm512_div_ps(a.v, b.v)}; }
+    // **NOTE** the unmasked versions of these trigger spurious -Wmaybe-uninitialized warnings in some GCC versions
+    friend AVX512 sqrt(AVX512 a){ return AVX512{_mm512_mask_sqrt_ps(a.v, 0xFFFF, a.v)}; }
+    friend AVX512 max(AVX512 a, AVX512 b){ return AVX512{_mm512_mask_max_ps(a.v, 0xFFFF, a.v, b.v)}; }
+    friend AVX512 min(AVX512 a, AVX512 b){ return AVX512{_mm512_mask_min_ps(a.v, 0xFFFF, a.v, b.v)}; }
+
+    __m512 v;
+};
+typedef AVX512 Native;
+#elif defined(__AVX2__)
+//----------------------------------------------------------------------------
+// SIMD::AVX2
+//----------------------------------------------------------------------------
+struct AVX2
+{
+    static constexpr size_t width = 8;
+
+    static AVX2 load(const float *ptr){ return AVX2{_mm256_loadu_ps(ptr)}; }
+    static AVX2 set(float v){ return AVX2{_mm256_set1_ps(v)}; }
+    void store(float *ptr) const{ _mm256_storeu_ps(ptr, v); }
+
+    friend AVX2 operator + (AVX2 a, AVX2 b){ return AVX2{_mm256_add_ps(a.v, b.v)}; }
+    friend AVX2 operator - (AVX2 a, AVX2 b){ return AVX2{_mm256_sub_ps(a.v, b.v)}; }
+    friend AVX2 operator * (AVX2 a, AVX2 b){ return AVX2{_mm256_mul_ps(a.v, b.v)}; }
+    friend AVX2 operator / (AVX2 a, AVX2 b){ return AVX2{_mm256_div_ps(a.v, b.v)}; }
+    friend AVX2 sqrt(AVX2 a){ return AVX2{_mm256_sqrt_ps(a.v)}; }
+    friend AVX2 max(AVX2 a, AVX2 b){ return AVX2{_mm256_max_ps(a.v, b.v)}; }
+    friend AVX2 min(AVX2 a, AVX2 b){ return AVX2{_mm256_min_ps(a.v, b.v)}; }
+
+    __m256 v;
+};
+typedef AVX2 Native;
+#else
+typedef Scalar Native;
+#endif
+}   // namespace SIMD
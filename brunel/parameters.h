@@ -21,6 +21,9 @@ namespace Parameters
 
     const unsigned int numTimesteps = 10000;
 
+    // Number of timesteps of spikes recorded on device before being drained to disk
+    const unsigned int recordingWindowTimesteps = 1000;
+
     // connection probability
     const double probabilityConnection = 0.1;
 
@@ -1,19 +1,20 @@
-import csv
 import matplotlib.pyplot as plt
 import numpy as np
+import sys
+from os import path
+
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "common"))
+from binary_spikes import read_binary_spikes
 
 DURATION = 1000.0
 NUM_NEURONS = 10000
 NUM_EXCITATORY = int(round((NUM_NEURONS * 4.0) / 5.0))
 NUM_INHIBITORY = NUM_NEURONS - NUM_EXCITATORY
 
-# Read CSV spikes
-spikes_e = np.loadtxt("spikes_e.csv", delimiter=",", skiprows=1,
-                      dtype={"names": ("time", "neuron_id"),
-                             "formats": (np.float, np.int)})
-spikes_i = np.loadtxt("spikes_i.csv", delimiter=",", skiprows=1,
-                      dtype={"names": ("time", "neuron_id"),
-                             "formats": (np.float, np.int)})
+# Read binary spikes
+spike_dtype = {"names": ("time", "neuron_id"), "formats": (float, int)}
+spikes_e = np.rec.fromarrays(read_binary_spikes("spikes_e.bin"), dtype=spike_dtype)
+spikes_i = np.rec.fromarrays(read_binary_spikes("spikes_i.bin"), dtype=spike_dtype)
 
 num_spikes = len(spikes_e) + len(spikes_i)
 print("%u spike (%f%%)" % (num_spikes, (100.0 * float(num_spikes)) / float(DURATION * 10.0 * NUM_NEURONS)))
@@ -4,7 +4,9 @@
 
 // GeNN robotics includes
 #include "timer.h"
-#include "spikeRecorder.h"
+
+// GeNN examples includes
+#include "../common/spike_recording_drain.h"
 
 // Model parameters
 #include "parameters.h"
@@ -17,25 +19,30 @@ int main()
     try
     {
         allocateMem();
-        allocateRecordingBuffers(Parameters::numTimesteps);
+        allocateRecordingBuffers(Parameters::recordingWindowTimesteps);
         initialize();
         initializeSparse();
 
+        BinarySpikeWriter spikeWriter;
         {
+            // Write each window of spikes while the next is simulated
+            SpikeRecordingDrain spikeDrain(spikeWriter, Parameters::recordingWindowTimesteps, Parameters::timestep,
+                                           pullRecordingBuffersFromDevice);
+            spikeDrain.addPopulation("spikes_e.bin", recordSpkE, Parameters::numExcitatory);
+            spikeDrain.addPopulation("spikes_i.bin", recordSpkI, Parameters::numInhibitory);
+
             Timer a("Simulation wall clock:");
             while(iT < Parameters::numTimesteps) {
                 stepTime();
+                spikeDrain.update(iT);
             }
+            spikeDrain.finish(iT);
+            std::cout << "Waiting for recording drain:" << spikeDrain.getWaitTime() << std::endl;
         }
         
         {
-            Timer a("Downloading spikes:");
-            pullRecordingBuffersFromDevice();
-            
-            writeTextSpikeRecording("spikes_e.csv", recordSpkE, Parameters::numExcitatory, 
-                                    Parameters::numTimesteps, Parameters::timestep, ",", true);
-            writeTextSpikeRecording("spikes_i.csv", recordSpkE, Parameters::numInhibitory, 
-                                    Parameters::numTimesteps, Parameters::timestep, ",", true);
+            Timer a("Writing spikes:");
+            spikeWriter.flush();
         }
      
         std::cout << "Init:" << initTime << std::endl;
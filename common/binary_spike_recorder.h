@@ -0,0 +1,446 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+// BinarySpikes
+//----------------------------------------------------------------------------
+//! Binary spike recording format. Files consist of a Header followed by either:
+//! - Bitfield: numBlocks blocks, each consisting of a BlockHeader followed by
+//!   numTimesteps * ceil(numNeurons / 32) words in the layout of GeNN's spike
+//!   recording buffers. Blocks needn't be contiguous in time.
+//! - Pairs: numSpikes (timestep, neuron ID) pairs of 32-bit words
+//! The format is read by BinarySpikes::read and common/binary_spikes.py
+namespace BinarySpikes
+{
+//! "GSPK" in little-endian byte order
+constexpr uint32_t magic = 0x4B505347;
+constexpr uint32_t version = 1;
+
+enum class Format : uint32_t
+{
+    Bitfield,
+    Pairs,
+};
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    Format format;
+    uint32_t numNeurons;
+    double dt;
+    uint64_t numBlocks;
+    uint64_t numTimesteps;
+    uint64_t numSpikes;
+};
+static_assert(sizeof(Header) == 48, "Unexpected padding in BinarySpikes::Header");
+
+struct BlockHeader
+{
+    uint64_t startTimestep;
+    uint64_t numTimesteps;
+};
+static_assert(sizeof(BlockHeader) == 16, "Unexpected padding in BinarySpikes::BlockHeader");
+
+inline unsigned int getNumWords(unsigned int numNeurons)
+{
+    return (numNeurons + 31) / 32;
+}
+
+//! Read spikes from binary file in either format into parallel time and ID vectors
+inline void read(const std::string &filename, std::vector<double> &times, std::vector<unsigned int> &ids)
+{
+    std::ifstream file(filename, std::ifstream::binary);
+    if(!file.good()) {
+        throw std::runtime_error(filename + " could not be opened for reading");
+    }
+
+    Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+    if(!file.good() || header.magic != magic || header.version != version) {
+        throw std::runtime_error(filename + " is not a version " + std::to_string(version) + " binary spike file");
+    }
+
+    times.clear();
+    ids.clear();
+    if(header.format == Format::Bitfield) {
+        const unsigned int numWords = getNumWords(header.numNeurons);
+        std::vector<uint32_t> words(numWords);
+        for(uint64_t b = 0; b < header.numBlocks; b++) {
+            BlockHeader block;
+            file.read(reinterpret_cast<char*>(&block), sizeof(BlockHeader));
+            for(uint64_t t = 0; t < block.numTimesteps; t++) {
+                file.read(reinterpret_cast<char*>(words.data()), sizeof(uint32_t) * numWords);
+                const double time = (double)(block.startTimestep + t) * header.dt;
+                for(unsigned int w = 0; w < numWords; w++) {
+                    uint32_t word = words[w];
+                    while(word != 0) {
+                        const unsigned int bit = __builtin_ctz(word);
+                        times.push_back(time);
+                        ids.push_back((w * 32) + bit);
+                        word &= (word - 1);
+                    }
+                }
+            }
+        }
+    }
+    else {
+        std::vector<uint32_t> pairs(2 * header.numSpikes);
+        file.read(reinterpret_cast<char*>(pairs.data()), sizeof(uint32_t) * pairs.size());
+        times.reserve(header.numSpikes);
+        ids.reserve(header.numSpikes);
+        for(uint64_t s = 0; s < header.numSpikes; s++) {
+            times.push_back((double)pairs[2 * s] * header.dt);
+            ids.push_back(pairs[(2 * s) + 1]);
+        }
+    }
+
+    if(!file.good()) {
+        throw std::runtime_error(filename + " is truncated");
+    }
+}
+}   // namespace BinarySpikes
+
+//----------------------------------------------------------------------------
+// BinarySpikeWriter
+//----------------------------------------------------------------------------
+//! Writes binary spike files on a background thread so the simulation can keep
+//! stepping. Data is either copied when queued, so recording buffers can be
+//! reused immediately, or written in place and a callback invoked once it has
+//! been written. If more than maxQueuedBytes are waiting, queuing blocks
+class BinarySpikeWriter
+{
+public:
+    BinarySpikeWriter(size_t maxQueuedBytes = 256 * 1024 * 1024)
+        : m_MaxQueuedBytes(maxQueuedBytes), m_QueuedBytes(0), m_Quit(false), m_Busy(false), m_Thread(&BinarySpikeWriter::writeThread, this)
+    {
+    }
+
+    ~BinarySpikeWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_Quit = true;
+        }
+        m_QueueNotEmpty.notify_one();
+        m_Thread.join();
+    }
+
+    //------------------------------------------------------------------------
+    // File
+    //------------------------------------------------------------------------
+    //! Handle to file being written by writer thread
+    struct File
+    {
+        File(const std::string &f) : filename(f), fp(nullptr)
+        {}
+
+        ~File()
+        {
+            if(fp != nullptr) {
+                fclose(fp);
+            }
+        }
+
+        const std::string filename;
+        FILE *fp;
+    };
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Queue header to be written at the start of file, opening it if required
+    void writeHeader(std::shared_ptr<File> file, const BinarySpikes::Header &header)
+    {
+        std::vector<uint32_t> data(sizeof(BinarySpikes::Header) / sizeof(uint32_t));
+        std::memcpy(data.data(), &header, sizeof(BinarySpikes::Header));
+        enqueue(Job{file, std::move(data), nullptr, 0, nullptr, JobType::Header});
+    }
+
+    //! Queue data to be appended to file
+    void append(std::shared_ptr<File> file, std::vector<uint32_t> &&data)
+    {
+        enqueue(Job{file, std::move(data), nullptr, 0, nullptr, JobType::Append});
+    }
+
+    //! Queue prefix followed by numWords of external data to be appended to file without copying
+    //! external data. onWritten is called from the writer thread once it is no longer required
+    void append(std::shared_ptr<File> file, std::vector<uint32_t> &&prefix,
+                const uint32_t *external, size_t numWords, std::function<void()> onWritten)
+    {
+        enqueue(Job{file, std::move(prefix), external, numWords, onWritten, JobType::Append});
+    }
+
+    //! Block until all queued data has been written
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_QueueEmpty.wait(lock, [this](){ return m_Queue.empty() && !m_Busy; });
+
+        if(!m_Error.empty()) {
+            throw std::runtime_error(m_Error);
+        }
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Enumerations
+    //------------------------------------------------------------------------
+    enum class JobType
+    {
+        Header,
+        Append,
+    };
+
+    //------------------------------------------------------------------------
+    // Job
+    //------------------------------------------------------------------------
+    struct Job
+    {
+        std::shared_ptr<File> file;
+        std::vector<uint32_t> data;
+        const uint32_t *external;
+        size_t numExternalWords;
+        std::function<void()> onWritten;
+        JobType type;
+
+        size_t getNumBytes() const{ return (data.size() + numExternalWords) * sizeof(uint32_t); }
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void enqueue(Job &&job)
+    {
+        const size_t bytes = job.getNumBytes();
+        {
+            // Wait for space in queue - single jobs larger than the limit are allowed when the queue is empty
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_QueueNotFull.wait(lock, [this, bytes](){ return m_Queue.empty() || (m_QueuedBytes + bytes) <= m_MaxQueuedBytes; });
+
+            m_QueuedBytes += bytes;
+            m_Queue.push_back(std::move(job));
+        }
+        m_QueueNotEmpty.notify_one();
+    }
+
+    void writeThread()
+    {
+        while(true) {
+            // Wait for job or quit signal
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_QueueMutex);
+                m_QueueNotEmpty.wait(lock, [this](){ return m_Quit || !m_Queue.empty(); });
+                if(m_Queue.empty()) {
+                    return;
+                }
+                job = std::move(m_Queue.front());
+                m_Queue.pop_front();
+                m_Busy = true;
+            }
+
+            // Perform write
+            const size_t bytes = job.getNumBytes();
+            std::string error;
+            File &file = *job.file;
+            if(file.fp == nullptr) {
+                file.fp = fopen(file.filename.c_str(), "wb");
+                if(file.fp == nullptr) {
+                    error = file.filename + " could not be opened for writing";
+                }
+            }
+            if(file.fp != nullptr) {
+                if(job.type == JobType::Header) {
+                    const long position = ftell(file.fp);
+                    fseek(file.fp, 0, SEEK_SET);
+                    fwrite(job.data.data(), 1, bytes, file.fp);
+                    fseek(file.fp, std::max<long>(position, (long)bytes), SEEK_SET);
+                }
+                else if(fwrite(job.data.data(), sizeof(uint32_t), job.data.size(), file.fp) != job.data.size()
+                        || fwrite(job.external, sizeof(uint32_t), job.numExternalWords, file.fp) != job.numExternalWords)
+                {
+                    error = "Error writing " + file.filename;
+                }
+            }
+
+            // Signal that external data is no longer required
+            if(job.onWritten) {
+                job.onWritten();
+            }
+
+            // Free job data and file handle (closing the file if this was the last reference) outside of lock
+            job = Job();
+
+            {
+                std::lock_guard<std::mutex> lock(m_QueueMutex);
+                m_QueuedBytes -= bytes;
+                m_Busy = false;
+                if(!error.empty() && m_Error.empty()) {
+                    m_Error = error;
+                }
+            }
+            m_QueueNotFull.notify_all();
+            m_QueueEmpty.notify_all();
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const size_t m_MaxQueuedBytes;
+    size_t m_QueuedBytes;
+    bool m_Quit;
+    bool m_Busy;
+    std::string m_Error;
+
+    std::deque<Job> m_Queue;
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueNotEmpty;
+    std::condition_variable m_QueueNotFull;
+    std::condition_variable m_QueueEmpty;
+
+    std::thread m_Thread;
+};
+
+//----------------------------------------------------------------------------
+// BinarySpikeRecorder
+//----------------------------------------------------------------------------
+//! Records spikes from one population to a binary file via a BinarySpikeWriter.
+//! In Bitfield format, blocks of GeNN recording buffer are appended; in Pairs
+//! format, per-timestep spike arrays are buffered and queued when the buffer fills
+class BinarySpikeRecorder
+{
+public:
+    BinarySpikeRecorder(BinarySpikeWriter &writer, const std::string &filename, unsigned int numNeurons,
+                        double dt, BinarySpikes::Format format, size_t pairBufferSize = 1024 * 1024)
+        : m_Writer(writer), m_File(std::make_shared<BinarySpikeWriter::File>(filename)), m_PairBufferSize(pairBufferSize),
+          m_NextTimestep(0)
+    {
+        m_Header.magic = BinarySpikes::magic;
+        m_Header.version = BinarySpikes::version;
+        m_Header.format = format;
+        m_Header.numNeurons = numNeurons;
+        m_Header.dt = dt;
+        m_Header.numBlocks = 0;
+        m_Header.numTimesteps = 0;
+        m_Header.numSpikes = 0;
+
+        // Write provisional header - it gets rewritten with final counts when recorder is destroyed
+        m_Writer.writeHeader(m_File, m_Header);
+    }
+
+    ~BinarySpikeRecorder()
+    {
+        flushPairs();
+        m_Writer.writeHeader(m_File, m_Header);
+    }
+
+    BinarySpikeRecorder(const BinarySpikeRecorder&) = delete;
+    BinarySpikeRecorder &operator = (const BinarySpikeRecorder&) = delete;
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Append block of numTimesteps timesteps of GeNN recording buffer, following on from the previous block
+    void appendBitfield(const uint32_t *recordSpk, unsigned int numTimesteps)
+    {
+        appendBitfield(m_NextTimestep, recordSpk, numTimesteps);
+    }
+
+    //! Append block of numTimesteps timesteps of GeNN recording buffer, starting at startTimestep.
+    //! If onWritten is provided, recordSpk is written in place and it is called once recordSpk can be reused
+    void appendBitfield(uint64_t startTimestep, const uint32_t *recordSpk, unsigned int numTimesteps,
+                        std::function<void()> onWritten = nullptr)
+    {
+        if(m_Header.format != BinarySpikes::Format::Bitfield) {
+            throw std::runtime_error("Recorder isn't using bitfield format");
+        }
+
+        // Build block header
+        const BinarySpikes::BlockHeader block{startTimestep, numTimesteps};
+        const size_t numWords = (size_t)numTimesteps * BinarySpikes::getNumWords(m_Header.numNeurons);
+        std::vector<uint32_t> data(sizeof(BinarySpikes::BlockHeader) / sizeof(uint32_t));
+        std::memcpy(data.data(), &block, sizeof(BinarySpikes::BlockHeader));
+
+        // Either queue with external data or copy data after header
+        if(onWritten) {
+            m_Writer.append(m_File, std::move(data), recordSpk, numWords, onWritten);
+        }
+        else {
+            data.insert(data.end(), recordSpk, recordSpk + numWords);
+            m_Writer.append(m_File, std::move(data));
+        }
+
+        m_Header.numBlocks++;
+        m_Header.numTimesteps += numTimesteps;
+        m_NextTimestep = startTimestep + numTimesteps;
+    }
+
+    //! Record spikes emitted in a single timestep
+    void record(uint64_t timestep, unsigned int spikeCount, const unsigned int *spikes)
+    {
+        if(m_Header.format != BinarySpikes::Format::Pairs) {
+            throw std::runtime_error("Recorder isn't using pairs format");
+        }
+        for(unsigned int i = 0; i < spikeCount; i++) {
+            m_PairBuffer.push_back((uint32_t)timestep);
+            m_PairBuffer.push_back(spikes[i]);
+        }
+        m_Header.numSpikes += spikeCount;
+        m_Header.numTimesteps++;
+
+        // Hand buffer to writer once it's full
+        if(m_PairBuffer.size() >= (2 * m_PairBufferSize)) {
+            flushPairs();
+        }
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void flushPairs()
+    {
+        if(!m_PairBuffer.empty()) {
+            m_Writer.append(m_File, std::move(m_PairBuffer));
+            m_PairBuffer = std::vector<uint32_t>();
+            m_PairBuffer.reserve(2 * m_PairBufferSize);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    BinarySpikeWriter &m_Writer;
+    std::shared_ptr<BinarySpikeWriter::File> m_File;
+    const size_t m_PairBufferSize;
+    uint64_t m_NextTimestep;
+    BinarySpikes::Header m_Header;
+    std::vector<uint32_t> m_PairBuffer;
+};
+
+//! Drop-in replacement for writeTextSpikeRecording which queues the recording buffer on a background writer
+inline void writeBinarySpikeRecording(BinarySpikeWriter &writer, const std::string &filename, const uint32_t *spkRecord,
+                                      unsigned int popSize, unsigned int numTimesteps, double dt = 1.0)
+{
+    BinarySpikeRecorder recorder(writer, filename, popSize, dt, BinarySpikes::Format::Bitfield);
+    recorder.appendBitfield(spkRecord, numTimesteps);
+}
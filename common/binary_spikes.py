@@ -0,0 +1,43 @@
+import numpy as np
+
+# Header layout written by common/binary_spike_recorder.h
+HEADER_DTYPE = np.dtype([("magic", "<u4"), ("version", "<u4"), ("format", "<u4"),
+                         ("num_neurons", "<u4"), ("dt", "<f8"), ("num_blocks", "<u8"),
+                         ("num_timesteps", "<u8"), ("num_spikes", "<u8")])
+BLOCK_HEADER_DTYPE = np.dtype([("start_timestep", "<u8"), ("num_timesteps", "<u8")])
+MAGIC = 0x4B505347
+VERSION = 1
+FORMAT_BITFIELD = 0
+FORMAT_PAIRS = 1
+
+def read_binary_spikes(filename):
+    """Read binary spike file and return spike times (in ms) and neuron IDs as numpy arrays"""
+    with open(filename, "rb") as file:
+        header = np.fromfile(file, dtype=HEADER_DTYPE, count=1)[0]
+        if header["magic"] != MAGIC or header["version"] != VERSION:
+            raise RuntimeError("%s is not a version %u binary spike file" % (filename, VERSION))
+
+        if header["format"] == FORMAT_BITFIELD:
+            num_words = (int(header["num_neurons"]) + 31) // 32
+            times = []
+            ids = []
+            for _ in range(int(header["num_blocks"])):
+                block = np.fromfile(file, dtype=BLOCK_HEADER_DTYPE, count=1)[0]
+                num_timesteps = int(block["num_timesteps"])
+
+                # Read words and unpack into a boolean timestep x neuron matrix
+                words = np.fromfile(file, dtype="<u4", count=num_timesteps * num_words)
+                bits = np.unpackbits(words.view(np.uint8), bitorder="little")
+                bits = bits.reshape((num_timesteps, num_words * 32))[:, :header["num_neurons"]]
+
+                # Convert set bits to times and IDs
+                block_timesteps, block_ids = np.nonzero(bits)
+                times.append((block_timesteps + block["start_timestep"]) * header["dt"])
+                ids.append(block_ids)
+
+            if len(times) == 0:
+                return np.empty(0), np.empty(0, dtype=int)
+            return np.concatenate(times), np.concatenate(ids)
+        else:
+            pairs = np.fromfile(file, dtype="<u4", count=2 * int(header["num_spikes"])).reshape((-1, 2))
+            return pairs[:, 0] * header["dt"], pairs[:, 1].astype(int)
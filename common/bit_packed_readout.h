@@ -0,0 +1,153 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// BitPackedReadout
+//----------------------------------------------------------------------------
+//! Cheap readout of a population's response to a stimulus from which of its (sparse) neurons spiked.
+//! Activity is accumulated into a bitset and the synaptic drive to a readout neuron, the sum of the weights
+//! from active neurons, is calculated with popcounts of the bitset ANDed with bit planes of quantised weights
+namespace BitPackedReadout
+{
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+//! Count bits set in both a and b
+//! **NOTE** __restrict and the simple loop let the compiler use vector or hardware popcount instructions
+inline unsigned int countAnd(const uint64_t *__restrict a, const uint64_t *__restrict b, size_t numWords)
+{
+    unsigned int count = 0;
+    for(size_t i = 0; i < numWords; i++) {
+        count += (unsigned int)__builtin_popcountll(a[i] & b[i]);
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------
+// BitPackedReadout::Bitset
+//----------------------------------------------------------------------------
+class Bitset
+{
+public:
+    Bitset(unsigned int numBits) : m_NumBits(numBits), m_Words((numBits + 63) / 64, 0)
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    void set(unsigned int i){ m_Words[i / 64] |= (1ull << (i % 64)); }
+    bool test(unsigned int i) const{ return (m_Words[i / 64] & (1ull << (i % 64))) != 0; }
+    void clear(){ std::fill(m_Words.begin(), m_Words.end(), 0); }
+
+    //! Set bits of neurons in a GeNN spike array
+    void setSpikes(unsigned int spikeCount, const unsigned int *spikes)
+    {
+        for(unsigned int s = 0; s < spikeCount; s++) {
+            set(spikes[s]);
+        }
+    }
+
+    unsigned int count() const
+    {
+        unsigned int count = 0;
+        for(uint64_t w : m_Words) {
+            count += (unsigned int)__builtin_popcountll(w);
+        }
+        return count;
+    }
+
+    unsigned int getNumBits() const{ return m_NumBits; }
+    size_t getNumWords() const{ return m_Words.size(); }
+    const uint64_t *getWords() const{ return m_Words.data(); }
+    uint64_t *getWords(){ return m_Words.data(); }
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    unsigned int m_NumBits;
+    std::vector<uint64_t> m_Words;
+};
+
+//----------------------------------------------------------------------------
+// BitPackedReadout::QuantisedWeights
+//----------------------------------------------------------------------------
+//! Weights from numPre neurons onto a readout neuron, quantised to numBits bits between 0 and maxWeight
+//! and stored as numBits bitsets where bit plane b holds bit b of every quantised weight. With one bit,
+//! weights are binary: present if they are at least half of maxWeight and absent otherwise
+class QuantisedWeights
+{
+public:
+    QuantisedWeights(unsigned int numPre, unsigned int numBits, float maxWeight)
+    :   m_NumBits(numBits), m_Step(getStep(numBits, maxWeight)), m_Planes(numBits, Bitset(numPre))
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Quantise weights, which are stride floats apart so a column of a GeNN DENSE weight matrix can be used directly
+    void set(const float *weights, size_t stride = 1)
+    {
+        const unsigned int maxLevel = (1u << m_NumBits) - 1;
+        for(auto &p : m_Planes) {
+            p.clear();
+        }
+        for(unsigned int i = 0; i < m_Planes.front().getNumBits(); i++) {
+            const float level = std::round(weights[i * stride] / m_Step);
+            const unsigned int q = (unsigned int)std::min((float)maxLevel, std::max(0.0f, level));
+            for(unsigned int b = 0; b < m_NumBits; b++) {
+                if(q & (1u << b)) {
+                    m_Planes[b].set(i);
+                }
+            }
+        }
+    }
+
+    //! Get sum of quantised weights from neurons active in bitset
+    float getDrive(const Bitset &active) const
+    {
+        if(active.getNumBits() != m_Planes.front().getNumBits()) {
+            throw std::runtime_error("Bitset and weights are from populations of different sizes");
+        }
+
+        unsigned int level = 0;
+        for(unsigned int b = 0; b < m_NumBits; b++) {
+            level += countAnd(active.getWords(), m_Planes[b].getWords(), active.getNumWords()) << b;
+        }
+        return m_Step * (float)level;
+    }
+
+    unsigned int getNumBits() const{ return m_NumBits; }
+
+private:
+    //------------------------------------------------------------------------
+    // Private static methods
+    //------------------------------------------------------------------------
+    //! Validate number of bits and get size of quantisation step
+    //! **NOTE** this is called from the initialiser list so numBits is checked before it is used in a shift
+    static float getStep(unsigned int numBits, float maxWeight)
+    {
+        if(numBits == 0 || numBits > 16) {
+            throw std::runtime_error("Weights can only be quantised to between 1 and 16 bits");
+        }
+        return maxWeight / (float)((1u << numBits) - 1);
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const unsigned int m_NumBits;
+    const float m_Step;
+    std::vector<Bitset> m_Planes;
+};
+}   // namespace BitPackedReadout
@@ -0,0 +1,42 @@
+import json
+import sys
+
+# Compares latency reports written by common/latency_report.h, printing the change in each
+# stage's percentiles and exiting with an error if any stage's p99 has regressed by more than tolerance:
+#       python compare_latency_reports.py baseline.json new.json [tolerance (default 0.1 i.e. 10%)]
+# Each stage's non-empty histogram bins are listed as [upper edge us, count] pairs; the upper edge
+# of the overflow bin (latencies over ~134s) is the stage's maximum latency so reports are valid JSON
+def check_bins(filename, report):
+    for name, stage in report["stages"].items():
+        edges = [b[0] for b in stage["bins"]]
+        if any(e is None for e in edges) or edges != sorted(edges) or sum(b[1] for b in stage["bins"]) != stage["count"]:
+            raise ValueError("%s: stage '%s' has malformed histogram bins" % (filename, name))
+
+def compare(baseline_filename, new_filename, tolerance):
+    with open(baseline_filename) as file:
+        baseline = json.load(file)
+    with open(new_filename) as file:
+        new = json.load(file)
+    check_bins(baseline_filename, baseline)
+    check_bins(new_filename, new)
+
+    regressions = []
+    print("%-24s %12s %12s %12s %12s" % ("Stage", "Base p50", "New p50", "Base p99", "New p99"))
+    for name, new_stage in new["stages"].items():
+        base_stage = baseline["stages"].get(name)
+        if base_stage is None or base_stage["count"] == 0 or new_stage["count"] == 0:
+            print("%-24s (not recorded in both reports)" % name)
+            continue
+
+        print("%-24s %10.1fus %10.1fus %10.1fus %10.1fus" % (name, base_stage["p50_us"], new_stage["p50_us"],
+                                                             base_stage["p99_us"], new_stage["p99_us"]))
+        if new_stage["p99_us"] > (base_stage["p99_us"] * (1.0 + tolerance)):
+            regressions.append(name)
+
+    if regressions:
+        print("p99 latency regressed in: %s" % ", ".join(regressions))
+    return len(regressions) == 0
+
+if __name__ == "__main__":
+    tolerance = float(sys.argv[3]) if len(sys.argv) > 3 else 0.1
+    sys.exit(0 if compare(sys.argv[1], sys.argv[2], tolerance) else 1)
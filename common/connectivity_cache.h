@@ -0,0 +1,267 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// ConnectivityCache
+//----------------------------------------------------------------------------
+//! Versioned binary snapshots of GeNN SPARSE connectivity (row lengths, indices and
+//! per-synapse variables), keyed by a hash of whatever was used to generate them.
+//! Files consist of a Header followed by numProjections ProjectionHeaders, each
+//! followed by its padded rowLength, ind and variable arrays (aligned to 8 bytes)
+//! so they can be copied straight out of a memory mapping into GeNN's arrays
+namespace ConnectivityCache
+{
+//! "GCON" in little-endian byte order
+constexpr uint32_t magic = 0x4E4F4347;
+constexpr uint32_t version = 1;
+constexpr unsigned int maxVars = 4;
+constexpr unsigned int maxNameLength = 64;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t numProjections;
+};
+
+struct ProjectionHeader
+{
+    char name[maxNameLength];
+    uint32_t numSrc;
+    uint32_t maxRowLength;
+    uint32_t indBytes;
+    uint32_t numVars;
+    uint32_t varBytes[maxVars];
+};
+
+//----------------------------------------------------------------------------
+// ConnectivityCache::Projection
+//----------------------------------------------------------------------------
+//! Pointers to GeNN's host arrays for one SPARSE synapse population
+struct Projection
+{
+    std::string name;
+    unsigned int numSrc;
+    unsigned int maxRowLength;
+    unsigned int *rowLength;
+    void *ind;
+    unsigned int indBytes;
+
+    //! Per-synapse variable arrays and the size of their elements in bytes
+    std::vector<std::pair<void*, unsigned int>> vars;
+
+    size_t getNumSlots() const{ return (size_t)numSrc * maxRowLength; }
+};
+
+//----------------------------------------------------------------------------
+// ConnectivityCache::Hash
+//----------------------------------------------------------------------------
+//! 64-bit FNV-1a hash used to build cache keys
+class Hash
+{
+public:
+    Hash() : m_Hash(0xCBF29CE484222325ull)
+    {
+    }
+
+    template<typename T>
+    Hash &add(const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be hashed");
+        return addBytes(&value, sizeof(T));
+    }
+
+    Hash &add(const std::string &value)
+    {
+        return addBytes(value.data(), value.size()).add(value.size());
+    }
+
+    uint64_t get() const{ return m_Hash; }
+
+private:
+    Hash &addBytes(const void *data, size_t size)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; i++) {
+            m_Hash = (m_Hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+        return *this;
+    }
+
+    uint64_t m_Hash;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+inline size_t align(size_t offset)
+{
+    return (offset + 7) & ~(size_t)7;
+}
+
+inline std::string getFilename(const std::string &prefix, uint64_t key)
+{
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)key);
+    return prefix + hex + ".bin";
+}
+
+//! Write projections to cache file - data is written to a temporary file and renamed
+//! so an interrupted run can't leave a truncated cache behind
+inline void save(const std::string &filename, uint64_t key, const std::vector<Projection> &projections)
+{
+    const std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream file(tmpFilename, std::ofstream::binary);
+        if(!file.good()) {
+            throw std::runtime_error(tmpFilename + " could not be opened for writing");
+        }
+
+        size_t offset = 0;
+        auto write = [&file, &offset](const void *data, size_t size)
+        {
+            // Write data followed by padding to alignment
+            const char padding[8] = {0};
+            file.write(static_cast<const char*>(data), size);
+            file.write(padding, align(offset + size) - (offset + size));
+            offset = align(offset + size);
+        };
+
+        const Header header{magic, version, key, projections.size()};
+        write(&header, sizeof(Header));
+
+        for(const auto &p : projections) {
+            if(p.name.size() >= maxNameLength || p.vars.size() > maxVars) {
+                throw std::runtime_error("Projection '" + p.name + "' cannot be cached");
+            }
+
+            ProjectionHeader projHeader;
+            std::memset(&projHeader, 0, sizeof(ProjectionHeader));
+            std::copy(p.name.cbegin(), p.name.cend(), projHeader.name);
+            projHeader.numSrc = p.numSrc;
+            projHeader.maxRowLength = p.maxRowLength;
+            projHeader.indBytes = p.indBytes;
+            projHeader.numVars = (uint32_t)p.vars.size();
+            for(size_t v = 0; v < p.vars.size(); v++) {
+                projHeader.varBytes[v] = p.vars[v].second;
+            }
+            write(&projHeader, sizeof(ProjectionHeader));
+
+            // Write padded arrays
+            write(p.rowLength, sizeof(unsigned int) * p.numSrc);
+            write(p.ind, p.indBytes * p.getNumSlots());
+            for(const auto &v : p.vars) {
+                write(v.first, v.second * p.getNumSlots());
+            }
+        }
+
+        if(!file.good()) {
+            throw std::runtime_error("Error writing " + tmpFilename);
+        }
+    }
+
+    if(rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("Unable to rename " + tmpFilename + " to " + filename);
+    }
+}
+
+//! Copy projections from cache file if it exists and was generated with key.
+//! Returns false if there is no usable cache, throws if the cache is corrupt
+//! or its projections don't match those of the model
+inline bool load(const std::string &filename, uint64_t key, std::vector<Projection> &projections)
+{
+    // Open file and get its size, returning false if it doesn't exist
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1) {
+        return false;
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) == -1 || (size_t)fileStat.st_size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    // Map file into memory
+    const size_t size = (size_t)fileStat.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        throw std::runtime_error("Unable to memory map " + filename);
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    const uint8_t *bytes = static_cast<const uint8_t*>(mapped);
+    size_t offset = 0;
+    auto read = [bytes, size, &offset, &filename](void *data, size_t dataSize)
+    {
+        if((offset + dataSize) > size) {
+            throw std::runtime_error(filename + " is truncated");
+        }
+        std::memcpy(data, bytes + offset, dataSize);
+        offset = align(offset + dataSize);
+    };
+
+    try
+    {
+        // Check header - caches from other versions or keys are ignored rather than being errors
+        Header header;
+        read(&header, sizeof(Header));
+        if(header.magic != magic || header.version != version || header.key != key) {
+            munmap(mapped, size);
+            return false;
+        }
+        if(header.numProjections != projections.size()) {
+            throw std::runtime_error(filename + " contains " + std::to_string(header.numProjections)
+                                     + " projections, expected " + std::to_string(projections.size()));
+        }
+
+        for(auto &p : projections) {
+            // Check projection matches
+            ProjectionHeader projHeader;
+            read(&projHeader, sizeof(ProjectionHeader));
+            projHeader.name[maxNameLength - 1] = '\0';
+            if(p.name != projHeader.name || p.numSrc != projHeader.numSrc || p.maxRowLength != projHeader.maxRowLength
+               || p.indBytes != projHeader.indBytes || p.vars.size() != projHeader.numVars
+               || !std::equal(p.vars.cbegin(), p.vars.cend(), projHeader.varBytes,
+                              [](const std::pair<void*, unsigned int> &v, uint32_t b){ return v.second == b; }))
+            {
+                throw std::runtime_error("Projection '" + p.name + "' in " + filename + " doesn't match model");
+            }
+
+            // Copy arrays
+            read(p.rowLength, sizeof(unsigned int) * p.numSrc);
+            read(p.ind, p.indBytes * p.getNumSlots());
+            for(auto &v : p.vars) {
+                read(v.first, v.second * p.getNumSlots());
+            }
+        }
+    }
+    catch(...)
+    {
+        munmap(mapped, size);
+        throw;
+    }
+
+    munmap(mapped, size);
+    return true;
+}
+}   // namespace ConnectivityCache
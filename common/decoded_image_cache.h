@@ -0,0 +1,147 @@
+#pragma once
+
+// Standard C++ includes
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Common includes
+#include "connectivity_cache.h"
+#include "png_to_float.h"
+
+//----------------------------------------------------------------------------
+// DecodedImageCache
+//----------------------------------------------------------------------------
+//! Caches datasets of images, decoded into floats, in a single file consisting of a Header followed
+//! by the decoded images, which can be copied straight out of a memory mapping into a stimulus buffer.
+//! Caches are keyed by a hash of the name, size and modification time of each image file and the
+//! parameters used to decode them so any change to the dataset or decoding invalidates the cache
+namespace DecodedImageCache
+{
+//! "GIMG" in little-endian byte order
+constexpr uint32_t magic = 0x474D4947;
+constexpr uint32_t version = 1;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t numImages;
+    uint64_t numPixels;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+inline uint64_t getKey(const std::vector<std::string> &filenames, float scale, bool rowMajor, size_t numPixels)
+{
+    ConnectivityCache::Hash hash;
+    hash.add(version).add(scale).add(rowMajor).add((uint64_t)numPixels).add((uint64_t)filenames.size());
+    for(const auto &f : filenames) {
+        struct stat fileStat;
+        if(stat(f.c_str(), &fileStat) == -1) {
+            throw std::runtime_error(f + " could not be found");
+        }
+        hash.add(f).add((uint64_t)fileStat.st_size).add((int64_t)fileStat.st_mtime);
+    }
+    return hash.get();
+}
+
+//! Write decoded images to cache file - data is written to a temporary file and renamed
+//! so an interrupted run can't leave a truncated cache behind
+inline void save(const std::string &filename, uint64_t key, size_t numImages, size_t numPixels, const float *data)
+{
+    const std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream file(tmpFilename, std::ofstream::binary);
+        if(!file.good()) {
+            throw std::runtime_error(tmpFilename + " could not be opened for writing");
+        }
+
+        const Header header{magic, version, key, numImages, numPixels};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(data), sizeof(float) * numImages * numPixels);
+        if(!file.good()) {
+            throw std::runtime_error("Error writing " + tmpFilename);
+        }
+    }
+
+    if(rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("Unable to rename " + tmpFilename + " to " + filename);
+    }
+}
+
+//! Copy decoded images from cache file if it exists and was generated with key.
+//! Returns false if there is no usable cache, throws if the cache is corrupt
+inline bool load(const std::string &filename, uint64_t key, size_t numImages, size_t numPixels, float *data)
+{
+    // Open file and get its size, returning false if it doesn't exist
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1) {
+        return false;
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) == -1 || (size_t)fileStat.st_size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    // Map file into memory
+    const size_t size = (size_t)fileStat.st_size;
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        throw std::runtime_error("Unable to memory map " + filename);
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    // Check header - caches from other versions or keys are ignored rather than being errors
+    Header header;
+    std::memcpy(&header, mapped, sizeof(Header));
+    if(header.magic != magic || header.version != version || header.key != key) {
+        munmap(mapped, size);
+        return false;
+    }
+
+    const size_t dataSize = sizeof(float) * numImages * numPixels;
+    if(header.numImages != numImages || header.numPixels != numPixels || size != (sizeof(Header) + dataSize)) {
+        munmap(mapped, size);
+        throw std::runtime_error(filename + " doesn't contain " + std::to_string(numImages) + " images of "
+                                 + std::to_string(numPixels) + " pixels");
+    }
+
+    std::memcpy(data, static_cast<const uint8_t*>(mapped) + sizeof(Header), dataSize);
+    munmap(mapped, size);
+    return true;
+}
+
+//! Fill data with images, decoded on a pool of threads, from the cache file in cacheDirectory
+//! matching them if there is one or by decoding them and writing a cache if not.
+//! Returns true if images were loaded from the cache
+inline bool readPNGs(const std::vector<std::string> &filenames, float scale, bool rowMajor, size_t numPixels,
+                     float *data, const std::string &cacheDirectory = ".", unsigned int numThreads = 0)
+{
+    const uint64_t key = getKey(filenames, scale, rowMajor, numPixels);
+    const std::string filename = ConnectivityCache::getFilename(cacheDirectory + "/decoded_images_", key);
+    if(load(filename, key, filenames.size(), numPixels, data)) {
+        return true;
+    }
+
+    PNGToFloat::readPNGs(filenames, scale, rowMajor, numPixels, data, numThreads);
+    save(filename, key, filenames.size(), numPixels, data);
+    return false;
+}
+}   // namespace DecodedImageCache
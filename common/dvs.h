@@ -1,103 +1,20 @@
 #pragma once
 
+// Standard C++ includes
+#include <iostream>
+#include <vector>
+
 // Lib CAER includes
 #include <libcaercpp/devices/davis.hpp>
 #include <libcaercpp/devices/dvs128.hpp>
 #include <libcaercpp/devices/dvxplorer.hpp>
 
-//----------------------------------------------------------------------------
-// DVS::Polarity
-//----------------------------------------------------------------------------
-namespace DVS
-{
-enum class Polarity
-{
-    ON,
-    OFF,
-    BOTH,
-};
-
-//! Filter events based on their polarity
-template<Polarity polarity = Polarity::BOTH>
-struct PolarityFilter
-{
-    static constexpr bool shouldAllow(const libcaer::events::PolarityEvent &event)
-    {
-        return (polarity == Polarity::BOTH
-                || (polarity == Polarity::ON && event.getPolarity())
-                || (polarity == Polarity::OFF && !event.getPolarity()));
-    }
-};
-
-//! Filter events depending on whether they are in region of interest
-template<uint16_t minX, uint16_t maxX, uint16_t minY, uint16_t maxY>
-struct ROIFilter
-{
-    static constexpr bool shouldAllow(const libcaer::events::PolarityEvent &event)
-    {
-        return (event.getX() > minX && event.getX() < maxX 
-                && event.getY() > minY && event.getY() < maxY);
-    }
-};
-
-//! Combine two event filters
-template<typename FilterA, typename FilterB>
-struct CombineFilter
-{
-    static constexpr bool shouldAllow(const libcaer::events::PolarityEvent &event)
-    {
-        return (FilterA::shouldAllow(event) && FilterB::shouldAllow(event));
-    }
-};
-
-//! Don't filter any events
-struct NoFilter
-{
-    static constexpr bool shouldAllow(const libcaer::events::PolarityEvent&)
-    {
-        return true;
-    }
-};
-
-//! Scale event coordinate - FixedPointScale is calculated by multiplying fraction by 1^15
-template<uint32_t FixedPointScale>
-struct Scale
-{
-    static constexpr uint32_t transform(uint32_t x)
-    {
-        return (x * FixedPointScale) >> 15;
-    }
-};
-
-//! Subtract value from event coordinate
-template<uint32_t Offset>
-struct Subtract
-{
-    static constexpr uint32_t transform(uint32_t x)
-    {
-        return (x - Offset);
-    }
-};
-
-//! Don't transform event coordinate
-struct NoTransform
-{
-    static constexpr uint32_t transform(uint32_t x)
-    {
-        return x;
-    }
-};
+// Common includes
+#include "dvs_event_pipeline.h"
+#include "dvs_filters.h"
 
-//! Combine two event coordinate transformations
-template<typename TransformA, typename TransformB>
-struct CombineTransform
+namespace DVS
 {
-    static constexpr uint32_t transform(uint32_t x)
-    {
-        return TransformB::transform(TransformA::transform(x));
-    }
-};
-
 //----------------------------------------------------------------------------
 // DVS::Base
 //----------------------------------------------------------------------------
@@ -151,6 +68,61 @@ public:
 
     template<unsigned int outputSize, typename Filter = NoFilter, typename TransformX = NoTransform, typename TransformY = NoTransform>
     void readEvents(uint32_t *spikeVector)
+    {
+        forEachEvent<outputSize, Filter, TransformX, TransformY>(
+            [spikeVector](unsigned int gennAddress)
+            {
+                // Set spike bit
+                spikeVector[gennAddress / 32] |= (1 << (gennAddress % 32));
+            });
+    }
+
+    //! Append GeNN addresses of filtered and transformed events to addresses
+    template<unsigned int outputSize, typename Filter = NoFilter, typename TransformX = NoTransform, typename TransformY = NoTransform>
+    void readEventAddresses(std::vector<uint32_t> &addresses)
+    {
+        forEachEvent<outputSize, Filter, TransformX, TransformY>(
+            [&addresses](unsigned int gennAddress)
+            {
+                addresses.push_back(gennAddress);
+            });
+    }
+
+    //! Append polarity events which pass Filter to batch, to be filtered further by an EventPipeline
+    template<typename Filter = NoFilter>
+    void readEventBatch(EventBatch &batch)
+    {
+        forEachPolarityEvent(
+            [&batch](const libcaer::events::PolarityEvent &event)
+            {
+                if(Filter::shouldAllow(event)) {
+                    batch.add((uint32_t)event.getTimestamp(), event.getX(), event.getY(), event.getPolarity());
+                }
+            });
+    }
+
+    //! Live devices never run out of events
+    bool isFinished() const
+    {
+        return false;
+    }
+
+    unsigned int getWidth() const
+    {
+        return m_Width;
+    }
+
+    unsigned int getHeight() const
+    {
+        return m_Height;
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    template<typename Action>
+    void forEachPolarityEvent(Action action)
     {
         // Get data from DVS
         auto packetContainer = m_DVSHandle.dataGet();
@@ -171,34 +143,30 @@ public:
 
                 // Loop through events
                 for(const auto &event : *polarityPacket) {
-                    // If event isn't filtered
-                    if(Filter::shouldAllow(event)) {
-                        // Transform event
-                        const uint32_t transformX = TransformX::transform(event.getX());
-                        const uint32_t transformY = TransformY::transform(event.getY());
-                        
-                        // Convert transformed X and Y into GeNN address
-                        const unsigned int gennAddress = (transformX + (transformY * outputSize));
-                        
-                        // Set spike bit
-                        spikeVector[gennAddress / 32] |= (1 << (gennAddress % 32));
-                    }
+                    action(event);
                 }
             }
         }
     }
 
-    unsigned int getWidth() const
+    template<unsigned int outputSize, typename Filter, typename TransformX, typename TransformY, typename Action>
+    void forEachEvent(Action action)
     {
-        return m_Width;
-    }
+        forEachPolarityEvent(
+            [action](const libcaer::events::PolarityEvent &event)
+            {
+                // If event isn't filtered
+                if(Filter::shouldAllow(event)) {
+                    // Transform event
+                    const uint32_t transformX = TransformX::transform(event.getX());
+                    const uint32_t transformY = TransformY::transform(event.getY());
 
-    unsigned int getHeight() const
-    {
-        return m_Height;
+                    // Convert transformed X and Y into GeNN address
+                    action(transformX + (transformY * outputSize));
+                }
+            });
     }
 
-private:
     //------------------------------------------------------------------------
     // Members
     //------------------------------------------------------------------------
@@ -0,0 +1,160 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+// DVSEventFile
+//----------------------------------------------------------------------------
+//! Compact binary format for pre-recorded DVS events. Files consist of a
+//! Header, followed by numFrames frame end offsets and then numEvents
+//! packed events, sorted by timestamp. Frame f contains the events in
+//! [frameEnd[f - 1], frameEnd[f]) i.e. all events with timestamps
+//! <= firstTimestamp + ((f + 1) * frameDurationUs), matching the framing
+//! used by DVSPreRecorded so either reader produces identical spikes
+namespace DVSEventFile
+{
+//! "GDVS" in little-endian byte order
+constexpr uint32_t magic = 0x53564447;
+constexpr uint32_t version = 1;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameDurationUs;
+    uint32_t firstTimestamp;
+    uint64_t numEvents;
+    uint64_t numFrames;
+};
+static_assert(sizeof(Header) == 40, "Unexpected padding in DVSEventFile::Header");
+
+//! Event packed into 8 bytes - polarity is stored in the top bit of y
+struct Event
+{
+    uint32_t timestamp;
+    uint16_t x;
+    uint16_t yPolarity;
+
+    uint16_t getY() const{ return (yPolarity & 0x7FFF); }
+    bool getPolarity() const{ return (yPolarity & 0x8000) != 0; }
+};
+static_assert(sizeof(Event) == 8, "Unexpected padding in DVSEventFile::Event");
+
+inline Event makeEvent(uint32_t timestamp, uint16_t x, uint16_t y, bool polarity)
+{
+    Event event;
+    event.timestamp = timestamp;
+    event.x = x;
+    event.yPolarity = (y & 0x7FFF) | (polarity ? 0x8000 : 0);
+    return event;
+}
+
+//! Get byte offset of frame index and event data within file
+inline size_t getFrameEndOffset()
+{
+    return sizeof(Header);
+}
+
+inline size_t getEventOffset(const Header &header)
+{
+    return sizeof(Header) + (sizeof(uint64_t) * header.numFrames);
+}
+
+//! Build frame index for events sorted by timestamp and write complete file
+inline void write(const std::string &filename, const std::vector<Event> &events,
+                  unsigned int frameDurationUs, unsigned int width, unsigned int height)
+{
+    if(frameDurationUs == 0) {
+        throw std::runtime_error("Frame duration must be at least 1us");
+    }
+    if(!std::is_sorted(events.cbegin(), events.cend(),
+                       [](const Event &a, const Event &b){ return a.timestamp < b.timestamp; }))
+    {
+        throw std::runtime_error("Events must be sorted by timestamp");
+    }
+
+    // Build header
+    Header header;
+    header.magic = magic;
+    header.version = version;
+    header.width = width;
+    header.height = height;
+    header.frameDurationUs = frameDurationUs;
+    header.firstTimestamp = events.empty() ? 0 : events.front().timestamp;
+    header.numEvents = events.size();
+
+    // Loop through events, recording offset at which each frame ends
+    std::vector<uint64_t> frameEnd;
+    uint64_t frameEndTimestamp = (uint64_t)header.firstTimestamp + frameDurationUs;
+    for(size_t i = 0; i < events.size(); i++) {
+        while(events[i].timestamp > frameEndTimestamp) {
+            frameEnd.push_back(i);
+            frameEndTimestamp += frameDurationUs;
+        }
+    }
+
+    // Final frame ends with last event
+    if(!events.empty()) {
+        frameEnd.push_back(events.size());
+    }
+    header.numFrames = frameEnd.size();
+
+    // Write header, frame index and events
+    std::ofstream file(filename, std::ofstream::binary);
+    if(!file.good()) {
+        throw std::runtime_error(filename + " could not be opened for writing");
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(frameEnd.data()), sizeof(uint64_t) * frameEnd.size());
+    file.write(reinterpret_cast<const char*>(events.data()), sizeof(Event) * events.size());
+    if(!file.good()) {
+        throw std::runtime_error("Error writing " + filename);
+    }
+}
+
+//! Parse CSV file in the format read by DVSPreRecorded - a header line followed by timestamp,x,y,polarity lines.
+//! Like DVSPreRecorded, events in recordings without a polarity column are treated as ON
+inline std::vector<Event> readCSV(const std::string &filename)
+{
+    std::ifstream csv(filename);
+    if(!csv.good()) {
+        throw std::runtime_error(filename + " could not be opened for reading");
+    }
+
+    // Skip header line
+    std::string line;
+    std::getline(csv, line);
+
+    // Parse lines without any intermediate string streams
+    std::vector<Event> events;
+    while(std::getline(csv, line)) {
+        if(line.empty()) {
+            continue;
+        }
+
+        const char *c = line.c_str();
+        char *end;
+        const unsigned long timestamp = std::strtoul(c, &end, 10);
+        const unsigned long x = std::strtoul(end + 1, &end, 10);
+        const unsigned long y = std::strtoul(end + 1, &end, 10);
+        const unsigned long polarity = (*end == ',') ? std::strtoul(end + 1, &end, 10) : 1;
+        if(x > 0xFFFF || y > 0x7FFF) {
+            throw std::runtime_error("Event coordinates out of range in line '" + line + "'");
+        }
+        events.push_back(makeEvent((uint32_t)timestamp, (uint16_t)x, (uint16_t)y, polarity == 1));
+    }
+
+    return events;
+}
+}   // namespace DVSEventFile
@@ -0,0 +1,192 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+
+// Common includes
+#include "dvs_filters.h"
+
+namespace DVS
+{
+//----------------------------------------------------------------------------
+// DVS::EventBatch
+//----------------------------------------------------------------------------
+//! Packet of events stored as separate arrays of each field. Arrays only grow so
+//! batches can be reused (e.g. as slots in an SPSCRing) without reallocating
+class EventBatch
+{
+public:
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    void clear()
+    {
+        m_Timestamp.clear();
+        m_X.clear();
+        m_Y.clear();
+        m_Polarity.clear();
+    }
+
+    void add(uint32_t timestamp, uint16_t x, uint16_t y, bool polarity)
+    {
+        m_Timestamp.push_back(timestamp);
+        m_X.push_back(x);
+        m_Y.push_back(y);
+        m_Polarity.push_back(polarity ? 1 : 0);
+    }
+
+    size_t size() const{ return m_Timestamp.size(); }
+    bool empty() const{ return m_Timestamp.empty(); }
+
+    const uint32_t *getTimestamps() const{ return m_Timestamp.data(); }
+    const uint16_t *getX() const{ return m_X.data(); }
+    const uint16_t *getY() const{ return m_Y.data(); }
+    const uint8_t *getPolarities() const{ return m_Polarity.data(); }
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    std::vector<uint32_t> m_Timestamp;
+    std::vector<uint16_t> m_X;
+    std::vector<uint16_t> m_Y;
+    std::vector<uint8_t> m_Polarity;
+};
+
+//----------------------------------------------------------------------------
+// DVS::EventPipeline
+//----------------------------------------------------------------------------
+//! Filters batches of events and sets the bits of the GeNN spike bitfield corresponding to those which remain.
+//! Stateless polarity and ROI filters are applied per-event when batches are read (see DVS::Base::readEventBatch)
+//! so filtered events never reach the pipeline. Events are then passed, in timestamp order, through two filters
+//! which suppress sensor noise using per-pixel maps of timestamps:
+//!  - refractory / hot-pixel - drops events from pixels which produced an event less than refractoryUs earlier.
+//!    Every event, including dropped ones, restarts the refractory period so hot pixels stay suppressed
+//!  - background activity - drops events unless one of the 8 neighbouring pixels produced an event less than
+//!    correlationUs earlier. Rather than reading 8 timestamps, each event writes its timestamp into its neighbours'
+//!    entries so the check is a single read. The map has a 1 pixel border so edge pixels need no bounds checks
+//! Setting either period to zero disables that filter. Finally, remaining events are transformed into GeNN addresses.
+//! **NOTE** events are processed one at a time because both noise filters depend on the maps as updated by every
+//! earlier event, including those in the same batch, so batches aren't filtered with SIMD
+template<unsigned int outputSize, typename TransformX = NoTransform, typename TransformY = NoTransform>
+class EventPipeline
+{
+public:
+    EventPipeline(unsigned int width, unsigned int height, uint32_t refractoryUs = 0, uint32_t correlationUs = 0)
+    :   m_Width(width), m_Height(height), m_RefractoryUs(refractoryUs), m_CorrelationUs(correlationUs),
+        m_LastEvent((refractoryUs == 0) ? 0 : (width * height)),
+        m_LastNeighbourEvent((correlationUs == 0) ? 0 : ((width + 2) * (height + 2))),
+        m_FirstBatch(true), m_NumEvents(0), m_NumRefractory(0), m_NumBackground(0)
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Filter and transform events in batch and set bits in spikeVector
+    void process(const EventBatch &batch, uint32_t *spikeVector)
+    {
+        const size_t numEvents = batch.size();
+        if(numEvents == 0) {
+            return;
+        }
+
+        // Before the first events, initialise maps so every pixel's last event is too old to suppress anything
+        if(m_FirstBatch) {
+            const uint32_t never = batch.getTimestamps()[0] - std::max(m_RefractoryUs, m_CorrelationUs) - 1;
+            std::fill(m_LastEvent.begin(), m_LastEvent.end(), never);
+            std::fill(m_LastNeighbourEvent.begin(), m_LastNeighbourEvent.end(), never);
+            m_FirstBatch = false;
+        }
+
+        // **NOTE** periods and counters are copied into locals as, otherwise, writes
+        // to spikeVector might alias them so they would be re-read for every event
+        const uint32_t *timestamp = batch.getTimestamps();
+        const uint16_t *x = batch.getX();
+        const uint16_t *y = batch.getY();
+        const uint32_t refractoryUs = m_RefractoryUs;
+        const uint32_t correlationUs = m_CorrelationUs;
+        const unsigned int borderWidth = m_Width + 2;
+        uint32_t *lastEventMap = m_LastEvent.data();
+        uint32_t *lastNeighbourEventMap = m_LastNeighbourEvent.data();
+        uint64_t numRefractory = 0;
+        uint64_t numBackground = 0;
+        for(size_t i = 0; i < numEvents; i++) {
+            const uint32_t t = timestamp[i];
+            if(refractoryUs > 0) {
+                // **NOTE** unsigned subtraction handles timestamps wrapping
+                uint32_t &lastEvent = lastEventMap[x[i] + (y[i] * m_Width)];
+                const bool refractory = ((t - lastEvent) < refractoryUs);
+                lastEvent = t;
+                if(refractory) {
+                    numRefractory++;
+                    continue;
+                }
+            }
+
+            if(correlationUs > 0) {
+                // Get pointer to event's pixel in bordered map
+                uint32_t *centre = &lastNeighbourEventMap[(x[i] + 1) + ((y[i] + 1) * borderWidth)];
+                const bool supported = ((t - *centre) < correlationUs);
+
+                // Update neighbours
+                uint32_t *above = centre - borderWidth;
+                uint32_t *below = centre + borderWidth;
+                above[-1] = above[0] = above[1] = t;
+                centre[-1] = centre[1] = t;
+                below[-1] = below[0] = below[1] = t;
+                if(!supported) {
+                    numBackground++;
+                    continue;
+                }
+            }
+
+            // Transform event and set bit corresponding to its GeNN address
+            const uint32_t address = TransformX::transform(x[i]) + (TransformY::transform(y[i]) * outputSize);
+            spikeVector[address / 32] |= (1 << (address % 32));
+        }
+        m_NumEvents += numEvents;
+        m_NumRefractory += numRefractory;
+        m_NumBackground += numBackground;
+    }
+
+    //------------------------------------------------------------------------
+    // Statistics
+    //------------------------------------------------------------------------
+    //! Total number of events processed
+    uint64_t getNumEvents() const{ return m_NumEvents; }
+
+    //! Number of events removed by refractory / hot-pixel filter
+    uint64_t getNumRefractory() const{ return m_NumRefractory; }
+
+    //! Number of events removed by background activity filter
+    uint64_t getNumBackground() const{ return m_NumBackground; }
+
+    //! Number of events which reached the spike bitfield
+    uint64_t getNumSpikes() const{ return m_NumEvents - m_NumRefractory - m_NumBackground; }
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const unsigned int m_Width;
+    const unsigned int m_Height;
+    const uint32_t m_RefractoryUs;
+    const uint32_t m_CorrelationUs;
+
+    //! Timestamp of last event at each pixel
+    std::vector<uint32_t> m_LastEvent;
+
+    //! Timestamp of last event at any of each pixel's neighbours, with 1 pixel border
+    std::vector<uint32_t> m_LastNeighbourEvent;
+
+    bool m_FirstBatch;
+    uint64_t m_NumEvents;
+    uint64_t m_NumRefractory;
+    uint64_t m_NumBackground;
+};
+}   // namespace DVS
@@ -0,0 +1,105 @@
+#pragma once
+
+// Standard C includes
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// DVS::Polarity
+//----------------------------------------------------------------------------
+namespace DVS
+{
+enum class Polarity
+{
+    ON,
+    OFF,
+    BOTH,
+};
+
+// **NOTE** filters are templated on event type so they can also be applied to
+// events replayed by DVSPreRecorded which provide the same getX, getY and getPolarity
+
+//! Filter events based on their polarity
+template<Polarity polarity = Polarity::BOTH>
+struct PolarityFilter
+{
+    template<typename Event>
+    static constexpr bool shouldAllow(const Event &event)
+    {
+        return (polarity == Polarity::BOTH
+                || (polarity == Polarity::ON && event.getPolarity())
+                || (polarity == Polarity::OFF && !event.getPolarity()));
+    }
+};
+
+//! Filter events depending on whether they are in region of interest
+template<uint16_t minX, uint16_t maxX, uint16_t minY, uint16_t maxY>
+struct ROIFilter
+{
+    template<typename Event>
+    static constexpr bool shouldAllow(const Event &event)
+    {
+        return (event.getX() > minX && event.getX() < maxX 
+                && event.getY() > minY && event.getY() < maxY);
+    }
+};
+
+//! Combine two event filters
+template<typename FilterA, typename FilterB>
+struct CombineFilter
+{
+    template<typename Event>
+    static constexpr bool shouldAllow(const Event &event)
+    {
+        return (FilterA::shouldAllow(event) && FilterB::shouldAllow(event));
+    }
+};
+
+//! Don't filter any events
+struct NoFilter
+{
+    template<typename Event>
+    static constexpr bool shouldAllow(const Event&)
+    {
+        return true;
+    }
+};
+
+//! Scale event coordinate - FixedPointScale is calculated by multiplying fraction by 1^15
+template<uint32_t FixedPointScale>
+struct Scale
+{
+    static constexpr uint32_t transform(uint32_t x)
+    {
+        return (x * FixedPointScale) >> 15;
+    }
+};
+
+//! Subtract value from event coordinate
+template<uint32_t Offset>
+struct Subtract
+{
+    static constexpr uint32_t transform(uint32_t x)
+    {
+        return (x - Offset);
+    }
+};
+
+//! Don't transform event coordinate
+struct NoTransform
+{
+    static constexpr uint32_t transform(uint32_t x)
+    {
+        return x;
+    }
+};
+
+//! Combine two event coordinate transformations
+template<typename TransformA, typename TransformB>
+struct CombineTransform
+{
+    static constexpr uint32_t transform(uint32_t x)
+    {
+        return TransformB::transform(TransformA::transform(x));
+    }
+};
+}   // namespace DVS
@@ -2,9 +2,13 @@
 
 // Standard C++ includes
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 // Standard C includes
+#include <cassert>
+#include <cstdint>
 #include <cstdlib>
 
 //----------------------------------------------------------------------------
@@ -52,9 +56,92 @@ public:
         // Zero spike count
         spikeCount = 0;
 
+        forEachEvent(
+            [&spikeCount, spikes, this](const Event &event)
+            {
+                // If we care about polarity and it doesn't match, skip
+                if((m_Polarity == Polarity::On && !event.getPolarity())
+                    || (m_Polarity == Polarity::Off && event.getPolarity()))
+                {
+                    return;
+                }
+
+                // Add row-major spike address
+                spikes[spikeCount++] = event.getX() + (event.getY() * m_Width);
+            });
+    }
+
+    //! Append GeNN addresses of the frame's events to addresses, filtering and transforming
+    //! them with the same filters and transforms DVS::Base uses for events from a live device
+    template<unsigned int outputSize, typename Filter, typename TransformX, typename TransformY>
+    void readEventAddresses(std::vector<uint32_t> &addresses)
+    {
+        forEachEvent(
+            [&addresses](const Event &event)
+            {
+                if(Filter::shouldAllow(event)) {
+                    addresses.push_back(TransformX::transform(event.getX())
+                                        + (TransformY::transform(event.getY()) * outputSize));
+                }
+            });
+    }
+
+    //! Append the frame's events which pass Filter to batch, to be filtered further by a DVS::EventPipeline
+    template<typename Filter, typename Batch>
+    void readEventBatch(Batch &batch)
+    {
+        forEachEvent(
+            [&batch](const Event &event)
+            {
+                if(Filter::shouldAllow(event)) {
+                    batch.add(event.timestamp, event.x, event.y, event.polarity);
+                }
+            });
+    }
+
+    //! Have all events been read?
+    bool isFinished() const
+    {
+        return m_NextLine.empty();
+    }
+
+    unsigned int getWidth() const
+    {
+        return m_Width;
+    }
+
+    unsigned int getHeight() const
+    {
+        return m_Height;
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Event
+    //------------------------------------------------------------------------
+    //! Replayed event with the same accessors as libcaer's polarity events
+    struct Event
+    {
+        uint32_t timestamp;
+        uint16_t x;
+        uint16_t y;
+        bool polarity;
+
+        uint16_t getX() const{ return x; }
+        uint16_t getY() const{ return y; }
+        bool getPolarity() const{ return polarity; }
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    template<typename Action>
+    void forEachEvent(Action action)
+    {
         // Loop through spikes in frame
+        // **NOTE** getline empties m_NextLine once there are no lines left to read
         std::string cell;
-        do
+        while(!m_NextLine.empty())
         {
             // Create string stream from line
             std::stringstream lineStream(m_NextLine);
@@ -73,52 +160,30 @@ public:
                 break;
             }
 
+            Event event;
+            event.timestamp = timestamp;
+
             // Read X coordinate
             std::getline(lineStream, cell, ',');
-            const unsigned int x = std::stoul(cell);
+            event.x = (uint16_t)std::stoul(cell);
 
             // Read Y coordinate
             std::getline(lineStream, cell, ',');
-            const unsigned int y = m_FlipY ? (127 - std::stoul(cell)) : std::stoul(cell);
+            event.y = (uint16_t)(m_FlipY ? (127 - std::stoul(cell)) : std::stoul(cell));
 
-            // Calculate row-major spike address
-            const unsigned int address = x + (y * m_Width);
+            // Read polarity - recordings without polarity column are treated as all ON (as in DVSEventFile::readCSV)
+            event.polarity = !std::getline(lineStream, cell, ',') || (std::stoul(cell) == 1);
 
-            // If we don't care about polarity
-            if(m_Polarity == Polarity::Both) {
-                spikes[spikeCount++] = address;
-            }
-            else {
-                // Read polarity
-                std::getline(lineStream, cell, ',');
-                const unsigned int polarity = std::stoul(cell);
-
-                if((m_Polarity == Polarity::On && (polarity == 1))
-                    || (m_Polarity == Polarity::Off && (polarity == 0))) {
-                    spikes[spikeCount++] = address;
-                }
-            }
+            action(event);
 
             // Read next spike into buffer
             std::getline(m_SpikeStream, m_NextLine);
         }
-        while(m_SpikeStream.good());
 
         // Update frame start timestamp for next frame
         m_FrameStartTimestamp += m_FrameDurationUs;
     }
 
-    unsigned int getWidth() const
-    {
-        return m_Width;
-    }
-
-    unsigned int getHeight() const
-    {
-        return m_Height;
-    }
-
-private:
     //------------------------------------------------------------------------
     // Members
     //------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+#pragma once
+
+// Standard C++ includes
+#include <stdexcept>
+#include <string>
+
+// Standard C includes
+#include <cstdint>
+
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Common includes
+#include "dvs_event_file.h"
+#include "dvs_pre_recorded.h"
+
+//----------------------------------------------------------------------------
+// DVSPreRecordedMapped
+//----------------------------------------------------------------------------
+//! Drop-in replacement for DVSPreRecorded which memory maps a binary event
+//! file written by DVSEventFile::write (see dvs_tools/convert_dvs_csv).
+//! If the timestep matches the frame duration the file was converted with,
+//! frames are located using the frame index, otherwise events are scanned
+class DVSPreRecordedMapped
+{
+public:
+    using Polarity = DVSPreRecorded::Polarity;
+
+    DVSPreRecordedMapped(const char *eventFilename, Polarity polarity, double dt, bool flipY = false)
+        : m_Polarity(polarity), m_FrameDurationUs((unsigned int)(dt * 1000.0)), m_FlipY(flipY),
+          m_MappedData(nullptr), m_MappedSize(0), m_Header(nullptr), m_FrameEnd(nullptr), m_Events(nullptr),
+          m_Frame(0), m_NextEvent(0)
+    {
+        // Open file and get its size
+        const int fd = open(eventFilename, O_RDONLY);
+        if(fd == -1) {
+            throw std::runtime_error(std::string(eventFilename) + " could not be opened for reading");
+        }
+        struct stat fileStat;
+        if(fstat(fd, &fileStat) == -1) {
+            close(fd);
+            throw std::runtime_error("Unable to stat " + std::string(eventFilename));
+        }
+        m_MappedSize = (size_t)fileStat.st_size;
+        if(m_MappedSize < sizeof(DVSEventFile::Header)) {
+            close(fd);
+            throw std::runtime_error(std::string(eventFilename) + " is too small to be a DVS event file");
+        }
+
+        // Map file into memory - the mapping remains valid after the descriptor is closed
+        m_MappedData = mmap(nullptr, m_MappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(m_MappedData == MAP_FAILED) {
+            m_MappedData = nullptr;
+            throw std::runtime_error("Unable to memory map " + std::string(eventFilename));
+        }
+
+        // We read through the file once so tell kernel to read ahead aggressively
+        madvise(m_MappedData, m_MappedSize, MADV_SEQUENTIAL);
+
+        // Validate header
+        const char *data = static_cast<const char*>(m_MappedData);
+        m_Header = reinterpret_cast<const DVSEventFile::Header*>(data);
+        if(m_Header->magic != DVSEventFile::magic || m_Header->version != DVSEventFile::version) {
+            unmap();
+            throw std::runtime_error(std::string(eventFilename) + " is not a version "
+                                     + std::to_string(DVSEventFile::version) + " DVS event file");
+        }
+        if(m_MappedSize != (DVSEventFile::getEventOffset(*m_Header) + (sizeof(DVSEventFile::Event) * m_Header->numEvents))) {
+            unmap();
+            throw std::runtime_error(std::string(eventFilename) + " is truncated");
+        }
+
+        m_FrameEnd = reinterpret_cast<const uint64_t*>(data + DVSEventFile::getFrameEndOffset());
+        m_Events = reinterpret_cast<const DVSEventFile::Event*>(data + DVSEventFile::getEventOffset(*m_Header));
+        m_FrameEndTimestamp = (uint64_t)m_Header->firstTimestamp + m_FrameDurationUs;
+    }
+
+    ~DVSPreRecordedMapped()
+    {
+        unmap();
+    }
+
+    DVSPreRecordedMapped(const DVSPreRecordedMapped&) = delete;
+    DVSPreRecordedMapped &operator = (const DVSPreRecordedMapped&) = delete;
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    void start()
+    {
+    }
+
+    void stop()
+    {
+    }
+
+    void readEvents(unsigned int &spikeCount, unsigned int *spikes)
+    {
+        // Determine range of events in this frame
+        const uint64_t begin = m_NextEvent;
+        uint64_t end;
+        if(m_FrameDurationUs == m_Header->frameDurationUs) {
+            end = (m_Frame < m_Header->numFrames) ? m_FrameEnd[m_Frame] : m_Header->numEvents;
+        }
+        else {
+            end = begin;
+            while(end < m_Header->numEvents && m_Events[end].timestamp <= m_FrameEndTimestamp) {
+                end++;
+            }
+        }
+
+        // Convert events to addresses
+        spikeCount = 0;
+        const unsigned int width = m_Header->width;
+        const unsigned int flipY = m_Header->height - 1;
+        for(uint64_t e = begin; e < end; e++) {
+            const DVSEventFile::Event &event = m_Events[e];
+            if(m_Polarity == Polarity::Both
+                || (m_Polarity == Polarity::On && event.getPolarity())
+                || (m_Polarity == Polarity::Off && !event.getPolarity()))
+            {
+                const unsigned int y = m_FlipY ? (flipY - event.getY()) : event.getY();
+                spikes[spikeCount++] = event.x + (y * width);
+            }
+        }
+
+        // Advance to next frame
+        m_NextEvent = end;
+        m_FrameEndTimestamp += m_FrameDurationUs;
+        m_Frame++;
+    }
+
+    //! Have all events been read?
+    bool isFinished() const
+    {
+        return (m_NextEvent == m_Header->numEvents);
+    }
+
+    unsigned int getWidth() const
+    {
+        return m_Header->width;
+    }
+
+    unsigned int getHeight() const
+    {
+        return m_Header->height;
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void unmap()
+    {
+        if(m_MappedData != nullptr) {
+            munmap(m_MappedData, m_MappedSize);
+            m_MappedData = nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const Polarity m_Polarity;
+    const unsigned int m_FrameDurationUs;
+    const bool m_FlipY;
+
+    void *m_MappedData;
+    size_t m_MappedSize;
+
+    const DVSEventFile::Header *m_Header;
+    const uint64_t *m_FrameEnd;
+    const DVSEventFile::Event *m_Events;
+
+    uint64_t m_Frame;
+    uint64_t m_NextEvent;
+    uint64_t m_FrameEndTimestamp;
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+
+// POSIX includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// IDXFile
+//----------------------------------------------------------------------------
+//! Memory-mapped view of an IDX file (the format MNIST is distributed in).
+//! The header is validated in all builds and data is accessed directly from the
+//! page cache so repeated runs on the same dataset don't copy it through a stream.
+//! If writable, data is mapped copy-on-write so it can be modified without affecting the file
+class IDXFile
+{
+public:
+    //! IDX data types - only unsigned bytes are currently supported
+    enum class Type : uint8_t
+    {
+        UnsignedByte = 0x08,
+    };
+
+    IDXFile(const std::string &filename, Type expectedType, unsigned int expectedNumDimensions, bool writable = false)
+        : m_Filename(filename), m_Writable(writable), m_MappedData(nullptr), m_MappedSize(0), m_Data(nullptr)
+    {
+        // Open file and get its size
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if(fd == -1) {
+            throw std::runtime_error(filename + " could not be opened for reading");
+        }
+        struct stat fileStat;
+        if(fstat(fd, &fileStat) == -1) {
+            close(fd);
+            throw std::runtime_error("Unable to stat " + filename);
+        }
+        m_MappedSize = (size_t)fileStat.st_size;
+        if(m_MappedSize < 4) {
+            close(fd);
+            throw std::runtime_error(filename + " is too small to be an IDX file");
+        }
+
+        // Map file into memory - the mapping remains valid after the descriptor is closed
+        m_MappedData = mmap(nullptr, m_MappedSize, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(m_MappedData == MAP_FAILED) {
+            m_MappedData = nullptr;
+            throw std::runtime_error("Unable to memory map " + filename);
+        }
+
+        try
+        {
+            // Validate magic number - two zero bytes, followed by type and number of dimensions
+            const uint8_t *bytes = static_cast<const uint8_t*>(m_MappedData);
+            if(bytes[0] != 0 || bytes[1] != 0) {
+                throw std::runtime_error(filename + " is not an IDX file");
+            }
+            if(bytes[2] != static_cast<uint8_t>(expectedType)) {
+                throw std::runtime_error(filename + " has unexpected data type " + std::to_string(bytes[2]));
+            }
+            if(bytes[3] != expectedNumDimensions) {
+                throw std::runtime_error(filename + " has " + std::to_string(bytes[3]) + " dimensions, expected "
+                                         + std::to_string(expectedNumDimensions));
+            }
+
+            // Read big-endian dimensions
+            const size_t headerSize = 4 + (4 * expectedNumDimensions);
+            if(m_MappedSize < headerSize) {
+                throw std::runtime_error(filename + " has a truncated header");
+            }
+            m_Dimensions.reserve(expectedNumDimensions);
+            for(unsigned int d = 0; d < expectedNumDimensions; d++) {
+                m_Dimensions.push_back(readBigEndian(bytes + 4 + (4 * d)));
+            }
+
+            // Check file is large enough to contain all data
+            if(m_MappedSize < (headerSize + getNumItems() * getItemSize())) {
+                throw std::runtime_error(filename + " is truncated");
+            }
+            m_Data = bytes + headerSize;
+        }
+        catch(...)
+        {
+            unmap();
+            throw;
+        }
+    }
+
+    ~IDXFile()
+    {
+        unmap();
+    }
+
+    IDXFile(const IDXFile&) = delete;
+    IDXFile &operator = (const IDXFile&) = delete;
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    const std::vector<uint32_t> &getDimensions() const{ return m_Dimensions; }
+
+    //! Number of items i.e. size of first dimension
+    size_t getNumItems() const{ return m_Dimensions.front(); }
+
+    //! Size of each item in bytes i.e. product of remaining dimensions
+    size_t getItemSize() const
+    {
+        return std::accumulate(m_Dimensions.cbegin() + 1, m_Dimensions.cend(), size_t{1},
+                               [](size_t a, uint32_t b){ return a * b; });
+    }
+
+    //! Pointer to first byte of data
+    const uint8_t *getData() const{ return m_Data; }
+
+    //! Pointer to first byte of data which can be modified - only available if file was mapped writable
+    uint8_t *getWritableData()
+    {
+        if(!m_Writable) {
+            throw std::runtime_error(m_Filename + " is not mapped writable");
+        }
+        return const_cast<uint8_t*>(m_Data);
+    }
+
+    //! Pointer to first byte of item
+    const uint8_t *getItem(size_t item) const{ return m_Data + (item * getItemSize()); }
+
+    //! Hint that items will be accessed soon so kernel can start reading them in
+    void prefetch(size_t firstItem, size_t numItems) const
+    {
+        advise(firstItem, numItems, MADV_WILLNEED);
+    }
+
+    //! Hint that items won't be accessed again so their pages can be reclaimed -
+    //! allows datasets larger than memory to be streamed through in chunks
+    //! **NOTE** any modifications made to the items through a writable mapping are discarded
+    void release(size_t firstItem, size_t numItems) const
+    {
+        advise(firstItem, numItems, MADV_DONTNEED);
+    }
+
+    const std::string &getFilename() const{ return m_Filename; }
+    bool isWritable() const{ return m_Writable; }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    static uint32_t readBigEndian(const uint8_t *bytes)
+    {
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+    }
+
+    void advise(size_t firstItem, size_t numItems, int advice) const
+    {
+        // Clamp range to data and round start down to page boundary as madvise requires
+        numItems = std::min(numItems, getNumItems() - std::min(firstItem, getNumItems()));
+        if(numItems == 0) {
+            return;
+        }
+        const uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+        const uintptr_t begin = (uintptr_t)getItem(firstItem) & ~(pageSize - 1);
+        const uintptr_t end = (uintptr_t)getItem(firstItem + numItems);
+        madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+    }
+
+    void unmap()
+    {
+        if(m_MappedData != nullptr) {
+            munmap(m_MappedData, m_MappedSize);
+            m_MappedData = nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const std::string m_Filename;
+    const bool m_Writable;
+    void *m_MappedData;
+    size_t m_MappedSize;
+    const uint8_t *m_Data;
+    std::vector<uint32_t> m_Dimensions;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// LatencyHistogram
+//----------------------------------------------------------------------------
+//! Histogram of latencies with logarithmically-spaced bins (binsPerOctave per doubling from 1us)
+//! so sub-millisecond stages and multi-second stalls are recorded with the same relative precision
+//! and recording a sample is a constant-time increment, cheap enough to do every timestep
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()
+        : m_Counts(numBins, 0), m_Count(0), m_Sum(0.0), m_Min(std::numeric_limits<double>::max()), m_Max(0.0)
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    void record(double seconds)
+    {
+        m_Counts[getBin(seconds)]++;
+        m_Count++;
+        m_Sum += seconds;
+        m_Min = std::min(m_Min, seconds);
+        m_Max = std::max(m_Max, seconds);
+    }
+
+    uint64_t getCount() const{ return m_Count; }
+    double getMean() const{ return (m_Count == 0) ? 0.0 : (m_Sum / (double)m_Count); }
+    double getMin() const{ return (m_Count == 0) ? 0.0 : m_Min; }
+    double getMax() const{ return m_Max; }
+
+    //! Get upper edge of bin containing the p'th percentile
+    double getPercentile(double p) const
+    {
+        const uint64_t rank = (uint64_t)std::ceil((p / 100.0) * (double)m_Count);
+        uint64_t cumulative = 0;
+        for(unsigned int b = 0; b < numBins; b++) {
+            cumulative += m_Counts[b];
+            if(cumulative >= rank && cumulative > 0) {
+                return std::min(getBinUpperEdge(b), m_Max);
+            }
+        }
+        return m_Max;
+    }
+
+    //! Write as JSON object with summary statistics in microseconds and non-empty bins. Bins are
+    //! written as [upper edge, count] with the overflow bin's edge written as the maximum latency
+    void writeJSON(std::ostream &os) const
+    {
+        os << "{\"count\": " << m_Count << ", \"mean_us\": " << getMean() * 1.0E6
+           << ", \"min_us\": " << getMin() * 1.0E6 << ", \"p50_us\": " << getPercentile(50.0) * 1.0E6
+           << ", \"p90_us\": " << getPercentile(90.0) * 1.0E6 << ", \"p99_us\": " << getPercentile(99.0) * 1.0E6
+           << ", \"max_us\": " << getMax() * 1.0E6 << ", \"bins\": [";
+        bool first = true;
+        for(unsigned int b = 0; b < numBins; b++) {
+            if(m_Counts[b] > 0) {
+                const double upperEdge = (b == (numBins - 1)) ? m_Max : getBinUpperEdge(b);
+                os << (first ? "" : ", ") << "[" << upperEdge * 1.0E6 << ", " << m_Counts[b] << "]";
+                first = false;
+            }
+        }
+        os << "]}";
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Constants
+    //------------------------------------------------------------------------
+    //! Bins cover 1us to 2^27us (~134s), with the first and last bins catching anything outside
+    static constexpr unsigned int binsPerOctave = 8;
+    static constexpr unsigned int numOctaves = 27;
+    static constexpr unsigned int numBins = (binsPerOctave * numOctaves) + 2;
+
+    //------------------------------------------------------------------------
+    // Private static methods
+    //------------------------------------------------------------------------
+    static unsigned int getBin(double seconds)
+    {
+        const double us = seconds * 1.0E6;
+        if(us < 1.0) {
+            return 0;
+        }
+        const unsigned int b = 1 + (unsigned int)(std::log2(us) * (double)binsPerOctave);
+        return std::min(b, numBins - 1);
+    }
+
+    static double getBinUpperEdge(unsigned int b)
+    {
+        return (b == (numBins - 1)) ? std::numeric_limits<double>::infinity() : std::exp2((double)b / (double)binsPerOctave) * 1.0E-6;
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    std::vector<uint64_t> m_Counts;
+    uint64_t m_Count;
+    double m_Sum;
+    double m_Min;
+    double m_Max;
+};
+
+//----------------------------------------------------------------------------
+// LatencyReport
+//----------------------------------------------------------------------------
+//! Named latency histograms for each stage of a simulation loop along with metadata
+//! describing the run, written as a JSON report which benchmark scripts can compare
+class LatencyReport
+{
+public:
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Add stage - the returned histogram remains valid for the lifetime of the report
+    LatencyHistogram &addStage(const std::string &name)
+    {
+        m_Stages.emplace_back(name, LatencyHistogram());
+        return m_Stages.back().second;
+    }
+
+    void setMetadata(const std::string &name, const std::string &value)
+    {
+        m_Metadata.emplace_back(name, "\"" + escape(value) + "\"");
+    }
+
+    void setMetadata(const std::string &name, double value)
+    {
+        std::ostringstream stream;
+        stream << value;
+        m_Metadata.emplace_back(name, stream.str());
+    }
+
+    void write(const std::string &filename) const
+    {
+        std::ofstream os(filename);
+        if(!os.good()) {
+            throw std::runtime_error("Cannot open '" + filename + "' to write latency report");
+        }
+
+        os << "{" << std::endl;
+        for(const auto &m : m_Metadata) {
+            os << "    \"" << escape(m.first) << "\": " << m.second << "," << std::endl;
+        }
+        os << "    \"stages\": {" << std::endl;
+        for(size_t s = 0; s < m_Stages.size(); s++) {
+            os << "        \"" << escape(m_Stages[s].first) << "\": ";
+            m_Stages[s].second.writeJSON(os);
+            os << ((s == (m_Stages.size() - 1)) ? "" : ",") << std::endl;
+        }
+        os << "    }" << std::endl;
+        os << "}" << std::endl;
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Private static methods
+    //------------------------------------------------------------------------
+    static std::string escape(const std::string &value)
+    {
+        std::string escaped;
+        for(char c : value) {
+            if(c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    //! **NOTE** deque so references returned by addStage aren't invalidated by adding more stages
+    std::deque<std::pair<std::string, LatencyHistogram>> m_Stages;
+    std::vector<std::pair<std::string, std::string>> m_Metadata;
+};
+
+//----------------------------------------------------------------------------
+// LatencyTimer
+//----------------------------------------------------------------------------
+//! Records time between construction and destruction in histogram
+class LatencyTimer
+{
+public:
+    typedef std::chrono::high_resolution_clock Clock;
+
+    LatencyTimer(LatencyHistogram &histogram)
+        : m_Histogram(histogram), m_Start(Clock::now())
+    {
+    }
+
+    ~LatencyTimer()
+    {
+        m_Histogram.record(std::chrono::duration<double>(Clock::now() - m_Start).count());
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer &operator = (const LatencyTimer&) = delete;
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    LatencyHistogram &m_Histogram;
+    const Clock::time_point m_Start;
+};
@@ -1,74 +1,117 @@
 #pragma once
 
 // Standard C++ includes
+#include <algorithm>
 #include <fstream>
+#include <stdexcept>
+#include <string>
 
 // Standard C includes
 #include <cassert>
-
-inline uint32_t readBigEndian(std::ifstream &data)
+#include <cstring>
+
+// Common includes
+#include "idx_file.h"
+
+// GeNN's CPU backend has no separate device memory so, rather than being allocated and
+// copied into, EGPs can simply point at the memory-mapped file. This must be enabled explicitly
+// by defining MNIST_EGP_ALIASES_HOST (e.g. building with make CPU_ONLY=1) when the model
+// was generated for the CPU backend and images must then be mapped writable
+#ifdef MNIST_EGP_ALIASES_HOST
+constexpr bool mnistEGPAliasesHost = true;
+#else
+constexpr bool mnistEGPAliasesHost = false;
+#endif
+
+//! Check mapped MNIST image file contains 28x28 images
+inline void validateImageData(const IDXFile &imageData)
 {
-    union
-    {
-        char b[4];
-        uint32_t w;
-    } swizzle;
-
-    // Read data into swizzle union
-    data.read(&swizzle.b[0], 4);
-
-    // Swap endianess
-    std::swap(swizzle.b[0], swizzle.b[3]);
-    std::swap(swizzle.b[1], swizzle.b[2]);
-    return swizzle.w;
+    const auto &dims = imageData.getDimensions();
+    if(dims[1] != 28 || dims[2] != 28) {
+        throw std::runtime_error(imageData.getFilename() + " contains " + std::to_string(dims[1]) + "x"
+                                 + std::to_string(dims[2]) + " images, expected 28x28");
+    }
 }
 
-inline unsigned int loadImageData(const std::string &imageDatafilename, uint8_t *&egp, 
+//! Point EGP at mapped image data if mnistEGPAliasesHost is set, otherwise allocate it and copy
+//! from the mapping. imageData must outlive any use of the EGP
+inline unsigned int loadImageData(IDXFile &imageData, uint8_t *&egp,
                                   void (*allocateEGPFn)(unsigned int), void (*pushEGPFn)(unsigned int))
 {
-    // Open binary file
-    std::ifstream imageData(imageDatafilename, std::ifstream::binary);
-    assert(imageData.good());
-
-    // Read header words
-    const uint32_t magic = readBigEndian(imageData);
-    const uint32_t numImages = readBigEndian(imageData);
-    const uint32_t numRows = readBigEndian(imageData);
-    const uint32_t numCols = readBigEndian(imageData);
-
-    // Validate header words
-    assert(magic == 0x803);
-    assert(numRows == 28);
-    assert(numCols == 28);
-
-    // Allocate EGP for data
-    allocateEGPFn(numRows * numCols * numImages);
-
-    // Read data into EGP
-    imageData.read(reinterpret_cast<char*>(egp), numRows * numCols * numImages);
+    validateImageData(imageData);
+
+    const unsigned int numBytes = imageData.getNumItems() * imageData.getItemSize();
+#ifdef MNIST_EGP_ALIASES_HOST
+    // Alias mapped data - it is mapped copy-on-write so, although the model only
+    // ever reads from dataset EGPs, any writes will not fault or reach the file
+    if(!imageData.isWritable()) {
+        throw std::runtime_error(imageData.getFilename() + " must be mapped writable to alias EGP");
+    }
+    egp = imageData.getWritableData();
+    (void)allocateEGPFn;
+#else
+    // Allocate EGP for data, copy from mapping and push
+    allocateEGPFn(numBytes);
+    std::memcpy(egp, imageData.getData(), numBytes);
+#endif
+    pushEGPFn(numBytes);
+
+    return imageData.getNumItems();
+}
 
-    // Push EGP
-    pushEGPFn(numRows * numCols * numImages);
+inline unsigned int loadImageData(const std::string &imageDatafilename, uint8_t *&egp,
+                                  void (*allocateEGPFn)(unsigned int), void (*pushEGPFn)(unsigned int))
+{
+    // Map and validate file
+    IDXFile imageData(imageDatafilename, IDXFile::Type::UnsignedByte, 3);
+    validateImageData(imageData);
+
+    // Allocate EGP for data, copy from mapping and push
+    // **NOTE** the mapping doesn't outlive this function so can't be aliased
+    const unsigned int numBytes = imageData.getNumItems() * imageData.getItemSize();
+    allocateEGPFn(numBytes);
+    std::memcpy(egp, imageData.getData(), numBytes);
+    pushEGPFn(numBytes);
+
+    return imageData.getNumItems();
+}
 
-    return numImages;
+//! Copy a chunk of images into an EGP previously allocated with space for numImages images.
+//! Pages belonging to the previous chunk are released and the next chunk prefetched so datasets
+//! larger than memory can be streamed by loading chunks at e.g. batch boundaries
+inline unsigned int loadImageChunk(const IDXFile &imageData, unsigned int firstImage, unsigned int numImages,
+                                   uint8_t *egp, void (*pushEGPFn)(unsigned int))
+{
+    validateImageData(imageData);
+    if(firstImage >= imageData.getNumItems()) {
+        return 0;
+    }
+
+    // Copy images in chunk into EGP and push
+    const unsigned int numChunkImages = std::min<unsigned int>(numImages, imageData.getNumItems() - firstImage);
+    const unsigned int numChunkBytes = numChunkImages * imageData.getItemSize();
+    std::memcpy(egp, imageData.getItem(firstImage), numChunkBytes);
+    pushEGPFn(numChunkBytes);
+
+    // Release previous chunk and prefetch next
+    if(firstImage >= numImages) {
+        imageData.release(firstImage - numImages, numImages);
+    }
+    imageData.prefetch(firstImage + numImages, numImages);
+    return numChunkImages;
 }
 
 inline void loadLabelData(const std::string &labelDataFilename, unsigned int desiredNumLabels, uint8_t *egp)
 {
-    // Open binary file
-    std::ifstream labelData(labelDataFilename, std::ifstream::binary);
-    assert(labelData.good());
-
-    // Read header words
-    const uint32_t magic = readBigEndian(labelData);
-    const uint32_t numLabels = readBigEndian(labelData);
-
-    // Validate header words
-    assert(magic == 0x801);
-    assert(numLabels == desiredNumLabels);
-    
-    // Read data into EGP
-    labelData.read(reinterpret_cast<char *>(egp), numLabels);
+    // Map and validate file
+    IDXFile labelData(labelDataFilename, IDXFile::Type::UnsignedByte, 1);
+    if(labelData.getNumItems() != desiredNumLabels) {
+        throw std::runtime_error(labelDataFilename + " contains " + std::to_string(labelData.getNumItems())
+                                 + " labels, expected " + std::to_string(desiredNumLabels));
+    }
+
+    // Copy data into EGP
+    std::memcpy(egp, labelData.getData(), desiredNumLabels);
 }
 
 inline void loadLabelData(const std::string &labelDataFilename, unsigned int desiredNumLabels, uint8_t *&egp,
@@ -86,12 +129,12 @@ inline void loadLabelData(const std::string &labelDataFilename, unsigned int des
 
 inline void loadDense(const std::string &weightFilename, scalar *weights, unsigned int count)
 {
-    std::ifstream file(weightFilename, std::ifstream::binary);    
+    std::ifstream file(weightFilename, std::ifstream::binary);
     file.read(reinterpret_cast<char*>(weights), sizeof(scalar) * count);
 }
 
 inline void saveDense(const std::string &weightFilename, const scalar *weights, unsigned int count)
 {
-    std::ofstream file(weightFilename, std::ifstream::binary);    
+    std::ofstream file(weightFilename, std::ifstream::binary);
     file.write(reinterpret_cast<const char*>(weights), sizeof(scalar) * count);
-}
\ No newline at end of file
+}
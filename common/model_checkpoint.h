@@ -0,0 +1,551 @@
+#pragma once
+
+// Standard C++ includes
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// POSIX includes
+#include <dlfcn.h>
+#include <link.h>
+
+//----------------------------------------------------------------------------
+// ModelCheckpoint
+//----------------------------------------------------------------------------
+//! Saves and restores the complete state of a GeNN model - state variables, optimiser
+//! moments, spikes, extra global parameters, host RNGs and any host-side values the
+//! simulation loop depends on - to a single binary file so training can be resumed
+//! bit-exactly. Arrays are found by name using a symbol lookup function so this works with
+//! both SharedLibraryModel::getSymbol and dlsym on the statically-linked generated code.
+//! If the names of the arrays the generated code exports are also provided, state GeNN
+//! names internally can be found and checkComplete can verify nothing has been missed.
+//! Saving pulls everything from the device and copies it into a staging buffer before
+//! returning; the file itself is written on a background thread.
+//! **NOTE** GeNN provides no way of transferring device RNG state so, on GPU backends,
+//! models which call $(gennrand_XXX) during simulation will diverge after restoring
+class ModelCheckpoint
+{
+public:
+    typedef std::function<void*(const std::string&)> GetSymbolFn;
+
+    //! Spike time arrays GeNN can maintain for each neuron population
+    enum class SpikeTime
+    {
+        Spike,
+        PreviousSpike,
+        SpikeEvent,
+        PreviousSpikeEvent,
+    };
+
+    //! "GCKP" in little-endian byte order
+    static constexpr uint32_t magic = 0x504B4347;
+    static constexpr uint32_t version = 1;
+
+    ModelCheckpoint(GetSymbolFn getSymbol, const std::vector<std::string> &exportedArrays = {})
+    :   m_GetSymbol(getSymbol), m_ExportedArrays(exportedArrays)
+    {
+    }
+
+    //! **NOTE** callers should call wait() before destruction so errors writing the last
+    //! checkpoint are reported - destructors can't throw so here they can only be logged
+    ~ModelCheckpoint()
+    {
+        try {
+            wait();
+        }
+        catch(const std::exception &ex) {
+            std::cerr << "Checkpoint not written: " << ex.what() << std::endl;
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Add state variables of a neuron, synapse or custom update population, each with count elements of type T
+    template<typename T>
+    void addVars(const std::string &popName, size_t count, const std::vector<std::string> &varNames)
+    {
+        for(const auto &v : varNames) {
+            addArray(v + popName, count * sizeof(T), "pull" + v + popName + "FromDevice", "push" + v + popName + "ToDevice");
+        }
+    }
+
+    //! Add the postsynaptic input of the synapse populations targetting a neuron population. If GeNN has
+    //! merged their postsynaptic models, the merged models' inputs are found in the exported arrays
+    template<typename T>
+    void addInSyn(const std::string &targetPopName, size_t numNeurons, const std::vector<std::string> &synapsePopNames)
+    {
+        // Add inputs of synapse populations which haven't been merged
+        std::vector<std::string> mergedPopNames;
+        for(const auto &s : synapsePopNames) {
+            if(m_GetSymbol("inSyn" + s) == nullptr) {
+                mergedPopNames.push_back(s);
+            }
+            else {
+                addVars<T>(s, numNeurons, {"inSyn"});
+            }
+        }
+
+        // If any were merged, add inputs of merged models targetting population
+        // **NOTE** GeNN names these 'Merged<N>_<target population>'
+        if(!mergedPopNames.empty()) {
+            const std::string suffix = "_" + targetPopName;
+            bool found = false;
+            for(const auto &a : m_ExportedArrays) {
+                if(a.compare(0, 11, "inSynMerged") == 0 && a.size() > (11 + suffix.size())
+                   && a.compare(a.size() - suffix.size(), suffix.size(), suffix) == 0
+                   && a.find_first_not_of("0123456789", 11) == (a.size() - suffix.size()))
+                {
+                    addVars<T>(a.substr(5), numNeurons, {"inSyn"});
+                    found = true;
+                }
+            }
+            if(!found) {
+                throw std::runtime_error("Cannot find postsynaptic input of '" + mergedPopNames.front() + "' to checkpoint");
+            }
+        }
+    }
+
+    //! Add current spikes of a neuron population, so they are propagated after restoring
+    void addSpikes(const std::string &popName, size_t numNeurons, size_t numDelaySlots = 1)
+    {
+        const std::string pull = "pull" + popName + "SpikesFromDevice";
+        const std::string push = "push" + popName + "SpikesToDevice";
+        addArray("glbSpkCnt" + popName, numDelaySlots * sizeof(unsigned int), pull, push);
+        addArray("glbSpk" + popName, numDelaySlots * numNeurons * sizeof(unsigned int), pull, push);
+    }
+
+    //! Add current spike-like events of a neuron population
+    void addSpikeEvents(const std::string &popName, size_t numNeurons, size_t numDelaySlots = 1)
+    {
+        const std::string pull = "pull" + popName + "SpikeEventsFromDevice";
+        const std::string push = "push" + popName + "SpikeEventsToDevice";
+        addArray("glbSpkCntEvnt" + popName, numDelaySlots * sizeof(unsigned int), pull, push);
+        addArray("glbSpkEvnt" + popName, numDelaySlots * numNeurons * sizeof(unsigned int), pull, push);
+    }
+
+    //! Add spike times of a neuron population, stored using type T
+    template<typename T>
+    void addSpikeTimes(const std::string &popName, size_t numNeurons, SpikeTime spikeTime = SpikeTime::Spike,
+                       size_t numDelaySlots = 1)
+    {
+        static const std::pair<const char*, const char*> names[] = {
+            {"sT", "SpikeTimes"}, {"prevST", "PreviousSpikeTimes"},
+            {"seT", "SpikeEventTimes"}, {"prevSET", "PreviousSpikeEventTimes"}};
+        const auto &n = names[static_cast<int>(spikeTime)];
+        addArray(n.first + popName, numDelaySlots * numNeurons * sizeof(T),
+                 "pull" + popName + n.second + "FromDevice", "push" + popName + n.second + "ToDevice");
+    }
+
+    //! Add a pointer extra global parameter with count elements of type T. If it
+    //! hasn't been allocated when restoring, it is allocated to match the checkpoint
+    template<typename T>
+    void addEGP(const std::string &egpName, size_t count = 0)
+    {
+        typedef void (*TransferFn)(unsigned int);
+        TransferFn allocate = reinterpret_cast<TransferFn>(getRequiredSymbol("allocate" + egpName));
+        TransferFn pull = reinterpret_cast<TransferFn>(getRequiredSymbol("pull" + egpName + "FromDevice"));
+        TransferFn push = reinterpret_cast<TransferFn>(getRequiredSymbol("push" + egpName + "ToDevice"));
+        void **hostPointer = static_cast<void**>(getRequiredSymbol(egpName));
+
+        // Count is shared between transfer functions and entry so it can be updated on restore
+        auto sharedCount = std::make_shared<size_t>(count);
+        m_Pull.push_back([pull, sharedCount](){ pull((unsigned int)*sharedCount); });
+        m_Push.push_back([push, sharedCount](){ push((unsigned int)*sharedCount); });
+        addEntry(egpName,
+                 [hostPointer, sharedCount, egpName](std::vector<char> &buffer)
+                 {
+                     const char *data = static_cast<const char*>(*hostPointer);
+                     if(data == nullptr) {
+                         throw std::runtime_error("'" + egpName + "' has not been allocated");
+                     }
+                     buffer.insert(buffer.end(), data, data + (*sharedCount * sizeof(T)));
+                 },
+                 [hostPointer, sharedCount, allocate, egpName](const char *data, size_t size)
+                 {
+                     if(*hostPointer == nullptr) {
+                         *sharedCount = size / sizeof(T);
+                         allocate((unsigned int)*sharedCount);
+                     }
+                     checkSize(egpName, size, *sharedCount * sizeof(T));
+                     std::memcpy(*hostPointer, data, size);
+                 });
+    }
+
+    //! Add host value such as a scalar extra global parameter, the model time or a loop counter
+    template<typename T>
+    void addValue(const std::string &name, T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be checkpointed");
+        addEntry(name,
+                 [&value](std::vector<char> &buffer)
+                 {
+                     const char *bytes = reinterpret_cast<const char*>(&value);
+                     buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+                 },
+                 [&value, name](const char *data, size_t size)
+                 {
+                     checkSize(name, size, sizeof(T));
+                     std::memcpy(&value, data, sizeof(T));
+                 });
+    }
+
+    //! Add host RNG, serialised using its stream operators
+    template<typename RNG>
+    void addRNG(const std::string &name, RNG &rng)
+    {
+        addEntry(name,
+                 [&rng](std::vector<char> &buffer)
+                 {
+                     std::ostringstream stream;
+                     stream << rng;
+                     const std::string state = stream.str();
+                     buffer.insert(buffer.end(), state.cbegin(), state.cend());
+                 },
+                 [&rng, name](const char *data, size_t size)
+                 {
+                     std::istringstream stream(std::string(data, size));
+                     stream >> rng;
+                     if(stream.fail()) {
+                         throw std::runtime_error("Unable to restore RNG '" + name + "'");
+                     }
+                 });
+    }
+
+    //! Add GeNN's host RNG, used by CPU backends for all random number generation, if model has one
+    bool addHostRNG()
+    {
+        void *hostRNG = m_GetSymbol("hostRNG");
+        if(hostRNG == nullptr) {
+            return false;
+        }
+        addRNG("hostRNG", *static_cast<std::mt19937*>(hostRNG));
+        return true;
+    }
+
+    //! Check that every exported array GeNN can transfer individually to the device has been
+    //! added, other than those in ignore e.g. datasets which are reloaded rather than restored
+    void checkComplete(const std::set<std::string> &ignore = {}) const
+    {
+        if(m_ExportedArrays.empty()) {
+            throw std::runtime_error("Exported arrays are required to check checkpoint is complete");
+        }
+
+        std::string missing;
+        for(const auto &a : m_ExportedArrays) {
+            if(m_Names.find(a) == m_Names.cend() && ignore.find(a) == ignore.cend()
+               && m_GetSymbol("push" + a + "ToDevice") != nullptr)
+            {
+                missing += " '" + a + "'";
+            }
+        }
+        if(!missing.empty()) {
+            throw std::runtime_error("Model state not checkpointed:" + missing);
+        }
+    }
+
+    //! Pull everything from device and write to filename in the background
+    void save(const std::string &filename)
+    {
+        // Wait for previous checkpoint to be written so staging buffer can be reused
+        wait();
+
+        for(const auto &p : m_Pull) {
+            p();
+        }
+
+        // Build checkpoint in staging buffer - header followed by aligned entries
+        m_Staging.clear();
+        const Header header{magic, version, m_Entries.size()};
+        append(&header, sizeof(Header));
+        for(const auto &e : m_Entries) {
+            EntryHeader entryHeader{(uint32_t)e.name.size(), 0, 0};
+            const size_t entryHeaderOffset = m_Staging.size();
+            append(&entryHeader, sizeof(EntryHeader));
+            append(e.name.data(), e.name.size());
+
+            // Serialise entry, then go back and fill in its size
+            const size_t dataOffset = m_Staging.size();
+            e.snapshot(m_Staging);
+            entryHeader.dataBytes = m_Staging.size() - dataOffset;
+            std::memcpy(&m_Staging[entryHeaderOffset], &entryHeader, sizeof(EntryHeader));
+            m_Staging.resize(align(m_Staging.size()), 0);
+        }
+
+        // Write to temporary file and rename so an interrupted job can't leave a truncated checkpoint behind
+        m_Writer = std::async(std::launch::async,
+            [this, filename]()
+            {
+                const std::string tmpFilename = filename + ".tmp";
+                {
+                    std::ofstream file(tmpFilename, std::ofstream::binary);
+                    file.write(m_Staging.data(), m_Staging.size());
+                    if(!file.good()) {
+                        throw std::runtime_error("Error writing " + tmpFilename);
+                    }
+                }
+
+                if(rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+                    throw std::runtime_error("Unable to rename " + tmpFilename + " to " + filename);
+                }
+            });
+    }
+
+    //! Block until the last checkpoint has been written, rethrowing any error encountered while writing it
+    void wait()
+    {
+        if(m_Writer.valid()) {
+            m_Writer.get();
+        }
+    }
+
+    //! Read checkpoint from filename and push everything to device
+    void restore(const std::string &filename)
+    {
+        wait();
+
+        std::ifstream file(filename, std::ifstream::binary);
+        if(!file.good()) {
+            throw std::runtime_error("Cannot open checkpoint " + filename);
+        }
+        const std::vector<char> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        size_t offset = 0;
+        auto read = [&data, &offset, &filename](size_t size)
+        {
+            if((offset + size) > data.size()) {
+                throw std::runtime_error(filename + " is truncated");
+            }
+            const char *ptr = &data[offset];
+            offset += size;
+            return ptr;
+        };
+
+        // Check header
+        Header header;
+        std::memcpy(&header, read(sizeof(Header)), sizeof(Header));
+        if(header.magic != magic || header.version != version) {
+            throw std::runtime_error(filename + " is not a compatible checkpoint");
+        }
+
+        // Index entries by name
+        std::map<std::string, std::pair<const char*, size_t>> entries;
+        for(uint64_t i = 0; i < header.numEntries; i++) {
+            EntryHeader entryHeader;
+            std::memcpy(&entryHeader, read(sizeof(EntryHeader)), sizeof(EntryHeader));
+            const std::string name(read(entryHeader.nameLength), entryHeader.nameLength);
+            entries.emplace(name, std::make_pair(read(entryHeader.dataBytes), (size_t)entryHeader.dataBytes));
+            offset = align(offset);
+        }
+
+        // Check checkpoint doesn't contain state which isn't going to be restored
+        for(const auto &e : entries) {
+            if(m_Names.find(e.first) == m_Names.cend()) {
+                throw std::runtime_error(filename + " contains '" + e.first + "' which isn't checkpointed by this model");
+            }
+        }
+
+        // Restore each entry
+        for(const auto &e : m_Entries) {
+            const auto entry = entries.find(e.name);
+            if(entry == entries.cend()) {
+                throw std::runtime_error(filename + " doesn't contain '" + e.name + "'");
+            }
+            e.restore(entry->second.first, entry->second.second);
+        }
+
+        for(const auto &p : m_Push) {
+            p();
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Static API
+    //------------------------------------------------------------------------
+    //! Get names of the arrays exported by the shared library or executable containing symbol, by reading its dynamic symbol table
+    static std::vector<std::string> getExportedArrays(const void *symbol)
+    {
+        Dl_info info;
+        if(symbol == nullptr || dladdr(symbol, &info) == 0 || info.dli_fname == nullptr) {
+            throw std::runtime_error("Cannot find library containing model");
+        }
+
+        // Read ELF file
+        std::ifstream file(info.dli_fname, std::ifstream::binary);
+        const std::vector<char> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        auto get = [&data, &info](size_t offset, size_t size)
+        {
+            if((offset + size) > data.size()) {
+                throw std::runtime_error(std::string(info.dli_fname) + " is not a valid ELF file");
+            }
+            return &data[offset];
+        };
+
+        ElfW(Ehdr) header;
+        std::memcpy(&header, get(0, sizeof(ElfW(Ehdr))), sizeof(ElfW(Ehdr)));
+        if(std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_shentsize != sizeof(ElfW(Shdr))) {
+            throw std::runtime_error(std::string(info.dli_fname) + " is not a valid ELF file");
+        }
+        std::vector<ElfW(Shdr)> sections(header.e_shnum);
+        std::memcpy(sections.data(), get(header.e_shoff, header.e_shnum * sizeof(ElfW(Shdr))), header.e_shnum * sizeof(ElfW(Shdr)));
+
+        // Add names of all defined data objects in dynamic symbol table
+        std::vector<std::string> names;
+        for(const auto &s : sections) {
+            if(s.sh_type == SHT_DYNSYM && s.sh_link < sections.size()) {
+                const auto &strings = sections[s.sh_link];
+                for(size_t i = 0; i < (s.sh_size / sizeof(ElfW(Sym))); i++) {
+                    ElfW(Sym) sym;
+                    std::memcpy(&sym, get(s.sh_offset + (i * sizeof(ElfW(Sym))), sizeof(ElfW(Sym))), sizeof(ElfW(Sym)));
+                    if(ELF64_ST_TYPE(sym.st_info) == STT_OBJECT && sym.st_shndx != SHN_UNDEF) {
+                        const char *name = get(strings.sh_offset + sym.st_name, 1);
+                        names.emplace_back(name, strnlen(name, data.data() + data.size() - name));
+                    }
+                }
+            }
+        }
+        return names;
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Header
+    //------------------------------------------------------------------------
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t numEntries;
+    };
+
+    struct EntryHeader
+    {
+        uint32_t nameLength;
+        uint32_t padding;
+        uint64_t dataBytes;
+    };
+
+    //------------------------------------------------------------------------
+    // Entry
+    //------------------------------------------------------------------------
+    struct Entry
+    {
+        std::string name;
+        std::function<void(std::vector<char>&)> snapshot;
+        std::function<void(const char*, size_t)> restore;
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    static size_t align(size_t offset)
+    {
+        return (offset + 7) & ~(size_t)7;
+    }
+
+    static void checkSize(const std::string &name, size_t size, size_t expectedSize)
+    {
+        if(size != expectedSize) {
+            throw std::runtime_error("Checkpointed '" + name + "' is " + std::to_string(size)
+                                     + " bytes, expected " + std::to_string(expectedSize));
+        }
+    }
+
+    void *getRequiredSymbol(const std::string &name) const
+    {
+        void *symbol = m_GetSymbol(name);
+        if(symbol == nullptr) {
+            throw std::runtime_error("Cannot find symbol '" + name + "' to checkpoint");
+        }
+        return symbol;
+    }
+
+    void append(const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char*>(data);
+        m_Staging.insert(m_Staging.end(), bytes, bytes + size);
+    }
+
+    void addEntry(const std::string &name, std::function<void(std::vector<char>&)> snapshot,
+                  std::function<void(const char*, size_t)> restore)
+    {
+        if(!m_Names.insert(name).second) {
+            throw std::runtime_error("'" + name + "' is already checkpointed");
+        }
+        m_Entries.push_back(Entry{name, snapshot, restore});
+    }
+
+    //! Add array GeNN allocates and transfers using the named functions -
+    //! several arrays are often transferred by the same function so these are only called once
+    void addArray(const std::string &name, size_t bytes, const std::string &pullName, const std::string &pushName)
+    {
+        typedef void (*TransferFn)();
+        if(m_TransferFunctions.insert(pullName).second) {
+            m_Pull.push_back(reinterpret_cast<TransferFn>(getRequiredSymbol(pullName)));
+        }
+        if(m_TransferFunctions.insert(pushName).second) {
+            m_Push.push_back(reinterpret_cast<TransferFn>(getRequiredSymbol(pushName)));
+        }
+        addPointer(name, bytes);
+    }
+
+    //! Add array pointed to by named host pointer - this is dereferenced on every
+    //! save and restore so arrays can be added before they are allocated
+    void addPointer(const std::string &name, size_t bytes)
+    {
+        void **hostPointer = static_cast<void**>(getRequiredSymbol(name));
+        auto getData = [hostPointer, name]()
+        {
+            if(*hostPointer == nullptr) {
+                throw std::runtime_error("'" + name + "' has not been allocated");
+            }
+            return static_cast<char*>(*hostPointer);
+        };
+
+        addEntry(name,
+                 [getData, bytes](std::vector<char> &buffer)
+                 {
+                     const char *data = getData();
+                     buffer.insert(buffer.end(), data, data + bytes);
+                 },
+                 [getData, bytes, name](const char *data, size_t size)
+                 {
+                     checkSize(name, size, bytes);
+                     std::memcpy(getData(), data, bytes);
+                 });
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const GetSymbolFn m_GetSymbol;
+    const std::vector<std::string> m_ExportedArrays;
+
+    std::vector<Entry> m_Entries;
+    std::set<std::string> m_Names;
+
+    //! Functions to transfer state between host and device
+    std::vector<std::function<void()>> m_Pull;
+    std::vector<std::function<void()>> m_Push;
+    std::set<std::string> m_TransferFunctions;
+
+    //! Checkpoint being written in background
+    std::vector<char> m_Staging;
+    std::future<void> m_Writer;
+};
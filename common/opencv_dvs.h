@@ -1,8 +1,20 @@
 #pragma once
 
 // Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard C includes
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 
 // OpenCV includes
 #include <opencv2/imgproc/imgproc.hpp>
@@ -18,22 +30,36 @@
 //! Uses OpenCV video capture interface to provide low-resolution, square 
 //! Image consisting of difference between frames:
 //! pipe into a layer of neurons and bob's your cheap DVS uncle
+//! **NOTE** frames are captured by a background thread which always keeps the next frame
+//! ready so camera latency and video decoding overlap with the simulation rather than stalling it
 class OpenCVDVS
 {
 public:
+    typedef std::chrono::high_resolution_clock Clock;
+
     OpenCVDVS(unsigned int device, unsigned int resolution, bool absolute)
-        : m_Camera(device), m_Resolution(resolution), m_Absolute(absolute)
+        : m_Camera(device), m_Resolution(resolution), m_Absolute(absolute), m_Live(true)
     {
-        // Check camera has opened correctly
-        if(!m_Camera.isOpened()) {
-            throw std::runtime_error("Cannot open camera");
+        startCapture();
+    }
+
+    //! Replay a video file rather than reading from a camera. Every frame is
+    //! processed, in order, with one call to update per frame
+    OpenCVDVS(const std::string &filename, unsigned int resolution, bool absolute)
+        : m_Camera(filename), m_Resolution(resolution), m_Absolute(absolute), m_Live(false)
+    {
+        startCapture();
+    }
+
+    virtual ~OpenCVDVS()
+    {
+        // Stop capture thread and wait for it to die
+        {
+            std::lock_guard<std::mutex> lock(m_CaptureMutex);
+            m_CaptureRunning = false;
         }
-        
-         // Read first frame from camera
-        readFrame();
-        
-        // Create square Region of Interest within raw frame
-        m_SquareROI = m_RawFrame(getCameraSquare());       
+        m_CaptureCondition.notify_all();
+        m_CaptureThread.join();
     }
     
     //----------------------------------------------------------------------------
@@ -51,26 +77,52 @@ public:
     {
         cv::imshow(name, m_RawFrame);
     }
+
+    //! Has the last frame of a video file been processed?
+    bool isFinished() const
+    {
+        return m_Finished;
+    }
+
+    //! Get time at which the frame the next call to update will process was captured
+    Clock::time_point getFrameTime() const
+    {
+        return m_FrameTime;
+    }
     
 protected:
     //----------------------------------------------------------------------------
     // Protected methods
     //----------------------------------------------------------------------------
+    //! Swap in the frame prefetched by the capture thread, waiting for it if necessary
     void readFrame()
     {
-        if(!m_Camera.read(m_RawFrame)) {
-            throw std::runtime_error("Cannot read first frame");
+        std::unique_lock<std::mutex> lock(m_CaptureMutex);
+        m_CaptureCondition.wait(lock, [this](){ return (m_NextFrameReady || m_CaptureFailed); });
+
+        // If capture failed, cameras have stopped working but video files have simply finished
+        if(!m_NextFrameReady) {
+            if(m_Live) {
+                throw std::runtime_error("Cannot read frame");
+            }
+            m_Finished = true;
+            return;
         }
+
+        // Swap in next frame and recreate square Region of Interest within it
+        cv::swap(m_RawFrame, m_NextFrame);
+        m_FrameTime = m_NextFrameTime;
+        m_SquareROI = m_RawFrame(m_CameraSquare);
+
+        // Wake capture thread to read the following frame
+        m_NextFrameReady = false;
+        lock.unlock();
+        m_CaptureCondition.notify_all();
     }
     
-    cv::Rect getCameraSquare()
+    cv::Rect getCameraSquare() const
     {
-        // Get frame dimensions
-        const unsigned int width = m_Camera.get(CV_CAP_PROP_FRAME_WIDTH);
-        const unsigned int height = m_Camera.get(CV_CAP_PROP_FRAME_HEIGHT);
-         
-        const unsigned int margin = (width - height) / 2;
-        return cv::Rect(cv::Point(margin, 0), cv::Point(width - margin, height));
+        return m_CameraSquare;
     }
     
     unsigned int getResolution() const
@@ -89,6 +141,71 @@ protected:
     }
     
 private:
+    //----------------------------------------------------------------------------
+    // Private methods
+    //----------------------------------------------------------------------------
+    void startCapture()
+    {
+        // Check camera has opened correctly
+        if(!m_Camera.isOpened()) {
+            throw std::runtime_error("Cannot open camera");
+        }
+
+        // Read first frame synchronously
+        if(!m_Camera.read(m_RawFrame)) {
+            throw std::runtime_error("Cannot read first frame");
+        }
+        m_FrameTime = Clock::now();
+
+        // Create square Region of Interest within raw frame
+        // **NOTE** this uses the frame rather than the capture properties as these aren't always available for files
+        const unsigned int margin = (m_RawFrame.cols - m_RawFrame.rows) / 2;
+        m_CameraSquare = cv::Rect(cv::Point(margin, 0), cv::Point(m_RawFrame.cols - margin, m_RawFrame.rows));
+        m_SquareROI = m_RawFrame(m_CameraSquare);
+
+        // Start thread to prefetch subsequent frames
+        m_NextFrameReady = false;
+        m_CaptureFailed = false;
+        m_CaptureRunning = true;
+        m_Finished = false;
+        m_CaptureThread = std::thread(&OpenCVDVS::captureThreadHandler, this);
+    }
+
+    void captureThreadHandler()
+    {
+        while(true) {
+            // Wait until last frame has been picked up
+            {
+                std::unique_lock<std::mutex> lock(m_CaptureMutex);
+                m_CaptureCondition.wait(lock, [this](){ return (!m_NextFrameReady || !m_CaptureRunning); });
+                if(!m_CaptureRunning) {
+                    return;
+                }
+            }
+
+            // Read next frame without holding lock
+            // **NOTE** m_NextFrame is only accessed by simulation thread while m_NextFrameReady is set
+            const bool success = m_Camera.read(m_NextFrame);
+            m_NextFrameTime = Clock::now();
+
+            // Mark frame as ready or capture as failed and wake simulation thread
+            {
+                std::lock_guard<std::mutex> lock(m_CaptureMutex);
+                if(success) {
+                    m_NextFrameReady = true;
+                }
+                else {
+                    m_CaptureFailed = true;
+                }
+            }
+            m_CaptureCondition.notify_all();
+
+            if(!success) {
+                return;
+            }
+        }
+    }
+
     //----------------------------------------------------------------------------
     // Members
     //----------------------------------------------------------------------------
@@ -99,32 +216,52 @@ private:
 
     // Should frame difference be absolute
     const bool m_Absolute;
+
+    // Is frame source a camera rather than a video file
+    const bool m_Live;
     
     // Full resolution, colour frame read directly from camera
     cv::Mat m_RawFrame;
+
+    // Frame prefetched by capture thread
+    cv::Mat m_NextFrame;
+
+    // Times at which raw and prefetched frames were captured
+    Clock::time_point m_FrameTime;
+    Clock::time_point m_NextFrameTime;
     
     // Square region of interest within m_RawFrame used for subsequent processing
+    cv::Rect m_CameraSquare;
     cv::Mat m_SquareROI;
+
+    // State shared with capture thread
+    std::thread m_CaptureThread;
+    std::mutex m_CaptureMutex;
+    std::condition_variable m_CaptureCondition;
+    bool m_NextFrameReady;
+    bool m_CaptureFailed;
+    bool m_CaptureRunning;
+    bool m_Finished;
 };
 
 //----------------------------------------------------------------------------
 // OpenCVDVSCPU
 //----------------------------------------------------------------------------
+//! Calculates the greyscale, downsampled frame and its difference with the previous
+//! frame in a single pass over the square region of interest of each camera frame
 class OpenCVDVSCPU : public OpenCVDVS
 {
 public:
     OpenCVDVSCPU(unsigned int device, unsigned int resolution, bool absolute=false)
         : OpenCVDVS(device, resolution, absolute)
     {
-        // Initialize and zero the two downsampled image
-        m_DownsampledFrames[0].create(getResolution(), getResolution(), CV_32FC1);
-        m_DownsampledFrames[1].create(getResolution(), getResolution(), CV_32FC1);
-        m_DownsampledFrames[0].setTo(0);
-        m_DownsampledFrames[1].setTo(0);
-        
-        // Create 3rd image to hold output
-        m_FrameDifference.create(getResolution(), getResolution(), CV_32FC1);
-        m_FrameDifference.setTo(0);
+        allocate();
+    }
+
+    OpenCVDVSCPU(const std::string &filename, unsigned int resolution, bool absolute=false)
+        : OpenCVDVS(filename, resolution, absolute)
+    {
+        allocate();
     }
     
     //----------------------------------------------------------------------------
@@ -134,28 +271,13 @@ public:
     {
         // Get references to current and previous down-sampled frame
         auto &curDownSampledFrame = m_DownsampledFrames[i % 2];
-        auto &prevDownSampledFrame = m_DownsampledFrames[(i + 1) % 2];
-        
-        // Convert square frame to floating-point using CPU
-        cv::cvtColor(getSquareROI(), m_GreyscaleFrame, CV_BGR2GRAY);
-        
-        // Convert greyscale frame to floating point
-        m_GreyscaleFrame.convertTo(m_GreyscaleFrame, CV_32FC1, 1.0 / 255.0);
+        const auto &prevDownSampledFrame = m_DownsampledFrames[(i + 1) % 2];
+
+        // Convert square frame to greyscale, downsample it and, if this isn't
+        // the first frame, calculate difference with previous frame
+        downsampleDifference(getSquareROI(), getResolution(), isAbsolute(), (i > 0), m_ColumnSums,
+                             curDownSampledFrame, prevDownSampledFrame, m_FrameDifference);
 
-        // Resample greyscale camera output into current down-sampled frame
-        cv::resize(m_GreyscaleFrame, curDownSampledFrame, 
-                   cv::Size(getResolution(), getResolution()));
-        
-        // If this isn't first frame, calculate difference with previous frame
-        if(i > 0) {
-            if(isAbsolute()) {
-                cv::absdiff(curDownSampledFrame, prevDownSampledFrame, m_FrameDifference);
-            }
-            else {
-                cv::subtract(curDownSampledFrame, prevDownSampledFrame, m_FrameDifference);
-            }
-        }
-    
         // Read next frame
         readFrame();
 
@@ -176,6 +298,8 @@ public:
 
     virtual void showGreyscaleFrame(const char *name) override
     {
+        // Full resolution greyscale frame isn't required by update so only calculate it for display
+        cv::cvtColor(getSquareROI(), m_GreyscaleFrame, CV_BGR2GRAY);
         cv::imshow(name, m_GreyscaleFrame);
     }
 
@@ -183,8 +307,81 @@ public:
     // Public API
     //----------------------------------------------------------------------------
     const cv::Mat &getFrameDifference() const{ return m_FrameDifference; }
+
+    //----------------------------------------------------------------------------
+    // Static API
+    //----------------------------------------------------------------------------
+    //! Convert BGR square frame to greyscale, average it over resolution x resolution blocks and, if
+    //! difference is set, subtract previous downsampled frame. Each row of blocks is built by adding
+    //! the bytes of its source rows into a row of per-channel column sums - a branch-free loop the
+    //! compiler vectorises - and then weighting and summing the column sums of each block
+    static void downsampleDifference(const cv::Mat &square, unsigned int resolution, bool absolute, bool difference,
+                                     std::vector<uint32_t> &columnSums, cv::Mat &downsampled,
+                                     const cv::Mat &prevDownsampled, cv::Mat &frameDifference)
+    {
+        assert(square.type() == CV_8UC3);
+
+        const size_t width = square.cols;
+        const size_t height = square.rows;
+        const size_t rowBytes = width * 3;
+        columnSums.resize(rowBytes);
+        for(unsigned int oy = 0; oy < resolution; oy++) {
+            // Sum each channel of source rows in this row of blocks
+            // **NOTE** __restrict tells the compiler the 8-bit pixels don't alias the sums so the loop can be vectorised
+            const size_t startY = (oy * height) / resolution;
+            const size_t endY = ((oy + 1) * height) / resolution;
+            uint32_t *__restrict sums = columnSums.data();
+            std::fill_n(sums, rowBytes, 0);
+            for(size_t y = startY; y < endY; y++) {
+                const uint8_t *__restrict bgr = square.ptr<uint8_t>(y);
+                for(size_t b = 0; b < rowBytes; b++) {
+                    sums[b] += bgr[b];
+                }
+            }
+
+            // Convert summed channels within each block to average greyscale value and calculate difference
+            float *out = downsampled.ptr<float>(oy);
+            const float *prev = prevDownsampled.ptr<float>(oy);
+            float *diff = frameDifference.ptr<float>(oy);
+            for(unsigned int ox = 0; ox < resolution; ox++) {
+                const size_t startX = (ox * width) / resolution;
+                const size_t endX = ((ox + 1) * width) / resolution;
+                uint64_t sumB = 0;
+                uint64_t sumG = 0;
+                uint64_t sumR = 0;
+                for(size_t x = startX; x < endX; x++) {
+                    sumB += sums[(x * 3) + 0];
+                    sumG += sums[(x * 3) + 1];
+                    sumR += sums[(x * 3) + 2];
+                }
+
+                // Apply the same BGR to greyscale weights as cv::cvtColor
+                const double scale = 1.0 / (255.0 * (double)((endX - startX) * (endY - startY)));
+                out[ox] = (float)(((0.114 * (double)sumB) + (0.587 * (double)sumG) + (0.299 * (double)sumR)) * scale);
+                if(difference) {
+                    diff[ox] = absolute ? std::fabs(out[ox] - prev[ox]) : (out[ox] - prev[ox]);
+                }
+            }
+        }
+    }
     
 private:
+    //----------------------------------------------------------------------------
+    // Private methods
+    //----------------------------------------------------------------------------
+    void allocate()
+    {
+        // Initialize and zero the two downsampled image
+        m_DownsampledFrames[0].create(getResolution(), getResolution(), CV_32FC1);
+        m_DownsampledFrames[1].create(getResolution(), getResolution(), CV_32FC1);
+        m_DownsampledFrames[0].setTo(0);
+        m_DownsampledFrames[1].setTo(0);
+
+        // Create 3rd image to hold output
+        m_FrameDifference.create(getResolution(), getResolution(), CV_32FC1);
+        m_FrameDifference.setTo(0);
+    }
+
     //----------------------------------------------------------------------------
     // Members
     //----------------------------------------------------------------------------
@@ -192,6 +389,9 @@ private:
     
     cv::Mat m_DownsampledFrames[2];
     cv::Mat m_FrameDifference;
+
+    // Per-column sums of greyscale values within current row of blocks
+    std::vector<uint32_t> m_ColumnSums;
 };
 
 //----------------------------------------------------------------------------
@@ -204,19 +404,13 @@ public:
     OpenCVDVSGPU(unsigned int device, unsigned int resolution, bool absolute=false)
         : OpenCVDVS(device, resolution, absolute)
     {
-        // Create GPU matrix to upload squared camera input into
-        auto cameraSquare = getCameraSquare();
-        m_SquareROIGPU.create(cameraSquare.width, cameraSquare.height, CV_8UC3);
-        
-        // Initialize and zero the two downsampled image
-        m_DownsampledFrames[0].create(getResolution(), getResolution(), CV_32FC1);
-        m_DownsampledFrames[1].create(getResolution(), getResolution(), CV_32FC1);
-        m_DownsampledFrames[0].setTo(0);
-        m_DownsampledFrames[1].setTo(0);
-        
-        // Create 3rd image to hold output
-        m_FrameDifference.create(getResolution(), getResolution(), CV_32FC1);
-        m_FrameDifference.setTo(0);
+        allocate();
+    }
+
+    OpenCVDVSGPU(const std::string &filename, unsigned int resolution, bool absolute=false)
+        : OpenCVDVS(filename, resolution, absolute)
+    {
+        allocate();
     }
     
     //----------------------------------------------------------------------------
@@ -291,6 +485,26 @@ public:
     const cv::cuda::GpuMat &getFrameDifference() const{ return m_FrameDifference; }
     
 private:
+    //----------------------------------------------------------------------------
+    // Private methods
+    //----------------------------------------------------------------------------
+    void allocate()
+    {
+        // Create GPU matrix to upload squared camera input into
+        auto cameraSquare = getCameraSquare();
+        m_SquareROIGPU.create(cameraSquare.width, cameraSquare.height, CV_8UC3);
+        
+        // Initialize and zero the two downsampled image
+        m_DownsampledFrames[0].create(getResolution(), getResolution(), CV_32FC1);
+        m_DownsampledFrames[1].create(getResolution(), getResolution(), CV_32FC1);
+        m_DownsampledFrames[0].setTo(0);
+        m_DownsampledFrames[1].setTo(0);
+        
+        // Create 3rd image to hold output
+        m_FrameDifference.create(getResolution(), getResolution(), CV_32FC1);
+        m_FrameDifference.setTo(0);
+    }
+
     //----------------------------------------------------------------------------
     // Members
     //----------------------------------------------------------------------------
@@ -0,0 +1,406 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// ParallelConnectors
+//----------------------------------------------------------------------------
+//! Multithreaded versions of GeNN's connectivity builders. Rather than drawing from one
+//! sequential generator, every row (or column) draws from its own counter-based random stream,
+//! keyed by (seed, row), so the connectivity built is identical whatever the number of threads.
+//! Because a stream can be regenerated for free, SPARSE projections are built in two passes -
+//! counting row lengths and then writing indices straight into the arrays allocated by GeNN
+namespace ParallelConnectors
+{
+//----------------------------------------------------------------------------
+// ParallelConnectors::RowLengthProjection
+//----------------------------------------------------------------------------
+//! Projection with FixedNumberTotal connectivity whose row lengths should be built.
+//! The stream should uniquely identify the projection within the model
+struct RowLengthProjection
+{
+    unsigned int numPre;
+    size_t numConnections;
+    unsigned int *rowLengths;
+    uint32_t stream;
+};
+
+//----------------------------------------------------------------------------
+// ParallelConnectors::Philox4x32
+//----------------------------------------------------------------------------
+//! Philox4x32-10 counter-based generator (Salmon et al. 2011). Each 128-bit counter is
+//! encrypted with a 64-bit key to give 4 random 32-bit words. The key is the seed and the
+//! counter is made up of the stream, sub-stream and the index of the block of words within it.
+//! Meets the requirements of a UniformRandomBitGenerator so can be used with standard distributions
+class Philox4x32
+{
+public:
+    typedef uint32_t result_type;
+
+    Philox4x32(uint64_t seed, uint32_t stream, uint32_t subStream = 0)
+    :   m_Key{(uint32_t)seed, (uint32_t)(seed >> 32)}, m_Stream(stream), m_SubStream(subStream), m_Block(0), m_NextWord(4)
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    static constexpr result_type min(){ return 0; }
+    static constexpr result_type max(){ return 0xFFFFFFFF; }
+
+    uint32_t operator()()
+    {
+        if(m_NextWord == 4) {
+            generateBlock();
+        }
+        return m_Words[m_NextWord++];
+    }
+
+    //! Uniformly-distributed double in (0, 1] with 53 bits of precision - safe to take log of
+    double getUniform()
+    {
+        const uint64_t high = (*this)() >> 6;
+        const uint64_t low = (*this)() >> 5;
+        return (double)((high << 27) + low + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    //! Integer in [0, n) using the multiply-shift method (bias is negligible for the small n used here)
+    uint32_t getInteger(uint32_t n)
+    {
+        return (uint32_t)(((uint64_t)(*this)() * n) >> 32);
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void generateBlock()
+    {
+        uint32_t counter[4] = {m_Block, m_SubStream, m_Stream, 0};
+        uint32_t key[2] = {m_Key[0], m_Key[1]};
+        for(unsigned int r = 0; r < 10; r++) {
+            const uint64_t product0 = (uint64_t)0xD2511F53 * counter[0];
+            const uint64_t product1 = (uint64_t)0xCD9E8D57 * counter[2];
+            const uint32_t next[4] = {(uint32_t)(product1 >> 32) ^ counter[1] ^ key[0], (uint32_t)product1,
+                                      (uint32_t)(product0 >> 32) ^ counter[3] ^ key[1], (uint32_t)product0};
+            std::copy_n(next, 4, counter);
+
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        std::copy_n(counter, 4, m_Words);
+        m_Block++;
+        m_NextWord = 0;
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const uint32_t m_Key[2];
+    const uint32_t m_Stream;
+    const uint32_t m_SubStream;
+    uint32_t m_Block;
+    uint32_t m_Words[4];
+    unsigned int m_NextWord;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+//! Number of threads to use - all hardware threads if numThreads is zero
+inline unsigned int getNumThreads(unsigned int numThreads)
+{
+    return (numThreads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : numThreads;
+}
+
+//! Split [0, numItems) into numThreads contiguous blocks and call f(thread, begin, end) for each
+//! block on its own thread (the first on the calling thread). Blocks are in thread order
+template<typename F>
+void parallelFor(unsigned int numItems, unsigned int numThreads, F f)
+{
+    const unsigned int itemsPerThread = (numItems + numThreads - 1) / numThreads;
+    std::vector<std::thread> threads;
+    for(unsigned int t = 1; t < numThreads; t++) {
+        const unsigned int begin = std::min(numItems, t * itemsPerThread);
+        const unsigned int end = std::min(numItems, begin + itemsPerThread);
+        threads.emplace_back([f, t, begin, end](){ f(t, begin, end); });
+    }
+    f(0, 0, std::min(numItems, itemsPerThread));
+
+    for(auto &t : threads) {
+        t.join();
+    }
+}
+
+//! Split numConnections synapses between rows [begin, mid) and [mid, end) of a projection, returning the number
+//! in the first half. Each split draws from a stream keyed by the projection's stream and mid, which identifies
+//! the split, so the result doesn't depend on which thread performs it or how the splits are scheduled
+inline size_t splitRowLengths(uint64_t seed, uint32_t stream, unsigned int begin, unsigned int mid, unsigned int end,
+                              size_t numConnections)
+{
+    if(numConnections == 0) {
+        return 0;
+    }
+
+    Philox4x32 rng(seed, stream, mid);
+    std::binomial_distribution<size_t> numFirstDist(numConnections, (double)(mid - begin) / (double)(end - begin));
+    return numFirstDist(rng);
+}
+
+//! Recursively distribute numConnections synapses between rows [begin, end)
+inline void buildRowLengths(uint64_t seed, uint32_t stream, unsigned int begin, unsigned int end, size_t numConnections,
+                            unsigned int *rowLengths)
+{
+    if((end - begin) == 1) {
+        rowLengths[begin] = (unsigned int)numConnections;
+    }
+    else {
+        const unsigned int mid = begin + ((end - begin) / 2);
+        const size_t numFirst = splitRowLengths(seed, stream, begin, mid, end, numConnections);
+        buildRowLengths(seed, stream, begin, mid, numFirst, rowLengths);
+        buildRowLengths(seed, stream, mid, end, numConnections - numFirst, rowLengths);
+    }
+}
+
+//! Call f(postIndex) for each target of row in a fixed probability projection. Rather than drawing
+//! a random number for every potential synapse, the gaps between synapses are drawn from a geometric
+//! distribution so the cost is proportional to the number of synapses
+template<typename F>
+void forEachFixedProbabilityTarget(unsigned int row, unsigned int numPost, double probability, uint64_t seed, F f)
+{
+    if(probability >= 1.0) {
+        for(unsigned int j = 0; j < numPost; j++) {
+            f(j);
+        }
+    }
+    else if(probability > 0.0) {
+        Philox4x32 rng(seed, row);
+        const double logProbNoConnection = std::log(1.0 - probability);
+        for(double j = -1.0;;) {
+            j += 1.0 + std::floor(std::log(rng.getUniform()) / logProbNoConnection);
+            if(j >= (double)numPost) {
+                return;
+            }
+            f((unsigned int)j);
+        }
+    }
+}
+
+//! Call f(preIndex) for each of the numSources distinct sources of column chosen using Floyd's algorithm
+template<typename F>
+void forEachFixedNumberPreSource(unsigned int column, unsigned int numPre, unsigned int numSources, uint64_t seed,
+                                 std::vector<unsigned int> &chosen, F f)
+{
+    Philox4x32 rng(seed, column);
+    chosen.clear();
+    for(unsigned int i = numPre - numSources; i < numPre; i++) {
+        const unsigned int t = rng.getInteger(i + 1);
+        chosen.push_back((std::find(chosen.cbegin(), chosen.cend(), t) == chosen.cend()) ? t : i);
+    }
+    for(unsigned int i : chosen) {
+        f(i);
+    }
+}
+
+//! Build fixed probability connectivity into a SPARSE projection, calling allocate with the number of synapses
+template<typename Projection, typename AllocateFn>
+void buildFixedProbabilityConnector(unsigned int numPre, unsigned int numPost, double probability,
+                                    Projection &projection, AllocateFn allocate, uint64_t seed, unsigned int numThreads = 0)
+{
+    numThreads = getNumThreads(numThreads);
+
+    // Count synapses in each row
+    std::vector<unsigned int> rowStart(numPre + 1, 0);
+    parallelFor(numPre, numThreads,
+                [&](unsigned int, unsigned int begin, unsigned int end)
+                {
+                    for(unsigned int i = begin; i < end; i++) {
+                        forEachFixedProbabilityTarget(i, numPost, probability, seed,
+                                                      [&rowStart, i](unsigned int){ rowStart[i + 1]++; });
+                    }
+                });
+
+    // Allocate projection and write row starts
+    std::partial_sum(rowStart.cbegin(), rowStart.cend(), rowStart.begin());
+    allocate(rowStart[numPre]);
+    std::copy(rowStart.cbegin(), rowStart.cend(), projection.indInG);
+
+    // Regenerate rows, writing targets directly into ind
+    parallelFor(numPre, numThreads,
+                [&](unsigned int, unsigned int begin, unsigned int end)
+                {
+                    for(unsigned int i = begin; i < end; i++) {
+                        auto *ind = &projection.ind[rowStart[i]];
+                        forEachFixedProbabilityTarget(i, numPost, probability, seed,
+                                                      [&ind](unsigned int j){ *ind++ = j; });
+                    }
+                });
+}
+
+//! Build connectivity where each postsynaptic neuron has numSources distinct presynaptic neurons into a
+//! SPARSE projection, calling allocate with the number of synapses. Columns are split between threads which,
+//! in the first pass, count how many synapses each row gets from their columns so, in the second pass, each
+//! can write into its own section of every row. Because blocks of columns are in order, rows are sorted
+//! by postsynaptic index exactly as if they had been built on one thread
+template<typename Projection, typename AllocateFn>
+void buildFixedNumberPreConnector(unsigned int numPre, unsigned int numPost, unsigned int numSources,
+                                  Projection &projection, AllocateFn allocate, uint64_t seed, unsigned int numThreads = 0)
+{
+    if(numSources > numPre) {
+        throw std::runtime_error("Cannot choose " + std::to_string(numSources) + " distinct sources from "
+                                 + std::to_string(numPre) + " neurons");
+    }
+
+    numThreads = getNumThreads(numThreads);
+
+    // Count synapses each thread's columns have in each row
+    std::vector<unsigned int> threadRowOffset((size_t)numThreads * numPre, 0);
+    parallelFor(numPost, numThreads,
+                [&](unsigned int t, unsigned int begin, unsigned int end)
+                {
+                    std::vector<unsigned int> chosen;
+                    unsigned int *rowCount = &threadRowOffset[(size_t)t * numPre];
+                    for(unsigned int j = begin; j < end; j++) {
+                        forEachFixedNumberPreSource(j, numPre, numSources, seed, chosen,
+                                                    [rowCount](unsigned int i){ rowCount[i]++; });
+                    }
+                });
+
+    // Allocate projection and convert counts into row starts and the offset of each thread's section of each row
+    allocate(numPost * numSources);
+    unsigned int offset = 0;
+    for(unsigned int i = 0; i < numPre; i++) {
+        projection.indInG[i] = offset;
+        for(unsigned int t = 0; t < numThreads; t++) {
+            const unsigned int count = threadRowOffset[((size_t)t * numPre) + i];
+            threadRowOffset[((size_t)t * numPre) + i] = offset;
+            offset += count;
+        }
+    }
+    projection.indInG[numPre] = offset;
+
+    // Regenerate columns, writing them directly into ind
+    parallelFor(numPost, numThreads,
+                [&](unsigned int t, unsigned int begin, unsigned int end)
+                {
+                    std::vector<unsigned int> chosen;
+                    unsigned int *rowOffset = &threadRowOffset[(size_t)t * numPre];
+                    for(unsigned int j = begin; j < end; j++) {
+                        forEachFixedNumberPreSource(j, numPre, numSources, seed, chosen,
+                                                    [&projection, rowOffset, j](unsigned int i){ projection.ind[rowOffset[i]++] = j; });
+                    }
+                });
+}
+
+//! Build numInstances identical copies of fixed number pre connectivity into a SPARSE projection, calling allocate with
+//! the number of synapses. Instance n connects presynaptic neurons [n * numPre, (n + 1) * numPre) to postsynaptic
+//! neurons [n * numPost, (n + 1) * numPost) so networks tiled into one population all get the same connectivity
+template<typename Projection, typename AllocateFn>
+void buildTiledFixedNumberPreConnector(unsigned int numInstances, unsigned int numPre, unsigned int numPost,
+                                       unsigned int numSources, Projection &projection, AllocateFn allocate,
+                                       uint64_t seed, unsigned int numThreads = 0)
+{
+    // Build connectivity of one instance
+    struct
+    {
+        unsigned int *indInG;
+        unsigned int *ind;
+    } instance;
+    std::vector<unsigned int> instanceIndInG(numPre + 1);
+    std::vector<unsigned int> instanceInd;
+    instance.indInG = instanceIndInG.data();
+    buildFixedNumberPreConnector(numPre, numPost, numSources, instance,
+                                 [&instance, &instanceInd](unsigned int n){ instanceInd.resize(n); instance.ind = instanceInd.data(); },
+                                 seed, numThreads);
+
+    // Copy it into each instance, offsetting rows and postsynaptic indices
+    const unsigned int numInstanceSynapses = instanceIndInG[numPre];
+    allocate(numInstances * numInstanceSynapses);
+    parallelFor(numInstances, getNumThreads(numThreads),
+                [&](unsigned int, unsigned int begin, unsigned int end)
+                {
+                    for(unsigned int n = begin; n < end; n++) {
+                        const unsigned int synapseOffset = n * numInstanceSynapses;
+                        const unsigned int postOffset = n * numPost;
+                        std::transform(instanceIndInG.cbegin(), instanceIndInG.cend() - 1, &projection.indInG[n * numPre],
+                                       [synapseOffset](unsigned int i){ return i + synapseOffset; });
+                        std::transform(instanceInd.cbegin(), instanceInd.cend(), &projection.ind[synapseOffset],
+                                       [postOffset](unsigned int j){ return j + postOffset; });
+                    }
+                });
+    projection.indInG[numInstances * numPre] = numInstances * numInstanceSynapses;
+}
+
+//! Distribute each projection's numConnections synapses between its rows, as GeNN's FixedNumberTotal connectivity requires.
+//! Rather than sampling each row's length from a binomial conditioned on the rows before it, rows are recursively split in
+//! half with a binomial split of the synapses between the halves. This samples exactly the same multinomial distribution
+//! but splits are independent once their parent has been sampled so projections are split breadth-first until there
+//! are enough ranges to keep every thread busy and these are then shared dynamically between threads
+inline void buildRowLengths(const std::vector<RowLengthProjection> &projections, uint64_t seed, unsigned int numThreads = 0)
+{
+    numThreads = getNumThreads(numThreads);
+
+    //! Rows of a projection and the number of synapses still to be distributed between them
+    struct Range
+    {
+        const RowLengthProjection *projection;
+        unsigned int begin;
+        unsigned int end;
+        size_t numConnections;
+    };
+
+    std::vector<Range> ranges;
+    for(const auto &p : projections) {
+        if(p.numPre > 0) {
+            ranges.push_back(Range{&p, 0, p.numPre, p.numConnections});
+        }
+        else if(p.numConnections > 0) {
+            throw std::runtime_error("Cannot distribute " + std::to_string(p.numConnections) + " synapses between no rows");
+        }
+    }
+
+    // Split ranges breadth-first until there are plenty more than threads
+    const size_t targetNumRanges = 16 * numThreads;
+    for(bool split = true; split && ranges.size() < targetNumRanges;) {
+        split = false;
+        std::vector<Range> nextRanges;
+        nextRanges.reserve(ranges.size() * 2);
+        for(const auto &r : ranges) {
+            if((r.end - r.begin) > 1) {
+                const unsigned int mid = r.begin + ((r.end - r.begin) / 2);
+                const size_t numFirst = splitRowLengths(seed, r.projection->stream, r.begin, mid, r.end, r.numConnections);
+                nextRanges.push_back(Range{r.projection, r.begin, mid, numFirst});
+                nextRanges.push_back(Range{r.projection, mid, r.end, r.numConnections - numFirst});
+                split = true;
+            }
+            else {
+                nextRanges.push_back(r);
+            }
+        }
+        ranges.swap(nextRanges);
+    }
+
+    // Recursively split ranges on each thread
+    std::atomic<size_t> nextRange{0};
+    parallelFor(numThreads, numThreads,
+                [&](unsigned int, unsigned int, unsigned int)
+                {
+                    for(size_t r = nextRange++; r < ranges.size(); r = nextRange++) {
+                        buildRowLengths(seed, ranges[r].projection->stream, ranges[r].begin, ranges[r].end,
+                                        ranges[r].numConnections, ranges[r].projection->rowLengths);
+                    }
+                });
+}
+}   // namespace ParallelConnectors
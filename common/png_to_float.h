@@ -1,104 +1,249 @@
 #pragma once
 
 // Standard C++ includes
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Standard C includes
+#include <csetjmp>
+#include <cstdint>
 #include <cstdio>
 
 // Libpng includes
 #include <png.h>
 
-
-void read_png(const std::string &filename, float scale, bool rowMajor, float *data)
+//----------------------------------------------------------------------------
+// PNGToFloat
+//----------------------------------------------------------------------------
+//! Decodes PNG images into scaled floating point data, converting any colour type or bit depth to 8-bit greyscale
+namespace PNGToFloat
 {
-    std::cout << "Loading:" << filename << std::endl;
-    // open file and test for it being a png
-    FILE *fp = fopen(filename.c_str(), "rb");
-    if (!fp) {
-        throw std::runtime_error(filename + " could not be opened for reading");
-    }
+//----------------------------------------------------------------------------
+// PNGToFloat::Decoder
+//----------------------------------------------------------------------------
+//! Decodes images one at a time, reusing the same pixel buffer for each image
+class Decoder
+{
+public:
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Decode image into numPixels floats in data, scaled so 255 maps to scale, stored in row- or column-major order
+    void decode(const std::string &filename, float scale, bool rowMajor, size_t numPixels, float *data)
+    {
+        File file;
+        file.file = fopen(filename.c_str(), "rb");
+        if(!file.file) {
+            throw std::runtime_error(filename + " could not be opened for reading");
+        }
 
-    png_byte header[8];    // 8 is the maximum size that can be checked
-    fread(header, 1, 8, fp);
-    if (png_sig_cmp(header, 0, 8)) {
-        throw std::runtime_error(filename + " is not recognized as a PNG file");
-    }
+        png_byte header[8];
+        if(fread(header, 1, 8, file.file) != 8 || png_sig_cmp(header, 0, 8)) {
+            throw std::runtime_error(filename + " is not recognized as a PNG file");
+        }
 
-    // initialize stuff
-    png_structp pngPtr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        file.png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if(!file.png) {
+            throw std::runtime_error("png_create_read_struct failed");
+        }
 
-    if (!pngPtr) {
-        throw std::runtime_error("png_create_read_struct failed");
-    }
+        file.info = png_create_info_struct(file.png);
+        if(!file.info) {
+            throw std::runtime_error("png_create_info_struct failed");
+        }
 
-    png_infop infoPtr = png_create_info_struct(pngPtr);
-    if (!infoPtr) {
-        throw std::runtime_error("png_create_info_struct failed");
-    }
+        // Decode image into pixel buffer - File's destructor cleans up however this fails
+        unsigned int width;
+        unsigned int height;
+        if(!readPixels(file, width, height)) {
+            throw std::runtime_error("Error decoding " + filename);
+        }
 
-    if (setjmp(png_jmpbuf(pngPtr))) {
-        throw std::runtime_error("Error during init_io");
-    }
+        if(((size_t)width * height) != numPixels) {
+            throw std::runtime_error(filename + " is " + std::to_string(width) + "x" + std::to_string(height)
+                                     + " pixels, expected " + std::to_string(numPixels));
+        }
 
-    png_init_io(pngPtr, fp);
-    png_set_sig_bytes(pngPtr, 8);
+        convert(m_Pixels.data(), width, height, scale, rowMajor, data);
+    }
 
-    png_read_info(pngPtr, infoPtr);
+private:
+    //------------------------------------------------------------------------
+    // File
+    //------------------------------------------------------------------------
+    //! Owns the file and libpng structures used to decode one image
+    struct File
+    {
+        File() : file(nullptr), png(nullptr), info(nullptr)
+        {
+        }
 
-    // Check format is compatible
-    if(png_get_color_type(pngPtr, infoPtr) != PNG_COLOR_TYPE_GRAY) {
-        throw std::runtime_error("Only greyscale images are supported");
-    }
-    if(png_get_bit_depth(pngPtr, infoPtr) != 8) {
-        throw std::runtime_error("Only images with 8-bit per channel are supported");
-    }
+        ~File()
+        {
+            if(png) {
+                png_destroy_read_struct(&png, info ? &info : nullptr, nullptr);
+            }
+            if(file) {
+                fclose(file);
+            }
+        }
 
-    // Read dimensions
-    const int width = png_get_image_width(pngPtr, infoPtr);
-    const int height = png_get_image_height(pngPtr, infoPtr);
-    std::cout << "\tImage width:" << width << ", height:" << height << std::endl;
+        FILE *file;
+        png_structp png;
+        png_infop info;
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    //! Read pixels of image into m_Pixels, returning false if libpng reports an error
+    //! **NOTE** libpng reports errors by longjmp-ing back to the setjmp so no objects with
+    //! destructors can be created in this function - m_Pixels and m_Rows outlive it
+    bool readPixels(File &file, unsigned int &width, unsigned int &height)
+    {
+        if(setjmp(png_jmpbuf(file.png))) {
+            return false;
+        }
 
-    // read file
-    png_read_update_info(pngPtr, infoPtr);
-    if (setjmp(png_jmpbuf(pngPtr))) {
-        throw std::runtime_error("Error during read_image");
-    }
+        png_init_io(file.png, file.file);
+        png_set_sig_bytes(file.png, 8);
+        png_read_info(file.png, file.info);
 
-    // Allocate rows
-    png_bytepp rowPointers = new png_bytep[height];
-    for (int y = 0; y < height; y++) {
-        rowPointers[y] = new png_byte[png_get_rowbytes(pngPtr, infoPtr)];
-    }
+        // Ask libpng to convert whatever format the image is in to 8-bit greyscale
+        const int colourType = png_get_color_type(file.png, file.info);
+        const int bitDepth = png_get_bit_depth(file.png, file.info);
+        if(colourType == PNG_COLOR_TYPE_PALETTE) {
+            png_set_palette_to_rgb(file.png);
+        }
+        if(colourType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
+            png_set_expand_gray_1_2_4_to_8(file.png);
+        }
+        if(bitDepth == 16) {
+            png_set_strip_16(file.png);
+        }
+        if(colourType & PNG_COLOR_MASK_ALPHA) {
+            png_set_strip_alpha(file.png);
+        }
+        if(colourType & PNG_COLOR_MASK_COLOR) {
+            png_set_rgb_to_gray_fixed(file.png, 1, -1, -1);
+        }
+        png_set_interlace_handling(file.png);
+        png_read_update_info(file.png, file.info);
 
-    // Read image
-    png_read_image(pngPtr, rowPointers);
+        width = png_get_image_width(file.png, file.info);
+        height = png_get_image_height(file.png, file.info);
+        if(png_get_rowbytes(file.png, file.info) != width) {
+            return false;
+        }
 
-    // Loop through rows
-    for (int y = 0; y < height; y++) {
-        png_bytep row = rowPointers[y];
-        for (int x = 0; x < width; x++) {
-            // Get scaled pixel value
-            float v = (scale / 255.0) * (float)row[x];
+        // Decode all rows into one contiguous buffer
+        m_Pixels.resize((size_t)width * height);
+        m_Rows.resize(height);
+        for(unsigned int y = 0; y < height; y++) {
+            m_Rows[y] = &m_Pixels[(size_t)y * width];
+        }
+        png_read_image(file.png, m_Rows.data());
+        png_read_end(file.png, nullptr);
+        return true;
+    }
 
-            // Write data to output pointer
-            if(rowMajor) {
-                data[(y * width) + x] = v;
+    //! Scale pixels into floats, transposing them in tiles if column-major
+    //! **NOTE** __restrict tells the compiler data doesn't alias pixels so conversion is vectorised
+    static void convert(const uint8_t *__restrict pixels, unsigned int width, unsigned int height,
+                        float scale, bool rowMajor, float *__restrict data)
+    {
+        const float pixelScale = scale / 255.0f;
+        if(rowMajor) {
+            const size_t numPixels = (size_t)width * height;
+            for(size_t i = 0; i < numPixels; i++) {
+                data[i] = pixelScale * (float)pixels[i];
             }
-            else {
-                data[(x * height) + y] = v;
+        }
+        else {
+            // Transpose in tiles of rows so rows being read stay in cache while columns are written
+            constexpr unsigned int tileHeight = 16;
+            for(unsigned int tileY = 0; tileY < height; tileY += tileHeight) {
+                const unsigned int tileEnd = std::min(height, tileY + tileHeight);
+                for(unsigned int x = 0; x < width; x++) {
+                    float *column = &data[((size_t)x * height)];
+                    for(unsigned int y = tileY; y < tileEnd; y++) {
+                        column[y] = pixelScale * (float)pixels[((size_t)y * width) + x];
+                    }
+                }
             }
         }
     }
 
-    // Delete rows
-    for (int y = 0; y < height; y++) {
-        delete [] rowPointers[y];
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    std::vector<png_byte> m_Pixels;
+    std::vector<png_bytep> m_Rows;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+//! Decode images into consecutive blocks of numPixels floats in data on a pool of threads
+//! (defaulting to one per hardware thread) which each take the next undecoded image
+inline void readPNGs(const std::vector<std::string> &filenames, float scale, bool rowMajor, size_t numPixels,
+                     float *data, unsigned int numThreads = 0)
+{
+    if(numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, (unsigned int)std::max<size_t>(1, filenames.size()));
+
+    std::atomic<size_t> nextImage{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker =
+        [&]()
+        {
+            try
+            {
+                Decoder decoder;
+                for(size_t i = nextImage++; i < filenames.size() && !failed; i = nextImage++) {
+                    decoder.decode(filenames[i], scale, rowMajor, numPixels, data + (i * numPixels));
+                }
+            }
+            catch(...)
+            {
+                // Stop other threads and keep first error to rethrow
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if(!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for(unsigned int t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker);
     }
-    delete [] rowPointers;
+    worker();
 
-    // Close file
-    fclose(fp);
-}
\ No newline at end of file
+    for(auto &t : threads) {
+        t.join();
+    }
+
+    if(error) {
+        std::rethrow_exception(error);
+    }
+}
+
+//! Decode a single image into numPixels floats in data
+inline void readPNG(const std::string &filename, float scale, bool rowMajor, size_t numPixels, float *data)
+{
+    Decoder decoder;
+    decoder.decode(filename, scale, rowMajor, numPixels, data);
+}
+}   // namespace PNGToFloat
@@ -0,0 +1,395 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Standard C includes
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+// POSIX includes
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+// SharedMemorySpikes
+//----------------------------------------------------------------------------
+//! Transport for spikes between simulators running as separate processes on the same machine, replacing the
+//! MUSIC ports in music.h. Each channel is a POSIX shared memory segment, created by the SharedMemorySpikeOut
+//! sending into it, containing a Header followed by a lock-free single-producer, single-consumer ring of
+//! preallocated slots. Each slot holds a window of windowTimesteps timesteps of spikes, each stored as the
+//! number of spikes followed by their IDs. The SharedMemorySpikeIn receiving from the channel delivers the
+//! spikes emitted in a timestep latencyTimesteps timesteps later so, as long as windowTimesteps is less than
+//! latencyTimesteps, windows arrive before they are needed and neither simulator waits for the other
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory spike transport requires lock-free atomics to work between processes");
+
+namespace SharedMemorySpikes
+{
+//! "GSPK" in little-endian byte order - written last by sender so receiver knows when header is valid
+constexpr uint32_t magic = 0x4B505347;
+constexpr uint32_t version = 1;
+constexpr size_t cacheLineBytes = 64;
+
+struct Header
+{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t popSize;
+    uint32_t windowTimesteps;
+    uint32_t capacity;
+    uint32_t slotWords;
+    int32_t senderPID;
+    std::atomic<int32_t> receiverPID;
+
+    // **NOTE** head and tail are on separate cache lines so sender and receiver don't contend
+    alignas(cacheLineBytes) std::atomic<uint64_t> head;
+    alignas(cacheLineBytes) std::atomic<uint64_t> tail;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+inline std::string getSharedMemoryName(const char *channelName)
+{
+    return std::string("/genn_spikes_") + channelName;
+}
+
+inline size_t getSlotsOffset()
+{
+    return ((sizeof(Header) + cacheLineBytes - 1) / cacheLineBytes) * cacheLineBytes;
+}
+
+inline size_t getSlotBytes(uint32_t slotWords)
+{
+    return (((slotWords * sizeof(uint32_t)) + cacheLineBytes - 1) / cacheLineBytes) * cacheLineBytes;
+}
+
+inline size_t getSize(uint32_t capacity, uint32_t slotWords)
+{
+    return getSlotsOffset() + (capacity * getSlotBytes(slotWords));
+}
+
+inline uint32_t *getSlot(Header *header, uint64_t index)
+{
+    return reinterpret_cast<uint32_t*>(reinterpret_cast<char*>(header) + getSlotsOffset()
+                                       + ((index % header->capacity) * getSlotBytes(header->slotWords)));
+}
+
+//! Is the process which is the other end of a channel still running?
+inline bool isAlive(int32_t pid)
+{
+    return (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+//! Spin, yielding to other threads, until ready returns true, throwing if the peer process exits
+template<typename Ready>
+void waitUntil(Ready ready, const std::atomic<int32_t> &peerPID, const char *channelName)
+{
+    for(unsigned int i = 1; !ready(); i++) {
+        // Periodically check peer - a PID of zero means it hasn't connected yet
+        if((i % 4096) == 0) {
+            const int32_t pid = peerPID.load(std::memory_order_relaxed);
+            if(pid != 0 && !isAlive(pid)) {
+                throw std::runtime_error(std::string("Process at other end of spike channel '") + channelName + "' has exited");
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+inline void throwErrno(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+}   // namespace SharedMemorySpikes
+
+//----------------------------------------------------------------------------
+// SharedMemorySpikeOut
+//----------------------------------------------------------------------------
+//! Sends the spikes emitted by a population each timestep into a shared memory channel
+class SharedMemorySpikeOut
+{
+public:
+    //! capacity is the number of windows the ring can hold - the sender only waits if the receiver is more than this far behind
+    SharedMemorySpikeOut(const char *channelName, unsigned int popSize,
+                         const unsigned int *spkCnt, const unsigned int *spk,
+                         unsigned int windowTimesteps = 1, unsigned int capacity = 16)
+    :   m_ChannelName(channelName), m_SharedMemoryName(SharedMemorySpikes::getSharedMemoryName(channelName)),
+        m_SpkCnt(spkCnt), m_Spk(spk), m_Slot(nullptr), m_SlotOffset(0), m_Timestep(0)
+    {
+        using namespace SharedMemorySpikes;
+
+        if(windowTimesteps == 0 || capacity == 0) {
+            throw std::runtime_error("Spike channel window and capacity must be at least 1");
+        }
+
+        // Remove any segment left by a previous run and create new one
+        shm_unlink(m_SharedMemoryName.c_str());
+        const int fd = shm_open(m_SharedMemoryName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if(fd == -1) {
+            throwErrno("Unable to create spike channel '" + m_ChannelName + "'");
+        }
+
+        // Size segment for windows in which every neuron spikes every timestep and map it
+        const uint32_t slotWords = windowTimesteps * (popSize + 1);
+        m_Size = getSize(capacity, slotWords);
+        if(ftruncate(fd, m_Size) == -1) {
+            close(fd);
+            throwErrno("Unable to size spike channel '" + m_ChannelName + "'");
+        }
+        void *memory = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(memory == MAP_FAILED) {
+            throwErrno("Unable to map spike channel '" + m_ChannelName + "'");
+        }
+
+        // Initialise header and publish it by setting magic
+        m_Header = new (memory) Header;
+        m_Header->version = version;
+        m_Header->popSize = popSize;
+        m_Header->windowTimesteps = windowTimesteps;
+        m_Header->capacity = capacity;
+        m_Header->slotWords = slotWords;
+        m_Header->senderPID = getpid();
+        m_Header->receiverPID.store(0, std::memory_order_relaxed);
+        m_Header->head.store(0, std::memory_order_relaxed);
+        m_Header->tail.store(0, std::memory_order_relaxed);
+        m_Header->magic.store(magic, std::memory_order_release);
+    }
+
+    ~SharedMemorySpikeOut()
+    {
+        // Send any partial window so receiver can read it
+        if(m_Slot != nullptr) {
+            m_Header->head.store(m_Header->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Unlink segment in case receiver never connected - it will already have done so otherwise
+        munmap(m_Header, m_Size);
+        shm_unlink(m_SharedMemoryName.c_str());
+    }
+
+    //----------------------------------------------------------------------------
+    // Public API
+    //----------------------------------------------------------------------------
+    //! Add this timestep's spikes to the current window, sending it if it is complete
+    void transmit()
+    {
+        // If this is the first timestep of a window, wait for a free slot
+        const unsigned int windowTimesteps = m_Header->windowTimesteps;
+        const uint64_t head = m_Header->head.load(std::memory_order_relaxed);
+        if(m_Slot == nullptr) {
+            SharedMemorySpikes::waitUntil(
+                [this, head](){ return (head - m_Header->tail.load(std::memory_order_acquire)) < m_Header->capacity; },
+                m_Header->receiverPID, m_ChannelName.c_str());
+            m_Slot = SharedMemorySpikes::getSlot(m_Header, head);
+            m_SlotOffset = 0;
+        }
+
+        // Add spikes to slot
+        const unsigned int spikeCount = m_SpkCnt[0];
+        if(spikeCount > m_Header->popSize) {
+            throw std::runtime_error("Spike count of " + std::to_string(spikeCount) + " exceeds size of population sending to '"
+                                     + m_ChannelName + "'");
+        }
+        m_Slot[m_SlotOffset++] = spikeCount;
+        std::copy_n(m_Spk, spikeCount, &m_Slot[m_SlotOffset]);
+        m_SlotOffset += spikeCount;
+
+        // If this is the last timestep of the window, make it visible to receiver
+        m_Timestep++;
+        if((m_Timestep % windowTimesteps) == 0) {
+            m_Header->head.store(head + 1, std::memory_order_release);
+            m_Slot = nullptr;
+        }
+    }
+
+private:
+    //----------------------------------------------------------------------------
+    // Members
+    //----------------------------------------------------------------------------
+    const std::string m_ChannelName;
+    const std::string m_SharedMemoryName;
+    const unsigned int * const m_SpkCnt;
+    const unsigned int * const m_Spk;
+
+    SharedMemorySpikes::Header *m_Header;
+    size_t m_Size;
+
+    uint32_t *m_Slot;
+    size_t m_SlotOffset;
+    unsigned long long m_Timestep;
+};
+
+//----------------------------------------------------------------------------
+// SharedMemorySpikeIn
+//----------------------------------------------------------------------------
+//! Receives spikes from a shared memory channel into a spike source population's spike arrays.
+//! Each tick fills them with the spikes sent latencyTimesteps - 1 timesteps earlier, so they are
+//! delivered latencyTimesteps after they were emitted (latencyTimesteps of 1 matches MUSIC with an
+//! acceptable latency of one timestep, where each simulator waits for the other every timestep)
+class SharedMemorySpikeIn
+{
+public:
+    //! Waits for the sender to create the channel. Throws if it was created for a population of a different size
+    //! or with windows too long or a ring too small to be delivered with latencyTimesteps without deadlocking
+    SharedMemorySpikeIn(const char *channelName, unsigned int popSize, unsigned int latencyTimesteps,
+                        unsigned int * const spkCnt, unsigned int * const spk)
+    :   m_ChannelName(channelName), m_LatencyTimesteps(latencyTimesteps), m_SpkCnt(spkCnt), m_Spk(spk),
+        m_Slot(nullptr), m_SlotOffset(0), m_SlotTimestep(0), m_Timestep(0)
+    {
+        using namespace SharedMemorySpikes;
+
+        if(latencyTimesteps == 0) {
+            throw std::runtime_error("Spike channel latency must be at least 1 timestep");
+        }
+
+        // Open sender's segment, retrying until it is created, initialised and belongs to a running sender
+        const std::string sharedMemoryName = getSharedMemoryName(channelName);
+        while(true) {
+            m_Header = tryOpen(sharedMemoryName);
+            if(m_Header != nullptr) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        // Unlink segment now it's mapped so it is cleaned up whichever simulator exits first
+        shm_unlink(sharedMemoryName.c_str());
+
+        if(m_Header->popSize != popSize) {
+            throw std::runtime_error("Spike channel '" + m_ChannelName + "' was created for a population of "
+                                     + std::to_string(m_Header->popSize) + " neurons rather than " + std::to_string(popSize));
+        }
+
+        // **NOTE** the sender can be up to (latency / window) + 1 windows ahead of the receiver
+        const unsigned int windowTimesteps = m_Header->windowTimesteps;
+        if(windowTimesteps > latencyTimesteps || m_Header->capacity < ((latencyTimesteps / windowTimesteps) + 2)) {
+            throw std::runtime_error("Spike channel '" + m_ChannelName + "' with window of " + std::to_string(windowTimesteps)
+                                     + " timesteps and capacity of " + std::to_string(m_Header->capacity)
+                                     + " windows cannot deliver spikes with a latency of " + std::to_string(latencyTimesteps) + " timesteps");
+        }
+
+        m_Header->receiverPID.store(getpid(), std::memory_order_relaxed);
+    }
+
+    ~SharedMemorySpikeIn()
+    {
+        munmap(m_Header, m_Size);
+    }
+
+    //----------------------------------------------------------------------------
+    // Public API
+    //----------------------------------------------------------------------------
+    //! Fill spike arrays with spikes to deliver in the next timestep, waiting for them if they haven't been sent yet
+    void tick()
+    {
+        m_SpkCnt[0] = 0;
+
+        // If a timestep has been sent long enough ago to deliver
+        m_Timestep++;
+        if(m_Timestep >= m_LatencyTimesteps) {
+            // If this is the first timestep of a window, wait for the sender to complete it
+            const uint64_t tail = m_Header->tail.load(std::memory_order_relaxed);
+            if(m_Slot == nullptr) {
+                SharedMemorySpikes::waitUntil(
+                    [this, tail](){ return m_Header->head.load(std::memory_order_acquire) > tail; },
+                    m_SenderPIDAtomic, m_ChannelName.c_str());
+                m_Slot = SharedMemorySpikes::getSlot(m_Header, tail);
+                m_SlotOffset = 0;
+                m_SlotTimestep = 0;
+            }
+
+            // Copy spikes from slot
+            const unsigned int spikeCount = m_Slot[m_SlotOffset++];
+            if(spikeCount > m_Header->popSize || (m_SlotOffset + spikeCount) > m_Header->slotWords) {
+                throw std::runtime_error("Corrupt spikes received from '" + m_ChannelName + "'");
+            }
+            std::copy_n(&m_Slot[m_SlotOffset], spikeCount, m_Spk);
+            m_SpkCnt[0] = spikeCount;
+            m_SlotOffset += spikeCount;
+
+            // If this was the last timestep of the window, return slot to sender
+            m_SlotTimestep++;
+            if(m_SlotTimestep == m_Header->windowTimesteps) {
+                m_Header->tail.store(tail + 1, std::memory_order_release);
+                m_Slot = nullptr;
+            }
+        }
+    }
+
+private:
+    //----------------------------------------------------------------------------
+    // Private methods
+    //----------------------------------------------------------------------------
+    //! Map segment if it exists, is fully initialised and was created by a sender which is still running
+    SharedMemorySpikes::Header *tryOpen(const std::string &sharedMemoryName)
+    {
+        using namespace SharedMemorySpikes;
+
+        const int fd = shm_open(sharedMemoryName.c_str(), O_RDWR, 0600);
+        if(fd == -1) {
+            if(errno == ENOENT) {
+                return nullptr;
+            }
+            throwErrno("Unable to open spike channel '" + m_ChannelName + "'");
+        }
+
+        // If segment hasn't been sized yet, try again later
+        struct stat status;
+        if(fstat(fd, &status) == -1 || (size_t)status.st_size < getSlotsOffset()) {
+            close(fd);
+            return nullptr;
+        }
+
+        m_Size = status.st_size;
+        void *memory = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(memory == MAP_FAILED) {
+            throwErrno("Unable to map spike channel '" + m_ChannelName + "'");
+        }
+
+        // If header isn't initialised or was left by a sender which has exited, try again later
+        Header *header = static_cast<Header*>(memory);
+        if(header->magic.load(std::memory_order_acquire) != magic || !isAlive(header->senderPID)) {
+            munmap(memory, m_Size);
+            return nullptr;
+        }
+
+        if(header->version != version || getSize(header->capacity, header->slotWords) > m_Size) {
+            munmap(memory, m_Size);
+            throw std::runtime_error("Spike channel '" + m_ChannelName + "' has incompatible format");
+        }
+
+        m_SenderPIDAtomic.store(header->senderPID, std::memory_order_relaxed);
+        return header;
+    }
+
+    //----------------------------------------------------------------------------
+    // Members
+    //----------------------------------------------------------------------------
+    const std::string m_ChannelName;
+    const unsigned int m_LatencyTimesteps;
+    unsigned int * const m_SpkCnt;
+    unsigned int * const m_Spk;
+
+    SharedMemorySpikes::Header *m_Header;
+    size_t m_Size;
+    std::atomic<int32_t> m_SenderPIDAtomic;
+
+    const uint32_t *m_Slot;
+    size_t m_SlotOffset;
+    unsigned int m_SlotTimestep;
+    unsigned long long m_Timestep;
+};
@@ -1,11 +1,15 @@
 #pragma once
 
 // Standard C includes
+#include <cassert>
 #include <cstdlib>
 
 // OpenCV includes
 #include <opencv2/core/mat.hpp>
 
+// Common includes
+#include "time_surface.h"
+
 inline void renderSpikeImage(unsigned int spikeCount, const unsigned int *spikes,
                              unsigned int width, float persistence, cv::Mat &image)
 {
@@ -22,4 +26,12 @@ inline void renderSpikeImage(unsigned int spikeCount, const unsigned int *spikes
 
     // Decay image
     image *= persistence;
-}
\ No newline at end of file
+}
+
+//! Build image for display from single channel surface
+inline void materialiseSpikeImage(const TimeSurface &surface, unsigned int width, cv::Mat &image)
+{
+    assert(surface.getNumChannels() == 1);
+    image.create(surface.getNumPixels() / width, width, CV_32FC1);
+    surface.materialise(reinterpret_cast<float*>(image.data));
+}
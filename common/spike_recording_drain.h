@@ -0,0 +1,166 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+// Common includes
+#include "binary_spike_recorder.h"
+
+//----------------------------------------------------------------------------
+// SpikeRecordingDrain
+//----------------------------------------------------------------------------
+//! Drains GeNN spike recording buffers allocated for a fixed window of timesteps
+//! rather than the whole simulation. When a window is drained, the recording
+//! buffers are pulled and copied into a second host buffer which is written by
+//! a BinarySpikeWriter while the simulation refills the first, so memory use is
+//! independent of duration and file I/O overlaps simulation.
+//! **NOTE** GeNN records timestep iT into slot iT % numRecordingTimesteps
+class SpikeRecordingDrain
+{
+public:
+    SpikeRecordingDrain(BinarySpikeWriter &writer, unsigned int windowTimesteps, double dt, void (*pullRecordingBuffersFn)())
+        : m_Writer(writer), m_WindowTimesteps(windowTimesteps), m_DT(dt), m_PullRecordingBuffersFn(pullRecordingBuffersFn),
+          m_LastDrainTimestep(0), m_NumInFlight(0), m_WaitTime(0.0)
+    {
+    }
+
+    ~SpikeRecordingDrain()
+    {
+        // Wait for writes from back buffers to complete before recorders (and buffers) are destroyed
+        waitForBackBuffers();
+    }
+
+    SpikeRecordingDrain(const SpikeRecordingDrain&) = delete;
+    SpikeRecordingDrain &operator = (const SpikeRecordingDrain&) = delete;
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Add population to drain - recordSpk must point to its (already allocated) recording buffer
+    void addPopulation(const std::string &filename, const uint32_t *recordSpk, unsigned int numNeurons)
+    {
+        m_Populations.emplace_back(new Population{
+            std::unique_ptr<BinarySpikeRecorder>(new BinarySpikeRecorder(m_Writer, filename, numNeurons, m_DT,
+                                                                         BinarySpikes::Format::Bitfield)),
+            recordSpk, BinarySpikes::getNumWords(numNeurons),
+            std::vector<uint32_t>((size_t)m_WindowTimesteps * BinarySpikes::getNumWords(numNeurons))});
+    }
+
+    //! Call after each simulation timestep with the current timestep (i.e. iT) - drains full windows
+    void update(unsigned long long timestep)
+    {
+        if((timestep % m_WindowTimesteps) == 0) {
+            drain(timestep, m_WindowTimesteps);
+        }
+    }
+
+    //! Drain any timesteps recorded since the last drain e.g. at the end of the simulation
+    void finish(unsigned long long timestep)
+    {
+        if(timestep > m_LastDrainTimestep) {
+            drain(timestep, (unsigned int)std::min<unsigned long long>(timestep - m_LastDrainTimestep, m_WindowTimesteps));
+        }
+    }
+
+    //! Pull recording buffers and queue the numTimesteps timesteps ending at timestep to be written
+    void drain(unsigned long long timestep, unsigned int numTimesteps)
+    {
+        assert(numTimesteps <= m_WindowTimesteps);
+        assert(timestep >= numTimesteps);
+
+        // Wait for back buffers to be written from last drain
+        waitForBackBuffers();
+
+        // Pull recording buffers into front buffers
+        m_PullRecordingBuffersFn();
+
+        // Determine which slots of the window these timesteps were recorded into
+        const unsigned long long startTimestep = timestep - numTimesteps;
+        const unsigned int startSlot = startTimestep % m_WindowTimesteps;
+        const unsigned int numFirstSlots = std::min(numTimesteps, m_WindowTimesteps - startSlot);
+
+        for(auto &p : m_Populations) {
+            // Copy timesteps from front to back buffer, unwrapping if they wrap around end of window
+            std::memcpy(p->backBuffer.data(), p->recordSpk + ((size_t)startSlot * p->numWords),
+                        (size_t)numFirstSlots * p->numWords * sizeof(uint32_t));
+            std::memcpy(p->backBuffer.data() + ((size_t)numFirstSlots * p->numWords), p->recordSpk,
+                        (size_t)(numTimesteps - numFirstSlots) * p->numWords * sizeof(uint32_t));
+
+            // Queue back buffer to be written in place
+            {
+                std::lock_guard<std::mutex> lock(m_InFlightMutex);
+                m_NumInFlight++;
+            }
+            p->recorder->appendBitfield(startTimestep, p->backBuffer.data(), numTimesteps,
+                                        [this](){ onBackBufferWritten(); });
+        }
+
+        m_LastDrainTimestep = timestep;
+    }
+
+    //! Total time spent waiting for writes to complete [s] - non-zero if I/O can't keep up with simulation
+    double getWaitTime() const{ return m_WaitTime; }
+
+    unsigned int getWindowTimesteps() const{ return m_WindowTimesteps; }
+
+private:
+    //------------------------------------------------------------------------
+    // Population
+    //------------------------------------------------------------------------
+    struct Population
+    {
+        std::unique_ptr<BinarySpikeRecorder> recorder;
+        const uint32_t *recordSpk;
+        unsigned int numWords;
+        std::vector<uint32_t> backBuffer;
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void waitForBackBuffers()
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(m_InFlightMutex);
+            m_InFlightDone.wait(lock, [this](){ return m_NumInFlight == 0; });
+        }
+        m_WaitTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    void onBackBufferWritten()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_InFlightMutex);
+            m_NumInFlight--;
+        }
+        m_InFlightDone.notify_all();
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    BinarySpikeWriter &m_Writer;
+    const unsigned int m_WindowTimesteps;
+    const double m_DT;
+    void (*m_PullRecordingBuffersFn)();
+
+    unsigned long long m_LastDrainTimestep;
+    std::vector<std::unique_ptr<Population>> m_Populations;
+
+    std::mutex m_InFlightMutex;
+    std::condition_variable m_InFlightDone;
+    unsigned int m_NumInFlight;
+    double m_WaitTime;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// Standard C++ includes
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// Standard C includes
+#include <cstddef>
+
+//----------------------------------------------------------------------------
+// SPSCRing
+//----------------------------------------------------------------------------
+//! Lock-free, bounded ring of preallocated slots for passing data from exactly one producer
+//! thread to exactly one consumer thread. Slots are written and read in place so, if T owns
+//! memory (e.g. a std::vector sized by the initial value), it is reused rather than reallocated
+template<typename T>
+class SPSCRing
+{
+public:
+    SPSCRing(size_t capacity, const T &initial = T())
+    :   m_Slots(capacity, initial), m_Mask(capacity - 1), m_Head(0), m_Tail(0)
+    {
+        if(capacity == 0 || (capacity & m_Mask) != 0) {
+            throw std::runtime_error("SPSCRing capacity must be a power of two");
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Producer API
+    //------------------------------------------------------------------------
+    //! Get slot to write into or nullptr if ring is full
+    T *beginWrite()
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        if((head - m_Tail.load(std::memory_order_acquire)) == m_Slots.size()) {
+            return nullptr;
+        }
+        return &m_Slots[head & m_Mask];
+    }
+
+    //! Make slot returned by beginWrite visible to consumer
+    void endWrite()
+    {
+        m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------
+    // Consumer API
+    //------------------------------------------------------------------------
+    //! Get oldest slot to read from or nullptr if ring is empty
+    T *beginRead()
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if(tail == m_Head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_Slots[tail & m_Mask];
+    }
+
+    //! Return slot returned by beginRead to producer
+    void endRead()
+    {
+        m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Approximate number of slots waiting to be read - exact only when called from producer or consumer
+    size_t size() const
+    {
+        return m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const{ return m_Slots.size(); }
+
+private:
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    std::vector<T> m_Slots;
+    const size_t m_Mask;
+
+    // **NOTE** head and tail are padded onto separate cache lines so producer and consumer don't contend
+    char m_HeadPadding[64];
+    std::atomic<size_t> m_Head;
+    char m_TailPadding[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_Tail;
+};
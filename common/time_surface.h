@@ -0,0 +1,129 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+
+//----------------------------------------------------------------------------
+// TimeSurface
+//----------------------------------------------------------------------------
+//! Image whose pixels decay exponentially by persistence every timestep. Rather than multiplying every pixel
+//! each timestep, the timestep each pixel was last updated is stored and decay is only applied when a pixel
+//! is updated or read, so the cost of a timestep scales with the number of spikes rather than the resolution.
+//! Whole surfaces are read for display with materialise - a branch-free loop over the pixels which looks
+//! up each pixel's decay in a table of powers of persistence. Pixels are numChannels floats wide so,
+//! for example, optical flow vectors can be stored as 2 channel pixels
+class TimeSurface
+{
+public:
+    //! Pixels which haven't been updated for long enough to decay by a factor of threshold are read as zero
+    TimeSurface(unsigned int numPixels, unsigned int numChannels, float persistence, float threshold = 1.0E-6f)
+    :   m_NumPixels(numPixels), m_NumChannels(numChannels), m_Timestep(0),
+        m_Values(numPixels * numChannels, 0.0f), m_LastUpdate(numPixels, 0)
+    {
+        if(persistence <= 0.0f || persistence >= 1.0f) {
+            throw std::runtime_error("TimeSurface persistence must be between 0 and 1");
+        }
+
+        // Build table of persistence^age up to the age at which pixels have decayed past threshold
+        const unsigned int maxAge = (unsigned int)std::ceil(std::log(threshold) / std::log(persistence));
+        m_Decay.resize(maxAge + 1);
+        for(unsigned int a = 0; a < maxAge; a++) {
+            m_Decay[a] = std::pow(persistence, (float)a);
+        }
+        m_Decay[maxAge] = 0.0f;
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Advance to next timestep, decaying all pixels by persistence
+    void step()
+    {
+        m_Timestep++;
+    }
+
+    //! Add value to channel of pixel
+    void add(unsigned int pixel, unsigned int channel, float value)
+    {
+        // Apply decay to all channels of pixel since it was last updated
+        const float decay = getDecay(pixel);
+        float *values = &m_Values[pixel * m_NumChannels];
+        for(unsigned int c = 0; c < m_NumChannels; c++) {
+            values[c] *= decay;
+        }
+        m_LastUpdate[pixel] = m_Timestep;
+
+        values[channel] += value;
+    }
+
+    //! Read current value of channel of pixel
+    float get(unsigned int pixel, unsigned int channel) const
+    {
+        return m_Values[(pixel * m_NumChannels) + channel] * getDecay(pixel);
+    }
+
+    //! Write current value of every channel of every pixel to output
+    void materialise(float *output) const
+    {
+        const uint32_t maxAge = (uint32_t)(m_Decay.size() - 1);
+        if(m_NumChannels == 1) {
+            materialise(output, m_Values.data(), m_LastUpdate.data(), m_Decay.data(), m_Timestep, maxAge, m_NumPixels);
+        }
+        else {
+            for(unsigned int i = 0; i < m_NumPixels; i++) {
+                const float decay = m_Decay[std::min(m_Timestep - m_LastUpdate[i], maxAge)];
+                for(unsigned int c = 0; c < m_NumChannels; c++) {
+                    output[(i * m_NumChannels) + c] = m_Values[(i * m_NumChannels) + c] * decay;
+                }
+            }
+        }
+    }
+
+    unsigned int getNumPixels() const{ return m_NumPixels; }
+    unsigned int getNumChannels() const{ return m_NumChannels; }
+    uint32_t getTimestep() const{ return m_Timestep; }
+
+private:
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    //! Materialise single channel pixels
+    //! **NOTE** __restrict tells the compiler output doesn't alias the surface so decays can be gathered with SIMD
+    static void materialise(float *__restrict output, const float *__restrict values, const uint32_t *__restrict lastUpdate,
+                            const float *__restrict decay, uint32_t timestep, uint32_t maxAge, unsigned int numPixels)
+    {
+        for(unsigned int i = 0; i < numPixels; i++) {
+            const int age = (int)std::min(timestep - lastUpdate[i], maxAge);
+            output[i] = values[i] * decay[age];
+        }
+    }
+
+    float getDecay(unsigned int pixel) const
+    {
+        // **NOTE** unsigned subtraction handles timestep wrapping
+        const uint32_t age = m_Timestep - m_LastUpdate[pixel];
+        return m_Decay[std::min(age, (uint32_t)(m_Decay.size() - 1))];
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const unsigned int m_NumPixels;
+    const unsigned int m_NumChannels;
+    uint32_t m_Timestep;
+
+    //! Value of each channel of each pixel when it was last updated
+    std::vector<float> m_Values;
+
+    //! Timestep each pixel was last updated
+    std::vector<uint32_t> m_LastUpdate;
+
+    //! persistence^age for each age until pixels have decayed to zero
+    std::vector<float> m_Decay;
+};
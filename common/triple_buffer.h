@@ -0,0 +1,78 @@
+#pragma once
+
+// Standard C++ includes
+#include <atomic>
+
+//----------------------------------------------------------------------------
+// TripleBuffer
+//----------------------------------------------------------------------------
+//! Lock-free triple buffer for publishing snapshots from one producer thread to one consumer
+//! thread. The producer writes into the back buffer and publishes it by swapping it with the
+//! middle buffer; the consumer takes the latest published snapshot by swapping the middle buffer
+//! with its front buffer. Neither thread ever waits and the consumer always sees a complete snapshot
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer(const T &initial = T())
+    :   m_Buffers{initial, initial, initial}, m_Back(0), m_Middle(1), m_Front(2)
+    {
+    }
+
+    //------------------------------------------------------------------------
+    // Producer API
+    //------------------------------------------------------------------------
+    //! Get buffer to write next snapshot into
+    T &getBack(){ return m_Buffers[m_Back]; }
+
+    //! Make back buffer available to consumer
+    void publish()
+    {
+        m_Back = m_Middle.exchange(m_Back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    //! Has the last published snapshot not yet been picked up by the consumer? Producers
+    //! whose snapshots are expensive to build can use this to skip building unseen ones
+    bool isPending() const
+    {
+        return (m_Middle.load(std::memory_order_acquire) & FreshBit) != 0;
+    }
+
+    //------------------------------------------------------------------------
+    // Consumer API
+    //------------------------------------------------------------------------
+    //! Swap latest published snapshot into front buffer, returning false if there isn't a new one
+    bool update()
+    {
+        if((m_Middle.load(std::memory_order_relaxed) & FreshBit) == 0) {
+            return false;
+        }
+
+        m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    //! Get buffer containing latest snapshot picked up by update
+    const T &getFront() const{ return m_Buffers[m_Front]; }
+
+private:
+    //------------------------------------------------------------------------
+    // Constants
+    //------------------------------------------------------------------------
+    static constexpr unsigned int IndexMask = 3;
+    static constexpr unsigned int FreshBit = 4;
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    T m_Buffers[3];
+
+    //! Index of buffer owned by producer
+    unsigned int m_Back;
+
+    //! Index of buffer being handed between threads with FreshBit set if it hasn't been picked up
+    std::atomic<unsigned int> m_Middle;
+
+    //! Index of buffer owned by consumer
+    unsigned int m_Front;
+};
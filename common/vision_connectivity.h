@@ -0,0 +1,168 @@
+#pragma once
+
+// GeNN includes
+#include "initSparseConnectivitySnippet.h"
+
+// Connectivity for the retinotopic topologies used by the vision models, generated procedurally by GeNN
+// when the model is initialised rather than built on the host and uploaded. Pixels of square populations
+// of neurons with resolution R are indexed x + (y * R) and each snippet builds its row in a single pass.
+// Populations can contain several independent instances of a network tiled one after another - the pixels
+// of instance n start at n * R * R - in which case each instance only connects to the same postsynaptic instance.
+
+//----------------------------------------------------------------------------
+// CentreToMacroPixel
+//----------------------------------------------------------------------------
+//! Connects each pixel in the central CentreSize x CentreSize region of a Resolution x Resolution population
+//! to the macro pixel covering its KernelSize x KernelSize block of the centre. Pixels in the border are unconnected.
+//! With KernelSize equal to CentreSize, every pixel in the centre connects to a single postsynaptic neuron
+class CentreToMacroPixel : public InitSparseConnectivitySnippet::Base
+{
+public:
+    DECLARE_SNIPPET(CentreToMacroPixel, 3);
+
+    SET_ROW_BUILD_CODE(
+        "const unsigned int resolution = (unsigned int)$(Resolution);\n"
+        "const unsigned int centreSize = (unsigned int)$(CentreSize);\n"
+        "const unsigned int kernelSize = (unsigned int)$(KernelSize);\n"
+        "const unsigned int nearBorder = (resolution - centreSize) / 2;\n"
+        "const unsigned int farBorder = nearBorder + centreSize;\n"
+        "const unsigned int macroSize = centreSize / kernelSize;\n"
+        "const unsigned int instance = $(id_pre) / (resolution * resolution);\n"
+        "const unsigned int x = $(id_pre) % resolution;\n"
+        "const unsigned int y = ($(id_pre) / resolution) % resolution;\n"
+        "if(x >= nearBorder && x < farBorder && y >= nearBorder && y < farBorder) {\n"
+        "    const unsigned int macroX = (x - nearBorder) / kernelSize;\n"
+        "    const unsigned int macroY = (y - nearBorder) / kernelSize;\n"
+        "    $(addSynapse, macroX + (macroY * macroSize) + (instance * macroSize * macroSize));\n"
+        "}\n"
+        "$(endRow);\n");
+
+    SET_PARAM_NAMES({"Resolution", "CentreSize", "KernelSize"});
+
+    SET_CALC_MAX_ROW_LENGTH_FUNC(
+        [](unsigned int, unsigned int, const std::vector<double> &)
+        {
+            return 1;
+        });
+};
+IMPLEMENT_SNIPPET(CentreToMacroPixel);
+
+//----------------------------------------------------------------------------
+// NeighbourRing
+//----------------------------------------------------------------------------
+//! Connects each pixel of a Resolution x Resolution population to the four pixels Distance away from it -
+//! horizontally and vertically or, if Diagonal is non-zero, diagonally - which lie in the central
+//! CentreSize x CentreSize region of a population of the same resolution
+class NeighbourRing : public InitSparseConnectivitySnippet::Base
+{
+public:
+    DECLARE_SNIPPET(NeighbourRing, 4);
+
+    SET_ROW_BUILD_CODE(
+        "const int resolution = (int)$(Resolution);\n"
+        "const int nearBorder = (resolution - (int)$(CentreSize)) / 2;\n"
+        "const int farBorder = nearBorder + (int)$(CentreSize);\n"
+        "const int distance = (int)$(Distance);\n"
+        "const int diagonal = ($(Diagonal) != 0.0) ? distance : 0;\n"
+        "const int offsetX[4] = {distance, -distance, diagonal, -diagonal};\n"
+        "const int offsetY[4] = {diagonal, -diagonal, -distance, distance};\n"
+        "const int instanceStart = ((int)$(id_pre) / (resolution * resolution)) * resolution * resolution;\n"
+        "const int x = (int)$(id_pre) % resolution;\n"
+        "const int y = ((int)$(id_pre) / resolution) % resolution;\n"
+        "for(int n = 0; n < 4; n++) {\n"
+        "    const int postX = x + offsetX[n];\n"
+        "    const int postY = y + offsetY[n];\n"
+        "    if(postX >= nearBorder && postX < farBorder && postY >= nearBorder && postY < farBorder) {\n"
+        "        $(addSynapse, instanceStart + postX + (postY * resolution));\n"
+        "    }\n"
+        "}\n"
+        "$(endRow);\n");
+
+    SET_PARAM_NAMES({"Resolution", "CentreSize", "Distance", "Diagonal"});
+
+    SET_CALC_MAX_ROW_LENGTH_FUNC(
+        [](unsigned int, unsigned int, const std::vector<double> &)
+        {
+            return 4;
+        });
+};
+IMPLEMENT_SNIPPET(NeighbourRing);
+
+//----------------------------------------------------------------------------
+// MotionDetectorExcitatory
+//----------------------------------------------------------------------------
+//! Connects each MacroPixelSize x MacroPixelSize macro pixel, outside the one pixel border, to the four
+//! (left, right, up and down) motion detectors associated with it. Detectors for each macro pixel are
+//! adjacent so the postsynaptic population is a (MacroPixelSize - 2) x (MacroPixelSize - 2) grid of groups of four
+class MotionDetectorExcitatory : public InitSparseConnectivitySnippet::Base
+{
+public:
+    DECLARE_SNIPPET(MotionDetectorExcitatory, 1);
+
+    SET_ROW_BUILD_CODE(
+        "const unsigned int macroPixelSize = (unsigned int)$(MacroPixelSize);\n"
+        "const unsigned int detectorSize = macroPixelSize - 2;\n"
+        "const unsigned int instance = $(id_pre) / (macroPixelSize * macroPixelSize);\n"
+        "const unsigned int x = $(id_pre) % macroPixelSize;\n"
+        "const unsigned int y = ($(id_pre) / macroPixelSize) % macroPixelSize;\n"
+        "if(x >= 1 && x < (macroPixelSize - 1) && y >= 1 && y < (macroPixelSize - 1)) {\n"
+        "    const unsigned int detector = ((x - 1) + ((y - 1) * detectorSize) + (instance * detectorSize * detectorSize)) * 4;\n"
+        "    $(addSynapse, detector);\n"
+        "    $(addSynapse, detector + 1);\n"
+        "    $(addSynapse, detector + 2);\n"
+        "    $(addSynapse, detector + 3);\n"
+        "}\n"
+        "$(endRow);\n");
+
+    SET_PARAM_NAMES({"MacroPixelSize"});
+
+    SET_CALC_MAX_ROW_LENGTH_FUNC(
+        [](unsigned int, unsigned int, const std::vector<double> &)
+        {
+            return 4;
+        });
+};
+IMPLEMENT_SNIPPET(MotionDetectorExcitatory);
+
+//----------------------------------------------------------------------------
+// MotionDetectorInhibitory
+//----------------------------------------------------------------------------
+//! Connects each macro pixel to the detectors of its neighbours which should not respond to motion
+//! away from it: the left detector of the macro pixel to its right, the right detector of the macro pixel
+//! to its left, the up detector of the macro pixel below and the down detector of the macro pixel above
+class MotionDetectorInhibitory : public InitSparseConnectivitySnippet::Base
+{
+public:
+    DECLARE_SNIPPET(MotionDetectorInhibitory, 1);
+
+    SET_ROW_BUILD_CODE(
+        "const unsigned int macroPixelSize = (unsigned int)$(MacroPixelSize);\n"
+        "const unsigned int detectorSize = macroPixelSize - 2;\n"
+        "const unsigned int instanceStart = ($(id_pre) / (macroPixelSize * macroPixelSize)) * detectorSize * detectorSize * 4;\n"
+        "const unsigned int x = $(id_pre) % macroPixelSize;\n"
+        "const unsigned int y = ($(id_pre) / macroPixelSize) % macroPixelSize;\n"
+        "const bool innerX = (x >= 1 && x < (macroPixelSize - 1));\n"
+        "const bool innerY = (y >= 1 && y < (macroPixelSize - 1));\n"
+        "if(x < (macroPixelSize - 2) && innerY) {\n"
+        "    $(addSynapse, instanceStart + ((x + ((y - 1) * detectorSize)) * 4) + 0);\n"
+        "}\n"
+        "if(x >= 2 && innerY) {\n"
+        "    $(addSynapse, instanceStart + (((x - 2) + ((y - 1) * detectorSize)) * 4) + 1);\n"
+        "}\n"
+        "if(innerX && y < (macroPixelSize - 2)) {\n"
+        "    $(addSynapse, instanceStart + (((x - 1) + (y * detectorSize)) * 4) + 2);\n"
+        "}\n"
+        "if(innerX && y >= 2) {\n"
+        "    $(addSynapse, instanceStart + (((x - 1) + ((y - 2) * detectorSize)) * 4) + 3);\n"
+        "}\n"
+        "$(endRow);\n");
+
+    SET_PARAM_NAMES({"MacroPixelSize"});
+
+    SET_CALC_MAX_ROW_LENGTH_FUNC(
+        [](unsigned int, unsigned int, const std::vector<double> &)
+        {
+            return 4;
+        });
+};
+IMPLEMENT_SNIPPET(MotionDetectorInhibitory);
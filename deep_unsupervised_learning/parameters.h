@@ -1,5 +1,7 @@
 #pragma once
 
+//#define RESUME_IMAGE 1000
+
 //------------------------------------------------------------------------
 // Parameters::Input
 //------------------------------------------------------------------------
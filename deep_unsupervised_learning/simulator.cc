@@ -2,6 +2,9 @@
 #include <iostream>
 #include <random>
 
+// POSIX includes
+#include <dlfcn.h>
+
 // GeNN userproject includes
 #include "spikeRecorder.h"
 
@@ -10,6 +13,7 @@
 
 // GeNN examples includes
 #include "../common/mnist_helpers.h"
+#include "../common/model_checkpoint.h"
 
 // Model parameters
 #include "parameters.h"
@@ -40,11 +44,59 @@ int main()
     initializeSparse();
 
     // Load training data and labels
-    const unsigned int numTrainingImages = loadImageData("train-images-idx3-ubyte", datasetInput, 
+    // **NOTE** mapped images must remain in scope while the model is reading them
+    IDXFile trainingImages("train-images-idx3-ubyte", IDXFile::Type::UnsignedByte, 3, mnistEGPAliasesHost);
+    const unsigned int numTrainingImages = loadImageData(trainingImages, datasetInput,
                                                          &allocatedatasetInput, &pushdatasetInputToDevice);
 
+    // Register everything training depends on with checkpoint
+    ModelCheckpoint checkpoint([](const std::string &name){ return dlsym(RTLD_DEFAULT, name.c_str()); },
+                               ModelCheckpoint::getExportedArrays(dlsym(RTLD_DEFAULT, "allocateMem")));
+    checkpoint.addVars<scalar>("Conv1", Conv1::numNeurons, {"Vwta", "Vinf", "TlastReset"});
+    checkpoint.addVars<scalar>("Conv2", Conv2::numNeurons, {"Vwta", "Vinf", "TlastReset"});
+    checkpoint.addVars<scalar>("Output", Output::numNeurons, {"Vwta", "Vinf", "TlastReset"});
+    checkpoint.addVars<scalar>("Input_Conv1", InputConv1::kernelSize, {"g"});
+    checkpoint.addVars<scalar>("Conv1_Conv2", Conv1Conv2::kernelSize, {"g"});
+    checkpoint.addVars<scalar>("Conv2_Output", Conv2Output::kernelSize, {"g"});
+    checkpoint.addInSyn<scalar>("Conv1", Conv1::numNeurons, {"Input_Conv1", "Conv1_Conv1"});
+    checkpoint.addInSyn<scalar>("Conv2", Conv2::numNeurons, {"Conv1_Conv2", "Conv2_Conv2"});
+    checkpoint.addInSyn<scalar>("Output", Output::numNeurons, {"Conv2_Output", "Output_Output"});
+    checkpoint.addSpikes("Input", Input::numNeurons);
+    checkpoint.addSpikes("Conv1", Conv1::numNeurons);
+    checkpoint.addSpikes("Conv2", Conv2::numNeurons);
+    checkpoint.addSpikes("Output", Output::numNeurons);
+    checkpoint.addSpikeEvents("Conv1", Conv1::numNeurons);
+    checkpoint.addSpikeEvents("Conv2", Conv2::numNeurons);
+
+    // Spike times used by STDP rules
+    checkpoint.addSpikeTimes<scalar>("Input", Input::numNeurons);
+    checkpoint.addSpikeTimes<scalar>("Conv1", Conv1::numNeurons, ModelCheckpoint::SpikeTime::SpikeEvent);
+    checkpoint.addSpikeTimes<scalar>("Conv2", Conv2::numNeurons, ModelCheckpoint::SpikeTime::SpikeEvent);
+    checkpoint.addSpikeTimes<scalar>("Conv1", Conv1::numNeurons);
+    checkpoint.addSpikeTimes<scalar>("Conv1", Conv1::numNeurons, ModelCheckpoint::SpikeTime::PreviousSpike);
+    checkpoint.addSpikeTimes<scalar>("Conv2", Conv2::numNeurons);
+    checkpoint.addSpikeTimes<scalar>("Conv2", Conv2::numNeurons, ModelCheckpoint::SpikeTime::PreviousSpike);
+    checkpoint.addSpikeTimes<scalar>("Output", Output::numNeurons);
+    checkpoint.addSpikeTimes<scalar>("Output", Output::numNeurons, ModelCheckpoint::SpikeTime::PreviousSpike);
+
+    // Input neurons are Poisson so also checkpoint GeNN's RNG if it lives on the host
+    checkpoint.addHostRNG();
+    checkpoint.addValue("t", t);
+    checkpoint.addValue("iT", iT);
+
+    // Check no model state has been missed - the dataset is reloaded and the fixed WTA weights are reinitialised
+    checkpoint.checkComplete({"datasetInput", "gConv1_Conv1", "gConv2_Conv2", "gOutput_Output"});
+
+#ifdef RESUME_IMAGE
+    // Restore model from after image was presented
+    checkpoint.restore("checkpoint_" + std::to_string(RESUME_IMAGE) + ".bin");
+    const unsigned int startImage = RESUME_IMAGE + 1;
+#else
+    const unsigned int startImage = 0;
+#endif
+
     // Loop through training images
-    for(unsigned int n = 0; n < numTrainingImages; n++) {
+    for(unsigned int n = startImage; n < numTrainingImages; n++) {
         std::cout << n << std::endl;
 
         // Simulate
@@ -92,8 +144,14 @@ int main()
             conv2.write(reinterpret_cast<const char*>(gConv1_Conv2), Conv1Conv2::kernelSize * sizeof(scalar));
             output.write(reinterpret_cast<const char*>(gConv2_Output), Conv2Output::kernelSize * sizeof(scalar));
 
+            // Checkpoint everything so training can be resumed from this image
+            checkpoint.save("checkpoint_" + std::to_string(n) + ".bin");
+
         }
     }
+
+    // Make sure final checkpoint was written successfully
+    checkpoint.wait();
     return EXIT_SUCCESS;
     
     
@@ -31,7 +31,9 @@ bool test()
     labelFile.read(reinterpret_cast<char*>(neuronLabel.data()), Output::numNeurons * sizeof(unsigned int));
 
     // Load testig data
-    const unsigned int numTestingImages = loadImageData("t10k-images-idx3-ubyte", datasetInput,
+    // **NOTE** mapped images must remain in scope while the model is reading them
+    IDXFile testingImages("t10k-images-idx3-ubyte", IDXFile::Type::UnsignedByte, 3, mnistEGPAliasesHost);
+    const unsigned int numTestingImages = loadImageData(testingImages, datasetInput,
                                                         &allocatedatasetInput, &pushdatasetInputToDevice);
 
     // Load testing labels
@@ -77,7 +79,9 @@ void label()
     std::cout << "Labelling..." << std::endl;
 
     // Load training data
-    const unsigned int numTrainingImages = loadImageData("train-images-idx3-ubyte", datasetInput, 
+    // **NOTE** mapped images must remain in scope while the model is reading them
+    IDXFile trainingImages("train-images-idx3-ubyte", IDXFile::Type::UnsignedByte, 3, mnistEGPAliasesHost);
+    const unsigned int numTrainingImages = loadImageData(trainingImages, datasetInput,
                                                          &allocatedatasetInput, &pushdatasetInputToDevice);
 
     // Load training labels
@@ -1,6 +1,9 @@
 // GeNN includes
 #include "modelSpec.h"
 
+// Common includes
+#include "../common/vision_connectivity.h"
+
 // Model includes
 #include "parameters.h"
 
@@ -56,6 +59,19 @@ void modelDefinition(NNmodel &model)
     PostsynapticModels::ExpCurr::ParamValues outputInhibitoryPostSynParams(
         50.0);         // 0 - TauSyn (ms)
 
+    // Connectivity parameters
+    // **NOTE** detector snippets add synapses to detectors in the order of Parameters::Detector
+    CentreToMacroPixel::ParamValues dvsMacroPixelConnectParams(
+        Parameters::inputSize,      // 0 - Resolution
+        Parameters::centreSize,     // 1 - CentreSize
+        Parameters::kernelSize);    // 2 - KernelSize
+
+    MotionDetectorExcitatory::ParamValues macroPixelOutputExcitatoryConnectParams(
+        Parameters::macroPixelSize);    // 0 - MacroPixelSize
+
+    MotionDetectorInhibitory::ParamValues macroPixelOutputInhibitoryConnectParams(
+        Parameters::macroPixelSize);    // 0 - MacroPixelSize
+
     //------------------------------------------------------------------------
     // Neuron populations
     //------------------------------------------------------------------------
@@ -71,27 +87,27 @@ void modelDefinition(NNmodel &model)
     //------------------------------------------------------------------------
     // Synapse populations
     //------------------------------------------------------------------------
-    auto *dvsMacroPixel = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
+    model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
         "DVS_MacroPixel", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
         "DVS", "MacroPixel",
         {}, dvsMacroPixelWeightUpdateInit,
-        macroPixelPostSynParams, {});
+        macroPixelPostSynParams, {},
+        initConnectivity<CentreToMacroPixel>(dvsMacroPixelConnectParams));
 
-    auto *macroPixelOutputExcitatory = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
+    model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
         "MacroPixel_Output_Excitatory", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
         "MacroPixel", "Output",
         {}, macroPixelOutputExcitatoryWeightUpdateInit,
-        outputExcitatoryPostSynParams, {});
+        outputExcitatoryPostSynParams, {},
+        initConnectivity<MotionDetectorExcitatory>(macroPixelOutputExcitatoryConnectParams));
 
-    auto *macroPixelOutputInhibitory = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
+    model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::ExpCurr>(
         "MacroPixel_Output_Inhibitory", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
         "MacroPixel", "Output",
         {}, macroPixelOutputInhibitoryWeightUpdateInit,
-        outputInhibitoryPostSynParams, {});
-    
-    dvsMacroPixel->setMaxConnections(1);
-    macroPixelOutputExcitatory->setMaxConnections(Parameters::DetectorMax);
-    macroPixelOutputInhibitory->setMaxConnections(Parameters::DetectorMax);
+        outputInhibitoryPostSynParams, {},
+        initConnectivity<MotionDetectorInhibitory>(macroPixelOutputInhibitoryConnectParams));
+
     // Use zero-copy for input and output spikes as we want to access them every timestep
     //dvs->setSpikeZeroCopyEnabled(true);
     //output->setSpikeZeroCopyEnabled(true);
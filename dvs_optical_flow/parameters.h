@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard C includes
+#include <cstdint>
+
 //------------------------------------------------------------------------
 // Parameters
 //------------------------------------------------------------------------
@@ -17,7 +20,14 @@ namespace Parameters
 
     constexpr double timestep = 1.0;
 
+    // Resolution of DVXplorer sensor
+    constexpr unsigned int sensorWidth = 640;
+    constexpr unsigned int sensorHeight = 480;
+
+    // Size of square region in centre of sensor used as input
     constexpr unsigned int inputSize = 480;
+    constexpr unsigned int inputLeft = (sensorWidth - inputSize) / 2;
+    constexpr unsigned int inputTop = (sensorHeight - inputSize) / 2;
     constexpr unsigned int kernelSize = 5;
     constexpr unsigned int centreSize = 465;
 
@@ -32,4 +42,10 @@ namespace Parameters
     constexpr float spikePersistence = 0.97f;
     
     constexpr float outputVectorScale = 2.0f;
+
+    // Events from pixels which produced an event less than this long ago are treated as hot pixel noise
+    constexpr uint32_t refractoryUs = 1000;
+
+    // Events without an event in a neighbouring pixel this long beforehand are treated as background activity
+    constexpr uint32_t correlationUs = 5000;
 }
@@ -1,25 +1,28 @@
 // Standard C++ includes
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
-#include <mutex>
+#include <memory>
 #include <random>
+#include <string>
 #include <thread>
+#include <vector>
 
 // Standard C includes
-#include <cassert>
 #include <csignal>
 #include <cstdlib>
 
 // OpenCV includes
 #include <opencv2/opencv.hpp>
 
-// GeNN userproject includes
-#include "timer.h"
-
 // Common includes
 #include "../common/dvs.h"
-
+#include "../common/dvs_pre_recorded.h"
+#include "../common/latency_report.h"
+#include "../common/spike_image_renderer.h"
+#include "../common/spsc_ring.h"
+#include "../common/triple_buffer.h"
 
 // Model includes
 #include "parameters.h"
@@ -32,7 +35,31 @@
 //----------------------------------------------------------------------------
 namespace
 {
-typedef void (*allocateFn)(unsigned int);
+// Events from the centre inputSize x inputSize ON pixels of the DVXplorer's sensor
+using Filter = DVS::CombineFilter<DVS::PolarityFilter<DVS::Polarity::ON>,
+                                  DVS::ROIFilter<Parameters::inputLeft, Parameters::inputLeft + Parameters::inputSize,
+                                                 Parameters::inputTop, Parameters::inputTop + Parameters::inputSize>>;
+using TransformX = DVS::Subtract<Parameters::inputLeft>;
+using TransformY = DVS::Subtract<Parameters::inputTop>;
+
+// Number of packets of events which can be queued between acquisition thread and simulation
+constexpr size_t acquisitionRingCapacity = 256;
+
+//! Batch of events and the time the acquisition thread read them from the device
+struct AcquiredBatch
+{
+    DVS::EventBatch events;
+    std::chrono::high_resolution_clock::time_point time;
+};
+
+using EventRing = SPSCRing<AcquiredBatch>;
+using EventPipeline = DVS::EventPipeline<Parameters::inputSize, TransformX, TransformY>;
+
+//! Flow field snapshot passed to display thread
+struct OutputFlow
+{
+    float flow[Parameters::detectorSize][Parameters::detectorSize][2];
+};
 
 volatile std::sig_atomic_t g_SignalStatus;
 
@@ -41,134 +68,51 @@ void signalHandler(int status)
     g_SignalStatus = status;
 }
 
-unsigned int getNeuronIndex(unsigned int resolution, unsigned int x, unsigned int y)
+template<typename Device>
+void acquisitionThreadHandler(Device &dvs, bool lockstep, EventRing &ring,
+                              const std::atomic<bool> &running, std::atomic<bool> &finished,
+                              std::atomic<unsigned int> &numDroppedPackets)
 {
-    return x + (y * resolution);
-}
-
-void buildCentreToMacroConnection(unsigned int *rowLength, unsigned int *ind)
-{
-    // Calculate start and end of border on each row
-    const unsigned int near_border = (Parameters::inputSize - Parameters::centreSize) / 2;
-    const unsigned int far_border = near_border + Parameters::centreSize;
-
-    // Loop through rows of pixels in centre
-    unsigned int i = 0;
-    for(unsigned int yi = 0; yi < Parameters::inputSize; yi++)
-    {
-        for(unsigned int xi = 0; xi < Parameters::inputSize; xi++)
-        {
-            // If we're in the centre
-            if(xi >= near_border && xi < far_border && yi >= near_border && yi < far_border) {
-                const unsigned int yj = (yi - near_border) / Parameters::kernelSize;
-                const unsigned int xj = (xi - near_border) / Parameters::kernelSize;
-                
-                ind[i] = getNeuronIndex(Parameters::macroPixelSize, xj, yj);
-                rowLength[i++] = 1;
+    DVS::EventBatch droppedBatch;
+    while(running && !dvs.isFinished()) {
+        // If ring is full
+        AcquiredBatch *batch = ring.beginWrite();
+        if(batch == nullptr) {
+            // When replaying in lockstep with the simulation, wait for space
+            if(lockstep) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
             }
+            // Otherwise, keep draining device so it doesn't fall behind but drop packet
             else {
-                rowLength[i++] = 0;
+                droppedBatch.clear();
+                dvs.template readEventBatch<Filter>(droppedBatch);
+                if(!droppedBatch.empty()) {
+                    numDroppedPackets++;
+                }
             }
+            continue;
         }
-    }
-
-    // Check
-    assert(i == (Parameters::inputSize * Parameters::inputSize));
-}
-
-void buildDetectors(unsigned int *excitatoryRowLength, unsigned int *excitatoryInd,
-                    unsigned int *inhibitoryRowLength, unsigned int *inhibitoryInd)
-{
-    // Loop through macro cells
-    unsigned int iExcitatory = 0;
-    unsigned int iInhibitory = 0;
-    for(unsigned int yi = 0; yi < Parameters::macroPixelSize; yi++)
-    {
-        for(unsigned int xi = 0; xi < Parameters::macroPixelSize; xi++)
-        {
-            // Get index of start of row
-            unsigned int sExcitatory = (iExcitatory * Parameters::DetectorMax);
-            unsigned int sInhibitory = (iInhibitory * Parameters::DetectorMax);
-            
-            // If we're not in border region
-            if(xi >= 1 && xi < (Parameters::macroPixelSize - 1)
-                && yi >= 1 && yi < (Parameters::macroPixelSize - 1))
-            {
-                const unsigned int xj = (xi - 1) * Parameters::DetectorMax;
-                const unsigned int yj = yi - 1;
-
-                // Add excitatory synapses to all detectors
-                excitatoryInd[sExcitatory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorLeft, yj);
-                excitatoryInd[sExcitatory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorRight, yj);
-                excitatoryInd[sExcitatory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorUp, yj);
-                excitatoryInd[sExcitatory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorDown, yj);
-                excitatoryRowLength[iExcitatory++] = 4;
-            }
-            else {
-                excitatoryRowLength[iExcitatory++] = 0;
-            }
-
-
-            // Create inhibitory connection to 'left' detector associated with macropixel one to right
-            inhibitoryRowLength[iInhibitory] = 0;
-            if(xi < (Parameters::macroPixelSize - 2)
-                && yi >= 1 && yi < (Parameters::macroPixelSize - 1))
-            {
-                const unsigned int xj = (xi - 1 + 1) * Parameters::DetectorMax;
-                const unsigned int yj = yi - 1;
-                inhibitoryInd[sInhibitory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorLeft, yj);
-                inhibitoryRowLength[iInhibitory]++;
-            }
 
-            // Create inhibitory connection to 'right' detector associated with macropixel one to right
-            if(xi >= 2
-                && yi >= 1 && yi < (Parameters::macroPixelSize - 1))
-            {
-                const unsigned int xj = (xi - 1 - 1) * Parameters::DetectorMax;
-                const unsigned int yj = yi - 1;
-                inhibitoryInd[sInhibitory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorRight, yj);
-                inhibitoryRowLength[iInhibitory]++;
-            }
-
-            // Create inhibitory connection to 'up' detector associated with macropixel one below
-            if(xi >= 1 && xi < (Parameters::macroPixelSize - 1)
-                && yi < (Parameters::macroPixelSize - 2))
-            {
-                const unsigned int xj = (xi - 1) * Parameters::DetectorMax;
-                const unsigned int yj = yi - 1 + 1;
-                inhibitoryInd[sInhibitory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorUp, yj);
-                inhibitoryRowLength[iInhibitory]++;
-            }
-
-            // Create inhibitory connection to 'down' detector associated with macropixel one above
-            if(xi >= 1 && xi < (Parameters::macroPixelSize - 1)
-                && yi >= 2)
-            {
-                const unsigned int xj = (xi - 1) * Parameters::DetectorMax;
-                const unsigned int yj = yi - 1 - 1;
-                inhibitoryInd[sInhibitory++] = getNeuronIndex(Parameters::detectorSize * Parameters::DetectorMax,
-                                                              xj + Parameters::DetectorDown, yj);
-                inhibitoryRowLength[iInhibitory]++;
-            }
-            iInhibitory++;
+        // Read events in ROI directly into slot - noise is filtered by the simulation thread's pipeline
+        batch->events.clear();
+        dvs.template readEventBatch<Filter>(batch->events);
+        batch->time = std::chrono::high_resolution_clock::now();
 
+        // Replayed frames always correspond to a timestep so are always passed on,
+        // but there's no point waking the simulation loop for empty live packets
+        if(lockstep || !batch->events.empty()) {
+            ring.endWrite();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
     }
 
-    // Check
-    assert(iExcitatory == (Parameters::macroPixelSize * Parameters::macroPixelSize));
-    assert(iInhibitory == (Parameters::macroPixelSize * Parameters::macroPixelSize));
+    finished = true;
 }
 
-void displayThreadHandler(std::mutex &inputMutex, const cv::Mat &inputImage,
-                          std::mutex &outputMutex, const float (&output)[Parameters::detectorSize][Parameters::detectorSize][2])
+void displayThreadHandler(const std::atomic<bool> &running,
+                          TripleBuffer<cv::Mat> &inputSnapshot, TripleBuffer<OutputFlow> &outputSnapshot)
 {
     cv::namedWindow("Input", cv::WINDOW_NORMAL);
     cv::resizeWindow("Input", Parameters::inputSize * Parameters::inputScale,
@@ -184,26 +128,27 @@ void displayThreadHandler(std::mutex &inputMutex, const cv::Mat &inputImage,
     std::ifstream cpuPowerStream("/sys/devices/platform/7000c400.i2c/i2c-1/1-0040/iio_device/in_power2_input");
 #endif  // JETSON_POWER
 
-    while(g_SignalStatus == 0)
+    while(running)
     {
+        // Pick up latest snapshots
+        inputSnapshot.update();
+        outputSnapshot.update();
+
         // Clear background
         outputImage.setTo(cv::Scalar::all(0));
 
+        // Loop through output coordinates
+        const auto &output = outputSnapshot.getFront().flow;
+        for(unsigned int x = 0; x < Parameters::detectorSize; x++)
         {
-            std::lock_guard<std::mutex> lock(outputMutex);
-
-            // Loop through output coordinates
-            for(unsigned int x = 0; x < Parameters::detectorSize; x++)
+            for(unsigned int y = 0; y < Parameters::detectorSize; y++)
             {
-                for(unsigned int y = 0; y < Parameters::detectorSize; y++)
-                {
-                    const cv::Point start(x * Parameters::outputScale, y * Parameters::outputScale);
-                    const cv::Point end = start + cv::Point(Parameters::outputVectorScale * output[x][y][0],
-                                                            Parameters::outputVectorScale * output[x][y][1]);
-
-                    cv::line(outputImage, start, end,
-                             CV_RGB(0xFF, 0xFF, 0xFF));
-                }
+                const cv::Point start(x * Parameters::outputScale, y * Parameters::outputScale);
+                const cv::Point end = start + cv::Point(Parameters::outputVectorScale * output[x][y][0],
+                                                        Parameters::outputVectorScale * output[x][y][1]);
+
+                cv::line(outputImage, start, end,
+                         CV_RGB(0xFF, 0xFF, 0xFF));
             }
         }
 
@@ -231,17 +176,16 @@ void displayThreadHandler(std::mutex &inputMutex, const cv::Mat &inputImage,
 
         cv::imshow("Output", outputImage);
 
-        {
-            std::lock_guard<std::mutex> lock(inputMutex);
-            cv::imshow("Input", inputImage);
+        // Input snapshot is empty until the simulation loop publishes its first one
+        if(!inputSnapshot.getFront().empty()) {
+            cv::imshow("Input", inputSnapshot.getFront());
         }
 
-
         cv::waitKey(33);
     }
 }
 
-void applyOutputSpikes(unsigned int outputSpikeCount, const unsigned int *outputSpikes, float (&output)[Parameters::detectorSize][Parameters::detectorSize][2])
+void applyOutputSpikes(unsigned int outputSpikeCount, const unsigned int *outputSpikes, TimeSurface &flowSurface)
 {
     // Loop through output spikes
     for(unsigned int s = 0; s < outputSpikeCount; s++)
@@ -254,72 +198,94 @@ void applyOutputSpikes(unsigned int outputSpikeCount, const unsigned int *output
         const int spikeX =  xCoord.quot;
 
         // Apply spike to correct axis of output pixel based on detector it was emitted by
+        // **NOTE** pixels are indexed in the same x-major order as OutputFlow::flow so surface can be materialised directly into it
+        const unsigned int pixel = (spikeX * Parameters::detectorSize) + spikeY;
         switch(xCoord.rem)
         {
             case Parameters::DetectorLeft:
-                output[spikeX][spikeY][0] -= 1.0f;
+                flowSurface.add(pixel, 0, -1.0f);
                 break;
 
             case Parameters::DetectorRight:
-                output[spikeX][spikeY][0] += 1.0f;
+                flowSurface.add(pixel, 0, 1.0f);
                 break;
 
             case Parameters::DetectorUp:
-                output[spikeX][spikeY][1] -= 1.0f;
+                flowSurface.add(pixel, 1, -1.0f);
                 break;
 
             case Parameters::DetectorDown:
-                output[spikeX][spikeY][1] += 1.0f;
+                flowSurface.add(pixel, 1, 1.0f);
                 break;
 
         }
     }
 
     // Decay output
-    for(unsigned int x = 0; x < Parameters::detectorSize; x++)
-    {
-        for(unsigned int y = 0; y < Parameters::detectorSize; y++)
-        {
-            output[x][y][0] *= Parameters::flowPersistence;
-            output[x][y][1] *= Parameters::flowPersistence;
-        }
-    }
+    // **NOTE** decay is applied lazily to pixels as they are touched
+    flowSurface.step();
 }
 }
 
-int main()
+// Run with no arguments to process events from a DVXplorer or pass the filename of a CSV recording from a DVXplorer
+// to replay it through DVSPreRecorded, optionally writing a latency report and replaying as fast as possible
+// rather than in real-time:
+//      ./optical_flow [recording.csv [latency report.json [0 to replay as fast as possible]]]
+int main(int argc, char *argv[])
 {
     constexpr unsigned int timestepWords = ((Parameters::inputSize * Parameters::inputSize) + 31) / 32;
-    
+
     allocateMem();
     allocatespikeVectorDVS(timestepWords);
     initialize();
-
-    buildCentreToMacroConnection(rowLengthDVS_MacroPixel, indDVS_MacroPixel);
-    buildDetectors(rowLengthMacroPixel_Output_Excitatory, indMacroPixel_Output_Excitatory,
-                   rowLengthMacroPixel_Output_Inhibitory, indMacroPixel_Output_Inhibitory);
-
     initializeSparse();
 
-    // Create DVXplorer device
-    using Filter = DVS::CombineFilter<DVS::PolarityFilter<DVS::Polarity::ON>, DVS::ROIFilter<80, 560, 0, 480>>;
-    using TransformX = DVS::Subtract<80>;
-    using TransformY = DVS::NoTransform;
-    DVS::DVXplorer dvs;
-    dvs.start();
-    
-    double dvsGet = 0.0;
-    double step = 0.0;
-    double render = 0.0;
-
-    std::mutex inputMutex;
-    cv::Mat inputImage(Parameters::inputSize, Parameters::inputSize, CV_32F);
-
-    std::mutex outputMutex;
-    float output[Parameters::detectorSize][Parameters::detectorSize][2] = {0};
-    std::thread displayThread(displayThreadHandler,
-                              std::ref(inputMutex), std::ref(inputImage),
-                              std::ref(outputMutex), std::ref(output));
+    // Start thread to acquire events from either recording or DVXplorer device
+    // **NOTE** replayed frames are simulated in lockstep, one per timestep, so runs are repeatable
+    const bool replay = (argc > 1);
+    const std::string reportFilename = (argc > 2) ? argv[2] : "";
+    const bool realTime = (argc > 3) ? (std::atoi(argv[3]) != 0) : true;
+    EventRing eventRing(acquisitionRingCapacity);
+    std::atomic<bool> running{true};
+    std::atomic<bool> acquisitionFinished{false};
+    std::atomic<unsigned int> numDroppedPackets{0};
+    EventPipeline eventPipeline(Parameters::sensorWidth, Parameters::sensorHeight, Parameters::refractoryUs, Parameters::correlationUs);
+    std::unique_ptr<DVSPreRecorded> replayDVS;
+    std::unique_ptr<DVS::DVXplorer> liveDVS;
+    std::thread acquisitionThread;
+    if(replay) {
+        replayDVS.reset(new DVSPreRecorded(argv[1], DVSPreRecorded::Polarity::Both, DT, false,
+                                            Parameters::sensorWidth, Parameters::sensorHeight));
+        acquisitionThread = std::thread(acquisitionThreadHandler<DVSPreRecorded>, std::ref(*replayDVS), true,
+                                        std::ref(eventRing), std::cref(running), std::ref(acquisitionFinished),
+                                        std::ref(numDroppedPackets));
+    }
+    else {
+        liveDVS.reset(new DVS::DVXplorer);
+        liveDVS->start();
+        acquisitionThread = std::thread(acquisitionThreadHandler<DVS::DVXplorer>, std::ref(*liveDVS), false,
+                                        std::ref(eventRing), std::cref(running), std::ref(acquisitionFinished),
+                                        std::ref(numDroppedPackets));
+    }
+
+    // Add latency report stages
+    LatencyReport report;
+    auto &acquireLatency = report.addStage("acquire");
+    auto &pushLatency = report.addStage("push");
+    auto &stepLatency = report.addStage("step");
+    auto &pullLatency = report.addStage("pull");
+    auto &inputRenderLatency = report.addStage("input_render");
+    auto &outputRenderLatency = report.addStage("output_render");
+    auto &eventToSpikeLatency = report.addStage("event_to_spike");
+
+    // Input image and output flow field are only touched by simulation loop and are
+    // materialised into triple buffers whenever display has picked up the last snapshot
+    TimeSurface inputSurface(Parameters::inputSize * Parameters::inputSize, 1, Parameters::spikePersistence);
+    TimeSurface flowSurface(Parameters::detectorSize * Parameters::detectorSize, 2, Parameters::flowPersistence);
+    TripleBuffer<cv::Mat> inputSnapshot;
+    TripleBuffer<OutputFlow> outputSnapshot(OutputFlow{});
+    std::thread displayThread(displayThreadHandler, std::cref(running),
+                              std::ref(inputSnapshot), std::ref(outputSnapshot));
 
     // Convert timestep to a duration
     const auto dtDuration = std::chrono::duration<double, std::milli>{DT};
@@ -328,7 +294,7 @@ int main()
     std::chrono::duration<double> sleepTime{0};
     std::chrono::duration<double> overrunTime{0};
     unsigned int i = 0;
-    
+
     // Catch interrupt (ctrl-c) signals
     std::signal(SIGINT, signalHandler);
 
@@ -336,90 +302,174 @@ int main()
     {
         auto tickStart = std::chrono::high_resolution_clock::now();
 
+        // Time at which oldest batch of events processed this timestep was acquired
+        std::chrono::high_resolution_clock::time_point eventTime;
+        bool anyEvents = false;
         {
-            TimerAccumulate timer(dvsGet);
-            
+            LatencyTimer timer(acquireLatency);
+
             std::fill_n(spikeVectorDVS, timestepWords, 0);
-            dvs.readEvents<Parameters::inputSize, Filter, TransformX, TransformY>(spikeVectorDVS);
+
+            // Filter events in a ring slot into spike bits and return it to acquisition thread
+            auto consume = [&eventRing, &eventPipeline, &eventTime, &anyEvents](const AcquiredBatch &batch)
+            {
+                if(!anyEvents && !batch.events.empty()) {
+                    eventTime = batch.time;
+                    anyEvents = true;
+                }
+                eventPipeline.process(batch.events, spikeVectorDVS);
+                eventRing.endRead();
+            };
+
+            // If we're replaying, wait for this timestep's frame
+            if(replay) {
+                const AcquiredBatch *batch = nullptr;
+                while(true) {
+                    // **NOTE** finished flag is read first so, if it's set, the final frame will be visible
+                    const bool finished = acquisitionFinished;
+                    batch = eventRing.beginRead();
+                    if(batch != nullptr || finished) {
+                        break;
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+
+                // Stop if recording has been completely replayed
+                if(batch == nullptr) {
+                    break;
+                }
+                consume(*batch);
+            }
+            // Otherwise, drain all events acquired since last timestep
+            else {
+                for(const auto *batch = eventRing.beginRead(); batch != nullptr; batch = eventRing.beginRead()) {
+                    consume(*batch);
+                }
+            }
+
+        }
+
+        {
+            LatencyTimer timer(pushLatency);
 
             // Copy to GPU
             pushspikeVectorDVSToDevice(timestepWords);
         }
 
         {
-            TimerAccumulate timer(render);
-            std::lock_guard<std::mutex> lock(inputMutex);
+            LatencyTimer timer(inputRenderLatency);
 
             {
                 for(unsigned int w = 0; w < timestepWords; w++) {
                     // Get word
                     uint32_t spikeWord = spikeVectorDVS[w];
-                    
+
                     // Calculate neuron id of highest bit of this word
                     unsigned int neuronID = (w * 32) + 31;
-                    
+
                     // While bits remain
                     while(spikeWord != 0) {
                         // Calculate leading zeros
                         const int numLZ = __builtin_clz(spikeWord);
-                        
+
                         // If all bits have now been processed, zero spike word
                         // Otherwise shift past the spike we have found
                         spikeWord = (numLZ == 31) ? 0 : (spikeWord << (numLZ + 1));
-                        
+
                         // Subtract number of leading zeros from neuron ID
                         neuronID -= numLZ;
-                        
-                        // Write out CSV line
-                        const auto spikeCoord = std::div((int)neuronID, (int)Parameters::inputSize);
-                        inputImage.at<float>(spikeCoord.quot, spikeCoord.rem) += 1.0f;
-                        
+
+                        // Add spike to image
+                        inputSurface.add(neuronID, 0, 1.0f);
+
                         // New neuron id of the highest bit of this word
                         neuronID--;
                     }
                 }
 
                 // Decay image
-                inputImage *= Parameters::spikePersistence;
+                // **NOTE** decay is applied lazily to pixels as they are touched
+                inputSurface.step();
+            }
+
+            // If display has picked up last input snapshot, publish a new one
+            if(!inputSnapshot.isPending()) {
+                materialiseSpikeImage(inputSurface, Parameters::inputSize, inputSnapshot.getBack());
+                inputSnapshot.publish();
             }
         }
 
         {
-            TimerAccumulate timer(step);
+            LatencyTimer timer(stepLatency);
 
             // Simulate
             stepTime();
+        }
+
+        {
+            LatencyTimer timer(pullLatency);
             pullOutputCurrentSpikesFromDevice();
         }
 
+        // If any detectors spiked, record latency from acquisition of the events processed this timestep
+        if(anyEvents && spikeCount_Output > 0) {
+            eventToSpikeLatency.record(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - eventTime).count());
+        }
+
         {
-            TimerAccumulate timer(render);
-            {
-                std::lock_guard<std::mutex> lock(outputMutex);
-                applyOutputSpikes(spikeCount_Output, spike_Output, output);
+            LatencyTimer timer(outputRenderLatency);
+            applyOutputSpikes(spikeCount_Output, spike_Output, flowSurface);
+
+            // If display has picked up last output snapshot, publish a new one
+            if(!outputSnapshot.isPending()) {
+                flowSurface.materialise(&outputSnapshot.getBack().flow[0][0][0]);
+                outputSnapshot.publish();
             }
         }
 
         // Get time of tick start
         auto tickEnd = std::chrono::high_resolution_clock::now();
 
-        // If there we're ahead of real-time pause
+        // If there we're ahead of real-time pause (unless replaying as fast as possible)
         auto tickDuration = tickEnd - tickStart;
         if(tickDuration < dtDuration) {
-            auto tickSleep = dtDuration - tickDuration;
-            sleepTime += tickSleep;
-            std::this_thread::sleep_for(tickSleep);
+            if(realTime) {
+                auto tickSleep = dtDuration - tickDuration;
+                sleepTime += tickSleep;
+                std::this_thread::sleep_for(tickSleep);
+            }
         }
         else {
             overrunTime += (tickDuration - dtDuration);
         }
     }
 
-    // Wait for display thread to die
+    // Stop acquisition and display threads and wait for them to die
+    running = false;
+    acquisitionThread.join();
     displayThread.join();
 
     std::cout << "Ran for " << i << " " << DT << "ms timesteps, overan for " << overrunTime.count() << "s, slept for " << sleepTime.count() << "s" << std::endl;
-    std::cout << "Average DVS:" << (dvsGet * 1000.0) / i<< "ms, Step:" << (step * 1000.0) / i << "s, Render:" << (render * 1000.0) / i<< std::endl;
+    std::cout << "Average DVS:" << acquireLatency.getMean() * 1000.0 << "ms, Push:" << pushLatency.getMean() * 1000.0
+              << "ms, Step:" << stepLatency.getMean() * 1000.0 << "ms, Pull:" << pullLatency.getMean() * 1000.0
+              << "ms, Render:" << (inputRenderLatency.getMean() + outputRenderLatency.getMean()) * 1000.0 << "ms" << std::endl;
+    std::cout << eventPipeline.getNumEvents() << " DVS events in ROI: " << eventPipeline.getNumRefractory() << " refractory, "
+              << eventPipeline.getNumBackground() << " background activity" << std::endl;
+    if(!replay) {
+        std::cout << numDroppedPackets << " DVS packets dropped due to full acquisition ring" << std::endl;
+    }
+
+    // Write latency report
+    if(!reportFilename.empty()) {
+        report.setMetadata("example", "dvs_optical_flow");
+        report.setMetadata("source", replay ? argv[1] : "DVXplorer");
+        report.setMetadata("real_time", realTime ? 1.0 : 0.0);
+        report.setMetadata("steps", i);
+        report.setMetadata("overrun_s", overrunTime.count());
+        report.setMetadata("dvs_events", (double)eventPipeline.getNumEvents());
+        report.setMetadata("dvs_spikes", (double)eventPipeline.getNumSpikes());
+        report.write(reportFilename);
+    }
 
     return 0;
 }
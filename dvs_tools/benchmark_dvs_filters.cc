@@ -0,0 +1,283 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdlib>
+
+// Common includes
+#include "../common/dvs_event_file.h"
+#include "../common/dvs_event_pipeline.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// Same configuration as dvs_optical_flow - centre 480x480 ON pixels of a 640x480 DVXplorer
+constexpr unsigned int sensorWidth = 640;
+constexpr unsigned int sensorHeight = 480;
+constexpr unsigned int outputSize = 480;
+constexpr unsigned int outputWords = ((outputSize * outputSize) + 31) / 32;
+using Filter = DVS::CombineFilter<DVS::PolarityFilter<DVS::Polarity::ON>, DVS::ROIFilter<80, 560, 0, 480>>;
+using TransformX = DVS::Subtract<80>;
+using TransformY = DVS::NoTransform;
+
+//! Event with the same accessors as libcaer's polarity events
+struct Event
+{
+    uint32_t timestamp;
+    uint16_t x;
+    uint16_t y;
+    bool polarity;
+
+    uint16_t getX() const{ return x; }
+    uint16_t getY() const{ return y; }
+    bool getPolarity() const{ return polarity; }
+};
+
+// Generate a synthetic recording of an edge sweeping across the sensor, on top of uniform
+// background activity and a handful of hot pixels which fire continuously
+std::vector<DVSEventFile::Event> generateEvents(unsigned int numEvents)
+{
+    std::mt19937 rng;
+    std::uniform_int_distribution<unsigned int> sourceDist(0, 99);
+    std::uniform_int_distribution<unsigned int> xDist(0, sensorWidth - 1);
+    std::uniform_int_distribution<unsigned int> yDist(0, sensorHeight - 1);
+    std::uniform_int_distribution<unsigned int> polarityDist(0, 1);
+    std::uniform_int_distribution<unsigned int> hotPixelDist(0, 15);
+    std::normal_distribution<double> edgeDist(0.0, 1.5);
+
+    // Pick hot pixels
+    std::vector<std::pair<uint16_t, uint16_t>> hotPixels(16);
+    std::generate(hotPixels.begin(), hotPixels.end(),
+                  [&](){ return std::make_pair((uint16_t)xDist(rng), (uint16_t)yDist(rng)); });
+
+    // ~1M events/s with the edge crossing the sensor every 100ms
+    std::vector<DVSEventFile::Event> events;
+    events.reserve(numEvents);
+    for(unsigned int i = 0; i < numEvents; i++) {
+        const uint32_t timestamp = i;
+        const unsigned int source = sourceDist(rng);
+
+        // 80% of events come from the edge
+        if(source < 80) {
+            const double edgeX = (double)(timestamp % 100000) * (double)sensorWidth / 100000.0;
+            const int x = std::min((int)sensorWidth - 1, std::max(0, (int)(edgeX + edgeDist(rng))));
+            events.push_back(DVSEventFile::makeEvent(timestamp, (uint16_t)x, (uint16_t)yDist(rng), true));
+        }
+        // 10% from hot pixels
+        else if(source < 90) {
+            const auto &hot = hotPixels[hotPixelDist(rng)];
+            events.push_back(DVSEventFile::makeEvent(timestamp, hot.first, hot.second, true));
+        }
+        // And the remainder are background activity
+        else {
+            events.push_back(DVSEventFile::makeEvent(timestamp, (uint16_t)xDist(rng), (uint16_t)yDist(rng),
+                                                     polarityDist(rng) == 1));
+        }
+    }
+    return events;
+}
+
+// Split recording into frames of events
+std::vector<std::vector<Event>> splitFrames(const std::vector<DVSEventFile::Event> &events, uint32_t frameDurationUs)
+{
+    std::vector<std::vector<Event>> frames;
+    uint32_t frameEndTimestamp = events.empty() ? 0 : (events.front().timestamp + frameDurationUs);
+    frames.emplace_back();
+    for(const auto &e : events) {
+        while(e.timestamp > frameEndTimestamp) {
+            frames.emplace_back();
+            frameEndTimestamp += frameDurationUs;
+        }
+        frames.back().push_back(Event{e.timestamp, e.x, e.getY(), e.getPolarity()});
+    }
+    return frames;
+}
+
+// Filter and transform events one at a time, as DVS::Base::readEvents does
+void processPerEvent(const std::vector<std::vector<Event>> &frames, std::vector<uint32_t> &spikeVector)
+{
+    for(const auto &frame : frames) {
+        for(const auto &event : frame) {
+            if(Filter::shouldAllow(event)) {
+                const uint32_t a = TransformX::transform(event.getX()) + (TransformY::transform(event.getY()) * outputSize);
+                spikeVector[a / 32] |= (1 << (a % 32));
+            }
+        }
+    }
+}
+
+// Read events which pass the stateless filter into a batch, as DVS::Base::readEventBatch does, and
+// filter and transform them using pipeline. Like a slot in dvs_optical_flow's acquisition ring, the batch is reused
+template<unsigned int size, typename TX, typename TY, typename F>
+void readAndProcess(const std::vector<std::vector<Event>> &frames, DVS::EventPipeline<size, TX, TY> &pipeline,
+                    F filter, std::vector<uint32_t> &spikeVector)
+{
+    DVS::EventBatch batch;
+    for(const auto &frame : frames) {
+        batch.clear();
+        for(const auto &event : frame) {
+            if(filter(event)) {
+                batch.add(event.timestamp, event.getX(), event.getY(), event.getPolarity());
+            }
+        }
+        pipeline.process(batch, spikeVector.data());
+    }
+}
+
+// Check noise filters drop exactly the expected events from short hand-made sequences of events at 1ms frames
+bool checkFilters()
+{
+    typedef DVS::EventPipeline<sensorWidth> CheckPipeline;
+    const auto allowAll = [](const Event&){ return true; };
+
+    // Run pipeline on frames of (timestamp, x, y) and check the set of pixels which spiked and the number of events dropped
+    auto check = [&allowAll](const std::string &name, CheckPipeline &pipeline, const std::vector<std::vector<Event>> &frames,
+                             const std::vector<std::pair<uint16_t, uint16_t>> &expectedSpikes,
+                             uint64_t expectedRefractory, uint64_t expectedBackground)
+    {
+        std::vector<uint32_t> spikes(((sensorWidth * sensorHeight) + 31) / 32, 0);
+        readAndProcess(frames, pipeline, allowAll, spikes);
+
+        std::vector<uint32_t> expected(spikes.size(), 0);
+        for(const auto &p : expectedSpikes) {
+            const uint32_t a = p.first + (p.second * sensorWidth);
+            expected[a / 32] |= (1 << (a % 32));
+        }
+        if(spikes != expected || pipeline.getNumRefractory() != expectedRefractory
+           || pipeline.getNumBackground() != expectedBackground)
+        {
+            std::cerr << name << " filter check failed: " << pipeline.getNumRefractory() << " refractory, "
+                      << pipeline.getNumBackground() << " background activity" << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    // Hot pixel at (10, 10) fires repeatedly - each of its events restarts the 1ms refractory period so only the
+    // first and one after a 1.3ms gap pass. Events at (20, 20) are spaced more widely than the refractory period
+    CheckPipeline refractory(sensorWidth, sensorHeight, 1000, 0);
+    const bool refractoryCorrect = check("Refractory", refractory,
+        {{{0, 10, 10, true}, {0, 20, 20, true}, {500, 10, 10, true}},
+         {{1200, 10, 10, true}, {1500, 20, 20, true}},
+         {{2500, 10, 10, true}, {3000, 20, 20, true}}},
+        {{10, 10}, {20, 20}}, 2, 0);
+
+    // Isolated events are dropped, as are repeated events from the same pixel and events whose neighbour produced
+    // an event more than 5ms earlier, but events with a neighbour which produced an event in the last 5ms pass,
+    // including at the edges of the sensor
+    CheckPipeline background(sensorWidth, sensorHeight, 0, 5000);
+    const bool backgroundCorrect = check("Background activity", background,
+        {{{0, 100, 100, true}, {100, 101, 101, true}, {200, 200, 200, true}, {300, 200, 200, true}},
+         {{1000, 0, 0, true}, {1100, 1, 0, true}, {1200, sensorWidth - 1, sensorHeight - 1, true}},
+         {{7000, 300, 300, true}},
+         {{13000, 301, 300, true}}},
+        {{101, 101}, {1, 0}}, 0, 7);
+
+    // Each of an isolated pixel's 8 neighbours is supported by an event from it
+    std::vector<std::vector<Event>> neighbourFrames;
+    std::vector<std::pair<uint16_t, uint16_t>> neighbourSpikes;
+    for(int dy = -1; dy <= 1; dy++) {
+        for(int dx = -1; dx <= 1; dx++) {
+            if(dx != 0 || dy != 0) {
+                const uint16_t x = (uint16_t)(50 + (10 * neighbourFrames.size()));
+                const uint32_t t = 1000 * (uint32_t)neighbourFrames.size();
+                neighbourFrames.push_back({{t, x, 400, true}, {t + 100, (uint16_t)(x + dx), (uint16_t)(400 + dy), true}});
+                neighbourSpikes.emplace_back((uint16_t)(x + dx), (uint16_t)(400 + dy));
+            }
+        }
+    }
+    CheckPipeline neighbour(sensorWidth, sensorHeight, 0, 5000);
+    const bool neighbourCorrect = check("Background activity neighbourhood", neighbour, neighbourFrames, neighbourSpikes, 0, 8);
+
+    return refractoryCorrect && backgroundCorrect && neighbourCorrect;
+}
+
+template<typename F>
+double time(F f)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+}   // Anonymous namespace
+
+// Compares the throughput of filtering events one at a time with reading filtered events into batches and
+// removing noise from them using DVS::EventPipeline, then checks the noise filters on hand-made sequences of events:
+//      ./benchmark_dvs_filters [num events] [recording.csv]
+// If no recording is specified, a synthetic one is generated
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const unsigned int numEvents = (argc > 1) ? std::stoul(argv[1]) : 10000000;
+        const uint32_t frameDurationUs = 1000;
+        const uint32_t refractoryUs = 1000;
+        const uint32_t correlationUs = 5000;
+
+        // Load or generate recording
+        std::vector<DVSEventFile::Event> events;
+        if(argc > 2) {
+            events = DVSEventFile::readCSV(argv[2]);
+            if(events.size() > numEvents) {
+                events.resize(numEvents);
+            }
+        }
+        else {
+            events = generateEvents(numEvents);
+        }
+        std::cout << events.size() << " events" << std::endl;
+
+        // Split events into frames for both approaches
+        const auto frames = splitFrames(events, frameDurationUs);
+        const auto filter = [](const Event &event){ return Filter::shouldAllow(event); };
+
+        // Process events one at a time
+        std::vector<uint32_t> perEventSpikes(outputWords, 0);
+        const double perEventS = time([&](){ processPerEvent(frames, perEventSpikes); });
+
+        // Read events into batches and process them with noise filters disabled
+        DVS::EventPipeline<outputSize, TransformX, TransformY> statelessPipeline(sensorWidth, sensorHeight);
+        std::vector<uint32_t> statelessSpikes(outputWords, 0);
+        const double statelessS = time([&](){ readAndProcess(frames, statelessPipeline, filter, statelessSpikes); });
+
+        // Read events into batches and process them with noise filters
+        DVS::EventPipeline<outputSize, TransformX, TransformY> pipeline(sensorWidth, sensorHeight, refractoryUs, correlationUs);
+        std::vector<uint32_t> pipelineSpikes(outputWords, 0);
+        const double pipelineS = time([&](){ readAndProcess(frames, pipeline, filter, pipelineSpikes); });
+
+        const double numEventsM = (double)events.size() / 1.0E6;
+        std::cout << "Per-event filter:" << perEventS << "s (" << numEventsM / perEventS << "M events/s)" << std::endl;
+        std::cout << "Read batches and pipeline without noise filters:" << statelessS << "s ("
+                  << numEventsM / statelessS << "M events/s, " << perEventS / statelessS << "x per-event)" << std::endl;
+        std::cout << "Read batches and pipeline with refractory and background activity filters:" << pipelineS << "s ("
+                  << numEventsM / pipelineS << "M events/s, " << perEventS / pipelineS << "x per-event)" << std::endl;
+        std::cout << "\t" << pipeline.getNumEvents() << " events passed ROI and polarity filter, " << pipeline.getNumRefractory()
+                  << " removed by refractory filter, " << pipeline.getNumBackground() << " removed by background activity filter, "
+                  << pipeline.getNumSpikes() << " remain" << std::endl;
+
+        // Without noise filters, both paths should set exactly the same bits
+        if(perEventSpikes != statelessSpikes) {
+            std::cerr << "Per-event filter and pipeline disagree" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Check noise filters drop the right events
+        if(!checkFilters()) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
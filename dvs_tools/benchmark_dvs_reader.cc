@@ -0,0 +1,136 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdlib>
+
+// Common includes
+#include "../common/dvs_event_file.h"
+#include "../common/dvs_pre_recorded.h"
+#include "../common/dvs_pre_recorded_mapped.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// Write a synthetic recording with Poisson-distributed event times and uniformly distributed addresses
+void generateCSV(const std::string &filename, unsigned int numEvents, double eventRateHz)
+{
+    std::mt19937 rng;
+    std::exponential_distribution<double> isi(eventRateHz / 1000000.0);
+    std::uniform_int_distribution<unsigned int> coord(0, 127);
+    std::uniform_int_distribution<unsigned int> polarity(0, 1);
+
+    std::ofstream csv(filename);
+    csv << "Timestamp,X,Y,Polarity" << std::endl;
+    double time = 0.0;
+    for(unsigned int i = 0; i < numEvents; i++) {
+        time += isi(rng);
+        csv << (unsigned int)time << "," << coord(rng) << "," << coord(rng) << "," << polarity(rng) << "\n";
+    }
+}
+
+// Read every frame of the recording, returning the total number of spikes and a checksum
+template<typename Reader>
+std::pair<uint64_t, uint64_t> readAll(Reader &reader, uint64_t numFrames, std::vector<unsigned int> &spikes)
+{
+    uint64_t numSpikes = 0;
+    uint64_t checksum = 0;
+    for(uint64_t f = 0; f < numFrames; f++) {
+        unsigned int spikeCount;
+        reader.readEvents(spikeCount, spikes.data());
+
+        numSpikes += spikeCount;
+        for(unsigned int s = 0; s < spikeCount; s++) {
+            checksum = (checksum * 31) + spikes[s];
+        }
+    }
+    return std::make_pair(numSpikes, checksum);
+}
+}
+
+// Compares the throughput of DVSPreRecorded (CSV) and DVSPreRecordedMapped (binary) on the same recording
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const double dt = 1.0;
+        const unsigned int numEvents = (argc > 1) ? std::stoul(argv[1]) : 5000000;
+        std::string csvFilename = (argc > 2) ? argv[2] : "benchmark_events.csv";
+        const std::string binFilename = csvFilename + ".bin";
+
+        // Generate synthetic recording if none is provided (~500k events/s is typical for a busy DVS128 scene)
+        if(argc < 3) {
+            std::cout << "Generating " << numEvents << " events" << std::endl;
+            generateCSV(csvFilename, numEvents, 500000.0);
+        }
+
+        // Convert to binary
+        DVSEventFile::write(binFilename, DVSEventFile::readCSV(csvFilename), (unsigned int)(dt * 1000.0), 128, 128);
+
+        // Read number of frames and largest frame from index
+        uint64_t numFrames = 0;
+        uint64_t maxFrameEvents = 0;
+        {
+            std::ifstream bin(binFilename, std::ifstream::binary);
+            DVSEventFile::Header header;
+            bin.read(reinterpret_cast<char*>(&header), sizeof(DVSEventFile::Header));
+            std::vector<uint64_t> frameEnd(header.numFrames);
+            bin.read(reinterpret_cast<char*>(frameEnd.data()), sizeof(uint64_t) * header.numFrames);
+
+            numFrames = header.numFrames;
+            uint64_t frameStart = 0;
+            for(uint64_t f : frameEnd) {
+                maxFrameEvents = std::max(maxFrameEvents, f - frameStart);
+                frameStart = f;
+            }
+        }
+        std::vector<unsigned int> spikes(maxFrameEvents);
+
+        for(auto polarity : {DVSPreRecorded::Polarity::Both, DVSPreRecorded::Polarity::On}) {
+            std::cout << ((polarity == DVSPreRecorded::Polarity::Both) ? "Both polarities:" : "On polarity:") << std::endl;
+
+            // Time CSV reader
+            std::pair<uint64_t, uint64_t> csvResult;
+            std::chrono::duration<double> csvDuration;
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                DVSPreRecorded reader(csvFilename.c_str(), polarity, dt);
+                csvResult = readAll(reader, numFrames, spikes);
+                csvDuration = std::chrono::high_resolution_clock::now() - start;
+            }
+
+            // Time mapped reader
+            std::pair<uint64_t, uint64_t> mappedResult;
+            std::chrono::duration<double> mappedDuration;
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                DVSPreRecordedMapped reader(binFilename.c_str(), polarity, dt);
+                mappedResult = readAll(reader, numFrames, spikes);
+                mappedDuration = std::chrono::high_resolution_clock::now() - start;
+            }
+
+            std::cout << "\tCSV:" << csvDuration.count() << "s (" << (csvResult.first / csvDuration.count()) / 1.0E6 << "M events/s)" << std::endl;
+            std::cout << "\tMapped:" << mappedDuration.count() << "s (" << (mappedResult.first / mappedDuration.count()) / 1.0E6 << "M events/s)" << std::endl;
+            std::cout << "\tSpeedup:" << csvDuration.count() / mappedDuration.count() << "x" << std::endl;
+
+            if(csvResult != mappedResult) {
+                std::cerr << "Readers disagree: CSV read " << csvResult.first << " spikes, mapped read " << mappedResult.first << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
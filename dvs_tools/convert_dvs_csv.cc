@@ -0,0 +1,38 @@
+// Standard C++ includes
+#include <iostream>
+#include <string>
+
+// Standard C includes
+#include <cstdlib>
+
+// Common includes
+#include "../common/dvs_event_file.h"
+
+// Converts CSV DVS recordings (as read by DVSPreRecorded) into the binary
+// format read by DVSPreRecordedMapped. The frame index is built for the
+// given timestep so it should match the DT of the model replaying it
+int main(int argc, char *argv[])
+{
+    if(argc < 4) {
+        std::cerr << "Usage: convert_dvs_csv <input.csv> <output.bin> <dt ms> [width=128] [height=128]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const double dt = std::stod(argv[3]);
+        const unsigned int width = (argc > 4) ? std::stoul(argv[4]) : 128;
+        const unsigned int height = (argc > 5) ? std::stoul(argv[5]) : 128;
+
+        const auto events = DVSEventFile::readCSV(argv[1]);
+        DVSEventFile::write(argv[2], events, (unsigned int)(dt * 1000.0), width, height);
+
+        std::cout << "Converted " << events.size() << " events" << std::endl;
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -16,6 +16,9 @@ namespace Parameters
 
     constexpr unsigned int batchSize = 512;
 
+    // Number of testing images streamed into the dataset EGP at a time (0 to load the whole dataset)
+    constexpr unsigned int testChunkImages = 1000;
+
     constexpr unsigned int numInputNeurons = 100;
     constexpr unsigned int numRecurrentNeurons = 800;
     constexpr unsigned int numOutputNeurons = 16;
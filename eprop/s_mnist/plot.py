@@ -1,7 +1,11 @@
 import matplotlib.pyplot as plt
 import matplotlib.patches as patches
 import numpy as np
-from pandas import read_csv
+import sys
+from os import path
+
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "..", "common"))
+from binary_spikes import read_binary_spikes
 
 epoch = 0
 batch = 0
@@ -11,10 +15,9 @@ DT = 1.0
 TRIAL_TIMESTEPS = (28 * 28 * 2) + 20
 
 # Load data
-input_spikes = read_csv("input_spikes_%u_%u.csv" % (epoch, batch), header=None, names=["time", "neuron_id"], skiprows=1, delimiter=",",
-                        dtype={"time":float, "neuron_id":int})
-recurrent_alif_spikes = read_csv("recurrent_alif_spikes_%u_%u.csv" % (epoch, batch), header=None, names=["time", "neuron_id"], skiprows=1, delimiter=",",
-                                 dtype={"time":float, "neuron_id":int})
+spike_dtype = {"names": ("time", "neuron_id"), "formats": (float, int)}
+input_spikes = np.rec.fromarrays(read_binary_spikes("input_spikes_%u_%u.bin" % (epoch, batch)), dtype=spike_dtype)
+recurrent_alif_spikes = np.rec.fromarrays(read_binary_spikes("recurrent_alif_spikes_%u_%u.bin" % (epoch, batch)), dtype=spike_dtype)
 output_data = np.loadtxt("output_%u_%u.csv" % (epoch, batch), delimiter=",", usecols=range(33))
 
 # Create plot
@@ -6,6 +6,9 @@
 #include <numeric>
 #include <random>
 
+// POSIX includes
+#include <dlfcn.h>
+
 // GeNN userproject includes
 #include "analogueRecorder.h"
 #include "spikeRecorder.h"
@@ -15,7 +18,9 @@
 #include "s_mnist_CODE/definitions.h"
 
 // Model parameters
+#include "../../common/binary_spike_recorder.h"
 #include "../../common/mnist_helpers.h"
+#include "../../common/model_checkpoint.h"
 #include "parameters.h"
 
 int main()
@@ -29,7 +34,9 @@ int main()
         initialize();
 
         // Load training data and labels
-        const unsigned int numTrainingImages = loadImageData("mnist/train-images-idx3-ubyte", datasetInput, 
+        // **NOTE** mapped images must remain in scope while the model is reading them
+        IDXFile trainingImages("mnist/train-images-idx3-ubyte", IDXFile::Type::UnsignedByte, 3, mnistEGPAliasesHost);
+        const unsigned int numTrainingImages = loadImageData(trainingImages, datasetInput,
                                                              &allocatedatasetInput, &pushdatasetInputToDevice);
         loadLabelData("mnist/train-labels-idx1-ubyte", numTrainingImages, labelsOutput, 
                       &allocatelabelsOutput, &pushlabelsOutputToDevice);
@@ -42,25 +49,63 @@ int main()
         // Calculate number of batches this equates to
         const unsigned int numBatches = ((numTrainingImages + Parameters::batchSize - 1) / Parameters::batchSize);
 
+        // Register everything training depends on with checkpoint
+        std::mt19937 shuffleRNG;
+        ModelCheckpoint checkpoint([](const std::string &name){ return dlsym(RTLD_DEFAULT, name.c_str()); },
+                                   ModelCheckpoint::getExportedArrays(dlsym(RTLD_DEFAULT, "allocateMem")));
+        checkpoint.addVars<scalar>("RecurrentALIF", Parameters::numRecurrentNeurons, {"V", "A", "RefracTime", "E"});
+        checkpoint.addVars<scalar>("Output", Parameters::numOutputNeurons, {"Y", "Pi", "E", "B", "DeltaB"});
+        checkpoint.addVars<scalar>("InputRecurrentALIF", Parameters::numInputNeurons * Parameters::numRecurrentNeurons,
+                                   {"g", "eFiltered", "epsilonA", "DeltaG"});
+        checkpoint.addVars<scalar>("ALIFALIFRecurrent", Parameters::numRecurrentNeurons * Parameters::numRecurrentNeurons,
+                                   {"g", "eFiltered", "epsilonA", "DeltaG"});
+        checkpoint.addVars<scalar>("RecurrentALIFOutput", Parameters::numRecurrentNeurons * Parameters::numOutputNeurons,
+                                   {"g", "DeltaG"});
+        checkpoint.addVars<scalar>("OutputRecurrentALIF", Parameters::numOutputNeurons * Parameters::numRecurrentNeurons, {"g"});
+
+        // Presynaptic and postsynaptic weight update model variables
+        checkpoint.addVars<scalar>("InputRecurrentALIF", Parameters::numInputNeurons, {"ZFilter"});
+        checkpoint.addVars<scalar>("InputRecurrentALIF", Parameters::numRecurrentNeurons, {"Psi", "FAvg"});
+        checkpoint.addVars<scalar>("ALIFALIFRecurrent", Parameters::numRecurrentNeurons, {"ZFilter", "Psi", "FAvg"});
+        checkpoint.addVars<scalar>("RecurrentALIFOutput", Parameters::numRecurrentNeurons, {"ZFilter"});
+
+        // Adam moments
+        checkpoint.addVars<scalar>("OutputBiasOptimiser", Parameters::numOutputNeurons, {"m", "v"});
+        checkpoint.addVars<scalar>("InputRecurrentWeightOptimiser", Parameters::numInputNeurons * Parameters::numRecurrentNeurons, {"m", "v"});
+        checkpoint.addVars<scalar>("RecurrentRecurrentWeightOptimiser", Parameters::numRecurrentNeurons * Parameters::numRecurrentNeurons, {"m", "v"});
+        checkpoint.addVars<scalar>("RecurrentOutputWeightOptimiser", Parameters::numRecurrentNeurons * Parameters::numOutputNeurons, {"m", "v"});
+
+        // **NOTE** the two DeltaCurr postsynaptic models targetting RecurrentALIF get merged
+        checkpoint.addInSyn<scalar>("RecurrentALIF", Parameters::numRecurrentNeurons,
+                                    {"InputRecurrentALIF", "ALIFALIFRecurrent", "OutputRecurrentALIF"});
+        checkpoint.addInSyn<scalar>("Output", Parameters::numOutputNeurons, {"RecurrentALIFOutput"});
+        checkpoint.addSpikes("Input", Parameters::numInputNeurons);
+        checkpoint.addSpikes("RecurrentALIF", Parameters::numRecurrentNeurons);
+        checkpoint.addEGP<unsigned int>("indicesInput", numTrainingImages);
+        checkpoint.addEGP<unsigned int>("indicesOutput", numTrainingImages);
+        checkpoint.addRNG("shuffleRNG", shuffleRNG);
+
+        // Check no model state has been missed - the dataset and labels are reloaded rather than restored
+        checkpoint.checkComplete({"datasetInput", "labelsOutput"});
+
+        initializeSparse();
+
 #ifdef RESUME_EPOCH
-        // Load from disk
-        loadDense("g_input_recurrent_" + std::to_string(RESUME_EPOCH) + ".bin", gInputRecurrentALIF, 
-                  Parameters::numInputNeurons * Parameters::numRecurrentNeurons);
-        loadDense("g_recurrent_recurrent_" + std::to_string(RESUME_EPOCH) + ".bin", gALIFALIFRecurrent, 
-                  Parameters::numRecurrentNeurons * Parameters::numRecurrentNeurons);
-        loadDense("g_recurrent_output_" + std::to_string(RESUME_EPOCH) + ".bin", gRecurrentALIFOutput, 
-                  Parameters::numRecurrentNeurons * Parameters::numOutputNeurons);
-        loadDense("b_output_" + std::to_string(RESUME_EPOCH) + ".bin", BOutput,
-                  Parameters::numOutputNeurons);
+        // Restore model and shuffle state from end of epoch
+        checkpoint.restore("checkpoint_" + std::to_string(RESUME_EPOCH) + ".bin");
         const unsigned int startEpoch = RESUME_EPOCH + 1;
 #else
         const unsigned int startEpoch = 0;
 #endif
-        initializeSparse();
         
         // Calculate initial transpose
         updateCalculateTranspose();
 
+#ifdef ENABLE_RECORDING
+        // Create background writer for spike recordings
+        BinarySpikeWriter spikeWriter;
+#endif
+
         std::ofstream performance("performance.csv");
         performance << "Epoch, Batch, Num trials, Number correct" << std::endl;
 
@@ -76,7 +121,7 @@ int main()
             
             // Shuffle indices, duplicate to output and upload
             // **TODO** some sort of shared pointer business
-            std::random_shuffle(&indicesInput[0], &indicesInput[numTrainingImages]);
+            std::shuffle(&indicesInput[0], &indicesInput[numTrainingImages], shuffleRNG);
             std::copy_n(indicesInput, numTrainingImages, indicesOutput);
             pushindicesInputToDevice(numTrainingImages);
             pushindicesOutputToDevice(numTrainingImages);
@@ -130,12 +175,10 @@ int main()
                 }
 #ifdef ENABLE_RECORDING
                 pullRecordingBuffersFromDevice();
-                writeTextSpikeRecording("input_spikes_" + filenameSuffix + ".csv", recordSpkInput,
-                                        Parameters::numInputNeurons, Parameters::batchSize * Parameters::trialTimesteps, Parameters::timestepMs,
-                                        ",", true);
-                writeTextSpikeRecording("recurrent_alif_spikes_" + filenameSuffix + ".csv", recordSpkRecurrentALIF,
-                                        Parameters::numRecurrentNeurons, Parameters::batchSize * Parameters::trialTimesteps, Parameters::timestepMs,
-                                        ",", true);
+                writeBinarySpikeRecording(spikeWriter, "input_spikes_" + filenameSuffix + ".bin", recordSpkInput,
+                                          Parameters::numInputNeurons, Parameters::batchSize * Parameters::trialTimesteps, Parameters::timestepMs);
+                writeBinarySpikeRecording(spikeWriter, "recurrent_alif_spikes_" + filenameSuffix + ".bin", recordSpkRecurrentALIF,
+                                          Parameters::numRecurrentNeurons, Parameters::batchSize * Parameters::trialTimesteps, Parameters::timestepMs);
 #endif
                 // Update weights
                 const unsigned int adamStep = (epoch * numBatches) + batch;
@@ -176,7 +219,13 @@ int main()
                       Parameters::numRecurrentNeurons * Parameters::numOutputNeurons);
             saveDense("b_output_" + std::to_string(epoch) + ".bin", BOutput,
                       Parameters::numOutputNeurons);
+
+            // Checkpoint everything so training can be resumed from this epoch
+            checkpoint.save("checkpoint_" + std::to_string(epoch) + ".bin");
         }
+
+        // Make sure final checkpoint was written successfully
+        checkpoint.wait();
     }
     catch(std::exception &ex) {
         std::cerr << ex.what() << std::endl;
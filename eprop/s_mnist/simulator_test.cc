@@ -18,6 +18,7 @@
 #include "batch_learning.h"
 
 // Model parameters
+#include "../../common/binary_spike_recorder.h"
 #include "../../common/mnist_helpers.h"
 #include "parameters.h"
 
@@ -28,9 +29,20 @@ int main()
         allocateMem();
         initialize();
 
-        // Load testing data and labels
-        const unsigned int numTestingImages = loadImageData("mnist/t10k-images-idx3-ubyte", datasetInput,
-                                                            &allocatedatasetInput, &pushdatasetInputToDevice);
+        // Map testing data and either load it all or allocate space for images to be streamed in chunks
+        // **NOTE** mapped images must remain in scope while the model is reading them
+        constexpr bool streamed = (Parameters::testChunkImages != 0);
+        IDXFile testingImages("mnist/t10k-images-idx3-ubyte", IDXFile::Type::UnsignedByte, 3, mnistEGPAliasesHost && !streamed);
+        unsigned int numTestingImages;
+        if(streamed) {
+            validateImageData(testingImages);
+            numTestingImages = testingImages.getNumItems();
+            allocatedatasetInput(Parameters::testChunkImages * testingImages.getItemSize());
+        }
+        else {
+            numTestingImages = loadImageData(testingImages, datasetInput,
+                                             &allocatedatasetInput, &pushdatasetInputToDevice);
+        }
 
         std::vector<uint8_t> testingLabels(numTestingImages);
         loadLabelData("mnist/t10k-labels-idx1-ubyte", numTestingImages, testingLabels.data());
@@ -39,9 +51,11 @@ int main()
         allocateRecordingBuffers(numTestingImages * Parameters::trialTimesteps);
 #endif
 
-        // Allocate indices buffer and initialize host indices
+        // Allocate indices buffer and initialize host indices to point each trial at its image in dataset EGP
         allocateindicesInput(numTestingImages);
-        std::iota(&indicesInput[0], &indicesInput[numTestingImages], 0);
+        for(unsigned int i = 0; i < numTestingImages; i++) {
+            indicesInput[i] = streamed ? (i % Parameters::testChunkImages) : i;
+        }
         pushindicesInputToDevice(numTestingImages);
 
         // Load from disk
@@ -68,6 +82,11 @@ int main()
                 std::cout << "Image " << image << "/" << numTestingImages << std::endl;
             }
 
+            // If images are being streamed, load next chunk when the previous one has been presented
+            if(streamed && (image % Parameters::testChunkImages) == 0) {
+                loadImageChunk(testingImages, image, Parameters::testChunkImages, datasetInput, &pushdatasetInputToDevice);
+            }
+
             // Loop through timesteps
             std::array<scalar, 10> output{0};
             for(unsigned int timestep = 0; timestep < Parameters::trialTimesteps; timestep++) {
@@ -103,12 +122,12 @@ int main()
 
 #ifdef ENABLE_RECORDING
         pullRecordingBuffersFromDevice();
-        writeTextSpikeRecording("test_input_spikes.csv", recordSpkInput,
-                                Parameters::numInputNeurons, numTestingImages * Parameters::trialTimesteps, Parameters::timestepMs,
-                                ",", true);
-        writeTextSpikeRecording("test_recurrent_alif_spikes.csv", recordSpkRecurrentALIF,
-                                Parameters::numRecurrentNeurons, numTestingImages * Parameters::trialTimesteps, Parameters::timestepMs,
-                                ",", true);
+        BinarySpikeWriter spikeWriter;
+        writeBinarySpikeRecording(spikeWriter, "test_input_spikes.bin", recordSpkInput,
+                                  Parameters::numInputNeurons, numTestingImages * Parameters::trialTimesteps, Parameters::timestepMs);
+        writeBinarySpikeRecording(spikeWriter, "test_recurrent_alif_spikes.bin", recordSpkRecurrentALIF,
+                                  Parameters::numRecurrentNeurons, numTestingImages * Parameters::trialTimesteps, Parameters::timestepMs);
+        spikeWriter.flush();
 #endif
 
         // Display performance
@@ -0,0 +1,16 @@
+#pragma once
+
+//------------------------------------------------------------------------
+// Parameters
+//------------------------------------------------------------------------
+namespace Parameters
+{
+    // Spikes sent between the excitatory and inhibitory simulators are delivered after this many timesteps.
+    // 1 matches MUSIC with an acceptable latency of one timestep so the simulators run in lockstep. Increasing
+    // it lets them drift apart without waiting for each other but lengthens the delay of the Exc<->Inh projections
+    constexpr unsigned int latencyTimesteps = 1;
+
+    // Number of timesteps of spikes sent together - must be no more than latencyTimesteps. The simulators
+    // can drift (latencyTimesteps - windowTimesteps) timesteps apart before either has to wait for the other
+    constexpr unsigned int windowTimesteps = 1;
+}
@@ -1,2 +1,5 @@
-#/bin/bash
-mpirun -np 2 music genn.music
\ No newline at end of file
+#!/bin/bash
+# Run both simulators - they connect to each other through shared memory so can be started in either order
+./simExc &
+./simInh
+wait
@@ -1,29 +1,24 @@
 #include "ModelExc_CODE/definitions.h"
-#include <fstream>
+#include <iostream>
 
-#include <music.hh>
-
-#include "../common/music.h"
+#include "../common/shared_memory_spikes.h"
 #include "genn_utils/spike_csv_recorder.h"
 
+#include "parameters.h"
+
 using namespace BoBRobotics;
 
-int main(int argc, char *argv[])
+int main()
 {
-    // Get real argc and argv
-    // **YUCK** MUSIC::Runtime deletes this so it needs to be created as raw pointer on heap
-    auto *setup = new MUSIC::Setup(argc, argv);
-
     allocateMem();
     std::cout << "Initialising" << std::endl;
     initialize();
     initModelExc();
 
-    MUSICSpikeIn spikeIn("in", 2000, DT, glbSpkCntInh, glbSpkInh, setup);
-    MUSICSpikeOut spikeOut("out", 8000, glbSpkCntExc, glbSpkExc, setup);
-
-    // Prepare for simulation
-    MUSIC::Runtime runtime(setup, 0.001);
+    // Send Exc spikes to, and receive Inh spikes from, the other simulator through shared memory
+    // **NOTE** each simulator creates its outgoing channel before waiting for the other's so they can start in either order
+    SharedMemorySpikeOut spikeOut("exc_to_inh", 8000, glbSpkCntExc, glbSpkExc, Parameters::windowTimesteps);
+    SharedMemorySpikeIn spikeIn("inh_to_exc", 2000, Parameters::latencyTimesteps, glbSpkCntInh, glbSpkInh);
 
     std::cout << "Simulating" << std::endl;
     BoBRobotics::GeNNUtils::SpikeCSVRecorder recorder("SpikesInh.csv", glbSpkCntInh, glbSpkInh);
@@ -37,15 +32,11 @@ int main(int argc, char *argv[])
         pullInhCurrentSpikesFromDevice();
 #endif
 
-        spikeOut.transmit(t);
+        spikeOut.transmit();
         spikeIn.tick();
 
-        runtime.tick ();
-
         recorder.record(t);
-        
     }
-    runtime.finalize();
 
     return EXIT_SUCCESS;
 }
@@ -1,29 +1,24 @@
 #include "ModelInh_CODE/definitions.h"
-#include <fstream>
+#include <iostream>
 
-#include <music.hh>
-
-#include "../common/music.h"
+#include "../common/shared_memory_spikes.h"
 #include "genn_utils/spike_csv_recorder.h"
 
-using namespace BoBRobotics;
+#include "parameters.h"
 
+using namespace BoBRobotics;
 
-int main(int argc, char *argv[])
+int main()
 {
-    // **YUCK** MUSIC::Runtime deletes this so it needs to be created as raw pointer on heap
-    auto *setup = new MUSIC::Setup(argc, argv);
-
     allocateMem();
     std::cout << "Initialising" << std::endl;
     initialize();
     initModelInh();
 
-    MUSICSpikeIn spikeIn("in", 8000, DT, glbSpkCntExc, glbSpkExc, setup);
-    MUSICSpikeOut spikeOut("out", 2000, glbSpkCntInh, glbSpkInh, setup);
-
-    // Prepare for simulation
-    MUSIC::Runtime runtime(setup, 0.001);
+    // Send Inh spikes to, and receive Exc spikes from, the other simulator through shared memory
+    // **NOTE** each simulator creates its outgoing channel before waiting for the other's so they can start in either order
+    SharedMemorySpikeOut spikeOut("inh_to_exc", 2000, glbSpkCntInh, glbSpkInh, Parameters::windowTimesteps);
+    SharedMemorySpikeIn spikeIn("exc_to_inh", 8000, Parameters::latencyTimesteps, glbSpkCntExc, glbSpkExc);
 
     std::cout << "Simulating" << std::endl;
     BoBRobotics::GeNNUtils::SpikeCSVRecorder recorder("SpikesExc.csv", glbSpkCntExc, glbSpkExc);
@@ -35,13 +30,12 @@ int main(int argc, char *argv[])
         stepTimeGPU();
         pullInhCurrentSpikesFromDevice();
 #endif
-        spikeOut.transmit(t);
-        spikeIn.tick();
 
-        runtime.tick();
+        spikeOut.transmit();
+        spikeIn.tick();
 
         recorder.record(t);
     }
-    runtime.finalize();
+
     return EXIT_SUCCESS;
 }
@@ -1,6 +1,10 @@
 import matplotlib.pyplot as plt
 import numpy as np
 import sys
+from os import path
+
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "common"))
+from binary_spikes import read_binary_spikes
 
 num_neurons = 1000 if len(sys.argv) <= 1 else int(sys.argv[1])
 num_excitatory = int(0.8 * num_neurons)
@@ -32,13 +36,13 @@ def plot_stimuli(axis, times, ids):
             annotation_clip=True, ha="center", va="bottom", color=colour)
 
 def read_spikes(filename):
-    return np.loadtxt(filename, delimiter=",", skiprows=1,
-                      dtype={"names": ("time", "id"),
-                             "formats": (np.float, np.int)})
+    return np.rec.fromarrays(read_binary_spikes(filename),
+                             dtype={"names": ("time", "id"),
+                                    "formats": (float, int)})
 
 # Read spikes
-e_spikes = read_spikes("e_spikes.csv")
-i_spikes = read_spikes("i_spikes.csv")
+e_spikes = read_spikes("e_spikes.bin")
+i_spikes = read_spikes("i_spikes.bin")
 
 # Read stimuli
 stimuli = np.loadtxt("stimulus_times.csv", delimiter=",",
@@ -7,7 +7,9 @@
 
 // GeNN user project includes
 #include "timer.h"
-#include "spikeRecorder.h"
+
+// GeNN examples includes
+#include "../common/spike_recording_drain.h"
 
 // GeNN generated code includes
 #include "izhikevich_pavlovian_CODE/definitions.h"
@@ -222,7 +224,13 @@ int main()
     
     std::ofstream weightEvolutionStream("weight_evolution.csv");
 
+    BinarySpikeWriter spikeWriter;
     {
+        // Create drain to write first and last recording windows in the background
+        SpikeRecordingDrain spikeDrain(spikeWriter, recordTime, Parameters::timestepMs, pullRecordingBuffersFromDevice);
+        spikeDrain.addPopulation("e_spikes.bin", recordSpkE, Parameters::numExcitatory);
+        spikeDrain.addPopulation("i_spikes.bin", recordSpkI, Parameters::numInhibitory);
+
         Timer timer("Simulation:");
 
         // Loop through timesteps
@@ -249,23 +257,12 @@ int main()
 
             // If we've just filled the recording buffer with data we want
             if(iT == recordTime || iT == duration) {
-                const bool firstRecordingBlock = (iT == recordTime);
-                const double recordingBlockStart = t - Parameters::recordTimeMs;
-                
-                // Download recording data
-                pullRecordingBuffersFromDevice();
-                
-                // Write spike data to CSV, starting a new file with a header if this is the 
-                // first recording phase and appending without a header if it is the second
-                writeTextSpikeRecording("e_spikes.csv", recordSpkE, Parameters::numExcitatory, 
-                                        recordTime, Parameters::timestepMs, ",", firstRecordingBlock, 
-                                        !firstRecordingBlock, recordingBlockStart);
-                writeTextSpikeRecording("i_spikes.csv", recordSpkI, Parameters::numInhibitory, 
-                                        recordTime, Parameters::timestepMs, ",", firstRecordingBlock,
-                                        !firstRecordingBlock, recordingBlockStart);
+                // Download recording data and write it as a block in the background
+                spikeDrain.drain(iT, recordTime);
             }
         }
     }
+    spikeWriter.flush();
 
     if(Parameters::measureTiming) {
         std::cout << "Init:" << initTime << std::endl;
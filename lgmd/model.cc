@@ -7,6 +7,7 @@
 // Common example includes
 #include "../common/exp_curr.h"
 #include "../common/lif.h"
+#include "../common/vision_connectivity.h"
 
 // LGMD includes
 #include "parameters.h"
@@ -100,56 +101,88 @@ void modelDefinition(NNmodel &model)
     ExpCurr::ParamValues p_i_s_exp_curr_params(
         tau_i);       // 0 - TauSyn (ms)
 
+    // Connectivity parameters
+    // **NOTE** connectivity is generated procedurally by GeNN rather than built on the host
+    CentreToMacroPixel::ParamValues centre_to_one_params(
+        Parameters::input_size,     // 0 - Resolution
+        Parameters::centre_size,    // 1 - CentreSize
+        Parameters::centre_size);   // 2 - KernelSize
+
+    NeighbourRing::ParamValues i_s_1_params(
+        Parameters::input_size,     // 0 - Resolution
+        Parameters::centre_size,    // 1 - CentreSize
+        1.0,                        // 2 - Distance
+        0.0);                       // 3 - Diagonal
+
+    NeighbourRing::ParamValues i_s_2_params(
+        Parameters::input_size,     // 0 - Resolution
+        Parameters::centre_size,    // 1 - CentreSize
+        1.0,                        // 2 - Distance
+        1.0);                       // 3 - Diagonal
+
+    NeighbourRing::ParamValues i_s_4_params(
+        Parameters::input_size,     // 0 - Resolution
+        Parameters::centre_size,    // 1 - CentreSize
+        2.0,                        // 2 - Distance
+        0.0);                       // 3 - Diagonal
+
     //------------------------------------------------------------------------
     // Neuron populations
     //------------------------------------------------------------------------
     // Create IF_curr neuron
-    model.addNeuronPopulation<NeuronModels::SpikeSource>("P", Parameters::input_size * Parameters::input_size,
+    // **NOTE** each population contains batch_size instances, tiled one after another
+    model.addNeuronPopulation<NeuronModels::SpikeSource>("P", Parameters::batch_size * Parameters::input_size * Parameters::input_size,
                                                          {}, {});
-    model.addNeuronPopulation<LIF>("S", Parameters::input_size * Parameters::input_size,
+    model.addNeuronPopulation<LIF>("S", Parameters::batch_size * Parameters::input_size * Parameters::input_size,
                                    s_lif_params, lif_init);
 
-    model.addNeuronPopulation<LIF>("LGMD", 1,
+    model.addNeuronPopulation<LIF>("LGMD", Parameters::batch_size,
                                    lgmd_lif_params, lif_init);
 
     //------------------------------------------------------------------------
     // Synapse populations
     //------------------------------------------------------------------------
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "P_F_LGMD", SynapseMatrixType::SPARSE_GLOBALG, 3,
+        "P_F_LGMD", SynapseMatrixType::RAGGED_GLOBALG, 3,
         "P", "LGMD",
         {}, p_f_lgmd_static_syn_init,
-        p_f_lgmd_exp_curr_params, {});
+        p_f_lgmd_exp_curr_params, {},
+        initConnectivity<CentreToMacroPixel>(centre_to_one_params));
 
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::DeltaCurr>(
-        "S_LGMD", SynapseMatrixType::SPARSE_GLOBALG, 1,
+        "S_LGMD", SynapseMatrixType::RAGGED_GLOBALG, 1,
         "S", "LGMD",
         {}, s_lgmd_static_syn_init,
-        {}, {});
+        {}, {},
+        initConnectivity<CentreToMacroPixel>(centre_to_one_params));
 
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "P_E_S", SynapseMatrixType::SPARSE_GLOBALG, 2,
+        "P_E_S", SynapseMatrixType::RAGGED_GLOBALG, 2,
         "P", "S",
         {}, p_e_s_static_syn_init,
-        p_e_s_exp_curr_params, {});
+        p_e_s_exp_curr_params, {},
+        initConnectivity<InitSparseConnectivitySnippet::OneToOne>({}));
 
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "P_I_S_1", SynapseMatrixType::SPARSE_GLOBALG, Parameters::i_s_delay_1,
+        "P_I_S_1", SynapseMatrixType::RAGGED_GLOBALG, Parameters::i_s_delay_1,
         "P", "S",
         {}, p_i_s_1_static_syn_init,
-        p_i_s_exp_curr_params, {});
+        p_i_s_exp_curr_params, {},
+        initConnectivity<NeighbourRing>(i_s_1_params));
 
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "P_I_S_2", SynapseMatrixType::SPARSE_GLOBALG, Parameters::i_s_delay_2,
+        "P_I_S_2", SynapseMatrixType::RAGGED_GLOBALG, Parameters::i_s_delay_2,
         "P", "S",
         {}, p_i_s_2_static_syn_init,
-        p_i_s_exp_curr_params, {});
+        p_i_s_exp_curr_params, {},
+        initConnectivity<NeighbourRing>(i_s_2_params));
 
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "P_I_S_4", SynapseMatrixType::SPARSE_GLOBALG, Parameters::i_s_delay_4,
+        "P_I_S_4", SynapseMatrixType::RAGGED_GLOBALG, Parameters::i_s_delay_4,
         "P", "S",
         {}, p_i_s_4_static_syn_init,
-        p_i_s_exp_curr_params, {});
+        p_i_s_exp_curr_params, {},
+        initConnectivity<NeighbourRing>(i_s_4_params));
 
 
     /*model.setSpanTypeToPre("EE");
@@ -10,6 +10,10 @@ namespace Parameters
     const unsigned int input_size = 32;
     const unsigned int centre_size = 20;
 
+    // Number of independent instances of the network simulated together, each driven by its own recording
+    // **NOTE** qian_dataset contains 30 recordings so they can all be evaluated in one batch
+    const unsigned int batch_size = 30;
+
     const double convergent_scale =  ((16.0 * 16.0) / ((double)centre_size * (double)centre_size));
 
     const double persistance_e = 0.1;
@@ -1,14 +1,16 @@
 #include "lgmd_CODE/definitions.h"
 
 // Standard C++ includes
+#include <algorithm>
 #include <fstream>
-#include <limits>
-#include <set>
-#include <sstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 // Standard C includes
-#include <cassert>
+#include <cstdint>
 #include <cstdlib>
 
 // Common example includes
@@ -23,277 +25,233 @@
 //----------------------------------------------------------------------------
 namespace
 {
-typedef void (*allocateFn)(unsigned int);
+// Resolution of the DVS used to make the qian_dataset recordings
+const unsigned int original_resolution = 128;
 
-unsigned int get_neuron_index(unsigned int resolution, unsigned int x, unsigned int y)
+//----------------------------------------------------------------------------
+// Recording
+//----------------------------------------------------------------------------
+//! Recording parsed into a compact index - the input spikes of each timestep with input are stored
+//! contiguously, already scaled to the model's resolution, so they can be copied straight into the spike source
+struct Recording
 {
-    return x + (y * resolution);
-}
+    std::string name;
 
-void print_sparse_matrix(unsigned int pre_resolution, const SparseProjection &projection)
-{
-    const unsigned int pre_size = pre_resolution * pre_resolution;
-    for(unsigned int i = 0; i < pre_size; i++)
-    {
-        std::cout << i << ":";
+    //! Timestep of each line of the recording
+    std::vector<unsigned int> times;
 
-        for(unsigned int j = projection.indInG[i]; j < projection.indInG[i + 1]; j++)
-        {
-            std::cout << projection.ind[j] << ",";
-        }
+    //! Index of the first spike of each line in indices, followed by the total number of spikes
+    std::vector<unsigned int> line_start;
 
-        std::cout << std::endl;
-    }
-}
+    //! Input neuron indices of all spikes in the recording
+    std::vector<uint16_t> indices;
 
-void build_one_to_one_connection(unsigned int resolution,
-                                 SparseProjection &projection, allocateFn allocate)
-{
-    // Allocate one connection per neuron
-    const unsigned int pop_size = resolution * resolution;
-    allocate(pop_size);
+    unsigned int get_end_time() const{ return times.empty() ? 0 : times.back(); }
+};
 
-    for(unsigned int i = 0; i < pop_size; i++)
-    {
-        projection.indInG[i] = i;
-        projection.ind[i] = i;
+Recording read_recording(const std::string &filename, unsigned int output_resolution)
+{
+    std::ifstream stream(filename);
+    if(!stream.good()) {
+        throw std::runtime_error("Cannot open recording '" + filename + "'");
     }
 
-    projection.indInG[pop_size] = pop_size;
-}
+    Recording recording;
+    recording.name = filename.substr(filename.find_last_of('/') + 1);
+    recording.line_start.push_back(0);
 
-void build_centre_to_one_connection(unsigned int pre_resolution, unsigned int centre_size,
-                                    SparseProjection &projection, allocateFn allocate)
-{
-    // Allocate centre_size * centre_size connections
-    allocate(centre_size * centre_size);
+    // Read lines of the form time;index,index,... until the end of the file or an empty line
+    std::string line;
+    while(std::getline(stream, line) && !line.empty()) {
+        char *end;
+        recording.times.push_back((unsigned int)std::strtoul(line.c_str(), &end, 10));
+        if(*end != ';') {
+            throw std::runtime_error("Malformed line '" + line + "' in recording '" + filename + "'");
+        }
 
-    // Calculate start and end of border on each row
-    const unsigned int border_size = (pre_resolution - centre_size) / 2;
-    const unsigned int far_border = pre_resolution - border_size;
+        while(*end != '\0') {
+            const char *start = end + 1;
+            const unsigned int input_index = (unsigned int)std::strtoul(start, &end, 10);
+            if(end == start || (*end != ',' && *end != '\0') || input_index >= (original_resolution * original_resolution)) {
+                throw std::runtime_error("Malformed line '" + line + "' in recording '" + filename + "'");
+            }
 
-    // Loop through rows of pixels in centre
-    unsigned int s = 0;
-    unsigned int i = 0;
-    for(unsigned int yi = 0; yi < pre_resolution; yi++)
-    {
-        for(unsigned int xi = 0; xi < pre_resolution; xi++)
-        {
-            projection.indInG[i++] = s;
+            // Convert this into x and y and scale into output resolution
+            const unsigned int output_x = ((input_index / original_resolution) * output_resolution) / original_resolution;
+            const unsigned int output_y = ((input_index % original_resolution) * output_resolution) / original_resolution;
 
-            // If we're in the centre
-            if(xi >= border_size && xi < far_border && yi >= border_size && yi < far_border) {
-                projection.ind[s++] = 0;
-            }
+            // Convert back to index and add to recording
+            recording.indices.push_back((uint16_t)((output_x * output_resolution) + output_y));
         }
+        recording.line_start.push_back((unsigned int)recording.indices.size());
     }
 
-    // Add ending entry to data structure
-    projection.indInG[i] = s;
-
-    // Check
-    assert(s == (centre_size * centre_size));
-    assert(i == (pre_resolution * pre_resolution));
+    return recording;
 }
 
-void build_i_s_connections(unsigned int resolution, unsigned int centre_size,
-                           SparseProjection &projection1, allocateFn allocate1,
-                           SparseProjection &projection2, allocateFn allocate2,
-                           SparseProjection &projection4, allocateFn allocate4)
+// Writes each recording's LGMD spike train and detection time i.e. the time of its first LGMD spike
+void write_report(const std::string &filename, const std::vector<Recording> &recordings,
+                  const std::vector<std::vector<unsigned int>> &lgmd_spikes)
 {
-    const unsigned int pop_size = resolution * resolution;
-    
-    // Allocate sparse projections
-    allocate1(centre_size * centre_size * 4);
-    allocate2(centre_size * centre_size * 4);
-    allocate4(centre_size * centre_size * 4);
-
-    // Calculate start and end of border on each row
-    const unsigned int border_size = (resolution - centre_size) / 2;
-    const unsigned int far_border = resolution - border_size;
-
-    // Create temporary vectors to hold rows
-    std::vector<std::vector<unsigned int>> projection1Map(pop_size);
-    std::vector<std::vector<unsigned int>> projection2Map(pop_size);
-    std::vector<std::vector<unsigned int>> projection4Map(pop_size);
-
-    // Loop through POSTsynaptic neurons
-    for(unsigned int xj =  border_size; xj < far_border; xj++)
-    {
-        for(unsigned int yj = border_size; yj < far_border; yj++)
-        {
-            const unsigned int j = get_neuron_index(resolution, xj, yj);
-
-            // Add adjacent neighbours to projection 1
-            projection1Map[get_neuron_index(resolution, xj - 1, yj)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj, yj - 1)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj + 1, yj)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj, yj + 1)].push_back(j);
-
-            // Add diagonal neighbours to projection 2
-            projection2Map[get_neuron_index(resolution, xj - 1, yj - 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj + 1, yj - 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj + 1, yj + 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj - 1, yj + 1)].push_back(j);
-
-            // Add one away neighbours to projection 4
-            projection4Map[get_neuron_index(resolution, xj - 2, yj)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj, yj - 2)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj + 2, yj)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj, yj + 2)].push_back(j);
-        }
+    std::ofstream os(filename);
+    if(!os.good()) {
+        throw std::runtime_error("Cannot open '" + filename + "' to write report");
     }
 
-    // Convert vector of vectors to GeNN format
-    unsigned int s1 = 0;
-    unsigned int s2 = 0;
-    unsigned int s4 = 0;
-    for(unsigned int i = 0; i < pop_size; i++)
-    {
-        projection1.indInG[i] = s1;
-        projection2.indInG[i] = s2;
-        projection4.indInG[i] = s4;
-
-        std::copy(projection1Map[i].cbegin(), projection1Map[i].cend(), &projection1.ind[s1]);
-        std::copy(projection2Map[i].cbegin(), projection2Map[i].cend(), &projection2.ind[s2]);
-        std::copy(projection4Map[i].cbegin(), projection4Map[i].cend(), &projection4.ind[s4]);
+    os << "{" << std::endl;
+    os << "    \"timestep_ms\": " << Parameters::timestep << "," << std::endl;
+    os << "    \"batch_size\": " << Parameters::batch_size << "," << std::endl;
+    os << "    \"recordings\": [" << std::endl;
+    for(size_t r = 0; r < recordings.size(); r++) {
+        const double end_ms = recordings[r].get_end_time() * Parameters::timestep;
+        os << "        {\"name\": \"" << recordings[r].name << "\", \"end_ms\": " << end_ms;
+
+        // **NOTE** detection before the end of the recording is also reported as it
+        // corresponds to the time remaining before collision in the looming stimuli
+        const auto &spikes = lgmd_spikes[r];
+        if(spikes.empty()) {
+            os << ", \"detection_ms\": null, \"detection_before_end_ms\": null";
+        }
+        else {
+            const double detection_ms = spikes.front() * Parameters::timestep;
+            os << ", \"detection_ms\": " << detection_ms << ", \"detection_before_end_ms\": " << end_ms - detection_ms;
+        }
 
-        s1 += projection1Map[i].size();
-        s2 += projection2Map[i].size();
-        s4 += projection4Map[i].size();
+        os << ", \"spikes_ms\": [";
+        for(size_t s = 0; s < spikes.size(); s++) {
+            os << ((s == 0) ? "" : ", ") << spikes[s] * Parameters::timestep;
+        }
+        os << "]}" << ((r == (recordings.size() - 1)) ? "" : ",") << std::endl;
     }
-
-    // Add ending entries to data structure
-    projection1.indInG[pop_size] = s1;
-    projection2.indInG[pop_size] = s2;
-    projection4.indInG[pop_size] = s4;
-
-    // Check
-    assert(s1 == (centre_size * centre_size * 4));
-    assert(s2 == (centre_size * centre_size * 4));
-    assert(s4 == (centre_size * centre_size * 4));
+    os << "    ]" << std::endl;
+    os << "}" << std::endl;
 }
+}   // Anonymous namespace
 
-unsigned read_p_input(unsigned int output_resolution, unsigned int original_resolution,
-                      std::ifstream &stream, std::vector<unsigned int> &indices)
+// Run with one or more recordings from qian_dataset, for example to evaluate all of them:
+//      ./simulator ../qian_dataset/*.spikes
+// Recordings are simulated Parameters::batch_size at a time, each driving its own instance of the network,
+// and the LGMD spike trains and detection times of every recording are written to lgmd_report.json.
+// When a single recording is simulated, voltages are also recorded for show_spikes.py
+int main(int argc, char *argv[])
 {
-    // Calculate resolution scale
-    const double scale = (double)original_resolution / (double)output_resolution;
-
-    // Read lines into string
-    std::string line;
-    std::getline(stream, line);
-
-    if(line.empty()) {
-        return std::numeric_limits<unsigned int>::max();
+    if(argc < 2) {
+        std::cerr << "Expected one or more recordings" << std::endl;
+        return EXIT_FAILURE;
     }
 
-    // Create string stream from line
-    std::stringstream lineStream(line);
-
-    // Read time from start of line
-    std::string nextTimeString;
-    std::getline(lineStream, nextTimeString, ';');
-    unsigned int nextTime = (unsigned int)std::stoul(nextTimeString);
-
-    // Clear existing times
-    indices.clear();
-
-    while(lineStream.good()) {
-        // Read input spike index
-        std::string inputIndexString;
-        std::getline(lineStream, inputIndexString, ',');
-        const int input_index = std::stoi(inputIndexString);
-
-        // Convert this into x and y
-        const div_t input_coord = std::div(input_index, original_resolution);
+    try
+    {
+        // Parse all recordings up front
+        std::vector<Recording> recordings;
+        for(int a = 1; a < argc; a++) {
+            recordings.push_back(read_recording(argv[a], Parameters::input_size));
+        }
 
-        // Scale into output resolution
-        const unsigned int output_x = (unsigned int)std::floor((double)input_coord.quot / scale);
-        const unsigned int output_y = (unsigned int)std::floor((double)input_coord.rem / scale);
-        assert(output_x < output_resolution);
-        assert(output_y < output_resolution);
+        allocateMem();
 
-        // Convert back to index and add to vector
-        const unsigned int output_index = (output_x * output_resolution) + output_y;
-        indices.push_back(output_index);
-    }
+        const bool record_voltages = (recordings.size() == 1);
+        std::unique_ptr<SpikeCSVRecorder> lgmdSpikeRecorder;
+        std::unique_ptr<AnalogueCSVRecorder<scalar>> sVoltageRecorder;
+        std::unique_ptr<AnalogueCSVRecorder<scalar>> lgmdVoltageRecorder;
+        if(record_voltages) {
+            lgmdSpikeRecorder.reset(new SpikeCSVRecorder("lgmd_spikes.csv", glbSpkCntLGMD, glbSpkLGMD));
+            sVoltageRecorder.reset(new AnalogueCSVRecorder<scalar>("s_voltages.csv", VS, Parameters::input_size * Parameters::input_size, "Voltage [mV]"));
+            lgmdVoltageRecorder.reset(new AnalogueCSVRecorder<scalar>("lgmd_voltages.csv", VLGMD, 1, "Voltage [mV]"));
+        }
 
-    return nextTime;
-}
-}
+        // Loop through batches of recordings
+        constexpr unsigned int instance_size = Parameters::input_size * Parameters::input_size;
+        std::vector<std::vector<unsigned int>> lgmd_spikes(recordings.size());
+        unsigned int numS = 0;
+        unsigned int numL = 0;
+        for(size_t batch_start = 0; batch_start < recordings.size(); batch_start += Parameters::batch_size) {
+            const size_t batch_end = std::min(recordings.size(), batch_start + Parameters::batch_size);
+
+            // Reinitialise model so every batch starts from rest
+            initialize();
+            initlgmd();
+
+            // Simulate until the end of the longest recording in batch
+            unsigned int end_time = 0;
+            for(size_t r = batch_start; r < batch_end; r++) {
+                end_time = std::max(end_time, recordings[r].get_end_time());
+            }
 
-int main(int argc, char *argv[])
-{
-    std::ifstream spikeInput(argv[1]);
-    assert(spikeInput.good());
-
-    allocateMem();
-    initialize();
-
-    build_centre_to_one_connection(Parameters::input_size, Parameters::centre_size,
-                                   CP_F_LGMD, &allocateP_F_LGMD);
-    build_centre_to_one_connection(Parameters::input_size, Parameters::centre_size,
-                                   CS_LGMD, &allocateS_LGMD);
-    build_one_to_one_connection(Parameters::input_size,
-                                CP_E_S, &allocateP_E_S);
-    build_i_s_connections(Parameters::input_size, Parameters::centre_size,
-                          CP_I_S_1, &allocateP_I_S_1,
-                          CP_I_S_2, &allocateP_I_S_2,
-                          CP_I_S_4, &allocateP_I_S_4);
-
-    initlgmd();
-
-    // Read first line of input
-    std::vector<unsigned int> inputIndices;
-    unsigned int nextInputTime = read_p_input(Parameters::input_size, 128, spikeInput, inputIndices);
-
-    SpikeCSVRecorder lgmdSpikeRecorder("lgmd_spikes.csv", glbSpkCntLGMD, glbSpkLGMD);
-    AnalogueCSVRecorder<scalar> sVoltageRecorder("s_voltages.csv", VS, Parameters::input_size * Parameters::input_size, "Voltage [mV]");
-    AnalogueCSVRecorder<scalar> lgmdVoltageRecorder("lgmd_voltages.csv", VLGMD, 1, "Voltage [mV]");
-
-    // Loop through timesteps until there is no more import
-    unsigned int numS = 0;
-    unsigned int numL = 0;
-    for(unsigned int i = 0; nextInputTime < std::numeric_limits<unsigned int>::max(); i++)
-    {
-        // If we should supply input this timestep
-        if(nextInputTime == i) {
-            // Copy into spike source
-            spikeCount_P = inputIndices.size();
-            std::copy(inputIndices.cbegin(), inputIndices.cend(), &spike_P[0]);
+            std::vector<unsigned int> next_line(batch_end - batch_start, 0);
+            for(unsigned int i = 0; i <= end_time; i++)
+            {
+                // Copy input from any recordings with input this timestep into their instance of spike source
+                bool any_input = false;
+                spikeCount_P = 0;
+                for(size_t r = batch_start; r < batch_end; r++) {
+                    const Recording &recording = recordings[r];
+                    unsigned int &line = next_line[r - batch_start];
+                    if(line < recording.times.size() && recording.times[line] == i) {
+                        const unsigned int instance_start = (unsigned int)(r - batch_start) * instance_size;
+                        for(unsigned int s = recording.line_start[line]; s < recording.line_start[line + 1]; s++) {
+                            spike_P[spikeCount_P++] = instance_start + recording.indices[s];
+                        }
+                        line++;
+                        any_input = true;
+                    }
+                }
 
 #ifndef CPU_ONLY
-            // Copy to GPU
-            pushPCurrentSpikesToDevice();
+                // Copy to GPU
+                if(any_input) {
+                    pushPCurrentSpikesToDevice();
+                }
 #endif
 
-            // Read NEXT input
-            nextInputTime = read_p_input(Parameters::input_size, 128, spikeInput, inputIndices);
-        }
-
-        // Simulate
+                // Simulate
 #ifndef CPU_ONLY
-        stepTimeGPU();
-
-        pullLGMDStateFromDevice();
-        pullLGMDCurrentSpikesFromDevice();
-        pullSStateFromDevice();
-        pullSCurrentSpikesFromDevice();
+                stepTimeGPU();
+
+                pullLGMDCurrentSpikesFromDevice();
+                pullSCurrentSpikesFromDevice();
+                if(record_voltages) {
+                    pullLGMDStateFromDevice();
+                    pullSStateFromDevice();
+                }
 #else
-        stepTimeCPU();
+                stepTimeCPU();
 #endif
 
-        numS += spikeCount_S;
-        numL += spikeCount_LGMD;
-
-        sVoltageRecorder.record(t);
-        lgmdVoltageRecorder.record(t);
-        lgmdSpikeRecorder.record(t);
-    }
-
-    std::cout << numS << " S spikes, " << numL << " LGMD spikes" << std::endl;
+                numS += spikeCount_S;
+                numL += spikeCount_LGMD;
+
+                // Add LGMD spikes to spike train of corresponding recording if it hasn't finished
+                for(unsigned int s = 0; s < spikeCount_LGMD; s++) {
+                    const size_t r = batch_start + spike_LGMD[s];
+                    if(r < batch_end && i <= recordings[r].get_end_time()) {
+                        lgmd_spikes[r].push_back(i);
+                    }
+                }
+
+                if(record_voltages) {
+                    sVoltageRecorder->record(t);
+                    lgmdVoltageRecorder->record(t);
+                    lgmdSpikeRecorder->record(t);
+                }
+            }
+        }
 
+        std::cout << numS << " S spikes, " << numL << " LGMD spikes" << std::endl;
+        for(size_t r = 0; r < recordings.size(); r++) {
+            std::cout << recordings[r].name << ": " << lgmd_spikes[r].size() << " LGMD spikes";
+            if(!lgmd_spikes[r].empty()) {
+                std::cout << ", detected at " << lgmd_spikes[r].front() * Parameters::timestep << "ms";
+            }
+            std::cout << std::endl;
+        }
 
-  return 0;
-}
\ No newline at end of file
+        write_report("lgmd_report.json", recordings, lgmd_spikes);
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
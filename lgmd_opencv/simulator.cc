@@ -1,8 +1,13 @@
 // Standard C++ includes
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <limits>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 // Standard C includes
@@ -13,180 +18,31 @@
 #include <opencv2/highgui/highgui.hpp>
 
 // Common example code
+#include "../common/latency_report.h"
 #include "../common/opencv_dvs.h"
-#include "../common/timer.h"
 
 // LGMD includes
 #include "parameters.h"
 
 #include "lgmd_opencv_CODE/definitions.h"
 
-//----------------------------------------------------------------------------
-// Anonymous namespace
-//----------------------------------------------------------------------------
-namespace
-{
-typedef void (*allocateFn)(unsigned int);
-typedef TimerAccumulate<std::chrono::microseconds>  ProfilingTimer;
-
-unsigned int get_neuron_index(unsigned int resolution, unsigned int x, unsigned int y)
-{
-    return x + (y * resolution);
-}
-
-void print_sparse_matrix(unsigned int pre_resolution, const SparseProjection &projection)
-{
-    const unsigned int pre_size = pre_resolution * pre_resolution;
-    for(unsigned int i = 0; i < pre_size; i++)
-    {
-        std::cout << i << ":";
-
-        for(unsigned int j = projection.indInG[i]; j < projection.indInG[i + 1]; j++)
-        {
-            std::cout << projection.ind[j] << ",";
-        }
-
-        std::cout << std::endl;
-    }
-}
-
-void build_one_to_one_connection(unsigned int resolution,
-                                 SparseProjection &projection, allocateFn allocate)
-{
-    // Allocate one connection per neuron
-    const unsigned int pop_size = resolution * resolution;
-    allocate(pop_size);
-
-    for(unsigned int i = 0; i < pop_size; i++)
-    {
-        projection.indInG[i] = i;
-        projection.ind[i] = i;
-    }
-
-    projection.indInG[pop_size] = pop_size;
-}
-
-void build_centre_to_one_connection(unsigned int pre_resolution, unsigned int centre_size,
-                                    SparseProjection &projection, allocateFn allocate)
-{
-    // Allocate centre_size * centre_size connections
-    allocate(centre_size * centre_size);
-
-    // Calculate start and end of border on each row
-    const unsigned int border_size = (pre_resolution - centre_size) / 2;
-    const unsigned int far_border = pre_resolution - border_size;
-
-    // Loop through rows of pixels in centre
-    unsigned int s = 0;
-    unsigned int i = 0;
-    for(unsigned int yi = 0; yi < pre_resolution; yi++)
-    {
-        for(unsigned int xi = 0; xi < pre_resolution; xi++)
-        {
-            projection.indInG[i++] = s;
-
-            // If we're in the centre
-            if(xi >= border_size && xi < far_border && yi >= border_size && yi < far_border) {
-                projection.ind[s++] = 0;
-            }
-        }
-    }
-
-    // Add ending entry to data structure
-    projection.indInG[i] = s;
-
-    // Check
-    assert(s == (centre_size * centre_size));
-    assert(i == (pre_resolution * pre_resolution));
-}
-
-void build_i_s_connections(unsigned int resolution, unsigned int centre_size,
-                           SparseProjection &projection1, allocateFn allocate1,
-                           SparseProjection &projection2, allocateFn allocate2,
-                           SparseProjection &projection4, allocateFn allocate4)
-{
-    const unsigned int pop_size = resolution * resolution;
-    
-    // Allocate sparse projections
-    allocate1(centre_size * centre_size * 4);
-    allocate2(centre_size * centre_size * 4);
-    allocate4(centre_size * centre_size * 4);
-
-    // Calculate start and end of border on each row
-    const unsigned int border_size = (resolution - centre_size) / 2;
-    const unsigned int far_border = resolution - border_size;
-
-    // Create temporary vectors to hold rows
-    std::vector<std::vector<unsigned int>> projection1Map(pop_size);
-    std::vector<std::vector<unsigned int>> projection2Map(pop_size);
-    std::vector<std::vector<unsigned int>> projection4Map(pop_size);
-
-    // Loop through POSTsynaptic neurons
-    for(unsigned int xj =  border_size; xj < far_border; xj++)
-    {
-        for(unsigned int yj = border_size; yj < far_border; yj++)
-        {
-            const unsigned int j = get_neuron_index(resolution, xj, yj);
-
-            // Add adjacent neighbours to projection 1
-            projection1Map[get_neuron_index(resolution, xj - 1, yj)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj, yj - 1)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj + 1, yj)].push_back(j);
-            projection1Map[get_neuron_index(resolution, xj, yj + 1)].push_back(j);
-
-            // Add diagonal neighbours to projection 2
-            projection2Map[get_neuron_index(resolution, xj - 1, yj - 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj + 1, yj - 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj + 1, yj + 1)].push_back(j);
-            projection2Map[get_neuron_index(resolution, xj - 1, yj + 1)].push_back(j);
-
-            // Add one away neighbours to projection 4
-            projection4Map[get_neuron_index(resolution, xj - 2, yj)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj, yj - 2)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj + 2, yj)].push_back(j);
-            projection4Map[get_neuron_index(resolution, xj, yj + 2)].push_back(j);
-        }
-    }
-
-    // Convert vector of vectors to GeNN format
-    unsigned int s1 = 0;
-    unsigned int s2 = 0;
-    unsigned int s4 = 0;
-    for(unsigned int i = 0; i < pop_size; i++)
-    {
-        projection1.indInG[i] = s1;
-        projection2.indInG[i] = s2;
-        projection4.indInG[i] = s4;
-
-        std::copy(projection1Map[i].cbegin(), projection1Map[i].cend(), &projection1.ind[s1]);
-        std::copy(projection2Map[i].cbegin(), projection2Map[i].cend(), &projection2.ind[s2]);
-        std::copy(projection4Map[i].cbegin(), projection4Map[i].cend(), &projection4.ind[s4]);
-
-        s1 += projection1Map[i].size();
-        s2 += projection2Map[i].size();
-        s4 += projection4Map[i].size();
-    }
-
-    // Add ending entries to data structure
-    projection1.indInG[pop_size] = s1;
-    projection2.indInG[pop_size] = s2;
-    projection4.indInG[pop_size] = s4;
-
-    // Check
-    assert(s1 == (centre_size * centre_size * 4));
-    assert(s2 == (centre_size * centre_size * 4));
-    assert(s4 == (centre_size * centre_size * 4));
-}
-}   // Anonymous namespace
-
+// Run with a camera device number (defaults to 0) to process live frames or with the filename of a video
+// to replay it, optionally writing a latency report and replaying at a fixed rate rather than as fast as possible:
+//      ./simulator [device | video] [latency report.json] [replay frame rate Hz]
 int main(int argc, char *argv[])
 {
-    const unsigned int device = (argc > 1) ? std::atoi(argv[1]) : 0;
+    // If source isn't a device number, replay it as a video file
+    const std::string source = (argc > 1) ? argv[1] : "0";
+    const bool replay = (source.find_first_not_of("0123456789") != std::string::npos);
+    const std::string reportFilename = (argc > 2) ? argv[2] : "";
+    const double replayRate = (argc > 3) ? std::atof(argv[3]) : 0.0;
+
 #ifndef CPU_ONLY
-    OpenCVDVSGPU dvs(device, 32);
+    std::unique_ptr<OpenCVDVSGPU> dvsPtr(replay ? new OpenCVDVSGPU(source, 32) : new OpenCVDVSGPU(std::stoul(source), 32));
 #else
-    OpenCVDVSCPU dvs(device, 32);
+    std::unique_ptr<OpenCVDVSCPU> dvsPtr(replay ? new OpenCVDVSCPU(source, 32) : new OpenCVDVSCPU(std::stoul(source), 32));
 #endif
+    auto &dvs = *dvsPtr;
     
     // Configure windows which will be used to show down-sampled images
     cv::namedWindow("Downsampled frame", CV_WINDOW_NORMAL);
@@ -201,37 +57,44 @@ int main(int argc, char *argv[])
     allocateMem();
     initialize();
 
-    build_centre_to_one_connection(Parameters::input_size, Parameters::centre_size,
-                                   CP_F_LGMD, &allocateP_F_LGMD);
-    build_centre_to_one_connection(Parameters::input_size, Parameters::centre_size,
-                                   CS_LGMD, &allocateS_LGMD);
-    build_one_to_one_connection(Parameters::input_size,
-                                CP_E_S, &allocateP_E_S);
-    build_i_s_connections(Parameters::input_size, Parameters::centre_size,
-                          CP_I_S_1, &allocateP_I_S_1,
-                          CP_I_S_2, &allocateP_I_S_2,
-                          CP_I_S_4, &allocateP_I_S_4);
-
     initlgmd_opencv();
 
+    // Add latency report stages
+    // **NOTE** frame differences are read directly from the OpenCVDVS so there is no push stage
+    LatencyReport report;
+    auto &acquireLatency = report.addStage("acquire");
+    auto &inputRenderLatency = report.addStage("input_render");
+    auto &stepLatency = report.addStage("step");
+    auto &pullLatency = report.addStage("pull");
+    auto &outputRenderLatency = report.addStage("output_render");
+    auto &eventProcessingLatency = report.addStage("event_processing");
+    auto &frameToSpikeLatency = report.addStage("frame_to_lgmd_spike");
+
     // Loop through timesteps until there is no more import
-    double dvsUpdate = 0.0;
-    double dvsRender = 0.0;
-    double simulationStep = 0.0;
-    double download = 0.0;
-    double outputRender = 0.0;
-    double eventProcessing = 0.0;
-    for(unsigned int i = 0;; i++)
+    const auto replayPeriod = std::chrono::duration<double>((replayRate > 0.0) ? (1.0 / replayRate) : 0.0);
+    const auto start = LatencyTimer::Clock::now();
+    unsigned int i;
+    for(i = 0; !dvs.isFinished(); i++)
     {
+        // When replaying at a fixed rate, wait until this frame is due
+        // **NOTE** the capture thread may have prefetched the frame long before it was due
+        // so latency is measured from the later of when it was captured and when it was due
+        auto frameTime = dvs.getFrameTime();
+        if(replay && replayRate > 0.0) {
+            const auto dueTime = start + std::chrono::duration_cast<LatencyTimer::Clock::duration>(replayPeriod * i);
+            std::this_thread::sleep_until(dueTime);
+            frameTime = std::max(frameTime, dueTime);
+        }
+
         // Read DVS state and put result into GeNN
         {
-            ProfilingTimer t(dvsUpdate);
+            LatencyTimer t(acquireLatency);
             tie(inputCurrentsP, stepP) = dvs.update(i);
         }
 
         // Show raw frame and difference with previous
         {
-            ProfilingTimer t(dvsRender);
+            LatencyTimer t(inputRenderLatency);
             dvs.showDownsampledFrame("Downsampled frame", i);
             dvs.showFrameDifference("Frame difference");
         }
@@ -239,13 +102,13 @@ int main(int argc, char *argv[])
         // Simulate
 #ifndef CPU_ONLY
         {
-            ProfilingTimer t(simulationStep);
+            LatencyTimer t(stepLatency);
             stepTimeGPU();
         }
 
         //pullLGMDStateFromDevice();
         {
-            ProfilingTimer t(download);
+            LatencyTimer t(pullLatency);
             
             pullPStateFromDevice();
             pullSStateFromDevice();
@@ -253,13 +116,18 @@ int main(int argc, char *argv[])
         }
 #else
         {
-            ProfilingTimer t(simulationStep);
+            LatencyTimer t(stepLatency);
             stepTimeCPU();
         }
 #endif
+
+        // If LGMD spiked, record latency from capture of frame which caused it
+        if(spikeCount_LGMD > 0) {
+            frameToSpikeLatency.record(std::chrono::duration<double>(LatencyTimer::Clock::now() - frameTime).count());
+        }
         
         {
-            ProfilingTimer t(outputRender);
+            LatencyTimer t(outputRenderLatency);
             
             cv::Mat wrappedPVoltage(32, 32, CV_32FC1, VP);
             cv::imshow("P Membrane voltage", wrappedPVoltage);
@@ -274,21 +142,30 @@ int main(int argc, char *argv[])
         
         // **YUCK** required for OpenCV GUI to do anything
         {
-            ProfilingTimer t(eventProcessing);
+            LatencyTimer t(eventProcessingLatency);
             
             if(cv::waitKey(1) == 27) {
-                std::cout << "DVS update:" << dvsUpdate / (double)i << std::endl;
-                std::cout << "DVS render:" << dvsRender / (double)i  << std::endl;
-                std::cout << "Simulation step:" << simulationStep / (double)i  << std::endl;
-                std::cout << "Download:" << download / (double)i  << std::endl;
-                std::cout << "Output render:" << outputRender / (double)i  << std::endl;
-                std::cout << "Event processing:" << eventProcessing / (double)i  << std::endl;
                 break;
             }
         }
     }
-    
-    
+
+    std::cout << "DVS update:" << acquireLatency.getMean() << "s" << std::endl;
+    std::cout << "DVS render:" << inputRenderLatency.getMean() << "s" << std::endl;
+    std::cout << "Simulation step:" << stepLatency.getMean() << "s" << std::endl;
+    std::cout << "Download:" << pullLatency.getMean() << "s" << std::endl;
+    std::cout << "Output render:" << outputRenderLatency.getMean() << "s" << std::endl;
+    std::cout << "Event processing:" << eventProcessingLatency.getMean() << "s" << std::endl;
+
+    // Write latency report
+    if(!reportFilename.empty()) {
+        report.setMetadata("example", "lgmd_opencv");
+        report.setMetadata("source", source);
+        report.setMetadata("replay_rate_hz", replayRate);
+        report.setMetadata("steps", i);
+        report.setMetadata("duration_s", std::chrono::duration<double>(LatencyTimer::Clock::now() - start).count());
+        report.write(reportFilename);
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -210,6 +210,7 @@ void modelDefinition(NNmodel &model)
     // Create IF_curr neuron
     auto *e = model.addNeuronPopulation<LIFPoisson>("E", Parameters::numExcitatory, lifParams, lifInit);
     auto *i = model.addNeuronPopulation<LIFPoisson>("I", Parameters::numInhibitory, lifParams, lifInit);
+    e->setSpikeRecordingEnabled(true);
 
 #ifdef STATIC
     model.addSynapsePopulation<WeightUpdateModels::StaticPulse, AlphaCurr>(
@@ -14,6 +14,9 @@ namespace Parameters
 
     const double durationMs = 200.0 * 1000.0;
 
+    // Number of timesteps of spikes recorded on device before being drained to disk
+    const unsigned int recordingWindowTimesteps = 1000;
+
     const double delayMs = 1.5;
 
     const unsigned int delayTimestep = (unsigned int)(delayMs / timestep);
@@ -1,46 +1,40 @@
-import csv
 import matplotlib.pyplot as plt
 import numpy as np
+import sys
+from os import path
 
-with open("spikes.csv", "rb") as spikes_csv_file:
-    spikes_csv_reader = csv.reader(spikes_csv_file, delimiter = ",")
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "common"))
+from binary_spikes import read_binary_spikes
 
-    # Skip headers
-    spikes_csv_reader.next()
+# Read binary spikes
+spike_times, spike_neuron_id = read_binary_spikes("spikes.bin")
 
-    # Read data and zip into columns
-    spikes_data_columns = zip(*spikes_csv_reader)
+# Create plot
+figure, axes = plt.subplots(2, sharex=True)
 
-    # Convert CSV columns to numpy
-    spike_times = np.asarray(spikes_data_columns[0], dtype=float)
-    spike_neuron_id = np.asarray(spikes_data_columns[1], dtype=int)
+# Plot spikes
+axes[0].scatter(spike_times, spike_neuron_id, s=2, edgecolors="none")
 
-    # Create plot
-    figure, axes = plt.subplots(2, sharex=True)
+# Plot rates
+num_excitatory = 90000
+duration_ms = 1000
+bin_ms = 10
 
-    # Plot spikes
-    axes[0].scatter(spike_times, spike_neuron_id, s=2, edgecolors="none")
+bins = np.arange(0, duration_ms + 1, bin_ms)
+rate = np.histogram(spike_times, bins=bins)[0] * (1000.0 / float(bin_ms)) * (1.0 / float(num_excitatory))
+axes[1].plot(bins[0:-1], rate)
 
-    # Plot rates
-    num_excitatory = 90000
-    duration_ms = 1000
-    bin_ms = 10
+axes[0].set_title("Spikes")
+axes[1].set_title("Firing rates")
 
-    bins = np.arange(0, duration_ms + 1, bin_ms)
-    rate = np.histogram(spike_times, bins=bins)[0] * (1000.0 / float(bin_ms)) * (1.0 / float(num_excitatory))
-    axes[1].plot(bins[0:-1], rate)
+axes[0].set_xlim((0, duration_ms))
+axes[0].set_ylim((0, num_excitatory))
 
-    axes[0].set_title("Spikes")
-    axes[1].set_title("Firing rates")
+axes[0].set_ylabel("Neuron number")
+axes[1].set_ylabel("Mean firing rate [Hz]")
 
-    axes[0].set_xlim((0, duration_ms))
-    axes[0].set_ylim((0, num_excitatory))
+axes[1].set_xlabel("Time [ms]")
 
-    axes[0].set_ylabel("Neuron number")
-    axes[1].set_ylabel("Mean firing rate [Hz]")
-
-    axes[1].set_xlabel("Time [ms]")
-
-    # Show plot
-    plt.show()
+# Show plot
+plt.show()
 
@@ -4,9 +4,11 @@
 
 // GeNN user project includes
 #include "timer.h"
-#include "spikeRecorder.h"
 //#include "third_party/path.h"
 
+// GeNN examples includes
+#include "../common/spike_recording_drain.h"
+
 // Model parameters
 #include "parameters.h"
 
@@ -21,12 +23,16 @@ int main(int argc, char** argv)
     }
 
     allocateMem();
+    allocateRecordingBuffers(Parameters::recordingWindowTimesteps);
     initialize();
     initializeSparse();
+
+    BinarySpikeWriter spikeWriter;
     {
-        // Open CSV output files
-        SpikeRecorderDelayCached spikes("spikes.csv", Parameters::numExcitatory,
-                                        spkQuePtrE, glbSpkCntE, glbSpkE, ",", true);
+        // Write each window of spikes while the next is simulated
+        SpikeRecordingDrain spikeDrain(spikeWriter, Parameters::recordingWindowTimesteps, Parameters::timestep,
+                                       pullRecordingBuffersFromDevice);
+        spikeDrain.addPopulation("spikes.bin", recordSpkE, Parameters::numExcitatory);
         {
             Timer tim("Simulation:");
             // Loop through timesteps
@@ -44,12 +50,16 @@ int main(int argc, char** argv)
                     std::cout << "Moving average spike rate:" << (averageSpikes / (double)Parameters::numExcitatory) / (Parameters::timestep / 1000.0) << " Hz" << std::endl;
                 }
 
-                // Record last 50s of spiking activity
-                //if(t > (Parameters::durationMs - (50.0 * 1000.0))) {
-                    spikes.record(t);
-                //}
+                // Drain recording buffers if window is full
+                spikeDrain.update(iT);
             }
+            spikeDrain.finish(iT);
         }
+        std::cout << "Waiting for recording drain:" << spikeDrain.getWaitTime() << "s" << std::endl;
+    }
+    {
+        Timer tim("Writing spikes:");
+        spikeWriter.flush();
     }
 
     if(Parameters::measureTiming) {
@@ -0,0 +1,130 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+#include <cstdlib>
+
+// mnist_helpers.h's dense weight helpers use GeNN's scalar type
+typedef float scalar;
+
+// Common includes
+#include "../common/mnist_helpers.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// Host copy of dataset EGP and the number of bytes pushed to it - stand-ins for GeNN's generated functions
+std::vector<uint8_t> datasetEGP;
+uint8_t *dataset = nullptr;
+unsigned int numPushedBytes = 0;
+
+void allocateDataset(unsigned int count)
+{
+    datasetEGP.resize(count);
+    dataset = datasetEGP.data();
+}
+
+void pushDataset(unsigned int count)
+{
+    numPushedBytes += count;
+}
+
+// Write a synthetic IDX file of random 28x28 images
+std::vector<uint8_t> generateIDX(const std::string &filename, unsigned int numImages)
+{
+    std::mt19937 rng;
+    std::uniform_int_distribution<unsigned int> pixel(0, 255);
+    std::vector<uint8_t> images(numImages * 28 * 28);
+    std::generate(images.begin(), images.end(), [&rng, &pixel](){ return (uint8_t)pixel(rng); });
+
+    // Write header - magic number followed by big-endian dimensions
+    std::ofstream file(filename, std::ofstream::binary);
+    const uint8_t header[16] = {0, 0, 0x08, 3,
+                                (uint8_t)(numImages >> 24), (uint8_t)(numImages >> 16), (uint8_t)(numImages >> 8), (uint8_t)numImages,
+                                0, 0, 0, 28,
+                                0, 0, 0, 28};
+    file.write(reinterpret_cast<const char*>(header), 16);
+    file.write(reinterpret_cast<const char*>(images.data()), images.size());
+    return images;
+}
+
+template<typename F>
+double time(F f)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+}   // Anonymous namespace
+
+// Loads a synthetic MNIST-format dataset in one go and streamed in chunks, checking both give the same images:
+//      ./benchmark_idx_loader [num images] [chunk images]
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const unsigned int numImages = (argc > 1) ? std::stoul(argv[1]) : 60000;
+        const unsigned int chunkImages = (argc > 2) ? std::stoul(argv[2]) : 1000;
+        const std::string filename = "benchmark-images-idx3-ubyte";
+        const auto images = generateIDX(filename, numImages);
+        const size_t imageBytes = 28 * 28;
+
+        // Load whole dataset
+        IDXFile wholeImages(filename, IDXFile::Type::UnsignedByte, 3);
+        unsigned int numWholeImages;
+        const double wholeS = time([&](){ numWholeImages = loadImageData(wholeImages, dataset, &allocateDataset, &pushDataset); });
+        if(numWholeImages != numImages || numPushedBytes != images.size()
+           || !std::equal(images.cbegin(), images.cend(), dataset))
+        {
+            std::cerr << "Whole dataset doesn't match file" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Stream dataset in chunks, checking each chunk as a model would read it, via its index within the chunk
+        IDXFile streamedImages(filename, IDXFile::Type::UnsignedByte, 3);
+        allocateDataset(chunkImages * streamedImages.getItemSize());
+        numPushedBytes = 0;
+        unsigned int numChunks = 0;
+        bool correct = true;
+        const double streamedS = time(
+            [&]()
+            {
+                for(unsigned int firstImage = 0; firstImage < numImages; firstImage += chunkImages) {
+                    const unsigned int numChunkImages = loadImageChunk(streamedImages, firstImage, chunkImages,
+                                                                       dataset, &pushDataset);
+                    if(numChunkImages != std::min(chunkImages, numImages - firstImage)
+                       || !std::equal(dataset, dataset + (numChunkImages * imageBytes), &images[firstImage * imageBytes]))
+                    {
+                        correct = false;
+                    }
+                    numChunks++;
+                }
+            });
+
+        // Loading past the end of the dataset should do nothing
+        const unsigned int numPastEndImages = loadImageChunk(streamedImages, numImages, chunkImages, dataset, &pushDataset);
+
+        std::cout << numImages << " images" << std::endl;
+        std::cout << "Whole dataset:" << wholeS << "s" << std::endl;
+        std::cout << "Streamed in " << numChunks << " chunks of " << chunkImages << " images:" << streamedS << "s" << std::endl;
+        if(!correct || numPushedBytes != images.size() || numPastEndImages != 0) {
+            std::cerr << "Streamed chunks don't match file" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
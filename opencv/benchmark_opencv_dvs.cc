@@ -0,0 +1,151 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdlib>
+
+// OpenCV includes
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+// Common example code
+#include "../common/opencv_dvs.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+typedef std::chrono::high_resolution_clock Clock;
+
+// cv::cvtColor rounds each greyscale pixel to 8 bits whereas the fused pass averages the channels
+// before converting so each downsampled frame can differ by up to half a greyscale level (plus
+// a little from cvtColor's fixed-point weights) and their difference by twice that
+constexpr double maxErrorTolerance = 1.1 / 255.0;
+
+double getDuration(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Busy-wait to emulate simulation step which capture can overlap with
+void simulateStep(double stepS)
+{
+    const auto start = Clock::now();
+    while(getDuration(start) < stepS) {
+    }
+}
+}   // Anonymous namespace
+
+// Compares the original separate greyscale, convert, resize and subtract passes, with frames read synchronously,
+// against OpenCVDVSCPU's fused pass and capture thread, replaying a video file rather than a camera, and
+// fails if their frame differences don't match. Resolution must divide the height of the video's frames:
+//      ./benchmark_opencv_dvs video.avi [resolution] [simulation step ms]
+int main(int argc, char *argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Expected video filename" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const std::string filename = argv[1];
+        const unsigned int resolution = (argc > 2) ? std::stoul(argv[2]) : 32;
+        const double stepS = (argc > 3) ? std::stod(argv[3]) / 1000.0 : 0.0;
+
+        // Process video using separate OpenCV passes on simulation thread
+        // **NOTE** INTER_AREA matches the block averaging performed by fused pass
+        std::vector<cv::Mat> referenceDifferences;
+        double referenceS = 0.0;
+        double referenceProcessS = 0.0;
+        {
+            cv::VideoCapture video(filename);
+            if(!video.isOpened()) {
+                throw std::runtime_error("Cannot open video '" + filename + "'");
+            }
+
+            cv::Mat rawFrame;
+            cv::Mat greyscaleFrame;
+            cv::Mat downsampledFrames[2];
+            const auto start = Clock::now();
+            for(unsigned int i = 0; video.read(rawFrame); i++) {
+                {
+                    const auto processStart = Clock::now();
+                    const unsigned int margin = (rawFrame.cols - rawFrame.rows) / 2;
+                    const cv::Mat squareROI = rawFrame(cv::Rect(cv::Point(margin, 0), cv::Point(rawFrame.cols - margin, rawFrame.rows)));
+
+                    // INTER_AREA only matches the fused pass's whole-pixel blocks if they divide the frame exactly
+                    if((squareROI.cols % resolution) != 0 || (squareROI.rows % resolution) != 0) {
+                        throw std::runtime_error("Square region " + std::to_string(squareROI.cols) + "x" + std::to_string(squareROI.rows)
+                                                 + " is not a multiple of resolution " + std::to_string(resolution));
+                    }
+
+                    cv::cvtColor(squareROI, greyscaleFrame, CV_BGR2GRAY);
+                    greyscaleFrame.convertTo(greyscaleFrame, CV_32FC1, 1.0 / 255.0);
+                    cv::resize(greyscaleFrame, downsampledFrames[i % 2], cv::Size(resolution, resolution), 0.0, 0.0, cv::INTER_AREA);
+
+                    cv::Mat frameDifference(resolution, resolution, CV_32FC1, cv::Scalar::all(0));
+                    if(i > 0) {
+                        cv::subtract(downsampledFrames[i % 2], downsampledFrames[(i + 1) % 2], frameDifference);
+                    }
+                    referenceDifferences.push_back(frameDifference);
+                    referenceProcessS += getDuration(processStart);
+                }
+
+                simulateStep(stepS);
+            }
+            referenceS = getDuration(start);
+        }
+
+        // Process video using OpenCVDVSCPU
+        double fusedS = 0.0;
+        double fusedUpdateS = 0.0;
+        double maxError = 0.0;
+        unsigned int numFrames = 0;
+        {
+            OpenCVDVSCPU dvs(filename, resolution);
+            const auto start = Clock::now();
+            for(numFrames = 0; !dvs.isFinished(); numFrames++) {
+                {
+                    const auto updateStart = Clock::now();
+                    dvs.update(numFrames);
+                    fusedUpdateS += getDuration(updateStart);
+                }
+
+                if(numFrames < referenceDifferences.size()) {
+                    maxError = std::max(maxError, cv::norm(dvs.getFrameDifference(), referenceDifferences[numFrames], cv::NORM_INF));
+                }
+
+                simulateStep(stepS);
+            }
+            fusedS = getDuration(start);
+        }
+
+        std::cout << numFrames << " frames" << std::endl;
+        std::cout << "Separate passes:" << referenceS << "s (" << (referenceProcessS * 1000.0) / numFrames << "ms processing per frame)" << std::endl;
+        std::cout << "Fused pass with capture thread:" << fusedS << "s (" << (fusedUpdateS * 1000.0) / numFrames
+                  << "ms per update including any wait for capture, " << referenceS / fusedS << "x)" << std::endl;
+        std::cout << "Maximum difference from separate passes:" << maxError << std::endl;
+
+        if(numFrames != referenceDifferences.size()) {
+            std::cerr << "Fused pass processed " << numFrames << " frames but separate passes processed " << referenceDifferences.size() << std::endl;
+            return EXIT_FAILURE;
+        }
+        if(maxError > maxErrorTolerance) {
+            std::cerr << "Fused pass differs from separate passes by " << maxError << " (tolerance " << maxErrorTolerance << ")" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
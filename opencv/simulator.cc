@@ -1,9 +1,14 @@
 // Standard C++ includes
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <limits>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 // Standard C includes
@@ -15,20 +20,30 @@
 
 // Common example code
 #include "../common/analogue_csv_recorder.h"
+#include "../common/latency_report.h"
 #include "../common/opencv_dvs.h"
 
 #include "opencv_CODE/definitions.h"
 
 
 
+// Run with a camera device number (defaults to 0) to process live frames or with the filename of a video
+// to replay it, optionally writing a latency report and replaying at a fixed rate rather than as fast as possible:
+//      ./simulator [device | video] [latency report.json] [replay frame rate Hz]
 int main(int argc, char *argv[])
 {
-    const unsigned int device = (argc > 1) ? std::atoi(argv[1]) : 0;
+    // If source isn't a device number, replay it as a video file
+    const std::string source = (argc > 1) ? argv[1] : "0";
+    const bool replay = (source.find_first_not_of("0123456789") != std::string::npos);
+    const std::string reportFilename = (argc > 2) ? argv[2] : "";
+    const double replayRate = (argc > 3) ? std::atof(argv[3]) : 0.0;
+
 #ifndef CPU_ONLY
-    OpenCVDVSGPU dvs(device, 32);
+    std::unique_ptr<OpenCVDVSGPU> dvsPtr(replay ? new OpenCVDVSGPU(source, 32) : new OpenCVDVSGPU(std::stoul(source), 32));
 #else
-    OpenCVDVSCPU dvs(device, 32);
+    std::unique_ptr<OpenCVDVSCPU> dvsPtr(replay ? new OpenCVDVSCPU(source, 32) : new OpenCVDVSCPU(std::stoul(source), 32));
 #endif
+    auto &dvs = *dvsPtr;
     
     // Configure windows which will be used to show down-sampled images
     cv::namedWindow("Downsampled frame", CV_WINDOW_NORMAL);
@@ -43,30 +58,84 @@ int main(int argc, char *argv[])
     
     initopencv();
 
-    for(unsigned int i = 0;; i++)
+    // Add latency report stages
+    // **NOTE** frame differences are read directly from the OpenCVDVS so there is no push stage
+    LatencyReport report;
+    auto &acquireLatency = report.addStage("acquire");
+    auto &stepLatency = report.addStage("step");
+    auto &pullLatency = report.addStage("pull");
+    auto &renderLatency = report.addStage("render");
+    auto &frameToSpikeLatency = report.addStage("frame_to_spike");
+
+    const auto replayPeriod = std::chrono::duration<double>((replayRate > 0.0) ? (1.0 / replayRate) : 0.0);
+    const auto start = LatencyTimer::Clock::now();
+    unsigned int i;
+    for(i = 0; !dvs.isFinished(); i++)
     {
-        // Read DVS state and put result into GeNN
-        tie(inputCurrentsP, stepP) = dvs.update(i);
+        // When replaying at a fixed rate, wait until this frame is due
+        // **NOTE** the capture thread may have prefetched the frame long before it was due
+        // so latency is measured from the later of when it was captured and when it was due
+        auto frameTime = dvs.getFrameTime();
+        if(replay && replayRate > 0.0) {
+            const auto dueTime = start + std::chrono::duration_cast<LatencyTimer::Clock::duration>(replayPeriod * i);
+            std::this_thread::sleep_until(dueTime);
+            frameTime = std::max(frameTime, dueTime);
+        }
 
-        // Show raw frame and difference with previous
-        dvs.showDownsampledFrame("Downsampled frame", i);
-        dvs.showFrameDifference("Frame difference");
+        // Read DVS state and put result into GeNN
+        {
+            LatencyTimer t(acquireLatency);
+            tie(inputCurrentsP, stepP) = dvs.update(i);
+        }
 
         // Simulate
+        {
+            LatencyTimer t(stepLatency);
 #ifndef CPU_ONLY
-        stepTimeGPU();
-
-        pullPStateFromDevice();
+            stepTimeGPU();
 #else
-        stepTimeCPU();
+            stepTimeCPU();
 #endif
-        
-        cv::Mat wrappedVoltage(32, 32, CV_32FC1, VP);
-        cv::imshow("P Membrane voltage", wrappedVoltage);
-        // **YUCK** required for OpenCV GUI to do anything
-        cv::waitKey(1);
+        }
+
+#ifndef CPU_ONLY
+        {
+            LatencyTimer t(pullLatency);
+            pullPStateFromDevice();
+            pullPCurrentSpikesFromDevice();
+        }
+#endif
+
+        // If any P neurons spiked, record latency from capture of frame which caused them
+        if(spikeCount_P > 0) {
+            frameToSpikeLatency.record(std::chrono::duration<double>(LatencyTimer::Clock::now() - frameTime).count());
+        }
+
+        // Show raw frame, difference with previous and output
+        {
+            LatencyTimer t(renderLatency);
+            dvs.showDownsampledFrame("Downsampled frame", i);
+            dvs.showFrameDifference("Frame difference");
+
+            cv::Mat wrappedVoltage(32, 32, CV_32FC1, VP);
+            cv::imshow("P Membrane voltage", wrappedVoltage);
+
+            // **YUCK** required for OpenCV GUI to do anything
+            if(cv::waitKey(1) == 27) {
+                break;
+            }
+        }
     }
 
+    // Write latency report
+    if(!reportFilename.empty()) {
+        report.setMetadata("example", "opencv");
+        report.setMetadata("source", source);
+        report.setMetadata("replay_rate_hz", replayRate);
+        report.setMetadata("steps", i);
+        report.setMetadata("duration_s", std::chrono::duration<double>(LatencyTimer::Clock::now() - start).count());
+        report.write(reportFilename);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
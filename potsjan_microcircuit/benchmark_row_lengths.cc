@@ -0,0 +1,136 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// GeNN user project includes
+#include "utils.h"
+
+// GeNN examples includes
+#include "../common/parallel_connectors.h"
+
+// Model includes
+#include "connectivity.h"
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+double getDuration(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//! Check every projection's row lengths sum to its number of connections and return the mean, across projections with
+//! more than one row, of the variance of their row lengths relative to that of the multinomial they should be sampled from
+double checkRowLengths(const std::vector<ParallelConnectors::RowLengthProjection> &projections, unsigned int &numErrors)
+{
+    double sumVarianceRatio = 0.0;
+    unsigned int numVarianceRatios = 0;
+    for(const auto &p : projections) {
+        const size_t numConnections = std::accumulate(p.rowLengths, p.rowLengths + p.numPre, (size_t)0);
+        if(numConnections != p.numConnections) {
+            numErrors++;
+        }
+
+        if(p.numPre > 1) {
+            const double mean = (double)p.numConnections / (double)p.numPre;
+            const double sumSquaredError = std::accumulate(p.rowLengths, p.rowLengths + p.numPre, 0.0,
+                                                           [mean](double sum, unsigned int l){ return sum + ((l - mean) * (l - mean)); });
+            const double expectedVariance = mean * (1.0 - (1.0 / (double)p.numPre));
+            sumVarianceRatio += (sumSquaredError / (double)(p.numPre - 1)) / expectedVariance;
+            numVarianceRatios++;
+        }
+    }
+    return sumVarianceRatio / (double)numVarianceRatios;
+}
+}   // Anonymous namespace
+
+// Compares building the row lengths of every projection in the microcircuit with GeNN's serial buildRowLengths
+// and with ParallelConnectors::buildRowLengths on increasing numbers of threads:
+//      ./benchmark_row_lengths [max threads]
+int main(int argc, char *argv[])
+{
+    const unsigned int maxThreads = (argc > 1) ? std::stoul(argv[1]) : ParallelConnectors::getNumThreads(0);
+
+    // Allocate row lengths for each projection which exists
+    std::vector<std::vector<unsigned int>> serialRowLengths;
+    std::vector<std::vector<unsigned int>> parallelRowLengths;
+    std::vector<std::vector<unsigned int>> referenceRowLengths;
+    std::vector<ParallelConnectors::RowLengthProjection> serialProjections;
+    std::vector<ParallelConnectors::RowLengthProjection> parallelProjections;
+    std::vector<unsigned int> numTrg;
+    size_t numConnections = 0;
+    for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
+        for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
+            for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
+                for(unsigned int srcPop = 0; srcPop < Parameters::PopulationMax; srcPop++) {
+                    const unsigned int projectionNumConnections = Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop);
+                    if(projectionNumConnections > 0) {
+                        const std::string name = Parameters::getPopulationName(srcLayer, srcPop) + "_" + Parameters::getPopulationName(trgLayer, trgPop);
+                        const unsigned int numSrc = Parameters::getScaledNumNeurons(srcLayer, srcPop);
+
+                        serialRowLengths.emplace_back(numSrc);
+                        parallelRowLengths.emplace_back(numSrc);
+                        numTrg.push_back(Parameters::getScaledNumNeurons(trgLayer, trgPop));
+                        serialProjections.push_back(ParallelConnectors::RowLengthProjection{
+                            numSrc, projectionNumConnections, nullptr, Connectivity::getStream(name)});
+                        numConnections += projectionNumConnections;
+                    }
+                }
+            }
+        }
+    }
+    parallelProjections = serialProjections;
+    for(size_t p = 0; p < serialProjections.size(); p++) {
+        serialProjections[p].rowLengths = serialRowLengths[p].data();
+        parallelProjections[p].rowLengths = parallelRowLengths[p].data();
+    }
+    std::cout << "Distributing " << numConnections << " synapses between the rows of " << serialProjections.size() << " projections" << std::endl;
+
+    // Build row lengths serially using GeNN
+    unsigned int numErrors = 0;
+    double serialS;
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        std::mt19937 rng;
+        for(size_t p = 0; p < serialProjections.size(); p++) {
+            buildRowLengths(serialProjections[p].numPre, numTrg[p], serialProjections[p].numConnections,
+                            serialProjections[p].rowLengths, rng);
+        }
+        serialS = getDuration(start);
+    }
+    std::cout << "Serial binomials: " << serialS << "s (row length variance / multinomial variance:"
+              << checkRowLengths(serialProjections, numErrors) << ")" << std::endl;
+
+    // Build row lengths using tree of binomials on increasing numbers of threads
+    for(unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        ParallelConnectors::buildRowLengths(parallelProjections, Parameters::connectivitySeed, numThreads);
+        const double parallelS = getDuration(start);
+        std::cout << "Binomial tree on " << numThreads << " threads: " << parallelS << "s (" << serialS / parallelS
+                  << "x, row length variance / multinomial variance:" << checkRowLengths(parallelProjections, numErrors) << ")" << std::endl;
+
+        // Check row lengths are the same whatever the number of threads
+        if(referenceRowLengths.empty()) {
+            referenceRowLengths = parallelRowLengths;
+        }
+        else if(referenceRowLengths != parallelRowLengths) {
+            std::cout << "\tROW LENGTHS DIFFER FROM THOSE BUILT ON 1 THREAD" << std::endl;
+            numErrors++;
+        }
+    }
+
+    if(numErrors > 0) {
+        std::cout << numErrors << " ERRORS" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+# Build models for each rank of microcircuit partitioned across $1 processes (default 2)
+# and simulator which runs them - any arguments after the first are passed to genn-buildmodel.sh
+NUM_RANKS=${1:-2}
+shift
+
+for (( RANK=0; RANK<$NUM_RANKS; RANK++ )); do
+    OUTPUT_PATH=rank_${RANK}_of_${NUM_RANKS}
+    mkdir -p $OUTPUT_PATH
+    POTJANS_NUM_RANKS=$NUM_RANKS POTJANS_RANK=$RANK genn-buildmodel.sh -o $OUTPUT_PATH "$@" model.cc || exit 1
+    make -C $OUTPUT_PATH/potjans_microcircuit_CODE || exit 1
+done
+
+make potjans_microcircuit_partitioned
@@ -0,0 +1,255 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdint>
+
+// GeNN user project includes
+#include "timer.h"
+
+// GeNN examples includes
+#include "../common/connectivity_cache.h"
+#include "../common/parallel_connectors.h"
+
+// Model parameters
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// Connectivity
+//----------------------------------------------------------------------------
+//! Host generation and caching of the microcircuit's connectivity, used when
+//! Parameters::cacheConnectivity is set and the model leaves it uninitialised.
+//! Generation matches the FixedNumberTotalWithReplacement, NormalClipped and
+//! NormalClippedDelay snippets used when connectivity is initialised on device
+namespace Connectivity
+{
+//! Bump whenever generation changes so stale caches are ignored
+constexpr uint32_t generatorVersion = 2;
+
+//----------------------------------------------------------------------------
+// Connectivity::Projection
+//----------------------------------------------------------------------------
+struct Projection
+{
+    unsigned int srcLayer;
+    unsigned int srcPop;
+    unsigned int trgLayer;
+    unsigned int trgPop;
+    ConnectivityCache::Projection arrays;
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+//! Size of postsynaptic indices GeNN uses for target population with narrow sparse indices enabled
+inline unsigned int getIndBytes(unsigned int numTrg)
+{
+    if(numTrg <= 0xFF) {
+        return 1;
+    }
+    else if(numTrg <= 0xFFFF) {
+        return 2;
+    }
+    else {
+        return 4;
+    }
+}
+
+//! Random stream used for projection, shared by host and device row length generation so they match
+inline uint32_t getStream(const std::string &name)
+{
+    return (uint32_t)ConnectivityCache::Hash().add(name).get();
+}
+
+//! Hash everything the generated connectivity depends on - parameters which
+//! only affect stimulation or neuron dynamics aren't included
+inline uint64_t getKey()
+{
+    ConnectivityCache::Hash hash;
+    hash.add(generatorVersion).add(Parameters::connectivitySeed).add(Parameters::dtMs);
+    for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
+        for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
+            for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
+                for(unsigned int srcPop = 0; srcPop < Parameters::PopulationMax; srcPop++) {
+                    hash.add(Parameters::getScaledNumNeurons(srcLayer, srcPop));
+                    hash.add(Parameters::getScaledNumNeurons(trgLayer, trgPop));
+                    hash.add(Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop));
+                    hash.add(Parameters::getMeanWeight(srcLayer, srcPop, trgLayer, trgPop) / sqrt(Parameters::connectivityScalingFactor));
+                    hash.add(Parameters::getWeightSD(srcLayer, srcPop, trgLayer, trgPop));
+                    hash.add(Parameters::meanDelay[srcPop]).add(Parameters::delaySD[srcPop]);
+                    hash.add(Parameters::getMaxDelayMs(srcPop));
+                }
+            }
+        }
+    }
+    return hash.get();
+}
+
+template<typename Ind>
+void generate(const Projection &projection, std::mt19937 &rng)
+{
+    const auto &arrays = projection.arrays;
+    const unsigned int numTrg = Parameters::getScaledNumNeurons(projection.trgLayer, projection.trgPop);
+    const unsigned int numConnections = Parameters::getScaledNumConnections(projection.srcLayer, projection.srcPop,
+                                                                            projection.trgLayer, projection.trgPop);
+
+    // Build row lengths and check they fit in the structure GeNN has allocated
+    // **NOTE** projections are already generated in parallel so this uses one thread
+    ParallelConnectors::buildRowLengths({ParallelConnectors::RowLengthProjection{arrays.numSrc, numConnections, arrays.rowLength,
+                                                                                 getStream(arrays.name)}},
+                                        Parameters::connectivitySeed, 1);
+    const unsigned int maxRowLength = *std::max_element(arrays.rowLength, arrays.rowLength + arrays.numSrc);
+    if(maxRowLength > arrays.maxRowLength) {
+        throw std::runtime_error("Generated row of length " + std::to_string(maxRowLength) + " in '" + arrays.name
+                                 + "' which exceeds max row length " + std::to_string(arrays.maxRowLength));
+    }
+
+    // Build weight and delay distributions
+    const bool excitatory = (projection.srcPop == Parameters::PopulationE);
+    const double meanWeight = Parameters::getMeanWeight(projection.srcLayer, projection.srcPop, projection.trgLayer, projection.trgPop) / sqrt(Parameters::connectivityScalingFactor);
+    const double maxDelayMs = Parameters::getMaxDelayMs(projection.srcPop);
+    std::uniform_int_distribution<unsigned int> indDist(0, numTrg - 1);
+    std::normal_distribution<double> weightDist(meanWeight, Parameters::getWeightSD(projection.srcLayer, projection.srcPop,
+                                                                                    projection.trgLayer, projection.trgPop));
+    std::normal_distribution<double> delayDist(Parameters::meanDelay[projection.srcPop], Parameters::delaySD[projection.srcPop]);
+
+    Ind *ind = static_cast<Ind*>(arrays.ind);
+    float *g = static_cast<float*>(arrays.vars[0].first);
+    uint8_t *d = static_cast<uint8_t*>(arrays.vars[1].first);
+    for(unsigned int i = 0; i < arrays.numSrc; i++) {
+        const size_t rowStart = (size_t)i * arrays.maxRowLength;
+        const size_t rowEnd = rowStart + arrays.rowLength[i];
+
+        // Draw postsynaptic indices with replacement and sort
+        std::generate(&ind[rowStart], &ind[rowEnd], [&indDist, &rng](){ return (Ind)indDist(rng); });
+        std::sort(&ind[rowStart], &ind[rowEnd]);
+
+        for(size_t s = rowStart; s < rowEnd; s++) {
+            // Resample weights until they have the correct sign
+            double weight;
+            do {
+                weight = weightDist(rng);
+            } while(excitatory ? (weight < 0.0) : (weight > 0.0));
+            g[s] = (float)weight;
+
+            // Resample delays until they are in range and convert to timesteps
+            double delay;
+            do {
+                delay = delayDist(rng);
+            } while(delay < 0.0 || delay > maxDelayMs);
+            d[s] = (uint8_t)std::rint(delay / Parameters::dtMs);
+        }
+    }
+}
+
+//! Copy connectivity from cache if available, otherwise generate it and write cache. getSymbol should
+//! return a pointer to the named symbol in the generated code or nullptr if it doesn't exist. Models
+//! containing different subsets of the projections (i.e. the ranks of a partitioned model) need their own cachePrefix
+inline void init(std::function<void*(const std::string&)> getSymbol,
+                 const std::string &cachePrefix = Parameters::connectivityCachePrefix)
+{
+    Timer timer("Connectivity initialisation:");
+
+    auto getRequiredSymbol = [&getSymbol](const std::string &name)
+    {
+        void *symbol = getSymbol(name);
+        if(symbol == nullptr) {
+            throw std::runtime_error("Cannot find symbol '" + name + "' - was model built with Parameters::cacheConnectivity?");
+        }
+        return symbol;
+    };
+
+    // Find GeNN's host arrays for all projections which exist
+    std::vector<Projection> projections;
+    for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
+        for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
+            for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
+                for(unsigned int srcPop = 0; srcPop < Parameters::PopulationMax; srcPop++) {
+                    const std::string name = Parameters::getPopulationName(srcLayer, srcPop) + "_" + Parameters::getPopulationName(trgLayer, trgPop);
+                    void *rowLength = getSymbol("rowLength" + name);
+                    if(rowLength == nullptr) {
+                        continue;
+                    }
+
+                    const unsigned int numTrg = Parameters::getScaledNumNeurons(trgLayer, trgPop);
+                    projections.push_back(Projection{srcLayer, srcPop, trgLayer, trgPop,
+                        ConnectivityCache::Projection{name, Parameters::getScaledNumNeurons(srcLayer, srcPop),
+                                                      *static_cast<const unsigned int*>(getRequiredSymbol("maxRowLength" + name)),
+                                                      *static_cast<unsigned int**>(rowLength),
+                                                      *static_cast<void**>(getRequiredSymbol("ind" + name)), getIndBytes(numTrg),
+                                                      {{*static_cast<void**>(getRequiredSymbol("g" + name)), sizeof(float)},
+                                                       {*static_cast<void**>(getRequiredSymbol("d" + name)), sizeof(uint8_t)}}}});
+                }
+            }
+        }
+    }
+
+    std::vector<ConnectivityCache::Projection> arrays;
+    arrays.reserve(projections.size());
+    std::transform(projections.cbegin(), projections.cend(), std::back_inserter(arrays),
+                   [](const Projection &p){ return p.arrays; });
+
+    // Try and load from cache
+    const uint64_t key = getKey();
+    const std::string filename = ConnectivityCache::getFilename(cachePrefix, key);
+    if(ConnectivityCache::load(filename, key, arrays)) {
+        std::cout << "Loaded connectivity from " << filename << std::endl;
+        return;
+    }
+
+    // Otherwise, generate projections in parallel
+    // **NOTE** each projection has its own RNG, seeded from its name, so results don't depend on scheduling
+    std::atomic<size_t> nextProjection(0);
+    std::vector<std::thread> workers;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    const unsigned int numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned int w = 0; w < numWorkers; w++) {
+        workers.emplace_back([&]()
+        {
+            try
+            {
+                for(size_t p = nextProjection++; p < projections.size(); p = nextProjection++) {
+                    std::seed_seq seeds{Parameters::connectivitySeed, getStream(projections[p].arrays.name)};
+                    std::mt19937 rng(seeds);
+
+                    switch(projections[p].arrays.indBytes) {
+                    case 1: generate<uint8_t>(projections[p], rng); break;
+                    case 2: generate<uint16_t>(projections[p], rng); break;
+                    default: generate<uint32_t>(projections[p], rng); break;
+                    }
+                }
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                error = std::current_exception();
+            }
+        });
+    }
+    for(auto &w : workers) {
+        w.join();
+    }
+    if(error) {
+        std::rethrow_exception(error);
+    }
+
+    // Write cache
+    ConnectivityCache::save(filename, key, arrays);
+    std::cout << "Generated connectivity and cached to " << filename << std::endl;
+}
+}   // namespace Connectivity
@@ -1,4 +1,5 @@
 // GeNN includes
+#include "binomial.h"
 #include "modelSpec.h"
 
 // Genn examples includes
@@ -6,6 +7,7 @@
 
 // Model includes
 #include "parameters.h"
+#include "partition.h"
 
 void modelDefinition(NNmodel &model)
 {
@@ -39,10 +41,9 @@ void modelDefinition(NNmodel &model)
     PostsynapticModels::ExpCurr::ParamValues inhibitoryExpCurrParams(
         0.5);  // 0 - TauSyn (ms)
 
-    const double quantile = 0.9999;
     const double maxDelayMs[Parameters::PopulationMax] = {
-        Parameters::meanDelay[Parameters::PopulationE] + (Parameters::delaySD[Parameters::PopulationE] * normalCDFInverse(quantile)),
-        Parameters::meanDelay[Parameters::PopulationI] + (Parameters::delaySD[Parameters::PopulationI] * normalCDFInverse(quantile))};
+        Parameters::getMaxDelayMs(Parameters::PopulationE),
+        Parameters::getMaxDelayMs(Parameters::PopulationI)};
     std::cout << "Max excitatory delay: " << maxDelayMs[Parameters::PopulationE] << "ms, max inhibitory delay: " << maxDelayMs[Parameters::PopulationI] << "ms" << std::endl;
 
     // Calculate maximum dendritic delay slots
@@ -50,6 +51,15 @@ void modelDefinition(NNmodel &model)
     const unsigned int maxDendriticDelaySlots = (unsigned int)std::rint(std::max(maxDelayMs[Parameters::PopulationE], maxDelayMs[Parameters::PopulationI])  / Parameters::dtMs);
     std::cout << "Max dendritic delay slots:" << maxDendriticDelaySlots << std::endl;
 
+    // If POTJANS_NUM_RANKS is set, only build this rank's part of the model
+    unsigned int numRanks;
+    unsigned int rank;
+    Partition::getRankFromEnvironment(numRanks, rank);
+    const Partition::Assignment assignment = Partition::partition(numRanks);
+    if(numRanks > 1) {
+        std::cout << "Building rank " << rank << " of " << numRanks << ": expected spike traffic between ranks:" << assignment.spikeTraffic << " spikes/s" << std::endl;
+    }
+
     // Loop through populations and layers
     std::cout << "Creating neuron populations:" << std::endl;
     unsigned int totalNeurons = 0;
@@ -58,6 +68,20 @@ void modelDefinition(NNmodel &model)
             // Determine name of population
             const std::string popName = Parameters::getPopulationName(layer, pop);
 
+            // If population is simulated on another rank but has targets on this one, add a spike source
+            // with the same name, whose spikes are pushed by simulator, to stand in for it
+            if(assignment.isMirrored(layer, pop, rank)) {
+                auto *mirrorPop = model.addNeuronPopulation<NeuronModels::SpikeSource>(popName, Parameters::getScaledNumNeurons(layer, pop),
+                                                                                       {}, {});
+                mirrorPop->setSpikeLocation(VarLocation::HOST_DEVICE);
+                std::cout << "\tPopulation " << popName << ": mirror of rank " << assignment.getRank(layer, pop) << std::endl;
+                continue;
+            }
+            // Otherwise, skip populations simulated on other ranks
+            else if(!assignment.isLocal(layer, pop, rank)) {
+                continue;
+            }
+
             // Calculate external input rate, weight and current
             const double extInputRate = (Parameters::numExternalInputs[layer][pop] *
                                          Parameters::connectivityScalingFactor *
@@ -92,6 +116,11 @@ void modelDefinition(NNmodel &model)
                                                                     poissonParams, poissonInit);
             // Make recordable on host
             neuronPop->setSpikeRecordingEnabled(true);
+
+            // If spikes are sent to other ranks, they need to be pulled every timestep
+            if(assignment.isExported(layer, pop)) {
+                neuronPop->setSpikeLocation(VarLocation::HOST_DEVICE);
+            }
 #ifdef USE_ZERO_COPY
             //neuronPop->setSpikeLocation(VarLocation::ZERO_COPY);
 #else
@@ -111,6 +140,11 @@ void modelDefinition(NNmodel &model)
         for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
             const std::string trgName = Parameters::getPopulationName(trgLayer, trgPop);
 
+            // Synapse populations are simulated on the same rank as their target
+            if(!assignment.isLocal(trgLayer, trgPop, rank)) {
+                continue;
+            }
+
             // Loop through source populations and layers
             for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
                 for(unsigned int srcPop = 0; srcPop < Parameters::PopulationMax; srcPop++) {
@@ -120,13 +154,7 @@ void modelDefinition(NNmodel &model)
                     const double meanWeight = Parameters::getMeanWeight(srcLayer, srcPop, trgLayer, trgPop) / sqrt(Parameters::connectivityScalingFactor);
 
                     // Determine weight standard deviation
-                    double weightSD;
-                    if(srcPop == Parameters::PopulationE && srcLayer == Parameters::Layer4 && trgLayer == Parameters::Layer23 && trgPop == Parameters::PopulationE) {
-                        weightSD = meanWeight * Parameters::layer234RelW;
-                    }
-                    else {
-                        weightSD = fabs(meanWeight * Parameters::relW);
-                    }
+                    const double weightSD = Parameters::getWeightSD(srcLayer, srcPop, trgLayer, trgPop);
 
                     // Calculate number of connections
                     const unsigned int numConnections = Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop);
@@ -149,6 +177,15 @@ void modelDefinition(NNmodel &model)
                             ? SynapseMatrixType::PROCEDURAL_PROCEDURALG
                             : SynapseMatrixType::SPARSE_INDIVIDUALG;
 
+                        // If connectivity is cached, it is generated on the host by the simulator so leave it uninitialised
+                        const auto connectivityInit = Parameters::cacheConnectivity
+                            ? uninitialisedConnectivity()
+                            : initConnectivity<InitSparseConnectivitySnippet::FixedNumberTotalWithReplacement>(connectParams);
+
+                        // GeNN can't calculate max row length of uninitialised connectivity so use the same bound as the snippet
+                        const unsigned int numSrc = Parameters::getScaledNumNeurons(srcLayer, srcPop);
+                        const unsigned int maxRowLength = binomialInverseCDF(pow(0.9999, 1.0 / (double)numSrc), numConnections, 1.0 / (double)numSrc);
+
                         // Excitatory
                         if(srcPop == Parameters::PopulationE) {
                             // Build distribution for weight parameters
@@ -168,15 +205,15 @@ void modelDefinition(NNmodel &model)
 
                             // Create weight parameters
                             WeightUpdateModels::StaticPulseDendriticDelay::VarValues staticSynapseInit(
-                                initVar<InitVarSnippet::NormalClipped>(wDist),          // 0 - Wij (nA)
-                                initVar<InitVarSnippet::NormalClippedDelay>(dDist));    // 1 - delay (ms)
+                                Parameters::cacheConnectivity ? uninitialisedVar() : initVar<InitVarSnippet::NormalClipped>(wDist),       // 0 - Wij (nA)
+                                Parameters::cacheConnectivity ? uninitialisedVar() : initVar<InitVarSnippet::NormalClippedDelay>(dDist)); // 1 - delay (ms)
 
                             // Add synapse population
                             auto *synPop = model.addSynapsePopulation<WeightUpdateModels::StaticPulseDendriticDelay, PostsynapticModels::ExpCurr>(
                                 synapseName, matrixType, NO_DELAY, srcName, trgName,
                                 {}, staticSynapseInit,
                                 excitatoryExpCurrParams, {},
-                                initConnectivity<InitSparseConnectivitySnippet::FixedNumberTotalWithReplacement>(connectParams));
+                                connectivityInit);
 
                             // Set max dendritic delay and span type
                             synPop->setMaxDendriticDelayTimesteps(maxDendriticDelaySlots);
@@ -184,6 +221,14 @@ void modelDefinition(NNmodel &model)
                             if(Parameters::presynapticParallelism) {
                                 synPop->setNumThreadsPerSpike(Parameters::numThreadsPerSpike);
                             }
+
+                            // Cached connectivity is copied into host arrays and pushed
+                            if(Parameters::cacheConnectivity) {
+                                synPop->setMaxConnections(maxRowLength);
+                                synPop->setSparseConnectivityLocation(VarLocation::HOST_DEVICE);
+                                synPop->setWUVarLocation("g", VarLocation::HOST_DEVICE);
+                                synPop->setWUVarLocation("d", VarLocation::HOST_DEVICE);
+                            }
                         }
                         // Inhibitory
                         else {
@@ -203,15 +248,15 @@ void modelDefinition(NNmodel &model)
 
                             // Create weight parameters
                             WeightUpdateModels::StaticPulseDendriticDelay::VarValues staticSynapseInit(
-                                initVar<InitVarSnippet::NormalClipped>(wDist),          // 0 - Wij (nA)
-                                initVar<InitVarSnippet::NormalClippedDelay>(dDist));    // 1 - delay (ms)
+                                Parameters::cacheConnectivity ? uninitialisedVar() : initVar<InitVarSnippet::NormalClipped>(wDist),       // 0 - Wij (nA)
+                                Parameters::cacheConnectivity ? uninitialisedVar() : initVar<InitVarSnippet::NormalClippedDelay>(dDist)); // 1 - delay (ms)
 
                             // Add synapse population
                             auto *synPop = model.addSynapsePopulation<WeightUpdateModels::StaticPulseDendriticDelay, PostsynapticModels::ExpCurr>(
                                 synapseName, matrixType, NO_DELAY, srcName, trgName,
                                 {}, staticSynapseInit,
                                 inhibitoryExpCurrParams, {},
-                                initConnectivity<InitSparseConnectivitySnippet::FixedNumberTotalWithReplacement>(connectParams));
+                                connectivityInit);
 
                             // Set max dendritic delay and span type
                             synPop->setMaxDendriticDelayTimesteps(maxDendriticDelaySlots);
@@ -219,6 +264,14 @@ void modelDefinition(NNmodel &model)
                             if(Parameters::presynapticParallelism) {
                                 synPop->setNumThreadsPerSpike(Parameters::numThreadsPerSpike);
                             }
+
+                            // Cached connectivity is copied into host arrays and pushed
+                            if(Parameters::cacheConnectivity) {
+                                synPop->setMaxConnections(maxRowLength);
+                                synPop->setSparseConnectivityLocation(VarLocation::HOST_DEVICE);
+                                synPop->setWUVarLocation("g", VarLocation::HOST_DEVICE);
+                                synPop->setWUVarLocation("d", VarLocation::HOST_DEVICE);
+                            }
                         }
 
                     }
@@ -1,7 +1,12 @@
+#pragma once
+
 // Standard C includes
 #include <cassert>
 #include <cmath>
 
+// GeNN examples includes
+#include "../common/normal_distribution.h"
+
 //#define USE_ZERO_COPY
 //#define JETSON_POWER
 
@@ -50,9 +55,27 @@ const bool presynapticParallelism = false;
 // Should we use procedural rather than in-memory connectivity?
 const bool proceduralConnectivity = false;
 
+// Should sparse connectivity be generated on the host and cached to disk
+// rather than being initialised on the device every time the model is run?
+// **NOTE** cached connectivity is drawn from a different random stream to
+// device-initialised connectivity so enabling this changes the network
+const bool cacheConnectivity = false;
+
+// Seed used when generating cached connectivity
+const unsigned int connectivitySeed = 1234;
+
+// Prefix for connectivity cache files - the hash of the connectivity parameters is appended
+const char *const connectivityCachePrefix = "connectivity_";
+
+// Maximum fraction by which the synapses simulated on any one rank can exceed
+// an even share when the model is partitioned across multiple processes
+const double maxPartitionImbalance = 0.25;
+
 // Assert settings are valid
 static_assert(presynapticParallelism || !proceduralConnectivity,
               "Procedural connectivity can only be use with presynaptic parallelism");
+static_assert(!proceduralConnectivity || !cacheConnectivity,
+              "Procedural connectivity cannot be cached");
 
 // Number of threads to use for each row if using presynaptic parallelism
 const unsigned int numThreadsPerSpike = 1;
@@ -63,6 +86,9 @@ const double dtMs = 0.1;
 // Simulation duration [ms]
 const double durationMs = 1000.0;
 
+// Number of timesteps of spikes recorded on device before being drained to disk
+const unsigned int recordingWindowTimesteps = 1000;
+
 // Scaling factors for number of neurons and synapses
 const double neuronScalingFactor = 1.0;
 const double connectivityScalingFactor = 1.0;
@@ -175,6 +201,23 @@ double getMeanWeight(unsigned int srcLayer, unsigned int srcPop, unsigned int tr
     }
 }
 
+double getWeightSD(unsigned int srcLayer, unsigned int srcPop, unsigned int trgLayer, unsigned int trgPop)
+{
+    const double meanWeight = getMeanWeight(srcLayer, srcPop, trgLayer, trgPop) / sqrt(connectivityScalingFactor);
+    if(srcPop == PopulationE && srcLayer == Layer4 && trgLayer == Layer23 && trgPop == PopulationE) {
+        return meanWeight * layer234RelW;
+    }
+    else {
+        return fabs(meanWeight * relW);
+    }
+}
+
+double getMaxDelayMs(unsigned int srcPop)
+{
+    const double quantile = 0.9999;
+    return meanDelay[srcPop] + (delaySD[srcPop] * normalCDFInverse(quantile));
+}
+
 unsigned int getScaledNumConnections(unsigned int srcLayer, unsigned int srcPop, unsigned int trgLayer, unsigned int trgPop)
 {
     // Scale full number of inputs by scaling factor
@@ -0,0 +1,58 @@
+// Standard C++ includes
+#include <iostream>
+#include <string>
+
+// Model includes
+#include "parameters.h"
+#include "partition.h"
+
+// Print how the microcircuit would be partitioned across the given number of ranks
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const unsigned int numRanks = (argc > 1) ? std::stoul(argv[1]) : 2;
+        const Partition::Assignment assignment = Partition::partition(numRanks);
+
+        double totalLoad = 0.0;
+        for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+            for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+                totalLoad += Partition::getLoad(layer, pop);
+            }
+        }
+
+        for(unsigned int r = 0; r < numRanks; r++) {
+            std::cout << "Rank " << r << ":" << std::endl;
+
+            double load = 0.0;
+            std::cout << "\tLocal:";
+            for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+                for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+                    if(assignment.isLocal(layer, pop, r)) {
+                        std::cout << " " << Parameters::getPopulationName(layer, pop);
+                        load += Partition::getLoad(layer, pop);
+                    }
+                }
+            }
+            std::cout << std::endl;
+
+            std::cout << "\tMirrored:";
+            for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+                for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+                    if(assignment.isMirrored(layer, pop, r)) {
+                        std::cout << " " << Parameters::getPopulationName(layer, pop);
+                    }
+                }
+            }
+            std::cout << std::endl;
+            std::cout << "\tSynapses:" << load << " (" << (100.0 * load / totalLoad) << "%)" << std::endl;
+        }
+        std::cout << "Expected spike traffic between ranks:" << assignment.spikeTraffic << " spikes/s" << std::endl;
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
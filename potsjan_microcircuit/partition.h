@@ -0,0 +1,204 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdlib>
+
+// Model parameters
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// Partition
+//----------------------------------------------------------------------------
+//! Assignment of the microcircuit's populations to the ranks of a multi-process simulation.
+//! Synapse populations live on the same rank as their target population and every rank which
+//! has targets of a remote population simulates a spike source 'mirror' of it with the same name.
+//! Each spike therefore crosses ranks once for every remote rank with targets of its population,
+//! irrespective of how many synapses it has there, so the traffic is estimated from the mean
+//! firing rates and which projections exist and the load from the number of synapses per rank
+namespace Partition
+{
+constexpr unsigned int numPopulations = Parameters::LayerMax * Parameters::PopulationMax;
+
+//----------------------------------------------------------------------------
+// Partition::Assignment
+//----------------------------------------------------------------------------
+struct Assignment
+{
+    unsigned int numRanks;
+
+    //! Rank each population is simulated on, indexed by (layer * PopulationMax) + pop
+    std::vector<unsigned int> rank;
+
+    //! Expected number of spikes sent between ranks per second
+    double spikeTraffic;
+
+    //! Number of synapses simulated on the most heavily-loaded rank
+    double maxLoad;
+
+    unsigned int getRank(unsigned int layer, unsigned int pop) const
+    {
+        return rank[(layer * Parameters::PopulationMax) + pop];
+    }
+
+    bool isLocal(unsigned int layer, unsigned int pop, unsigned int localRank) const
+    {
+        return (getRank(layer, pop) == localRank);
+    }
+
+    //! Does the given rank need spikes from the population - i.e. is it remote but has targets there?
+    bool isMirrored(unsigned int layer, unsigned int pop, unsigned int localRank) const
+    {
+        if(isLocal(layer, pop, localRank)) {
+            return false;
+        }
+
+        for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
+            for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
+                if(isLocal(trgLayer, trgPop, localRank)
+                   && Parameters::getScaledNumConnections(layer, pop, trgLayer, trgPop) > 0)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    //! Does any other rank need spikes from the population?
+    bool isExported(unsigned int layer, unsigned int pop) const
+    {
+        for(unsigned int r = 0; r < numRanks; r++) {
+            if(isMirrored(layer, pop, r)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Free functions
+//----------------------------------------------------------------------------
+//! Number of synapses targetting population
+inline double getLoad(unsigned int layer, unsigned int pop)
+{
+    double numSynapses = 0.0;
+    for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
+        for(unsigned int srcPop = 0; srcPop < Parameters::PopulationMax; srcPop++) {
+            numSynapses += Parameters::getScaledNumConnections(srcLayer, srcPop, layer, pop);
+        }
+    }
+    return numSynapses;
+}
+
+//! Expected number of spikes emitted by population per second
+inline double getSpikeRate(unsigned int layer, unsigned int pop)
+{
+    return Parameters::meanFiringRates[layer][pop] * Parameters::getScaledNumNeurons(layer, pop);
+}
+
+//! Fill in assignment's traffic and load estimates from its ranks
+inline void evaluate(Assignment &assignment)
+{
+    std::vector<double> load(assignment.numRanks, 0.0);
+    assignment.spikeTraffic = 0.0;
+    for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+        for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+            load[assignment.getRank(layer, pop)] += getLoad(layer, pop);
+
+            for(unsigned int r = 0; r < assignment.numRanks; r++) {
+                if(assignment.isMirrored(layer, pop, r)) {
+                    assignment.spikeTraffic += getSpikeRate(layer, pop);
+                }
+            }
+        }
+    }
+    assignment.maxLoad = *std::max_element(load.cbegin(), load.cend());
+}
+
+//! Is assignment a better than b? Balanced assignments are preferred, then those with less
+//! traffic. If neither is balanced, the more balanced assignment is preferred
+inline bool isBetter(const Assignment &a, bool aBalanced, const Assignment &b, bool bBalanced)
+{
+    if(aBalanced != bBalanced) {
+        return aBalanced;
+    }
+    else if(aBalanced) {
+        return (a.spikeTraffic < b.spikeTraffic) || (a.spikeTraffic == b.spikeTraffic && a.maxLoad < b.maxLoad);
+    }
+    else {
+        return (a.maxLoad < b.maxLoad) || (a.maxLoad == b.maxLoad && a.spikeTraffic < b.spikeTraffic);
+    }
+}
+
+//! Recursively enumerate set partitions as restricted growth strings - population p is assigned to
+//! an existing rank or the next unused one - so permutations of the same division aren't revisited
+inline void search(unsigned int p, unsigned int numUsedRanks, double balancedLoad,
+                   Assignment &current, Assignment &best, bool &bestBalanced)
+{
+    // Prune if there aren't enough populations left to give every rank one
+    if((numUsedRanks + (numPopulations - p)) < current.numRanks) {
+        return;
+    }
+
+    if(p == numPopulations) {
+        evaluate(current);
+        const bool balanced = (current.maxLoad <= balancedLoad);
+        if(isBetter(current, balanced, best, bestBalanced)) {
+            best = current;
+            bestBalanced = balanced;
+        }
+        return;
+    }
+
+    for(unsigned int r = 0; r < std::min(numUsedRanks + 1, current.numRanks); r++) {
+        current.rank[p] = r;
+        search(p + 1, std::max(numUsedRanks, r + 1), balancedLoad, current, best, bestBalanced);
+    }
+}
+
+//! Find the assignment of populations to numRanks ranks with the least spike traffic whose most heavily
+//! loaded rank has no more than (1 + maxImbalance) times an even share of the synapses. If no assignment
+//! is this balanced, the most balanced is returned. With only 8 populations, every way of dividing them
+//! between ranks (at most 4140) can be evaluated. Deterministic, so every rank calculates the same result
+inline Assignment partition(unsigned int numRanks, double maxImbalance = Parameters::maxPartitionImbalance)
+{
+    if(numRanks == 0 || numRanks > numPopulations) {
+        throw std::runtime_error("Microcircuit can only be partitioned across 1-" + std::to_string(numPopulations) + " ranks");
+    }
+
+    // Calculate total load
+    double totalLoad = 0.0;
+    for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+        for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+            totalLoad += getLoad(layer, pop);
+        }
+    }
+
+    Assignment best{numRanks, {}, std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    Assignment current{numRanks, std::vector<unsigned int>(numPopulations, 0), 0.0, 0.0};
+    bool bestBalanced = false;
+    search(0, 0, (1.0 + maxImbalance) * totalLoad / (double)numRanks, current, best, bestBalanced);
+    return best;
+}
+
+//! Read number of ranks and this process's rank from POTJANS_NUM_RANKS and POTJANS_RANK
+//! environment variables, used when building per-rank models, defaulting to a single rank
+inline void getRankFromEnvironment(unsigned int &numRanks, unsigned int &rank)
+{
+    const char *numRanksString = std::getenv("POTJANS_NUM_RANKS");
+    const char *rankString = std::getenv("POTJANS_RANK");
+    numRanks = (numRanksString == nullptr) ? 1 : std::stoul(numRanksString);
+    rank = (rankString == nullptr) ? 0 : std::stoul(rankString);
+    if(rank >= numRanks) {
+        throw std::runtime_error("POTJANS_RANK must be less than POTJANS_NUM_RANKS");
+    }
+}
+}   // namespace Partition
@@ -1,7 +1,11 @@
-import csv
 import matplotlib.pyplot as plt
 import numpy as np
 import re
+import sys
+from os import path
+
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "common"))
+from binary_spikes import read_binary_spikes
 
 N_full = {
   '23': {'E': 20683, 'I': 5834},
@@ -14,26 +18,24 @@ N_scaling = 0.1
 
 def load_spikes(filename):
     # Parse filename and use to get population name and size
-    match = re.match("([0-9]+)([EI])\.csv", filename)
+    match = re.match("([0-9]+)([EI])\.bin", filename)
     name = match.group(1) + match.group(2)
     num = int(N_full[match.group(1)][match.group(2)] * N_scaling)
 
     print(name, num)
-    # Read CSV spikes
-    spikes = np.loadtxt(filename, delimiter=",", skiprows=1,
-                        dtype={"names": ("time", "neuron_id"),
-                            "formats": (np.float, np.int)})
-
-    return spikes["time"], spikes["neuron_id"], name, num
-
-pop_spikes = [load_spikes("6I.csv"),
-              load_spikes("6E.csv"),
-              load_spikes("5I.csv"),
-              load_spikes("5E.csv"),
-              load_spikes("4I.csv"),
-              load_spikes("4E.csv"),
-              load_spikes("23I.csv"),
-              load_spikes("23E.csv")]
+    # Read binary spikes
+    times, ids = read_binary_spikes(filename)
+
+    return times, ids, name, num
+
+pop_spikes = [load_spikes("6I.bin"),
+              load_spikes("6E.bin"),
+              load_spikes("5I.bin"),
+              load_spikes("5E.bin"),
+              load_spikes("4I.bin"),
+              load_spikes("4E.bin"),
+              load_spikes("23I.bin"),
+              load_spikes("23E.bin")]
 
 # Find the maximum spike time and convert to seconds
 duration_s = max(np.amax(t) for t, _, _, _ in pop_spikes) / 1000.0
@@ -0,0 +1,4 @@
+#!/bin/bash
+# Run microcircuit partitioned across $1 local processes (default 2) - build with build_partitioned.sh first
+NUM_RANKS=${1:-2}
+mpirun -np $NUM_RANKS ./potjans_microcircuit_partitioned
@@ -4,19 +4,25 @@
 #include <random>
 #include <vector>
 
+// POSIX includes
+#include <dlfcn.h>
+
 // GeNN user projects includes
 #include "timer.h"
-#include "spikeRecorder.h"
 
-// Model parameters
+// GeNN examples includes
+#include "../common/spike_recording_drain.h"
+
+// Model includes
+#include "connectivity.h"
 #include "parameters.h"
 
 // Auto-generated model code
 #include "potjans_microcircuit_CODE/definitions.h"
 
-// Macro to record a population's output
+// Macro to add a population's output to recording drain
 #define RECORD_SPIKES(LAYER, POPULATION) \
-    writeTextSpikeRecording(#LAYER#POPULATION".csv", recordSpk##LAYER##POPULATION, Parameters::getScaledNumNeurons(Parameters::Layer##LAYER, Parameters::Population##POPULATION), timesteps, Parameters::dtMs, ",", true);
+    spikeDrain.addPopulation(#LAYER#POPULATION".bin", recordSpk##LAYER##POPULATION, Parameters::getScaledNumNeurons(Parameters::Layer##LAYER, Parameters::Population##POPULATION));
 
 int main()
 {
@@ -25,13 +31,33 @@ int main()
         const unsigned int timesteps = (unsigned int)round(Parameters::durationMs / Parameters::dtMs);
         
         allocateMem();
-        allocateRecordingBuffers(timesteps);
+        allocateRecordingBuffers(Parameters::recordingWindowTimesteps);
+
+        // If connectivity is cached, copy it from cache (or generate it) into host arrays to be pushed by initializeSparse
+        // **NOTE** arrays are found by name, in the runner library loaded alongside this executable
+        if(Parameters::cacheConnectivity) {
+            Connectivity::init([](const std::string &name){ return dlsym(RTLD_DEFAULT, name.c_str()); });
+        }
         initialize();
         initializeSparse();
 
-        double recordS = 0.0;
+        // Create background writer for spike recordings
+        BinarySpikeWriter spikeWriter;
 
+        double drainWaitS = 0.0;
         {
+            // Create drain to write each window of spikes while the next is simulated
+            SpikeRecordingDrain spikeDrain(spikeWriter, Parameters::recordingWindowTimesteps, Parameters::dtMs,
+                                           pullRecordingBuffersFromDevice);
+            RECORD_SPIKES(23, E);
+            RECORD_SPIKES(23, I);
+            RECORD_SPIKES(4, E);
+            RECORD_SPIKES(4, I);
+            RECORD_SPIKES(5, E);
+            RECORD_SPIKES(5, I);
+            RECORD_SPIKES(6, E);
+            RECORD_SPIKES(6, I);
+
             Timer timer("Simulation:");
             // Loop through timesteps
             
@@ -45,21 +71,20 @@ int main()
 
                 // Simulate
                 stepTime();
+
+                // Drain recording buffers if window is full
+                spikeDrain.update(iT);
             }
+
+            // Drain any remaining partial window
+            spikeDrain.finish(iT);
+            drainWaitS = spikeDrain.getWaitTime();
         }
 
-        // Write spike recorder cache to disk
+        // Wait for remaining spikes to be written to disk
         {
             Timer timer("Recording spikes:");
-            pullRecordingBuffersFromDevice();
-            RECORD_SPIKES(23, E);
-            RECORD_SPIKES(23, I);
-            RECORD_SPIKES(4, E);
-            RECORD_SPIKES(4, I);
-            RECORD_SPIKES(5, E);
-            RECORD_SPIKES(5, I);
-            RECORD_SPIKES(6, E);
-            RECORD_SPIKES(6, I);
+            spikeWriter.flush();
         }
 
         if(Parameters::measureTiming) {
@@ -69,7 +94,7 @@ int main()
             std::cout << "\tNeuron simulation:" << neuronUpdateTime * 1000.0 << std::endl;
             std::cout << "\tSynapse simulation:" << presynapticUpdateTime * 1000.0 << std::endl;
         }
-        std::cout << "Record:" << recordS << "ms" << std::endl;
+        std::cout << "Waiting for recording drain:" << drainWaitS * 1000.0 << "ms" << std::endl;
     }
     catch(const std::exception &ex)
     {
@@ -1,9 +1,12 @@
 // Standard C++ includes
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <fstream>
+#include <iostream>
 #include <memory>
-#include <mutex>
-#include <random>
+#include <numeric>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -15,22 +18,33 @@
 #include "sharedLibraryModel.h"
 #include "spikeRecorder.h"
 
+// GeNN examples includes
+#include "../common/parallel_connectors.h"
+#include "../common/spsc_ring.h"
+
 // Model parameters
+#include "connectivity.h"
 #include "parameters.h"
-#include "utils.h"
 
 //----------------------------------------------------------------------------
 // LiveVisualiser
 //----------------------------------------------------------------------------
+//! Renders the spikes of every population as a decaying raster. The simulation thread only
+//! snapshots spike indices into a lock-free ring per render worker. Each worker owns a subset
+//! of populations whose spike images it rasterises and, when the display thread requests a
+//! frame, decays and composites into one of two output buffers. The display thread shows
+//! one buffer while the workers composite the next frame into the other
 class LiveVisualiser
 {
 public:
-    LiveVisualiser(SharedLibraryModel<float> &model, const cv::Size outputRes, double scale)
-    :   m_Model(model), m_OutputImage(outputRes, CV_8UC3), m_RotatedOutput(outputRes.width, outputRes.height, CV_8UC3)/*, t
+    LiveVisualiser(SharedLibraryModel<float> &model, const cv::Size outputRes, double scale, unsigned int numWorkers)
+    :   m_Model(model), m_OutputImages{cv::Mat(outputRes, CV_8UC3, CV_RGB(0, 0, 0)), cv::Mat(outputRes, CV_8UC3, CV_RGB(0, 0, 0))},
+        m_RotatedOutput(outputRes.width, outputRes.height, CV_8UC3), m_LastSimTimestep(0), m_SimTimestep(0),
+        m_RequestedFrame(0), m_NumWorkersComposited(0), m_ShouldQuit(false), m_SnapshotTime(0.0), m_NumDisplayFrames(0),
+        m_CompositeWaitTime(0.0), m_DisplayTime(0.0)/*,
         m_VideoWriter("test.avi", cv::VideoWriter::fourcc('H', '2', '6', '4'), 33.0, outputRes, true)*/
     {
         const int leftBorder = 50;
-        const int bottomBorder = 20;
         const int verticalSpacing = 5;
         const int verticalSpacingLayer = 5;
         const int neuronWidth = (int)std::round((double)(outputRes.width - leftBorder) / scale);
@@ -66,13 +80,16 @@ public:
                 cv::Rect roi(leftBorder, populationY, (int)std::round((double)neuronWidth * scale), 
                              (int)std::round((double)neuronHeight * scale));
 
+                // Label population in both output buffers
                 const auto textSize = cv::getTextSize(name.c_str(), cv::FONT_HERSHEY_COMPLEX_SMALL, 1.0, 1, nullptr);
-                cv::putText(m_OutputImage, name.c_str(), cv::Point(0, populationY + (roi.height / 2) + (textSize.height / 2)),
-                            cv::FONT_HERSHEY_COMPLEX_SMALL, 1.0, CV_RGB(255, 255, 255));
+                for(auto &outputImage : m_OutputImages) {
+                    cv::putText(outputImage, name.c_str(), cv::Point(0, populationY + (roi.height / 2) + (textSize.height / 2)),
+                                cv::FONT_HERSHEY_COMPLEX_SMALL, 1.0, CV_RGB(255, 255, 255));
+                }
 
                 // Add suitable sized subimage, spike count and spikes to populations
-                m_Populations.emplace_back(cv::Mat(neuronHeight, neuronWidth, CV_8UC3),
-                                           roi, colours[m_Populations.size()], spikeCount, spikes);
+                m_Populations.push_back(Population{cv::Mat(neuronHeight, neuronWidth, CV_8UC3, CV_RGB(0, 0, 0)), roi,
+                                                   colours[m_Populations.size()], spikeCount, spikes, (unsigned int)numNeurons});
 
                 // Update y position for next population
                 populationY += roi.height + verticalSpacing;
@@ -81,38 +98,103 @@ public:
             // Add addition inter-layer spacing
             populationY += verticalSpacingLayer;
         }
+
+        // Distribute populations between workers, largest first, to balance the number of neurons each rasterises
+        m_Workers.resize(std::max(1u, std::min(numWorkers, (unsigned int)m_Populations.size())));
+        std::vector<size_t> populationOrder(m_Populations.size());
+        std::iota(populationOrder.begin(), populationOrder.end(), 0);
+        std::sort(populationOrder.begin(), populationOrder.end(),
+                  [this](size_t a, size_t b){ return m_Populations[a].numNeurons > m_Populations[b].numNeurons; });
+        std::vector<size_t> workerNumNeurons(m_Workers.size(), 0);
+        for(size_t p : populationOrder) {
+            const size_t w = std::distance(workerNumNeurons.cbegin(), std::min_element(workerNumNeurons.cbegin(), workerNumNeurons.cend()));
+            m_Workers[w].populations.push_back(p);
+            workerNumNeurons[w] += m_Populations[p].numNeurons;
+        }
+
+        // Create rings with slots large enough for every neuron in worker's populations to spike and start workers
+        for(size_t w = 0; w < m_Workers.size(); w++) {
+            SpikeFrame initialFrame;
+            initialFrame.spikeCounts.resize(m_Workers[w].populations.size());
+            initialFrame.spikes.resize(workerNumNeurons[w]);
+            m_Workers[w].ring.reset(new SPSCRing<SpikeFrame>(ringCapacity, initialFrame));
+            m_Workers[w].thread = std::thread(&LiveVisualiser::workerThread, this, std::ref(m_Workers[w]));
+        }
+
+        // Request first frame
+        m_LastRealTime = std::chrono::high_resolution_clock::now();
+        m_RequestedFrame.store(1, std::memory_order_release);
+    }
+
+    ~LiveVisualiser()
+    {
+        stop();
     }
 
     //------------------------------------------------------------------------
     // Public API
     //------------------------------------------------------------------------
-    void applySpikes()
+    //! Copy current spikes of each population into worker rings - called from simulation thread
+    void snapshotSpikes()
     {
-        // Loop through populations
-        for(auto &pop : m_Populations) {
-            // Loop through spikes
-            cv::Vec3b *spikeImageRaw = reinterpret_cast<cv::Vec3b*>(std::get<0>(pop).data);
-            for(unsigned int i = 0; i < std::get<3>(pop)[0]; i++) {
-                auto &pixel = spikeImageRaw[std::get<4>(pop)[i]];
-                pixel = std::get<2>(pop);
+        TimerAccumulate timer(m_SnapshotTime);
+
+        const auto now = std::chrono::high_resolution_clock::now();
+        for(auto &w : m_Workers) {
+            // If worker has fallen behind, drop this timestep rather than stalling simulation
+            SpikeFrame *frame = w.ring->beginWrite();
+            if(frame == nullptr) {
+                w.numDroppedFrames++;
+                continue;
             }
+
+            // Concatenate spikes from each of worker's populations
+            frame->time = now;
+            size_t offset = 0;
+            for(size_t i = 0; i < w.populations.size(); i++) {
+                const auto &pop = m_Populations[w.populations[i]];
+                const unsigned int spikeCount = pop.spikeCount[0];
+                frame->spikeCounts[i] = spikeCount;
+                std::copy_n(pop.spikes, spikeCount, &frame->spikes[offset]);
+                offset += spikeCount;
+            }
+            w.ring->endWrite();
         }
+
+        m_SimTimestep.store(m_Model.getTimestep(), std::memory_order_relaxed);
     }
 
+    //! Display latest composited frame and request next one - called from display thread
     void render(const char *windowName, bool rotate=false)
     {
-        unsigned long long simTimestep = m_Model.getTimestep();
+        // Wait for workers to finish compositing requested frame
+        const unsigned int frame = m_RequestedFrame.load(std::memory_order_relaxed);
+        {
+            TimerAccumulate timer(m_CompositeWaitTime);
+            while(m_NumWorkersComposited.load(std::memory_order_acquire) != m_Workers.size()) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Immediately request next frame so it gets composited into the other buffer while this one is displayed
+        m_NumWorkersComposited.store(0, std::memory_order_relaxed);
+        m_RequestedFrame.store(frame + 1, std::memory_order_release);
+
+        TimerAccumulate timer(m_DisplayTime);
+        cv::Mat &outputImage = m_OutputImages[frame % 2];
+
+        unsigned long long simTimestep = m_SimTimestep.load(std::memory_order_relaxed);
         auto realTime = std::chrono::high_resolution_clock::now();
 
         std::chrono::duration<double, std::milli> realMs = realTime - m_LastRealTime;
-        const double simMs = (double)(simTimestep - m_LastSimTimestep) * 0.1;
+        const double simMs = (double)(simTimestep - m_LastSimTimestep) * Parameters::dtMs;
 
         m_LastRealTime = realTime;
         m_LastSimTimestep = simTimestep;
 
         // Clear background behind text
-        cv::rectangle(m_OutputImage, cv::Point(0, m_OutputImage.rows - 20),
-                      cv::Point(m_OutputImage.cols, m_OutputImage.rows),
+        cv::rectangle(outputImage, cv::Point(0, outputImage.rows - 20),
+                      cv::Point(outputImage.cols, outputImage.rows),
                       CV_RGB(0, 0, 0), cv::FILLED);
         
         // Render status text
@@ -127,75 +209,223 @@ public:
         sprintf(status, "Speed:%.2fx realtime", simMs / realMs.count());
 #endif  // JETSON_POWER
         
-        cv::putText(m_OutputImage, status, cv::Point(0, m_OutputImage.rows - 5),
+        cv::putText(outputImage, status, cv::Point(0, outputImage.rows - 5),
                     cv::FONT_HERSHEY_COMPLEX_SMALL, 1.0, CV_RGB(255, 255, 255));
 
-        // Decay each populations spike image
-        for(auto &pop : m_Populations) {
-            cv::Mat &spikeImage = std::get<0>(pop);
-            cv::Vec3b *spikeImageRaw = reinterpret_cast<cv::Vec3b*>(std::get<0>(pop).data);
-
-            // Use fixed point maths to decay each pixel
-            std::transform(&spikeImageRaw[0], &spikeImageRaw[spikeImage.rows * spikeImage.cols], &spikeImageRaw[0],
-                           [](const cv::Vec3b &pixel)
-                           {
-                               const uint16_t r = ((uint16_t)pixel[0] * 252) >> 8;
-                               const uint16_t g = ((uint16_t)pixel[1] * 252) >> 8;
-                               const uint16_t b = ((uint16_t)pixel[2] * 252) >> 8;
-
-                               return cv::Vec3b(r, g, b);
-                           });
-
-            // Scale up spike image into output image ROI
-            auto roi = cv::Mat(m_OutputImage, std::get<1>(pop));
-            cv::resize(spikeImage, roi, roi.size(), 0.0, 0.0, cv::INTER_NEAREST);
-
-        }
-        
-        
         if(rotate) {
-            cv::transpose(m_OutputImage, m_RotatedOutput);
+            cv::transpose(outputImage, m_RotatedOutput);
             cv::flip(m_RotatedOutput, m_RotatedOutput, 0);
             cv::imshow(windowName, m_RotatedOutput);
         }
         // Otherwise, Render output image directly to window`
         else {
-            cv::imshow(windowName, m_OutputImage);
+            cv::imshow(windowName, outputImage);
         }
+        m_NumDisplayFrames++;
         
         // Write frame
-        //m_VideoWriter.write(m_OutputImage);
+        //m_VideoWriter.write(outputImage);
+
+    }
 
+    //! Stop render workers
+    void stop()
+    {
+        // Set should quit flag and wait on workers to finish
+        m_ShouldQuit = true;
+        for(auto &w : m_Workers) {
+            if(w.thread.joinable()) {
+                w.thread.join();
+            }
+        }
+    }
+
+    //! Print per-stage latencies - call once visualiser has been stopped
+    void printStats() const
+    {
+        const unsigned long long numTimesteps = m_SimTimestep.load();
+        std::cout << "Snapshot:" << (m_SnapshotTime * 1000.0) / (double)std::max(1ull, numTimesteps) << "ms per timestep" << std::endl;
+        for(size_t w = 0; w < m_Workers.size(); w++) {
+            const auto &worker = m_Workers[w];
+            std::cout << "Worker " << w << " (" << worker.populations.size() << " populations):" << std::endl;
+            std::cout << "\tRasterise latency:" << worker.rasteriseLatency / (double)std::max(1ull, worker.numRasterisedFrames) 
+                      << "ms mean, " << worker.maxRasteriseLatency << "ms max" << std::endl;
+            std::cout << "\tComposite:" << (worker.compositeTime * 1000.0) / (double)std::max(1ull, worker.numCompositedFrames) << "ms per frame" << std::endl;
+            std::cout << "\tDropped timesteps:" << worker.numDroppedFrames << std::endl;
+        }
+        std::cout << "Composite wait:" << (m_CompositeWaitTime * 1000.0) / (double)std::max(1ull, m_NumDisplayFrames) << "ms per frame" << std::endl;
+        std::cout << "Display:" << (m_DisplayTime * 1000.0) / (double)std::max(1ull, m_NumDisplayFrames) << "ms per frame" << std::endl;
     }
 
 private:
+    //------------------------------------------------------------------------
+    // Population
+    //------------------------------------------------------------------------
+    struct Population
+    {
+        cv::Mat spikeImage;
+        cv::Rect roi;
+        cv::Vec3b colour;
+        unsigned int *spikeCount;
+        unsigned int *spikes;
+        unsigned int numNeurons;
+    };
+
+    //------------------------------------------------------------------------
+    // SpikeFrame
+    //------------------------------------------------------------------------
+    //! Spikes emitted by a worker's populations in one timestep
+    struct SpikeFrame
+    {
+        std::chrono::time_point<std::chrono::high_resolution_clock> time;
+        std::vector<unsigned int> spikeCounts;
+        std::vector<unsigned int> spikes;
+    };
+
+    //------------------------------------------------------------------------
+    // Worker
+    //------------------------------------------------------------------------
+    struct Worker
+    {
+        Worker() : numDroppedFrames(0), rasteriseLatency(0.0), maxRasteriseLatency(0.0), numRasterisedFrames(0),
+            compositeTime(0.0), numCompositedFrames(0)
+        {
+        }
+
+        std::vector<size_t> populations;
+        std::unique_ptr<SPSCRing<SpikeFrame>> ring;
+        std::thread thread;
+
+        // Written by simulation thread
+        unsigned long long numDroppedFrames;
+
+        // Written by worker thread
+        double rasteriseLatency;
+        double maxRasteriseLatency;
+        unsigned long long numRasterisedFrames;
+        double compositeTime;
+        unsigned long long numCompositedFrames;
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    void workerThread(Worker &worker)
+    {
+        unsigned int compositedFrame = 0;
+        while(!m_ShouldQuit) {
+            bool idle = true;
+
+            // Rasterise spikes from available timesteps
+            // **NOTE** limited to one ring's worth so composite requests are serviced promptly
+            for(size_t i = 0; i < worker.ring->capacity(); i++) {
+                const SpikeFrame *frame = worker.ring->beginRead();
+                if(frame == nullptr) {
+                    break;
+                }
+
+                const unsigned int *spike = frame->spikes.data();
+                for(size_t p = 0; p < worker.populations.size(); p++) {
+                    auto &pop = m_Populations[worker.populations[p]];
+                    cv::Vec3b *spikeImageRaw = reinterpret_cast<cv::Vec3b*>(pop.spikeImage.data);
+                    for(unsigned int s = 0; s < frame->spikeCounts[p]; s++) {
+                        spikeImageRaw[*spike++] = pop.colour;
+                    }
+                }
+
+                // Update latency from snapshot to rasterisation
+                const std::chrono::duration<double, std::milli> latency = std::chrono::high_resolution_clock::now() - frame->time;
+                worker.rasteriseLatency += latency.count();
+                worker.maxRasteriseLatency = std::max(worker.maxRasteriseLatency, latency.count());
+                worker.numRasterisedFrames++;
+
+                worker.ring->endRead();
+                idle = false;
+            }
+
+            // If a new frame has been requested
+            const unsigned int requestedFrame = m_RequestedFrame.load(std::memory_order_acquire);
+            if(requestedFrame != compositedFrame) {
+                TimerAccumulate timer(worker.compositeTime);
+                cv::Mat &outputImage = m_OutputImages[requestedFrame % 2];
+                for(size_t p : worker.populations) {
+                    auto &pop = m_Populations[p];
+                    cv::Vec3b *spikeImageRaw = reinterpret_cast<cv::Vec3b*>(pop.spikeImage.data);
+
+                    // Use fixed point maths to decay each pixel
+                    std::transform(&spikeImageRaw[0], &spikeImageRaw[pop.spikeImage.rows * pop.spikeImage.cols], &spikeImageRaw[0],
+                                   [](const cv::Vec3b &pixel)
+                                   {
+                                       const uint16_t r = ((uint16_t)pixel[0] * 252) >> 8;
+                                       const uint16_t g = ((uint16_t)pixel[1] * 252) >> 8;
+                                       const uint16_t b = ((uint16_t)pixel[2] * 252) >> 8;
+
+                                       return cv::Vec3b(r, g, b);
+                                   });
+
+                    // Scale up spike image into output image ROI
+                    // **NOTE** ROIs don't overlap so workers can write to the same output image in parallel
+                    auto roi = cv::Mat(outputImage, pop.roi);
+                    cv::resize(pop.spikeImage, roi, roi.size(), 0.0, 0.0, cv::INTER_NEAREST);
+                }
+
+                worker.numCompositedFrames++;
+                compositedFrame = requestedFrame;
+                m_NumWorkersComposited.fetch_add(1, std::memory_order_release);
+                idle = false;
+            }
+
+            // If there was nothing to do, sleep rather than spinning on a core the simulation could use
+            if(idle) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Static constants
+    //------------------------------------------------------------------------
+    //! Number of timesteps of spikes that can be waiting to be rasterised by each worker
+    //! **NOTE** each slot has room for all of a worker's neurons to spike so this is kept fairly small
+    static constexpr size_t ringCapacity = 64;
+
     //------------------------------------------------------------------------
     // Members
     //------------------------------------------------------------------------
     SharedLibraryModel<float> &m_Model;
-    cv::Mat m_OutputImage;
+    cv::Mat m_OutputImages[2];
     cv::Mat m_RotatedOutput;
     //cv::VideoWriter m_VideoWriter;
     
     // Times used for tracking real vs simulated time
     std::chrono::time_point<std::chrono::high_resolution_clock> m_LastRealTime;
     unsigned long long m_LastSimTimestep;
-
-    // Array of population spike variables to render
-    std::vector<std::tuple<cv::Mat, cv::Rect, cv::Vec3b, unsigned int*, unsigned int*>> m_Populations;
+    std::atomic<unsigned long long> m_SimTimestep;
+
+    // Populations to render and workers which render them
+    std::vector<Population> m_Populations;
+    std::vector<Worker> m_Workers;
+
+    // Frame requested by display thread and number of workers which have composited it
+    std::atomic<unsigned int> m_RequestedFrame;
+    std::atomic<unsigned int> m_NumWorkersComposited;
+    std::atomic<bool> m_ShouldQuit;
+
+    // Stage timing
+    double m_SnapshotTime;
+    unsigned long long m_NumDisplayFrames;
+    double m_CompositeWaitTime;
+    double m_DisplayTime;
 };
 
-void displayThreadHandler(LiveVisualiser &visualiser, std::mutex &mutex, std::atomic<bool> &run)
+void displayThreadHandler(LiveVisualiser &visualiser, std::atomic<bool> &run)
 {
     cv::namedWindow("Output", cv::WINDOW_NORMAL);
     cv::resizeWindow("Output", 480, 800);
 
     bool rotated = false;
     while(true) {
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            visualiser.render("Output", rotated);
-        }
+        visualiser.render("Output", rotated);
 
         const auto key = cv::waitKey(33);
         if(key == 'f') {
@@ -227,14 +457,20 @@ int main()
 
     model.allocateMem();
 
-    {
+    // If connectivity is cached, copy it from cache (or generate it) into host arrays to be pushed by initializeSparse
+    if(Parameters::cacheConnectivity) {
+        Connectivity::init([&model](const std::string &name){ return model.getSymbol(name, true); });
+    }
+    // Otherwise, build row lengths for FixedNumberTotalWithReplacement connectivity initialisation on device
+    else {
         Timer timer("Building row lengths:");
 
-        std::mt19937 rng;
+        // Allocate row lengths for each synapse group which exists
+        std::vector<std::string> synapsePopNames;
+        std::vector<ParallelConnectors::RowLengthProjection> projections;
         for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
             for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
                 const std::string trgName = Parameters::getPopulationName(trgLayer, trgPop);
-                const unsigned int numTrg = Parameters::getScaledNumNeurons(trgLayer, trgPop);
 
                 // Loop through source populations and layers
                 for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
@@ -246,34 +482,42 @@ int main()
                         const std::string synapsePopName = srcName + "_" + trgName;
                         void *rowLengths = model.getSymbol("preCalcRowLength" + synapsePopName, true);
                         if(rowLengths) {
-                            // Allocate row lengths
                             model.allocateExtraGlobalParam(synapsePopName, "preCalcRowLength", numSrc);
 
-                            // Build row lengths on host
-                            buildRowLengths(numSrc, numTrg, Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop),
-                                            *(static_cast<unsigned int**>(rowLengths)), rng);
-
-                            // Push to device
-                            model.pushExtraGlobalParam(synapsePopName, "preCalcRowLength", numSrc);
+                            synapsePopNames.push_back(synapsePopName);
+                            projections.push_back(ParallelConnectors::RowLengthProjection{
+                                numSrc, Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop),
+                                *(static_cast<unsigned int**>(rowLengths)), Connectivity::getStream(synapsePopName)});
                         }
                     }
                 }
             }
         }
+
+        // Build row lengths for all synapse groups in parallel on host
+        ParallelConnectors::buildRowLengths(projections, Parameters::connectivitySeed);
+
+        // Push to device
+        for(size_t p = 0; p < projections.size(); p++) {
+            model.pushExtraGlobalParam(synapsePopNames[p], "preCalcRowLength", projections[p].numPre);
+        }
     }
 
     model.initialize();
     model.initializeSparse();
 
+    // Use all cores not required by simulation and display threads for rendering
+    const unsigned int numCores = std::thread::hardware_concurrency();
+    const unsigned int numRenderWorkers = (numCores > 3) ? (numCores - 2) : 1;
+
     std::atomic<bool> run{true};
-    std::mutex mutex;
-    LiveVisualiser visualiser(model, cv::Size(480, 800), 2.75);
-    std::thread displayThread(displayThreadHandler, std::ref(visualiser), std::ref(mutex), std::ref(run));
+    LiveVisualiser visualiser(model, cv::Size(480, 800), 2.75, numRenderWorkers);
+    std::thread displayThread(displayThreadHandler, std::ref(visualiser), std::ref(run));
 
-    
-    double applyS = 0.0;
+    double simulationS = 0.0;
     {
-        Timer timer("Simulation:");
+        TimerAccumulate timer(simulationS);
+
         // Loop through timesteps
         while(run)
         {
@@ -287,18 +531,17 @@ int main()
                 }
             }
 
-            {
-                TimerAccumulate timer(applyS);
-
-                {
-                    std::lock_guard<std::mutex> lock(mutex);
-                    visualiser.applySpikes();
-                }
-            }
+            // Hand spikes to render workers
+            visualiser.snapshotSpikes();
         }
     }
 
-    std::cout << "Apply:" << applyS << "s" << std::endl;
+    displayThread.join();
+    visualiser.stop();
+
+    const double simulatedS = (double)model.getTimestep() * Parameters::dtMs / 1000.0;
+    std::cout << "Simulation:" << simulationS << "s (" << simulatedS / simulationS << "x realtime)" << std::endl;
+    visualiser.printStats();
 
     return 0;
 }
@@ -0,0 +1,233 @@
+// Standard C++ includes
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+
+// MPI includes
+#include <mpi.h>
+
+// GeNN user project includes
+#include "sharedLibraryModel.h"
+#include "timer.h"
+
+// GeNN examples includes
+#include "../common/binary_spike_recorder.h"
+
+// Model includes
+#include "connectivity.h"
+#include "parameters.h"
+#include "partition.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+//! Spikes of one population which are exchanged between ranks
+struct ExchangedPopulation
+{
+    std::string name;
+    unsigned int *spikeCount;
+    unsigned int *spikes;
+};
+
+//! Populations exchanged with another rank, in the same order on both ranks, and buffer of their spikes
+//! Buffers contain, for each population, the number of spikes followed by their IDs
+struct Peer
+{
+    int rank;
+    std::vector<ExchangedPopulation> populations;
+    std::vector<unsigned int> buffer;
+};
+}   // Anonymous namespace
+
+// Simulates one rank of the microcircuit partitioned by Partition::partition and built by build_partitioned.sh.
+// Every timestep, spikes emitted by local populations are sent to the ranks which have targets of them and
+// spikes received from other ranks are pushed into the spike source populations which mirror their sources.
+// Mirrored spikes are pushed after each timestep so are delivered at the same time as they would be locally.
+int main(int argc, char *argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    int exitCode = EXIT_SUCCESS;
+    try
+    {
+        int rank;
+        int numRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+        // Partition model - this is deterministic so matches the assignment the rank's model was built with
+        const Partition::Assignment assignment = Partition::partition(numRanks);
+        const std::string rankSuffix = "rank_" + std::to_string(rank) + "_of_" + std::to_string(numRanks);
+
+        SharedLibraryModel<float> model(rankSuffix + "/", "potjans_microcircuit");
+        model.allocateMem();
+
+        // If connectivity is cached, copy it from cache (or generate it) into host arrays to be pushed by initializeSparse
+        // **NOTE** each rank only contains the projections targetting its populations so has its own cache
+        if(Parameters::cacheConnectivity) {
+            Connectivity::init([&model](const std::string &name){ return model.getSymbol(name, true); },
+                               Parameters::connectivityCachePrefix + rankSuffix + "_");
+        }
+        model.initialize();
+        model.initializeSparse();
+
+        // Loop through populations
+        BinarySpikeWriter spikeWriter;
+        std::vector<std::unique_ptr<BinarySpikeRecorder>> spikeRecorders;
+        std::vector<ExchangedPopulation> localPopulations;
+        std::vector<Peer> sendPeers;
+        std::vector<Peer> receivePeers;
+        for(int r = 0; r < numRanks; r++) {
+            if(r != rank) {
+                sendPeers.push_back(Peer{r, {}, {}});
+                receivePeers.push_back(Peer{r, {}, {}});
+            }
+        }
+        for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
+            for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
+                const std::string name = Parameters::getPopulationName(layer, pop);
+                const bool local = assignment.isLocal(layer, pop, rank);
+                if(!local && !assignment.isMirrored(layer, pop, rank)) {
+                    continue;
+                }
+
+                const ExchangedPopulation exchangedPop{name, model.getArray<unsigned int>("glbSpkCnt" + name),
+                                                       model.getArray<unsigned int>("glbSpk" + name)};
+
+                // If population is local, record it and send its spikes to all ranks which mirror it
+                if(local) {
+                    localPopulations.push_back(exchangedPop);
+                    spikeRecorders.emplace_back(
+                        new BinarySpikeRecorder(spikeWriter, name + ".bin", Parameters::getScaledNumNeurons(layer, pop),
+                                                Parameters::dtMs, BinarySpikes::Format::Pairs));
+
+                    for(auto &p : sendPeers) {
+                        if(assignment.isMirrored(layer, pop, p.rank)) {
+                            p.populations.push_back(exchangedPop);
+                        }
+                    }
+                }
+                // Otherwise, receive its spikes from rank it's simulated on
+                else {
+                    for(auto &p : receivePeers) {
+                        if(p.rank == (int)assignment.getRank(layer, pop)) {
+                            p.populations.push_back(exchangedPop);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Remove peers we don't exchange any spikes with
+        auto noPopulations = [](const Peer &p){ return p.populations.empty(); };
+        sendPeers.erase(std::remove_if(sendPeers.begin(), sendPeers.end(), noPopulations), sendPeers.end());
+        receivePeers.erase(std::remove_if(receivePeers.begin(), receivePeers.end(), noPopulations), receivePeers.end());
+        std::vector<MPI_Request> sendRequests(sendPeers.size());
+
+        double simulationS = 0.0;
+        double exchangeS = 0.0;
+        double recordS = 0.0;
+        unsigned long long numSpikesSent = 0;
+        {
+            Timer timer("Simulation:");
+
+            // Loop through timesteps
+            const unsigned int timesteps = round(Parameters::durationMs / Parameters::dtMs);
+            const unsigned int tenPercentTimestep = timesteps / 10;
+            for(unsigned int i = 0; i < timesteps; i++) {
+                // Indicate every 10%
+                if(rank == 0 && (i % tenPercentTimestep) == 0) {
+                    std::cout << i / 100 << "%" << std::endl;
+                }
+
+                // Simulate and pull spikes from local populations
+                {
+                    TimerAccumulate timer(simulationS);
+                    model.stepTime();
+
+                    for(const auto &p : localPopulations) {
+                        model.pullCurrentSpikesFromDevice(p.name);
+                    }
+                }
+
+                {
+                    TimerAccumulate timer(exchangeS);
+
+                    // Pack spikes for each peer and start sending
+                    for(size_t s = 0; s < sendPeers.size(); s++) {
+                        auto &peer = sendPeers[s];
+                        peer.buffer.clear();
+                        for(const auto &p : peer.populations) {
+                            peer.buffer.push_back(p.spikeCount[0]);
+                            peer.buffer.insert(peer.buffer.end(), p.spikes, p.spikes + p.spikeCount[0]);
+                            numSpikesSent += p.spikeCount[0];
+                        }
+                        MPI_Isend(peer.buffer.data(), (int)peer.buffer.size(), MPI_UNSIGNED, peer.rank, 0,
+                                  MPI_COMM_WORLD, &sendRequests[s]);
+                    }
+
+                    // Receive spikes from each peer, copy them into mirror populations and push
+                    // **NOTE** messages between a pair of ranks can't overtake each other so can all use the same tag
+                    for(auto &peer : receivePeers) {
+                        MPI_Status status;
+                        int count;
+                        MPI_Probe(peer.rank, 0, MPI_COMM_WORLD, &status);
+                        MPI_Get_count(&status, MPI_UNSIGNED, &count);
+                        peer.buffer.resize(count);
+                        MPI_Recv(peer.buffer.data(), count, MPI_UNSIGNED, peer.rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+                        size_t offset = 0;
+                        for(const auto &p : peer.populations) {
+                            const unsigned int spikeCount = peer.buffer.at(offset++);
+                            if((offset + spikeCount) > peer.buffer.size()) {
+                                throw std::runtime_error("Truncated spikes received from rank " + std::to_string(peer.rank));
+                            }
+                            p.spikeCount[0] = spikeCount;
+                            std::copy_n(&peer.buffer[offset], spikeCount, p.spikes);
+                            offset += spikeCount;
+
+                            model.pushCurrentSpikesToDevice(p.name);
+                        }
+                    }
+
+                    // Wait for sends to complete so buffers can be reused
+                    MPI_Waitall((int)sendRequests.size(), sendRequests.data(), MPI_STATUSES_IGNORE);
+                }
+
+                // Record spikes from local populations
+                {
+                    TimerAccumulate timer(recordS);
+                    for(size_t p = 0; p < localPopulations.size(); p++) {
+                        spikeRecorders[p]->record(model.getTimestep(), localPopulations[p].spikeCount[0],
+                                                  localPopulations[p].spikes);
+                    }
+                }
+            }
+        }
+
+        std::cout << "Rank " << rank << ":" << std::endl;
+        std::cout << "\tSimulation:" << simulationS << "s" << std::endl;
+        std::cout << "\tSpike exchange:" << exchangeS << "s (" << numSpikesSent << " spikes sent)" << std::endl;
+        std::cout << "\tRecord:" << recordS << "s" << std::endl;
+
+        // Close recordings and wait for them to be written
+        spikeRecorders.clear();
+        spikeWriter.flush();
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        exitCode = EXIT_FAILURE;
+        MPI_Abort(MPI_COMM_WORLD, exitCode);
+    }
+
+    MPI_Finalize();
+    return exitCode;
+}
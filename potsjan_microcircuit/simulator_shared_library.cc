@@ -1,16 +1,19 @@
 // Standard C++ includes
 #include <memory>
-#include <random>
+#include <string>
 #include <vector>
 
 // GeNN user project includes
 #include "sharedLibraryModel.h"
-#include "spikeRecorder.h"
 #include "timer.h"
 
-// Model parameters
+// GeNN examples includes
+#include "../common/binary_spike_recorder.h"
+#include "../common/parallel_connectors.h"
+
+// Model includes
+#include "connectivity.h"
 #include "parameters.h"
-#include "utils.h"
 
 int main()
 {
@@ -18,14 +21,20 @@ int main()
 
     model.allocateMem();
 
-    {
+    // If connectivity is cached, copy it from cache (or generate it) into host arrays to be pushed by initializeSparse
+    if(Parameters::cacheConnectivity) {
+        Connectivity::init([&model](const std::string &name){ return model.getSymbol(name, true); });
+    }
+    // Otherwise, build row lengths for FixedNumberTotalWithReplacement connectivity initialisation on device
+    else {
         Timer timer("Building row lengths:");
 
-        std::mt19937 rng;
+        // Allocate row lengths for each synapse group which exists
+        std::vector<std::string> synapsePopNames;
+        std::vector<ParallelConnectors::RowLengthProjection> projections;
         for(unsigned int trgLayer = 0; trgLayer < Parameters::LayerMax; trgLayer++) {
             for(unsigned int trgPop = 0; trgPop < Parameters::PopulationMax; trgPop++) {
                 const std::string trgName = Parameters::getPopulationName(trgLayer, trgPop);
-                const unsigned int numTrg = Parameters::getScaledNumNeurons(trgLayer, trgPop);
 
                 // Loop through source populations and layers
                 for(unsigned int srcLayer = 0; srcLayer < Parameters::LayerMax; srcLayer++) {
@@ -37,27 +46,34 @@ int main()
                         const std::string synapsePopName = srcName + "_" + trgName;
                         void *rowLengths = model.getSymbol("preCalcRowLength" + synapsePopName, true);
                         if(rowLengths) {
-                            // Allocate row lengths
                             model.allocateExtraGlobalParam(synapsePopName, "preCalcRowLength", numSrc);
 
-                            // Build row lengths on host
-                            buildRowLengths(numSrc, numTrg, Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop),
-                                            *(static_cast<unsigned int**>(rowLengths)), rng);
-
-                            // Push to device
-                            model.pushExtraGlobalParam(synapsePopName, "preCalcRowLength", numSrc);
+                            synapsePopNames.push_back(synapsePopName);
+                            projections.push_back(ParallelConnectors::RowLengthProjection{
+                                numSrc, Parameters::getScaledNumConnections(srcLayer, srcPop, trgLayer, trgPop),
+                                *(static_cast<unsigned int**>(rowLengths)), Connectivity::getStream(synapsePopName)});
                         }
                     }
                 }
             }
         }
+
+        // Build row lengths for all synapse groups in parallel on host
+        ParallelConnectors::buildRowLengths(projections, Parameters::connectivitySeed);
+
+        // Push to device
+        for(size_t p = 0; p < projections.size(); p++) {
+            model.pushExtraGlobalParam(synapsePopNames[p], "preCalcRowLength", projections[p].numPre);
+        }
     }
 
     model.initialize();
     model.initializeSparse();
 
-    // Create spike recorders
-    std::vector<std::unique_ptr<SpikeRecorderCached>> spikeRecorders;
+    // Create background writer and spike recorders
+    BinarySpikeWriter spikeWriter;
+    std::vector<std::unique_ptr<BinarySpikeRecorder>> spikeRecorders;
+    std::vector<std::pair<unsigned int*, unsigned int*>> spikeArrays;
     spikeRecorders.reserve(Parameters::LayerMax * Parameters::PopulationMax);
     for(unsigned int layer = 0; layer < Parameters::LayerMax; layer++) {
         for(unsigned int pop = 0; pop < Parameters::PopulationMax; pop++) {
@@ -67,9 +83,11 @@ int main()
             unsigned int *spikeCount = model.getArray<unsigned int>("glbSpkCnt" + name);
             unsigned int *spikes = model.getArray<unsigned int>("glbSpk" + name);
 
-            // Add cached recorder
+            // Add recorder
+            spikeArrays.emplace_back(spikeCount, spikes);
             spikeRecorders.emplace_back(
-                new SpikeRecorderCached((name + ".csv").c_str(), spikeCount, spikes, ",", true));
+                new BinarySpikeRecorder(spikeWriter, name + ".bin", Parameters::getScaledNumNeurons(layer, pop),
+                                        Parameters::dtMs, BinarySpikes::Format::Pairs));
         }
     }
 
@@ -99,8 +117,8 @@ int main()
                 TimerAccumulate timer(recordS);
 
                 // Record spikes
-                for(auto &s : spikeRecorders) {
-                    s->record(model.getTime());
+                for(size_t s = 0; s < spikeRecorders.size(); s++) {
+                    spikeRecorders[s]->record(model.getTimestep(), spikeArrays[s].first[0], spikeArrays[s].second);
                 }
             }
         }
@@ -115,5 +133,9 @@ int main()
     }
     std::cout << "Record:" << recordS << "s" << std::endl;
 
+    // Close recordings and wait for them to be written
+    spikeRecorders.clear();
+    spikeWriter.flush();
+
     return 0;
 }
@@ -0,0 +1,168 @@
+// GeNN includes
+#include "modelSpec.h"
+
+#include "models.h"
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// BatchPoissonCurrentSource
+//----------------------------------------------------------------------------
+//! Poisson current input to a variable population whose clue is a variable so each batch
+//! instance can solve a different puzzle. If Clue is zero, every neuron receives weak noise
+//! input, otherwise only neurons in the domain of the clue receive strong input
+class BatchPoissonCurrentSource : public CurrentSourceModels::Base
+{
+public:
+    DECLARE_MODEL(BatchPoissonCurrentSource, 4, 4);
+
+    SET_PARAM_NAMES({
+        "Tau",
+        "Rate",
+        "ClueRate",
+        "CoreSize"});
+
+    SET_VARS({
+        {"Weight", "scalar", VarAccess::READ_ONLY},
+        {"ClueWeight", "scalar", VarAccess::READ_ONLY},
+        {"Clue", "unsigned int"},
+        {"Current", "scalar"}});
+
+    SET_DERIVED_PARAMS({
+        {"ExpDecay", [](const std::vector<double> &pars, double dt){ return std::exp(-dt / pars[0]); }},
+        {"Init", [](const std::vector<double> &pars, double dt){ return (1.0 - std::exp(-dt / pars[0])) * (pars[0] / dt); }},
+        {"ExpMinusLambda", [](const std::vector<double> &pars, double dt){ return std::exp(-(pars[1] / 1000.0) * dt); }},
+        {"ClueExpMinusLambda", [](const std::vector<double> &pars, double dt){ return std::exp(-(pars[2] / 1000.0) * dt); }}});
+
+    SET_INJECTION_CODE(
+        "const bool isClue = ($(Clue) != 0);\n"
+        "if(!isClue || (($(id) / (unsigned int)$(CoreSize)) == ($(Clue) - 1))) {\n"
+        "    const scalar expMinusLambda = isClue ? $(ClueExpMinusLambda) : $(ExpMinusLambda);\n"
+        "    scalar p = 1.0f;\n"
+        "    unsigned int numPoissonSpikes = 0;\n"
+        "    do\n"
+        "    {\n"
+        "        numPoissonSpikes++;\n"
+        "        p *= $(gennrand_uniform);\n"
+        "    } while (p > expMinusLambda);\n"
+        "    $(Current) += (isClue ? $(ClueWeight) : $(Weight)) * $(Init) * (scalar)(numPoissonSpikes - 1);\n"
+        "    $(injectCurrent, $(Current));\n"
+        "    $(Current) *= $(ExpDecay);\n"
+        "}\n");
+};
+IMPLEMENT_MODEL(BatchPoissonCurrentSource);
+
+//----------------------------------------------------------------------------
+// DomainSpikeCount
+//----------------------------------------------------------------------------
+//! Counts the spikes emitted by one domain over windows of Window timesteps. Counts are reset at the start
+//! of each window so the host only needs to read them at the end of a window, rather than reading, summing
+//! and zeroing the spike counts of every neuron in every domain
+class DomainSpikeCount : public NeuronModels::Base
+{
+public:
+    DECLARE_MODEL(DomainSpikeCount, 1, 1);
+
+    SET_PARAM_NAMES({"Window"});
+
+    SET_VARS({{"SpikeCount", "scalar"}});
+
+    SET_SIM_CODE(
+        "if(((unsigned int)rint($(t) / DT) % (unsigned int)$(Window)) == 0) {\n"
+        "    $(SpikeCount) = 0.0;\n"
+        "}\n"
+        "$(SpikeCount) += $(Isyn);\n");
+};
+IMPLEMENT_MODEL(DomainSpikeCount);
+
+//----------------------------------------------------------------------------
+// DomainToCount
+//----------------------------------------------------------------------------
+//! Connects each neuron in a variable population to the neuron counting its domain's spikes in
+//! the block of 9 neurons counting the spikes of the VariableIndex'th variable population
+class DomainToCount : public InitSparseConnectivitySnippet::Base
+{
+public:
+    DECLARE_SNIPPET(DomainToCount, 2);
+
+    SET_ROW_BUILD_CODE(
+        "const unsigned int coreSize = (unsigned int)$(CoreSize);\n"
+        "$(addSynapse, ((unsigned int)$(VariableIndex) * 9) + ($(id_pre) / coreSize));\n"
+        "$(endRow);\n");
+
+    SET_PARAM_NAMES({"CoreSize", "VariableIndex"});
+
+    SET_CALC_MAX_ROW_LENGTH_FUNC(
+        [](unsigned int, unsigned int, const std::vector<double> &)
+        {
+            return 1;
+        });
+};
+IMPLEMENT_SNIPPET(DomainToCount);
+
+void modelDefinition(ModelSpec &model)
+{
+    GENN_PREFERENCES.useConstantCacheForMergedStructs = false;
+
+    model.setDT(Parameters::timestepMs);
+    model.setName("sudoku_batch");
+    model.setMergePostsynapticModels(true);
+    model.setDefaultVarLocation(VarLocation::DEVICE);
+    model.setDefaultSparseConnectivityLocation(VarLocation::DEVICE);
+    model.setBatchSize(Parameters::batchSize);
+
+    // Distributions of weights for noise and clue noise input
+    InitVarSnippet::Uniform::ParamValues stimWeightDist(
+        1.4,  // 0 - min
+        1.6); // 1 - max
+    InitVarSnippet::Uniform::ParamValues clueWeightDist(
+        1.8,  // 0 - min
+        2.0); // 1 - max
+
+    //**NOTE** clue input is connected all-to-all in original model so rate is multiplied by core size
+    BatchPoissonCurrentSource::ParamValues stimParams(
+        5.0,                            // Tau [ms]
+        20.0,                           // Rate [Hz]
+        20.0 * Parameters::coreSize,    // Clue rate [Hz]
+        Parameters::coreSize);          // Core size
+
+    BatchPoissonCurrentSource::VarValues stimInitVals(
+        initVar<InitVarSnippet::Uniform>(stimWeightDist),   // Weight [nA]
+        initVar<InitVarSnippet::Uniform>(clueWeightDist),   // Clue weight [nA]
+        0,                                                  // Clue
+        0.0);                                               // Current [nA]
+
+    DomainSpikeCount::ParamValues domainSpikeCountParams(
+        Parameters::convergenceCheckTimesteps); // Window [timesteps]
+
+    WeightUpdateModels::StaticPulse::VarValues domainSpikeCountInit(
+        1.0);   // g
+
+    // Add population to count spikes emitted by each domain of each variable
+    auto *domainSpikes = model.addNeuronPopulation<DomainSpikeCount>("DomainSpikes", 9 * 9 * 9, domainSpikeCountParams,
+                                                                    DomainSpikeCount::VarValues(0.0));
+    domainSpikes->setVarLocation("SpikeCount", VarLocation::HOST_DEVICE);
+
+    // Add neuron populations for each variable state, with inputs whose clues are
+    // uploaded per-instance, and connect each domain to the neuron counting its spikes
+    for(size_t y = 0; y < 9; y++) {
+        for(size_t x = 0; x < 9; x++) {
+            const std::string popName = Parameters::getPopName(x, y);
+            addVariablePopulation(model, popName);
+
+            auto *stim = model.addCurrentSource<BatchPoissonCurrentSource>("stim_" + popName, popName,
+                                                                           stimParams, stimInitVals);
+            stim->setVarLocation("Clue", VarLocation::HOST_DEVICE);
+
+            DomainToCount::ParamValues domainToCountParams(
+                Parameters::coreSize,   // Core size
+                (y * 9) + x);           // Variable index
+            model.addSynapsePopulation<WeightUpdateModels::StaticPulse, PostsynapticModels::DeltaCurr>(
+                "domainSpikes_" + popName, SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY, popName, "DomainSpikes",
+                {}, domainSpikeCountInit,
+                {}, {},
+                initConnectivity<DomainToCount>(domainToCountParams));
+        }
+    }
+
+    addConstraints<9>(model);
+}
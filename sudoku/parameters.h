@@ -10,9 +10,20 @@ namespace Parameters
 {
     // Number of neurons per variables (note < blockzise is a bit wasteful)
     constexpr unsigned int coreSize = 25;
-    
-    // Runtime of simulation
+
+    constexpr double timestepMs = 1.0;
+
+    // Runtime of simulation (and maximum time batch solver spends on each batch of puzzles)
     constexpr double runTimeMs = 60000.0;
+
+    // Number of puzzles batch solver simulates simultaneously as batch instances
+    constexpr unsigned int batchSize = 64;
+
+    // Number of timesteps batch solver counts domain spikes over before checking each instance's assignment
+    constexpr unsigned int convergenceCheckTimesteps = 200;
+
+    // Number of consecutive checks an assignment must remain valid and unchanged for puzzle to be solved
+    constexpr unsigned int numStableChecks = 3;
     
     constexpr unsigned int delay = 1;
 
@@ -0,0 +1,311 @@
+// Standard C++ includes
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdlib>
+
+// GeNN userproject includes
+#include "sharedLibraryModel.h"
+
+// Model parameters
+#include "parameters.h"
+#include "puzzles.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+// Cells of puzzles and assignments are indexed x + (y * 9) and hold 0 if unknown
+typedef std::array<int, 81> Grid;
+
+//----------------------------------------------------------------------------
+// CorpusPuzzle
+//----------------------------------------------------------------------------
+struct CorpusPuzzle
+{
+    Grid clues;
+    Grid solution;
+    bool hasSolution;
+};
+
+//----------------------------------------------------------------------------
+// Instance
+//----------------------------------------------------------------------------
+//! State of the puzzle being solved by one batch instance
+struct Instance
+{
+    //! Assignment read out at last check
+    Grid assignment;
+
+    //! Number of consecutive checks assignment has been valid and unchanged
+    unsigned int numStableChecks;
+
+    //! Time at which the current valid assignment was first read out
+    double validSinceMs;
+
+    bool solved;
+};
+
+CorpusPuzzle toCorpusPuzzle(const Puzzle<9> &puzzle)
+{
+    CorpusPuzzle corpusPuzzle;
+    corpusPuzzle.hasSolution = true;
+    for(size_t y = 0; y < 9; y++) {
+        for(size_t x = 0; x < 9; x++) {
+            corpusPuzzle.clues[x + (y * 9)] = puzzle.puzzle[y][x];
+            corpusPuzzle.solution[x + (y * 9)] = puzzle.solution[y][x];
+            corpusPuzzle.hasSolution &= (puzzle.solution[y][x] != 0);
+        }
+    }
+    return corpusPuzzle;
+}
+
+// Read corpus with one puzzle per line - 81 cells containing digits for clues and '0' or '.' for unknown cells - optionally
+// followed by a separator and the 81 digit solution, as in the common "quizzes,solutions" CSV format. Lines not starting
+// with a cell, such as headers and comments, are skipped
+std::vector<CorpusPuzzle> readCorpus(const std::string &filename)
+{
+    std::ifstream stream(filename);
+    if(!stream.good()) {
+        throw std::runtime_error("Cannot open corpus '" + filename + "'");
+    }
+
+    auto isCell = [](char c){ return (c == '.') || (c >= '0' && c <= '9'); };
+    auto parseCell = [](char c){ return (c == '.') ? 0 : (c - '0'); };
+
+    std::vector<CorpusPuzzle> puzzles;
+    std::string line;
+    while(std::getline(stream, line)) {
+        if(line.empty() || !isCell(line[0])) {
+            continue;
+        }
+
+        CorpusPuzzle puzzle;
+        if(line.size() < 81 || !std::all_of(line.cbegin(), line.cbegin() + 81, isCell)) {
+            throw std::runtime_error("Malformed puzzle '" + line + "' in corpus '" + filename + "'");
+        }
+        std::transform(line.cbegin(), line.cbegin() + 81, puzzle.clues.begin(), parseCell);
+
+        puzzle.hasSolution = (line.size() >= 163);
+        if(puzzle.hasSolution) {
+            if(!std::all_of(line.cbegin() + 82, line.cbegin() + 163, [](char c){ return (c >= '1' && c <= '9'); })) {
+                throw std::runtime_error("Malformed solution '" + line + "' in corpus '" + filename + "'");
+            }
+            std::transform(line.cbegin() + 82, line.cbegin() + 163, puzzle.solution.begin(), parseCell);
+        }
+        puzzles.push_back(puzzle);
+    }
+    return puzzles;
+}
+
+// Is assignment complete, consistent with clues and does it satisfy every row, column and sub-square constraint
+bool isValidSolution(const Grid &assignment, const Grid &clues)
+{
+    for(size_t c = 0; c < 81; c++) {
+        if(assignment[c] == 0 || (clues[c] != 0 && clues[c] != assignment[c])) {
+            return false;
+        }
+    }
+
+    for(size_t i = 0; i < 9; i++) {
+        // Build bitmasks of the values in row i, column i and sub-square i
+        unsigned int row = 0;
+        unsigned int column = 0;
+        unsigned int square = 0;
+        for(size_t j = 0; j < 9; j++) {
+            row |= (1 << assignment[j + (i * 9)]);
+            column |= (1 << assignment[i + (j * 9)]);
+
+            const size_t x = ((i % 3) * 3) + (j % 3);
+            const size_t y = ((i / 3) * 3) + (j / 3);
+            square |= (1 << assignment[x + (y * 9)]);
+        }
+
+        // If any don't contain all 9 values, assignment is invalid
+        constexpr unsigned int allValues = 0x3FE;
+        if(row != allValues || column != allValues || square != allValues) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read assignment from domain spike counts - each variable takes the value of the domain that spiked most
+Grid getAssignment(const float *domainSpikes)
+{
+    Grid assignment;
+    for(size_t c = 0; c < 81; c++) {
+        const float *variableSpikes = &domainSpikes[c * 9];
+        const auto maxSpikes = std::max_element(variableSpikes, variableSpikes + 9);
+        assignment[c] = (*maxSpikes > 0.0f) ? (1 + (int)std::distance(variableSpikes, maxSpikes)) : 0;
+    }
+    return assignment;
+}
+}   // Anonymous namespace
+
+// Headless solver which solves each puzzle in a corpus (or, by default, the built-in puzzles) using a batch instance
+// of the network and writes whether it was solved, when and how accurately to a report CSV file:
+//      ./sudoku_batch [corpus.txt] [report.csv]
+// Every Parameters::convergenceCheckTimesteps timesteps, each unsolved instance's assignment is read from the spike counts
+// of each domain, reduced in the model, and instances are solved once their assignment has been valid and unchanged for
+// Parameters::numStableChecks checks. Batches run until every instance is solved or for at most Parameters::runTimeMs
+int main(int argc, char *argv[])
+{
+    try
+    {
+        // Load corpus
+        std::vector<CorpusPuzzle> puzzles;
+        if(argc > 1) {
+            puzzles = readCorpus(argv[1]);
+        }
+        else {
+            puzzles = {toCorpusPuzzle(Puzzles::easy), toCorpusPuzzle(Puzzles::hard), toCorpusPuzzle(Puzzles::platinumBlonde)};
+        }
+        std::cout << puzzles.size() << " puzzles" << std::endl;
+
+        const std::string reportFilename = (argc > 2) ? argv[2] : "sudoku_batch_report.csv";
+        std::ofstream report(reportFilename);
+        if(!report.good()) {
+            throw std::runtime_error("Cannot open '" + reportFilename + "' to write report");
+        }
+        report << "Puzzle, Solved, Solve time [ms], Accuracy" << std::endl;
+
+        SharedLibraryModel<float> model("./", "sudoku_batch");
+        model.allocateMem();
+
+        // Get pointers to domain spike counts and the clue of each variable's input
+        constexpr unsigned int numVariableNeurons = Parameters::coreSize * 9;
+        const float *domainSpikes = model.getArray<float>("SpikeCountDomainSpikes");
+        std::array<unsigned int*, 81> clues;
+        for(size_t y = 0; y < 9; y++) {
+            for(size_t x = 0; x < 9; x++) {
+                clues[x + (y * 9)] = model.getArray<unsigned int>("Cluestim_" + Parameters::getPopName(x, y));
+            }
+        }
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        const unsigned long long maxTimesteps = (unsigned long long)std::round(Parameters::runTimeMs / Parameters::timestepMs);
+        unsigned int numSolved = 0;
+        unsigned int numCorrect = 0;
+        unsigned int numWithSolutions = 0;
+        double totalSolveTimeMs = 0.0;
+        for(size_t batchStart = 0; batchStart < puzzles.size(); batchStart += Parameters::batchSize) {
+            const size_t batchEnd = std::min(puzzles.size(), batchStart + Parameters::batchSize);
+            const unsigned int numInstances = (unsigned int)(batchEnd - batchStart);
+
+            // Reinitialise model so every batch starts from rest
+            model.initialize();
+            model.initializeSparse();
+
+            // Upload clues of each instance's puzzle, leaving unused instances with an empty puzzle
+            for(size_t c = 0; c < 81; c++) {
+                for(unsigned int b = 0; b < Parameters::batchSize; b++) {
+                    const int clue = (b < numInstances) ? puzzles[batchStart + b].clues[c] : 0;
+                    std::fill_n(&clues[c][b * numVariableNeurons], numVariableNeurons, (unsigned int)clue);
+                }
+                model.pushVarToDevice("stim_" + Parameters::getPopName(c % 9, c / 9), "Clue");
+            }
+
+            // **NOTE** batches always end on a check so domain spike count windows stay aligned
+            std::vector<Instance> instances(numInstances, Instance{Grid(), 0, 0.0, false});
+            const unsigned long long batchStartTimestep = model.getTimestep();
+            unsigned int numBatchSolved = 0;
+            while(numBatchSolved < numInstances && (model.getTimestep() - batchStartTimestep) < maxTimesteps) {
+                model.stepTime();
+
+                // If a window of spikes has been counted, download counts and check unsolved instances
+                if((model.getTimestep() % Parameters::convergenceCheckTimesteps) == 0) {
+                    model.pullVarFromDevice("DomainSpikes", "SpikeCount");
+
+                    const double timeMs = (double)(model.getTimestep() - batchStartTimestep) * Parameters::timestepMs;
+                    for(unsigned int b = 0; b < numInstances; b++) {
+                        auto &instance = instances[b];
+                        if(instance.solved) {
+                            continue;
+                        }
+
+                        const Grid assignment = getAssignment(&domainSpikes[b * 9 * 9 * 9]);
+                        if(isValidSolution(assignment, puzzles[batchStart + b].clues)) {
+                            if(instance.numStableChecks > 0 && assignment == instance.assignment) {
+                                instance.numStableChecks++;
+                            }
+                            else {
+                                instance.numStableChecks = 1;
+                                instance.validSinceMs = timeMs;
+                            }
+                        }
+                        else {
+                            instance.numStableChecks = 0;
+                        }
+                        instance.assignment = assignment;
+
+                        // Once assignment is stable, instance is solved and its assignment is no longer updated
+                        if(instance.numStableChecks >= Parameters::numStableChecks) {
+                            instance.solved = true;
+                            numBatchSolved++;
+                        }
+                    }
+                }
+            }
+
+            // Report solve time and accuracy of each puzzle i.e. fraction of unknown cells
+            // in final assignment that match solution (if solution is known)
+            for(unsigned int b = 0; b < numInstances; b++) {
+                const auto &instance = instances[b];
+                const auto &puzzle = puzzles[batchStart + b];
+                report << batchStart + b << ", " << instance.solved << ", ";
+                if(instance.solved) {
+                    report << instance.validSinceMs;
+                    totalSolveTimeMs += instance.validSinceMs;
+                    numSolved++;
+                }
+                report << ", ";
+
+                if(puzzle.hasSolution) {
+                    unsigned int numUnknown = 0;
+                    unsigned int numUnknownCorrect = 0;
+                    for(size_t c = 0; c < 81; c++) {
+                        if(puzzle.clues[c] == 0) {
+                            numUnknown++;
+                            numUnknownCorrect += (instance.assignment[c] == puzzle.solution[c]) ? 1 : 0;
+                        }
+                    }
+                    report << ((numUnknown == 0) ? 1.0 : ((double)numUnknownCorrect / (double)numUnknown));
+
+                    numWithSolutions++;
+                    numCorrect += (numUnknownCorrect == numUnknown) ? 1 : 0;
+                }
+                report << std::endl;
+            }
+
+            std::cout << "Puzzles " << batchStart << "-" << batchEnd - 1 << ": " << numBatchSolved << "/" << numInstances
+                      << " solved in " << (double)(model.getTimestep() - batchStartTimestep) * Parameters::timestepMs << "ms" << std::endl;
+        }
+
+        const double wallS = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << numSolved << "/" << puzzles.size() << " puzzles solved";
+        if(numSolved > 0) {
+            std::cout << ", mean solve time " << totalSolveTimeMs / (double)numSolved << "ms";
+        }
+        std::cout << std::endl;
+        if(numWithSolutions > 0) {
+            std::cout << numCorrect << "/" << numWithSolutions << " puzzles with known solutions solved correctly" << std::endl;
+        }
+        std::cout << "Wall clock time " << wallS << "s, " << (double)puzzles.size() / wallS << " puzzles per second" << std::endl;
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << "Error:" << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
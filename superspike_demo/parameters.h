@@ -1,5 +1,7 @@
 #pragma once
 
+//#define RESUME_TRIAL 100
+
 namespace Parameters
 {
     constexpr double timestepMs = 0.1;
@@ -28,6 +30,7 @@ namespace Parameters
     constexpr unsigned int numTrials = 600;
     constexpr double updateTimeMs = 500.0;
     constexpr double trialMs = 1890.0;
+    constexpr unsigned int checkpointTrials = 100;
 
     // Convert parameters to timesteps
     const unsigned long long updateTimesteps = (unsigned long long)(updateTimeMs / timestepMs);
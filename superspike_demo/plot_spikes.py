@@ -1,14 +1,17 @@
-import csv
 import matplotlib.pyplot as plt
 import numpy as np
+import sys
 
 from glob import glob
 from os import path
 
-spike_dtype = {"names": ("time", "neuron_id"), "formats": (np.float, np.int)}
+sys.path.append(path.join(path.dirname(path.abspath(__file__)), "..", "common"))
+from binary_spikes import read_binary_spikes
 
+spike_dtype = {"names": ("time", "neuron_id"), "formats": (float, int)}
 
-input_spikes = sorted(list(glob("input_spikes_*.csv")))
+
+input_spikes = sorted(list(glob("input_spikes_*.bin")))
 
 # Create plot
 figure, axes = plt.subplots(3, len(input_spikes), sharex="col", sharey="row")
@@ -18,12 +21,9 @@ for i, s in enumerate(input_spikes):
     index = int(s[13:-4])
     
     # Read spikes
-    input_spikes = np.loadtxt(s, delimiter=",", skiprows=1,
-                              dtype=spike_dtype)
-    hidden_spikes = np.loadtxt("hidden_spikes_%u.csv" % index, delimiter=",", skiprows=1,
-                               dtype=spike_dtype)
-    output_spikes = np.loadtxt("output_spikes_%u.csv" % index, delimiter=",", skiprows=1,
-                               dtype=spike_dtype)
+    input_spikes = np.rec.fromarrays(read_binary_spikes(s), dtype=spike_dtype)
+    hidden_spikes = np.rec.fromarrays(read_binary_spikes("hidden_spikes_%u.bin" % index), dtype=spike_dtype)
+    output_spikes = np.rec.fromarrays(read_binary_spikes("output_spikes_%u.bin" % index), dtype=spike_dtype)
 
     # Plot spikes
     start_time_s = float(index) * 1.890
@@ -6,9 +6,15 @@
 #include <string>
 #include <sstream>
 
+// POSIX includes
+#include <dlfcn.h>
+
 // GeNN userproject includes
 #include "timer.h"
-#include "spikeRecorder.h"
+
+// GeNN examples includes
+#include "../common/binary_spike_recorder.h"
+#include "../common/model_checkpoint.h"
 
 // Model parameters
 #include "parameters.h"
@@ -77,7 +83,7 @@ void loadTargetSpikes(const std::string &filename)
 
 }
 
-void generateFrozenPoissonInput(std::mt19937 &gen)
+unsigned int generateFrozenPoissonInput(std::mt19937 &gen)
 {
     std::exponential_distribution<float> dist(1.0);
 
@@ -103,6 +109,7 @@ void generateFrozenPoissonInput(std::mt19937 &gen)
     allocatespikeTimesInput(spikeTimes.size());
     std::copy(spikeTimes.cbegin(), spikeTimes.cend(), &spikeTimesInput[0]);
     pushspikeTimesInputToDevice(spikeTimes.size());
+    return spikeTimes.size();
 }
 
 float calculateError(unsigned int timestep)
@@ -134,22 +141,67 @@ int main()
         // Load target spikes
         loadTargetSpikes("oxford-target.ras");
         
+#ifdef RESUME_TRIAL
+        // Frozen Poisson input is restored from checkpoint
+        const unsigned int numInputSpikes = 0;
+#else
         // Generate frozen Poisson input
-        generateFrozenPoissonInput(gen);
-
+        const unsigned int numInputSpikes = generateFrozenPoissonInput(gen);
+#endif
         
         initializeSparse();
 
         // Calculate initial transpose
         updateCalculateTranspose();
+
+        // Create background writer for spike recordings
+        BinarySpikeWriter spikeWriter;
         {
             Timer a("Simulation wall clock:");
 
-            // Loop through trials
             unsigned int timestep = 0;
             r0HiddenOutputWeightOptimiser = Parameters::r0;
             r0InputHiddenWeightOptimiser = Parameters::r0;
-            for(unsigned int trial = 0; trial < Parameters::numTrials; trial++) {
+
+            // Register everything training depends on with checkpoint
+            ModelCheckpoint checkpoint([](const std::string &name){ return dlsym(RTLD_DEFAULT, name.c_str()); },
+                                       ModelCheckpoint::getExportedArrays(dlsym(RTLD_DEFAULT, "allocateMem")));
+            checkpoint.addVars<unsigned int>("Input", Parameters::numInput, {"startSpike", "endSpike"});
+            checkpoint.addVars<scalar>("Hidden", Parameters::numHidden, {"V", "refracTime", "errTilda"});
+            checkpoint.addVars<scalar>("Output", Parameters::numOutput, {"V", "refracTime", "errRise", "errTilda", "avgSqrErr", "errDecay"});
+            checkpoint.addVars<unsigned int>("Output", Parameters::numOutput, {"startSpike", "endSpike"});
+            checkpoint.addVars<scalar>("Input_Hidden", Parameters::numInput * Parameters::numHidden, {"w", "e", "lambda", "m"});
+            checkpoint.addVars<scalar>("Input_Hidden", Parameters::numInput, {"z", "zTilda"});
+            checkpoint.addVars<scalar>("Input_Hidden", Parameters::numHidden, {"sigmaPrime"});
+            checkpoint.addVars<scalar>("Hidden_Output", Parameters::numHidden * Parameters::numOutput, {"w", "e", "lambda", "m"});
+            checkpoint.addVars<scalar>("Hidden_Output", Parameters::numHidden, {"z", "zTilda"});
+            checkpoint.addVars<scalar>("Hidden_Output", Parameters::numOutput, {"sigmaPrime"});
+            checkpoint.addVars<scalar>("Output_Hidden", Parameters::numOutput * Parameters::numHidden, {"w"});
+            checkpoint.addVars<scalar>("InputHiddenWeightOptimiser", Parameters::numInput * Parameters::numHidden, {"upsilon"});
+            checkpoint.addVars<scalar>("HiddenOutputWeightOptimiser", Parameters::numHidden * Parameters::numOutput, {"upsilon"});
+            checkpoint.addInSyn<scalar>("Hidden", Parameters::numHidden, {"Input_Hidden", "Output_Hidden"});
+            checkpoint.addInSyn<scalar>("Output", Parameters::numOutput, {"Hidden_Output"});
+            checkpoint.addSpikes("Input", Parameters::numInput);
+            checkpoint.addSpikes("Hidden", Parameters::numHidden);
+            checkpoint.addSpikes("Output", Parameters::numOutput);
+            checkpoint.addEGP<scalar>("spikeTimesInput", numInputSpikes);
+            checkpoint.addValue("r0HiddenOutputWeightOptimiser", r0HiddenOutputWeightOptimiser);
+            checkpoint.addValue("r0InputHiddenWeightOptimiser", r0InputHiddenWeightOptimiser);
+            checkpoint.addValue("timestep", timestep);
+
+            // Check no model state has been missed - target spike times are reloaded rather than restored
+            checkpoint.checkComplete({"spikeTimesHidden", "spikeTimesOutput"});
+
+#ifdef RESUME_TRIAL
+            // Restore model from end of trial
+            checkpoint.restore("checkpoint_" + std::to_string(RESUME_TRIAL) + ".bin");
+            const unsigned int startTrial = RESUME_TRIAL + 1;
+#else
+            const unsigned int startTrial = 0;
+#endif
+
+            // Loop through trials
+            for(unsigned int trial = startTrial; trial < Parameters::numTrials; trial++) {
                 // Reduce learning rate every 400 trials
                 if(trial != 0 && (trial % 400) == 0) {
                     r0HiddenOutputWeightOptimiser *= 0.1;
@@ -188,19 +240,24 @@ int main()
 
                 if((trial % 100) == 0) {
                     pullRecordingBuffersFromDevice();
-                    writeTextSpikeRecording("input_spikes_" + std::to_string(trial) + ".csv", recordSpkInput,
-                                            Parameters::numInput, Parameters::trialTimesteps, Parameters::timestepMs,
-                                            ",", true);
-                    writeTextSpikeRecording("hidden_spikes_" + std::to_string(trial) + ".csv", recordSpkHidden,
-                                            Parameters::numHidden, Parameters::trialTimesteps, Parameters::timestepMs,
-                                            ",", true);
-                    writeTextSpikeRecording("output_spikes_" + std::to_string(trial) + ".csv", recordSpkOutput,
-                                            Parameters::numOutput, Parameters::trialTimesteps, Parameters::timestepMs,
-                                            ",", true);
+                    writeBinarySpikeRecording(spikeWriter, "input_spikes_" + std::to_string(trial) + ".bin", recordSpkInput,
+                                              Parameters::numInput, Parameters::trialTimesteps, Parameters::timestepMs);
+                    writeBinarySpikeRecording(spikeWriter, "hidden_spikes_" + std::to_string(trial) + ".bin", recordSpkHidden,
+                                              Parameters::numHidden, Parameters::trialTimesteps, Parameters::timestepMs);
+                    writeBinarySpikeRecording(spikeWriter, "output_spikes_" + std::to_string(trial) + ".bin", recordSpkOutput,
+                                              Parameters::numOutput, Parameters::trialTimesteps, Parameters::timestepMs);
+                }
+
+                // Periodically checkpoint everything so training can be resumed from this trial
+                // **NOTE** this happens after spike sources have been reset so the restored host copies are correct
+                if((trial % Parameters::checkpointTrials) == 0) {
+                    checkpoint.save("checkpoint_" + std::to_string(trial) + ".bin");
                 }
 
             }
 
+            // Make sure final checkpoint was written successfully
+            checkpoint.wait();
         }
 
         std::cout << "Init:" << initTime << std::endl;
@@ -0,0 +1,164 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cmath>
+#include <cstdlib>
+
+// GeNN examples includes
+#include "../common/parallel_connectors.h"
+
+// Model parameters
+#include "parameters.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+//! Host-side SPARSE projection with the same members as GeNN's SparseProjection
+struct Projection
+{
+    Projection(unsigned int numPre) : indInGStorage(numPre + 1), indInG(indInGStorage.data()), ind(nullptr)
+    {
+    }
+
+    Projection(const Projection&) = delete;
+    Projection &operator = (const Projection&) = delete;
+
+    void allocate(unsigned int numSynapses)
+    {
+        indStorage.resize(numSynapses);
+        ind = indStorage.data();
+    }
+
+    std::vector<unsigned int> indInGStorage;
+    std::vector<unsigned int> indStorage;
+    unsigned int *indInG;
+    unsigned int *ind;
+};
+
+double getDuration(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//! Check rows are sorted, without duplicates, and only contain valid postsynaptic neurons
+bool checkRows(const std::vector<unsigned int> &indInG, const std::vector<unsigned int> &ind, unsigned int numPost)
+{
+    for(size_t i = 0; i < (indInG.size() - 1); i++) {
+        const auto rowBegin = ind.cbegin() + indInG[i];
+        const auto rowEnd = ind.cbegin() + indInG[i + 1];
+        if(std::adjacent_find(rowBegin, rowEnd, [](unsigned int a, unsigned int b){ return a >= b; }) != rowEnd
+           || std::any_of(rowBegin, rowEnd, [numPost](unsigned int j){ return j >= numPost; }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Check every column of a fixed number pre projection has exactly numSources synapses
+bool checkColumns(const std::vector<unsigned int> &ind, unsigned int numPost, unsigned int numSources)
+{
+    std::vector<unsigned int> columnLength(numPost, 0);
+    for(unsigned int j : ind) {
+        columnLength[j]++;
+    }
+    return std::all_of(columnLength.cbegin(), columnLength.cend(), [numSources](unsigned int l){ return l == numSources; });
+}
+
+//! Build projection with builder on increasing numbers of threads, checking it is identical to that built
+//! on one thread, which is copied into indInG and ind so its structure can be checked
+template<typename Builder>
+bool checkThreadCounts(const std::string &name, unsigned int numPre, unsigned int maxThreads, Builder build,
+                       std::vector<unsigned int> &indInG, std::vector<unsigned int> &ind)
+{
+    bool identical = true;
+    for(unsigned int numThreads = 1; numThreads <= maxThreads; numThreads = (numThreads < 4) ? (numThreads + 1) : (numThreads * 2)) {
+        Projection projection(numPre);
+        const auto start = std::chrono::high_resolution_clock::now();
+        build(projection, numThreads);
+        const double durationS = getDuration(start);
+        std::cout << name << " on " << numThreads << " threads: " << durationS << "s (" << projection.indStorage.size() << " synapses)" << std::endl;
+
+        if(numThreads == 1) {
+            indInG = projection.indInGStorage;
+            ind = projection.indStorage;
+        }
+        else if(projection.indInGStorage != indInG || projection.indStorage != ind) {
+            std::cout << "\tCONNECTIVITY DIFFERS FROM THAT BUILT ON 1 THREAD" << std::endl;
+            identical = false;
+        }
+    }
+    return identical;
+}
+}   // Anonymous namespace
+
+// Builds the benchmark's fixed probability connectivity, as well as fixed number pre connectivity like
+// ardin_webb_mb's, using ParallelConnectors on increasing numbers of threads and checks it is identical
+// whatever the number of threads and has the expected structure:
+//      ./benchmark_connectivity [max threads]
+int main(int argc, char *argv[])
+{
+    // **NOTE** default to more threads than most machines have cores so uneven splits are always checked
+    const unsigned int maxThreads = (argc > 1) ? std::stoul(argv[1]) : 16;
+    unsigned int numErrors = 0;
+
+    // Build largest fixed probability projection in model (E->E)
+    const unsigned int numPre = Parameters::numExcitatory;
+    const unsigned int numPost = Parameters::numExcitatory;
+    const double probability = Parameters::probabilityConnection;
+    std::vector<unsigned int> indInG;
+    std::vector<unsigned int> ind;
+    const bool fixedProbabilityIdentical = checkThreadCounts(
+        "Fixed probability", numPre, maxThreads,
+        [=](Projection &projection, unsigned int numThreads)
+        {
+            ParallelConnectors::buildFixedProbabilityConnector(numPre, numPost, probability, projection,
+                                                               [&projection](unsigned int n){ projection.allocate(n); },
+                                                               Parameters::connectivitySeed, numThreads);
+        },
+        indInG, ind);
+
+    // Number of synapses should be within 5 standard deviations of binomial mean
+    const double numPotential = (double)numPre * (double)numPost;
+    const double meanSynapses = numPotential * probability;
+    const double sdSynapses = std::sqrt(numPotential * probability * (1.0 - probability));
+    std::cout << "\t" << ind.size() << " synapses, expected " << meanSynapses << " +- " << sdSynapses << std::endl;
+    if(!fixedProbabilityIdentical || !checkRows(indInG, ind, numPost)
+       || std::fabs((double)ind.size() - meanSynapses) > (5.0 * sdSynapses))
+    {
+        numErrors++;
+    }
+
+    // Build tiled fixed number pre connectivity with similar dimensions to ardin_webb_mb's PN->KC projection
+    const unsigned int numInstances = 4;
+    const unsigned int numSources = 10;
+    const unsigned int numTilePre = 360;
+    const unsigned int numTilePost = 20000;
+    const bool fixedNumberPreIdentical = checkThreadCounts(
+        "Tiled fixed number pre", numInstances * numTilePre, maxThreads,
+        [=](Projection &projection, unsigned int numThreads)
+        {
+            ParallelConnectors::buildTiledFixedNumberPreConnector(numInstances, numTilePre, numTilePost, numSources, projection,
+                                                                  [&projection](unsigned int n){ projection.allocate(n); },
+                                                                  Parameters::connectivitySeed, numThreads);
+        },
+        indInG, ind);
+    if(!fixedNumberPreIdentical || !checkRows(indInG, ind, numInstances * numTilePost)
+       || !checkColumns(ind, numInstances * numTilePost, numSources))
+    {
+        numErrors++;
+    }
+
+    if(numErrors > 0) {
+        std::cout << numErrors << " ERRORS" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
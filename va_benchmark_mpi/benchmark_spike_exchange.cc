@@ -0,0 +1,264 @@
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Standard C includes
+#include <cstdlib>
+
+// MPI includes
+#include <mpi.h>
+
+// Model parameters
+#include "parameters.h"
+
+// MPI spike exchange
+#include "spike_exchange.h"
+
+//----------------------------------------------------------------------------
+// Anonymous namespace
+//----------------------------------------------------------------------------
+namespace
+{
+//! Timing of one exchange scheme
+struct Result
+{
+    double totalS;
+    double simulationS;
+    double mpiS;
+    size_t numBytesSent;
+    size_t numMessagesSent;
+    size_t numErrors;
+};
+
+//! Emulate a timestep of a GPU simulation, during which the host is idle, followed by pulling
+//! a deterministic set of spikes so receivers can check which spikes should have arrived
+class EmulatedPopulation
+{
+public:
+    EmulatedPopulation(unsigned int numNeurons, double rateHz)
+    :   m_NumNeurons(numNeurons), m_SpikeProbability(rateHz * Parameters::timestep / 1000.0),
+        m_SpikeCount(0), m_Spikes(numNeurons)
+    {
+    }
+
+    void generate(int rank, unsigned int timestep)
+    {
+        generate(rank, timestep, m_SpikeCount, m_Spikes);
+    }
+
+    void generate(int rank, unsigned int timestep, unsigned int &spikeCount, std::vector<unsigned int> &spikes) const
+    {
+        std::mt19937 rng((rank * 1000003u) + timestep);
+        std::bernoulli_distribution spike(m_SpikeProbability);
+        spikeCount = 0;
+        for(unsigned int i = 0; i < m_NumNeurons; i++) {
+            if(spike(rng)) {
+                spikes[spikeCount++] = i;
+            }
+        }
+
+        // Spikes emitted by GPUs aren't in order
+        std::shuffle(spikes.begin(), spikes.begin() + spikeCount, rng);
+    }
+
+    unsigned int getNumNeurons() const{ return m_NumNeurons; }
+    unsigned int *getSpikeCount(){ return &m_SpikeCount; }
+    unsigned int *getSpikes(){ return m_Spikes.data(); }
+
+private:
+    const unsigned int m_NumNeurons;
+    const double m_SpikeProbability;
+    unsigned int m_SpikeCount;
+    std::vector<unsigned int> m_Spikes;
+};
+
+double getDuration(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Current scheme - exchange uncompressed spikes after every timestep and wait for remote spikes
+Result runBlocking(int rank, EmulatedPopulation &local, EmulatedPopulation &remote,
+                   unsigned int numTimesteps, std::chrono::microseconds stepDuration)
+{
+    const int otherRank = 1 - rank;
+    Result result{0.0, 0.0, 0.0, 0, 0, 0};
+    std::vector<unsigned int> sendBuffer;
+    std::vector<unsigned int> receiveBuffer(remote.getNumNeurons() + 1);
+    unsigned int expectedCount;
+    std::vector<unsigned int> expected(remote.getNumNeurons());
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(unsigned int t = 0; t < numTimesteps; t++) {
+        {
+            const auto simStart = std::chrono::high_resolution_clock::now();
+            std::this_thread::sleep_for(stepDuration);
+            local.generate(rank, t);
+            result.simulationS += getDuration(simStart);
+        }
+
+        {
+            const auto mpiStart = std::chrono::high_resolution_clock::now();
+            sendBuffer.assign(local.getSpikes(), local.getSpikes() + *local.getSpikeCount());
+            sendBuffer.insert(sendBuffer.begin(), *local.getSpikeCount());
+
+            MPI_Status status;
+            MPI_Sendrecv(sendBuffer.data(), (int)sendBuffer.size(), MPI_UNSIGNED, otherRank, 0,
+                         receiveBuffer.data(), (int)receiveBuffer.size(), MPI_UNSIGNED, otherRank, 0,
+                         MPI_COMM_WORLD, &status);
+            result.mpiS += getDuration(mpiStart);
+            result.numBytesSent += sendBuffer.size() * sizeof(unsigned int);
+            result.numMessagesSent++;
+        }
+
+        // Check spikes
+        remote.generate(otherRank, t, expectedCount, expected);
+        if(receiveBuffer[0] != expectedCount
+           || !std::equal(expected.cbegin(), expected.cbegin() + expectedCount, receiveBuffer.cbegin() + 1))
+        {
+            result.numErrors++;
+        }
+    }
+    result.totalS = getDuration(start);
+    return result;
+}
+
+// New scheme - exchange compressed windows of spikes with non-blocking MPI
+Result runWindowed(int rank, EmulatedPopulation &local, EmulatedPopulation &remote,
+                   unsigned int numTimesteps, std::chrono::microseconds stepDuration,
+                   unsigned int delayTimesteps, unsigned int windowTimesteps)
+{
+    const int otherRank = 1 - rank;
+    Result result{0.0, 0.0, 0.0, 0, 0, 0};
+    unsigned int expectedCount;
+    std::vector<unsigned int> expected(remote.getNumNeurons());
+    std::vector<unsigned int> remoteSpikes(remote.getNumNeurons());
+    unsigned int remoteSpikeCount = 0;
+
+    // Check pushed spikes - they were sorted when encoded
+    int pushTimestep = 1 - (int)delayTimesteps;
+    auto pushSpikes = [&]()
+    {
+        if(pushTimestep >= 0) {
+            remote.generate(otherRank, pushTimestep, expectedCount, expected);
+            std::sort(expected.begin(), expected.begin() + expectedCount);
+            if(remoteSpikeCount != expectedCount
+               || !std::equal(expected.cbegin(), expected.cbegin() + expectedCount, remoteSpikes.cbegin()))
+            {
+                result.numErrors++;
+            }
+        }
+        pushTimestep++;
+    };
+
+    SpikeExchange spikeExchange(windowTimesteps, delayTimesteps);
+    spikeExchange.addLocalPopulation(local.getSpikeCount(), local.getSpikes(), {otherRank});
+    spikeExchange.addRemotePopulation(otherRank, &remoteSpikeCount, remoteSpikes.data(),
+                                      remote.getNumNeurons(), pushSpikes);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(unsigned int t = 0; t < numTimesteps; t++) {
+        {
+            const auto simStart = std::chrono::high_resolution_clock::now();
+            std::this_thread::sleep_for(stepDuration);
+            local.generate(rank, t);
+            result.simulationS += getDuration(simStart);
+        }
+
+        {
+            const auto mpiStart = std::chrono::high_resolution_clock::now();
+            spikeExchange.update(t);
+            result.mpiS += getDuration(mpiStart);
+        }
+    }
+    {
+        const auto mpiStart = std::chrono::high_resolution_clock::now();
+        spikeExchange.finish(numTimesteps);
+        result.mpiS += getDuration(mpiStart);
+    }
+    result.totalS = getDuration(start);
+    result.numBytesSent = spikeExchange.getNumBytesSent();
+    result.numMessagesSent = spikeExchange.getNumMessagesSent();
+    return result;
+}
+
+void printResult(const std::string &name, const Result &result)
+{
+    std::cout << name << ":" << std::endl;
+    std::cout << "\tTotal:" << result.totalS << "s, simulation:" << result.simulationS << "s, MPI:" << result.mpiS << "s" << std::endl;
+    std::cout << "\tMPI/simulation:" << result.mpiS / result.simulationS << std::endl;
+    std::cout << "\tSent " << result.numMessagesSent << " messages, " << result.numBytesSent << " bytes" << std::endl;
+    if(result.numErrors > 0) {
+        std::cout << "\t" << result.numErrors << " TIMESTEPS RECEIVED INCORRECT SPIKES" << std::endl;
+    }
+}
+}
+
+// Compares exchanging spikes every timestep, as GeNN's synchroniseMPI did, with SpikeExchange
+// between an emulated excitatory and inhibitory population on two local ranks:
+//      mpirun -np 2 ./benchmark_spike_exchange [num timesteps] [step duration us] [rate Hz] [delay timesteps] [window timesteps]
+// The delay and window default to those in parameters.h
+int main(int argc, char *argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    int exitCode = EXIT_SUCCESS;
+    try
+    {
+        int rank;
+        int numRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+        if(numRanks != 2) {
+            throw std::runtime_error("Benchmark must be run on 2 ranks");
+        }
+
+        const unsigned int numTimesteps = (argc > 1) ? std::stoul(argv[1]) : 10000;
+        const std::chrono::microseconds stepDuration((argc > 2) ? std::stoul(argv[2]) : 100);
+        const double rateHz = (argc > 3) ? std::stod(argv[3]) : 20.0;
+        const unsigned int delayTimesteps = (argc > 4) ? std::stoul(argv[4]) : Parameters::remoteDelayTimesteps;
+        const unsigned int windowTimesteps = (argc > 5) ? std::stoul(argv[5]) : Parameters::exchangeWindowTimesteps;
+
+        EmulatedPopulation excitatory(Parameters::numExcitatory, rateHz);
+        EmulatedPopulation inhibitory(Parameters::numInhibitory, rateHz);
+        EmulatedPopulation &local = (rank == Parameters::excitatoryRank) ? excitatory : inhibitory;
+        EmulatedPopulation &remote = (rank == Parameters::excitatoryRank) ? inhibitory : excitatory;
+
+        const Result blocking = runBlocking(rank, local, remote, numTimesteps, stepDuration);
+        const Result windowed = runWindowed(rank, local, remote, numTimesteps, stepDuration,
+                                             delayTimesteps, windowTimesteps);
+
+        // Print results from each rank in turn
+        for(int r = 0; r < numRanks; r++) {
+            if(r == rank) {
+                std::cout << "Rank " << rank << " (" << ((rank == Parameters::excitatoryRank) ? "E" : "I") << "), "
+                          << numTimesteps << " timesteps of " << stepDuration.count() << "us:" << std::endl;
+                printResult("Blocking every timestep", blocking);
+                printResult("Windowed (" + std::to_string(windowTimesteps) + " timestep window, "
+                            + std::to_string(delayTimesteps) + " timestep delay)", windowed);
+                std::cout << "Fraction of blocking MPI time hidden:" << 1.0 - (windowed.mpiS / blocking.mpiS) << std::endl;
+                std::cout << "Speedup:" << blocking.totalS / windowed.totalS << "x" << std::endl;
+                if(blocking.numErrors > 0 || windowed.numErrors > 0) {
+                    exitCode = EXIT_FAILURE;
+                }
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+
+    MPI_Finalize();
+    return exitCode;
+}
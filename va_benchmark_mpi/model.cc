@@ -66,16 +66,24 @@ void modelDefinition(NNmodel &model)
         10.0);  // 0 - TauSyn (ms)
 
     // Create IF_curr neuron
-    auto *e = model.addNeuronPopulation<LIF>("E", Parameters::numExcitatory, lifParams, lifInit, 0);
-    auto *i = model.addNeuronPopulation<LIF>("I", Parameters::numInhibitory, lifParams, lifInit, 1);
+    auto *e = model.addNeuronPopulation<LIF>("E", Parameters::numExcitatory, lifParams, lifInit, Parameters::excitatoryRank);
+    auto *i = model.addNeuronPopulation<LIF>("I", Parameters::numInhibitory, lifParams, lifInit, Parameters::inhibitoryRank);
 
     auto *ee = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
         "EE", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
         "E", "E",
         {}, excitatoryStaticSynapseInit,
         excitatoryExpCurrParams, {});
+    // When using MPI, the spike exchange delays spikes between ranks by remoteDelayTimesteps
+    // but, otherwise, the same delay is added to the E->I and I->E projections themselves
+#ifdef MPI_ENABLE
+    const unsigned int remoteDelaySteps = NO_DELAY;
+#else
+    const unsigned int remoteDelaySteps = Parameters::remoteDelayTimesteps - 1;
+#endif  // MPI_ENABLE
+
     auto *ei = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "EI", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
+        "EI", SynapseMatrixType::SPARSE_GLOBALG, remoteDelaySteps,
         "E", "I",
         {}, excitatoryStaticSynapseInit,
         excitatoryExpCurrParams, {});
@@ -85,7 +93,7 @@ void modelDefinition(NNmodel &model)
         {}, inhibitoryStaticSynapseInit,
         inhibitoryExpCurrParams, {});
     auto *ie = model.addSynapsePopulation<WeightUpdateModels::StaticPulse, ExpCurr>(
-        "IE", SynapseMatrixType::SPARSE_GLOBALG, NO_DELAY,
+        "IE", SynapseMatrixType::SPARSE_GLOBALG, remoteDelaySteps,
         "I", "E",
         {}, inhibitoryStaticSynapseInit,
         inhibitoryExpCurrParams, {});
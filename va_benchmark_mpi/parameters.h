@@ -30,4 +30,22 @@ namespace Parameters
     const double excitatoryWeight = 4.0E-3 * scale;
     const double inhibitoryWeight = -51.0E-3 * scale;
 
+    // Seed for connectivity - each row of each projection gets its own random stream so it's independent of thread count
+    const unsigned int connectivitySeed = 1234;
+
+    // Ranks excitatory and inhibitory populations are simulated on when using MPI
+    const int excitatoryRank = 0;
+    const int inhibitoryRank = 1;
+
+    // Delay of the E->I and I->E projections. When using MPI, these are the projections between ranks so
+    // this is the time available for exchanging spikes without the simulation having to wait for them.
+    // The original benchmark has 1 timestep delays everywhere so spikes are exchanged in lockstep, every
+    // timestep. Increasing this allows MPI communication to overlap simulation but, in both the MPI and
+    // single machine builds, changes the network so its activity is no longer that of the original benchmark
+    const unsigned int remoteDelayTimesteps = 1;
+
+    // Number of timesteps of spikes sent in each MPI message - must be no more than remoteDelayTimesteps.
+    // Messages for the remaining (remoteDelayTimesteps - exchangeWindowTimesteps) timesteps are in flight while simulating
+    const unsigned int exchangeWindowTimesteps = 1;
+
 }
\ No newline at end of file
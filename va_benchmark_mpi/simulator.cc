@@ -1,14 +1,18 @@
-// Standard C++ includes
-#include <random>
-
 // GeNN robotics includes
-#include "connectors.h"
 #include "spike_csv_recorder.h"
 #include "timer.h"
 
+// GeNN examples includes
+#include "../common/parallel_connectors.h"
+
 // Model parameters
 #include "parameters.h"
 
+// MPI spike exchange
+#ifdef MPI_ENABLE
+#include "spike_exchange.h"
+#endif  // MPI_ENABLE
+
 // Auto-generated model code
 #ifdef DEFINITIONS_HEADER
 #include DEFINITIONS_HEADER
@@ -30,22 +34,21 @@ int main()
     {
         Timer<> t("Building connectivity:");
 
-        std::mt19937 rng;
-
         // If the inhibitory population is being simulated on the local machine build its afferent connectivity
+        // **NOTE** each projection is built from its own seed so connectivity is the same whichever rank builds it
 #ifndef I_REMOTE
-        buildFixedProbabilityConnector(Parameters::numInhibitory, Parameters::numInhibitory, Parameters::probabilityConnection,
-                                       CII, &allocateII, rng);
-        buildFixedProbabilityConnector(Parameters::numExcitatory, Parameters::numInhibitory, Parameters::probabilityConnection,
-                                       CEI, &allocateEI, rng);
+        ParallelConnectors::buildFixedProbabilityConnector(Parameters::numInhibitory, Parameters::numInhibitory, Parameters::probabilityConnection,
+                                                           CII, &allocateII, Parameters::connectivitySeed + 0);
+        ParallelConnectors::buildFixedProbabilityConnector(Parameters::numExcitatory, Parameters::numInhibitory, Parameters::probabilityConnection,
+                                                           CEI, &allocateEI, Parameters::connectivitySeed + 1);
 #endif  // I_REMOTE
 
         // If the excitatory population is being simulated on the local machine build its afferent connectivity
 #ifndef E_REMOTE
-        buildFixedProbabilityConnector(Parameters::numInhibitory, Parameters::numExcitatory, Parameters::probabilityConnection,
-                                       CIE, &allocateIE, rng);
-        buildFixedProbabilityConnector(Parameters::numExcitatory, Parameters::numExcitatory, Parameters::probabilityConnection,
-                                       CEE, &allocateEE, rng);
+        ParallelConnectors::buildFixedProbabilityConnector(Parameters::numInhibitory, Parameters::numExcitatory, Parameters::probabilityConnection,
+                                                           CIE, &allocateIE, Parameters::connectivitySeed + 2);
+        ParallelConnectors::buildFixedProbabilityConnector(Parameters::numExcitatory, Parameters::numExcitatory, Parameters::probabilityConnection,
+                                                           CEE, &allocateEE, Parameters::connectivitySeed + 3);
 #endif  // E_REMOTE
     }
 
@@ -62,14 +65,40 @@ int main()
 #ifndef I_REMOTE
     SpikeCSVRecorder spikesI("spikes_i.csv", glbSpkCntI, glbSpkI);
 #endif  // E_REMOTE
+#ifdef MPI_ENABLE
+    // Send spikes from local population to other rank and receive spikes from remote population
+    // **NOTE** populations must be added in the same order on both ranks
+    SpikeExchange spikeExchange(Parameters::exchangeWindowTimesteps, Parameters::remoteDelayTimesteps);
+#ifdef E_REMOTE
+    spikeExchange.addRemotePopulation(Parameters::excitatoryRank, glbSpkCntE, glbSpkE, Parameters::numExcitatory,
+#ifndef CPU_ONLY
+                                      pushECurrentSpikesToDevice);
+#else
+                                      [](){});
+#endif  // CPU_ONLY
+#else
+    spikeExchange.addLocalPopulation(glbSpkCntE, glbSpkE, {Parameters::inhibitoryRank});
+#endif  // E_REMOTE
+#ifdef I_REMOTE
+    spikeExchange.addRemotePopulation(Parameters::inhibitoryRank, glbSpkCntI, glbSpkI, Parameters::numInhibitory,
+#ifndef CPU_ONLY
+                                      pushICurrentSpikesToDevice);
+#else
+                                      [](){});
+#endif  // CPU_ONLY
+#else
+    spikeExchange.addLocalPopulation(glbSpkCntI, glbSpkI, {Parameters::excitatoryRank});
+#endif  // I_REMOTE
+#endif  // MPI_ENABLE
+
+    const unsigned int numTimesteps = 10000;
     double simulationMs = 0.0;
     double pullLocalMs = 0.0;
     double recordMs = 0.0;
     double mpiMs = 0.0;
-    double pushRemoteMs = 0.0;
     {
         // Loop through timesteps
-        for(unsigned int t = 0; t < 10000; t++)
+        for(unsigned int t = 0; t < numTimesteps; t++)
         {
             // Simulate
 #ifndef CPU_ONLY
@@ -106,31 +135,31 @@ int main()
             }
 
 #ifdef MPI_ENABLE
-            // Synchronise nodes using MPI
+            // Send this timestep's local spikes and push remote spikes due to be delivered in the next timestep
+            // **NOTE** this only waits if the remote spikes haven't arrived after remoteDelayTimesteps
             {
                 TimerAccumulate<> timer(mpiMs);
-                synchroniseMPI();
-            }
-
-            // Push spikes received from remote populations to device
-            {
-                TimerAccumulate<> timer(pushRemoteMs);
-#ifdef E_REMOTE
-                pushECurrentSpikesToDevice();
-#endif  // E_REMOTE
-#ifdef I_REMOTE
-                pushICurrentSpikesToDevice();
-#endif  // I_REMOTE
+                spikeExchange.update(t);
             }
 #endif  // MPI_ENABLE
         }
     }
 
+#ifdef MPI_ENABLE
+    {
+        TimerAccumulate<> timer(mpiMs);
+        spikeExchange.finish(numTimesteps);
+    }
+#endif  // MPI_ENABLE
+
     std::cout << "Simulation:" << simulationMs << "ms" << std::endl;
     std::cout << "Pull local:" << pullLocalMs << "ms" << std::endl;
     std::cout << "Record:" << recordMs << "ms" << std::endl;
     std::cout << "MPI:" << mpiMs << "ms" << std::endl;
-    std::cout << "Push remote:" << pushRemoteMs << "ms" << std::endl;
+#ifdef MPI_ENABLE
+    std::cout << "MPI wait:" << spikeExchange.getWaitTime() * 1000.0 << "ms" << std::endl;
+    std::cout << "MPI sent:" << spikeExchange.getNumMessagesSent() << " messages, " << spikeExchange.getNumBytesSent() << " bytes" << std::endl;
+#endif  // MPI_ENABLE
 
     // Exit GeNN
     // **NOTE** this is particularily important for MPI simulations as MPI_Finalize is called here
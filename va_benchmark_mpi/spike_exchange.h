@@ -0,0 +1,400 @@
+#pragma once
+
+// Standard C++ includes
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Standard C includes
+#include <cstdint>
+
+// MPI includes
+#include <mpi.h>
+
+//----------------------------------------------------------------------------
+// SpikeExchange
+//----------------------------------------------------------------------------
+//! Exchanges spikes between ranks with a communication window rather than every timestep.
+//! Spikes emitted on one rank at timestep s are delivered to the mirror of their population
+//! on another rank after timestep s + delayTimesteps - 1 so, with NO_DELAY synapses, they are
+//! processed delayTimesteps after being emitted. Because nothing is needed until then, spikes
+//! from windowTimesteps timesteps are sent in each message and, if windowTimesteps is less
+//! than delayTimesteps, messages are sent with non-blocking MPI calls and received while the
+//! following (delayTimesteps - windowTimesteps) timesteps are simulated. With a delay and window
+//! of one timestep, spikes are exchanged in lockstep, waiting for each timestep's. Within messages,
+//! the spikes of each timestep and population are encoded as a count followed by the sorted
+//! IDs' differences, all as LEB128-style variable-length integers
+class SpikeExchange
+{
+public:
+    SpikeExchange(unsigned int windowTimesteps, unsigned int delayTimesteps, MPI_Comm comm = MPI_COMM_WORLD)
+    :   m_WindowTimesteps(windowTimesteps), m_DelayTimesteps(delayTimesteps),
+        m_NumBuffers(((delayTimesteps + windowTimesteps - 1) / windowTimesteps) + 1), m_Comm(comm),
+        m_Started(false), m_WaitTime(0.0), m_NumBytesSent(0), m_NumMessagesSent(0)
+    {
+        if(windowTimesteps == 0 || windowTimesteps > delayTimesteps) {
+            throw std::runtime_error("Spike exchange window must be at least one timestep and no longer than the delay");
+        }
+        MPI_Comm_rank(m_Comm, &m_Rank);
+    }
+
+    ~SpikeExchange()
+    {
+        // If there are any outstanding requests, cancel them
+        // **NOTE** finish should be called to complete them cleanly
+        for(auto &p : m_SendPeers) {
+            cancelAll(p.requests);
+        }
+        for(auto &p : m_ReceivePeers) {
+            cancelAll(p.requests);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Public API
+    //------------------------------------------------------------------------
+    //! Send spikes of a population simulated on this rank to the given ranks. Populations must
+    //! be added in the same order on this rank and the destination ranks
+    void addLocalPopulation(const unsigned int *spikeCount, const unsigned int *spikes,
+                            const std::vector<int> &destinationRanks)
+    {
+        m_LocalPopulations.push_back(LocalPopulation{spikeCount, spikes});
+        for(int r : destinationRanks) {
+            getPeer(m_SendPeers, r).populations.push_back(m_LocalPopulations.size() - 1);
+        }
+    }
+
+    //! Receive spikes into mirror of population simulated on another rank. pushSpikes is called
+    //! to copy them to the device after they've been written to spikeCount and spikes
+    void addRemotePopulation(int sourceRank, unsigned int *spikeCount, unsigned int *spikes,
+                             unsigned int numNeurons, std::function<void()> pushSpikes)
+    {
+        m_RemotePopulations.push_back(RemotePopulation{spikeCount, spikes, numNeurons, pushSpikes,
+                                                       std::vector<std::vector<unsigned int>>(m_WindowTimesteps)});
+        getPeer(m_ReceivePeers, sourceRank).populations.push_back(m_RemotePopulations.size() - 1);
+    }
+
+    //! Call after simulating timestep and pulling the current spikes of local populations
+    void update(unsigned int timestep)
+    {
+        if(!m_Started) {
+            start();
+        }
+
+        // Add local spikes to current window of each destination
+        const unsigned int window = timestep / m_WindowTimesteps;
+        for(auto &p : m_SendPeers) {
+            const size_t b = window % m_NumBuffers;
+
+            // If this is the first timestep in window, wait for buffer's previous send to complete
+            if((timestep % m_WindowTimesteps) == 0) {
+                wait(p.requests[b]);
+                p.buffers[b].clear();
+            }
+
+            for(size_t l : p.populations) {
+                encodeSpikes(*m_LocalPopulations[l].spikeCount, m_LocalPopulations[l].spikes, p.buffers[b]);
+            }
+
+            // If this is the last timestep in window, start sending
+            if((timestep % m_WindowTimesteps) == (m_WindowTimesteps - 1)) {
+                MPI_Isend(p.buffers[b].data(), (int)p.buffers[b].size(), MPI_BYTE, p.rank, 0, m_Comm, &p.requests[b]);
+                m_NumBytesSent += p.buffers[b].size();
+                m_NumMessagesSent++;
+            }
+        }
+
+        // Determine which timestep's remote spikes should be delivered before the next timestep
+        const int deliverTimestep = (int)timestep + 1 - (int)m_DelayTimesteps;
+        for(auto &p : m_ReceivePeers) {
+            // If there are spikes to deliver, make sure window containing them has been received and decoded
+            if(deliverTimestep >= 0 && p.decodedWindow != (deliverTimestep / (int)m_WindowTimesteps)) {
+                receiveWindow(p, deliverTimestep / m_WindowTimesteps);
+            }
+
+            // Copy spikes into mirror populations and push
+            for(size_t r : p.populations) {
+                auto &pop = m_RemotePopulations[r];
+                if(deliverTimestep < 0) {
+                    *pop.spikeCount = 0;
+                }
+                else {
+                    const auto &spikes = pop.windowSpikes[deliverTimestep % m_WindowTimesteps];
+                    *pop.spikeCount = (unsigned int)spikes.size();
+                    std::copy(spikes.cbegin(), spikes.cend(), pop.spikes);
+                }
+                pop.pushSpikes();
+            }
+
+            // Progress any outstanding receives
+            progress(p.requests);
+        }
+
+        // Progress any outstanding sends
+        for(auto &p : m_SendPeers) {
+            progress(p.requests);
+        }
+    }
+
+    //! Complete all sends and the receives of any windows which were sent after simulating numTimesteps timesteps
+    void finish(unsigned int numTimesteps)
+    {
+        for(auto &p : m_SendPeers) {
+            for(auto &r : p.requests) {
+                wait(r);
+            }
+        }
+
+        const int numWindowsSent = (int)(numTimesteps / m_WindowTimesteps);
+        for(auto &p : m_ReceivePeers) {
+            for(size_t b = 0; b < m_NumBuffers; b++) {
+                if(p.postedWindows[b] < numWindowsSent) {
+                    wait(p.requests[b]);
+                }
+                else if(p.requests[b] != MPI_REQUEST_NULL) {
+                    MPI_Cancel(&p.requests[b]);
+                    MPI_Wait(&p.requests[b], MPI_STATUS_IGNORE);
+                }
+            }
+        }
+    }
+
+    //! Total time spent waiting for MPI, in seconds
+    double getWaitTime() const{ return m_WaitTime; }
+
+    size_t getNumBytesSent() const{ return m_NumBytesSent; }
+    size_t getNumMessagesSent() const{ return m_NumMessagesSent; }
+
+    //------------------------------------------------------------------------
+    // Static API
+    //------------------------------------------------------------------------
+    static void encodeVarint(uint32_t value, std::vector<uint8_t> &buffer)
+    {
+        while(value >= 0x80) {
+            buffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((uint8_t)value);
+    }
+
+    static uint32_t decodeVarint(const uint8_t *&data, const uint8_t *end)
+    {
+        uint32_t value = 0;
+        for(unsigned int shift = 0; shift < 35; shift += 7) {
+            if(data == end) {
+                throw std::runtime_error("Truncated spike message");
+            }
+            const uint8_t byte = *data++;
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Corrupt varint in spike message");
+    }
+
+    //! Append spike count followed by the differences between the sorted spike IDs
+    static void encodeSpikes(unsigned int spikeCount, const unsigned int *spikes, std::vector<uint8_t> &buffer)
+    {
+        encodeVarint(spikeCount, buffer);
+
+        // **NOTE** spikes aren't emitted in ID order on the GPU so sort a copy
+        thread_local std::vector<unsigned int> sorted;
+        sorted.assign(spikes, spikes + spikeCount);
+        std::sort(sorted.begin(), sorted.end());
+
+        unsigned int previous = 0;
+        for(unsigned int s : sorted) {
+            encodeVarint(s - previous, buffer);
+            previous = s;
+        }
+    }
+
+    static void decodeSpikes(const uint8_t *&data, const uint8_t *end, unsigned int numNeurons,
+                             std::vector<unsigned int> &spikes)
+    {
+        const uint32_t spikeCount = decodeVarint(data, end);
+        if(spikeCount > numNeurons) {
+            throw std::runtime_error("Spike message contains more spikes than neurons");
+        }
+
+        spikes.resize(spikeCount);
+        unsigned int previous = 0;
+        for(auto &s : spikes) {
+            s = previous + decodeVarint(data, end);
+            previous = s;
+        }
+        if(spikeCount > 0 && previous >= numNeurons) {
+            throw std::runtime_error("Spike message contains out of range neuron ID");
+        }
+    }
+
+private:
+    //------------------------------------------------------------------------
+    // LocalPopulation
+    //------------------------------------------------------------------------
+    struct LocalPopulation
+    {
+        const unsigned int *spikeCount;
+        const unsigned int *spikes;
+    };
+
+    //------------------------------------------------------------------------
+    // RemotePopulation
+    //------------------------------------------------------------------------
+    struct RemotePopulation
+    {
+        unsigned int *spikeCount;
+        unsigned int *spikes;
+        unsigned int numNeurons;
+        std::function<void()> pushSpikes;
+
+        //! Spikes emitted during each timestep of the most recently decoded window
+        std::vector<std::vector<unsigned int>> windowSpikes;
+    };
+
+    //------------------------------------------------------------------------
+    // Peer
+    //------------------------------------------------------------------------
+    //! Rank spikes are exchanged with and ring of buffers for messages in flight
+    struct Peer
+    {
+        int rank;
+        std::vector<size_t> populations;
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<MPI_Request> requests;
+
+        //! Window each receive buffer is posted for
+        std::vector<int> postedWindows;
+
+        //! Window which has most recently been decoded into populations
+        int decodedWindow;
+    };
+
+    //------------------------------------------------------------------------
+    // Private methods
+    //------------------------------------------------------------------------
+    Peer &getPeer(std::vector<Peer> &peers, int rank)
+    {
+        if(rank == m_Rank) {
+            throw std::runtime_error("Spikes can't be exchanged with own rank");
+        }
+        auto p = std::find_if(peers.begin(), peers.end(), [rank](const Peer &p){ return p.rank == rank; });
+        if(p == peers.end()) {
+            peers.push_back(Peer{rank, {}, std::vector<std::vector<uint8_t>>(m_NumBuffers),
+                                 std::vector<MPI_Request>(m_NumBuffers, MPI_REQUEST_NULL),
+                                 std::vector<int>(m_NumBuffers, -1), -1});
+            return peers.back();
+        }
+        else {
+            return *p;
+        }
+    }
+
+    //! Size receive buffers for the largest possible message and post receives for first windows
+    void start()
+    {
+        for(auto &p : m_ReceivePeers) {
+            size_t maxBytes = 0;
+            for(size_t r : p.populations) {
+                maxBytes += (5 * (size_t)(m_RemotePopulations[r].numNeurons + 1)) * m_WindowTimesteps;
+            }
+            for(size_t b = 0; b < m_NumBuffers; b++) {
+                p.buffers[b].resize(maxBytes);
+                postReceive(p, (int)b);
+            }
+        }
+        m_Started = true;
+    }
+
+    void postReceive(Peer &peer, int window)
+    {
+        // **NOTE** messages between a pair of ranks can't overtake each other so
+        // receives are matched with windows in the order they are posted
+        const size_t b = window % m_NumBuffers;
+        MPI_Irecv(peer.buffers[b].data(), (int)peer.buffers[b].size(), MPI_BYTE, peer.rank, 0, m_Comm, &peer.requests[b]);
+        peer.postedWindows[b] = window;
+    }
+
+    void receiveWindow(Peer &peer, unsigned int window)
+    {
+        const size_t b = window % m_NumBuffers;
+        if(peer.postedWindows[b] != (int)window) {
+            throw std::runtime_error("Spike exchange window " + std::to_string(window) + " was not posted");
+        }
+
+        // Wait for message and decode each timestep
+        MPI_Status status;
+        wait(peer.requests[b], &status);
+        int numBytes;
+        MPI_Get_count(&status, MPI_BYTE, &numBytes);
+        const uint8_t *data = peer.buffers[b].data();
+        const uint8_t *end = data + numBytes;
+        for(unsigned int t = 0; t < m_WindowTimesteps; t++) {
+            for(size_t r : peer.populations) {
+                auto &pop = m_RemotePopulations[r];
+                decodeSpikes(data, end, pop.numNeurons, pop.windowSpikes[t]);
+            }
+        }
+        if(data != end) {
+            throw std::runtime_error("Spike message from rank " + std::to_string(peer.rank) + " has trailing data");
+        }
+        peer.decodedWindow = (int)window;
+
+        // Re-use buffer for a future window
+        postReceive(peer, (int)(window + m_NumBuffers));
+    }
+
+    void wait(MPI_Request &request, MPI_Status *status = MPI_STATUS_IGNORE)
+    {
+        if(request != MPI_REQUEST_NULL) {
+            const auto start = std::chrono::high_resolution_clock::now();
+            MPI_Wait(&request, status);
+            m_WaitTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+    }
+
+    //! Give MPI an opportunity to progress requests without completing them
+    //! **NOTE** completing receives would discard the status needed to get their size
+    static void progress(std::vector<MPI_Request> &requests)
+    {
+        for(auto &r : requests) {
+            if(r != MPI_REQUEST_NULL) {
+                int flag;
+                MPI_Request_get_status(r, &flag, MPI_STATUS_IGNORE);
+            }
+        }
+    }
+
+    static void cancelAll(std::vector<MPI_Request> &requests)
+    {
+        for(auto &r : requests) {
+            if(r != MPI_REQUEST_NULL) {
+                MPI_Cancel(&r);
+                MPI_Request_free(&r);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Members
+    //------------------------------------------------------------------------
+    const unsigned int m_WindowTimesteps;
+    const unsigned int m_DelayTimesteps;
+    const size_t m_NumBuffers;
+    const MPI_Comm m_Comm;
+    int m_Rank;
+    bool m_Started;
+
+    std::vector<LocalPopulation> m_LocalPopulations;
+    std::vector<RemotePopulation> m_RemotePopulations;
+    std::vector<Peer> m_SendPeers;
+    std::vector<Peer> m_ReceivePeers;
+
+    double m_WaitTime;
+    size_t m_NumBytesSent;
+    size_t m_NumMessagesSent;
+};